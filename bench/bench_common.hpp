@@ -0,0 +1,165 @@
+#pragma once
+
+#include "timeseries.hpp"
+#include "datetime.hpp"
+#include "synthetic.hpp"
+#include "profiler.hpp"
+#include "alloc_counter.hpp"
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#ifndef TSBENCH_MAX_ROWS
+#define TSBENCH_MAX_ROWS 1000000
+#endif
+
+namespace tsbench {
+
+constexpr int64_t kMinRows = 1000;
+constexpr int64_t kMaxRows = TSBENCH_MAX_ROWS;
+
+/// Row counts 1e3, 1e4, ... up to TSBENCH_MAX_ROWS
+inline std::vector<int64_t> row_counts() {
+    return benchmark::CreateRange(kMinRows, kMaxRows, 10);
+}
+
+/// Window sizes used for every rolling kernel
+inline std::vector<int64_t> windows() {
+    return {5, 20, 200};
+}
+
+/**
+ * @brief Deterministic minute-bar random walk with `rows` rows
+ */
+inline tsproc::TimeSeries make_series(size_t rows) {
+    tsproc::synthetic::GeneratorConfig config;
+    config.rows = rows;
+    config.start = "2010-01-04";
+    config.frequency_ns = 60LL * 1000000000LL;
+    config.volatility = 0.002;
+    return tsproc::synthetic::generate_series(config);
+}
+
+/**
+ * @brief Shared series per row count (built once per process)
+ */
+inline tsproc::TimeSeries& cached_series(size_t rows) {
+    static std::map<size_t, tsproc::TimeSeries> cache;
+    auto it = cache.find(rows);
+    if (it == cache.end()) {
+        it = cache.emplace(rows, make_series(rows)).first;
+    }
+    return it->second;
+}
+
+/**
+ * @brief Path of a generated CSV input with `rows` rows (written once)
+ *
+ * Dirty files mix in what vendor data contains: CRLF line endings,
+ * padded fields, empty and NaN values, malformed rows and blank lines.
+ */
+inline std::string csv_input(size_t rows, bool dirty) {
+    namespace fs = std::filesystem;
+    fs::path path = fs::temp_directory_path() /
+                    ("tsbench_" + std::to_string(rows) + (dirty ? "_dirty" : "_clean") + ".csv");
+    if (fs::exists(path)) return path.string();
+
+    const tsproc::TimeSeries& ts = cached_series(rows);
+    std::ofstream ofs(path, std::ios::binary);
+    const char* eol = dirty ? "\r\n" : "\n";
+    ofs << "Date,Open,High,Low,Close,Adj Close,Volume" << eol;
+    for (size_t i = 0; i < ts.size(); ++i) {
+        const tsproc::Record& r = ts[i];
+        if (dirty && i % 97 == 13) {
+            ofs << r.date << ",,," << eol;              // malformed
+            continue;
+        }
+        if (dirty && i % 101 == 7) ofs << eol;          // blank line
+        ofs << r.date << ',' << r.open << ',' << r.high << ',' << r.low << ',';
+        if (dirty && i % 53 == 5) {
+            ofs << ",NaN," << r.volume << eol;          // missing close
+        } else if (dirty && i % 31 == 3) {
+            ofs << "  " << r.close << " , " << r.adj_close << " ," << r.volume << eol;
+        } else {
+            ofs << r.close << ',' << r.adj_close << ',' << r.volume << eol;
+        }
+    }
+    return path.string();
+}
+
+inline int64_t file_bytes(const std::string& path) {
+    return static_cast<int64_t>(std::filesystem::file_size(path));
+}
+
+/// Bytes of the OHLCV payload a kernel reads per row
+constexpr int64_t kRowBytes = 6 * sizeof(double);
+
+/**
+ * @brief Hardware and allocation counters around a benchmark loop
+ *        (construct right before it)
+ *
+ * Counts are reported per row by set_throughput(). When perf_event_open is
+ * not permitted a note is printed once and no hardware columns are added.
+ */
+class LoopCounters {
+public:
+    LoopCounters()
+        : start_(hardware().read()), start_allocs_(tsproc::testing::process_allocations()) {}
+
+    tsproc::profiling::CounterSample elapsed() const { return hardware().read().since(start_); }
+    uint64_t allocations() const { return tsproc::testing::process_allocations() - start_allocs_; }
+
+    static const tsproc::profiling::PerfCounters& hardware() {
+        static const tsproc::profiling::PerfCounters instance;
+        static const bool noted = [] {
+            if (!instance.available()) {
+                std::cerr << "tsbench: hardware counters unavailable: " << instance.status() << "\n";
+            }
+            return true;
+        }();
+        (void)noted;
+        return instance;
+    }
+
+private:
+    tsproc::profiling::CounterSample start_;
+    uint64_t start_allocs_;
+};
+
+/**
+ * @brief Report rows/s and bytes/s for a benchmark that touched `rows` rows,
+ *        plus heap allocations and (when counted) cycles, IPC, cache and
+ *        branch misses per row
+ */
+inline void set_throughput(benchmark::State& state, const LoopCounters& counters, int64_t rows,
+                           int64_t bytes) {
+    namespace prof = tsproc::profiling;
+    state.SetItemsProcessed(state.iterations() * rows);
+    state.SetBytesProcessed(state.iterations() * bytes);
+    state.counters["rows"] = static_cast<double>(rows);
+
+    const prof::CounterSample c = counters.elapsed();
+    const uint64_t allocs = counters.allocations();
+    const double total_rows = static_cast<double>(state.iterations() * rows);
+    if (total_rows <= 0.0) return;
+    state.counters["allocs/row"] = static_cast<double>(allocs) / total_rows;
+    auto per_row = [&](const char* name, size_t e) {
+        if (c.valid[e]) state.counters[name] = static_cast<double>(c.values[e]) / total_rows;
+    };
+    per_row("cycles/row", prof::kCycles);
+    per_row("L1d/row", prof::kL1DMisses);
+    per_row("LLC/row", prof::kLLCMisses);
+    per_row("brmiss/row", prof::kBranchMisses);
+    if (c.valid[prof::kCycles] && c.valid[prof::kInstructions] && c.values[prof::kCycles] > 0) {
+        state.counters["IPC"] = static_cast<double>(c.values[prof::kInstructions]) /
+                                static_cast<double>(c.values[prof::kCycles]);
+    }
+}
+
+} // namespace tsbench
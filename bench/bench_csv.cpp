@@ -0,0 +1,50 @@
+#include "bench_common.hpp"
+#include "csv_reader.hpp"
+
+namespace {
+
+void BM_CSVReader_Read(benchmark::State& state, bool dirty) {
+    const size_t rows = static_cast<size_t>(state.range(0));
+    const std::string path = tsbench::csv_input(rows, dirty);
+    tsbench::LoopCounters counters;
+    for (auto _ : state) {
+        tsproc::CSVReader reader(path);
+        tsproc::TimeSeries ts = reader.read_to_timeseries();
+        benchmark::DoNotOptimize(ts.size());
+    }
+    tsbench::set_throughput(state, counters, static_cast<int64_t>(rows), tsbench::file_bytes(path));
+}
+
+void BM_CSVReader_Stream(benchmark::State& state) {
+    const size_t rows = static_cast<size_t>(state.range(0));
+    const std::string path = tsbench::csv_input(rows, false);
+    tsbench::LoopCounters counters;
+    for (auto _ : state) {
+        tsproc::CSVReader reader(path);
+        double sum = 0.0;
+        reader.stream_to([&sum](const tsproc::Record& r) { sum += r.close; });
+        benchmark::DoNotOptimize(sum);
+    }
+    tsbench::set_throughput(state, counters, static_cast<int64_t>(rows), tsbench::file_bytes(path));
+}
+
+void BM_CSVReader_Parallel(benchmark::State& state) {
+    const size_t rows = static_cast<size_t>(state.range(0));
+    const std::string path = tsbench::csv_input(rows, false);
+    tsbench::LoopCounters counters;
+    for (auto _ : state) {
+        tsproc::CSVReader reader(path);
+        tsproc::TimeSeries ts = reader.read_parallel();
+        benchmark::DoNotOptimize(ts.size());
+    }
+    tsbench::set_throughput(state, counters, static_cast<int64_t>(rows), tsbench::file_bytes(path));
+}
+
+} // namespace
+
+BENCHMARK_CAPTURE(BM_CSVReader_Read, clean, false)
+    ->ArgsProduct({tsbench::row_counts()})->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_CSVReader_Read, dirty, true)
+    ->ArgsProduct({tsbench::row_counts()})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CSVReader_Stream)->ArgsProduct({tsbench::row_counts()})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CSVReader_Parallel)->ArgsProduct({tsbench::row_counts()})->Unit(benchmark::kMillisecond);
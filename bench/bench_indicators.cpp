@@ -0,0 +1,134 @@
+#include "bench_common.hpp"
+#include "indicators.hpp"
+#include "kernels.hpp"
+
+namespace {
+
+// Every rolling kernel has the same shape: (series, window, column)
+template <void (*Kernel)(tsproc::TimeSeries&, size_t, const std::string&)>
+void BM_Indicator(benchmark::State& state) {
+    const size_t rows = static_cast<size_t>(state.range(0));
+    const size_t window = static_cast<size_t>(state.range(1));
+    tsproc::TimeSeries& ts = tsbench::cached_series(rows);
+    tsbench::LoopCounters counters;
+    for (auto _ : state) {
+        Kernel(ts, window, "close");
+        benchmark::ClobberMemory();
+    }
+    tsbench::set_throughput(state, counters, static_cast<int64_t>(rows),
+                            static_cast<int64_t>(rows * sizeof(double)));
+}
+
+void add_volatility(tsproc::TimeSeries& ts, size_t window, const std::string& col) {
+    tsproc::indicators::add_volatility(ts, window, col);
+}
+
+void add_range_volatility(tsproc::TimeSeries& ts, size_t window, const std::string&) {
+    tsproc::indicators::add_range_volatility(ts, window);
+}
+
+void BM_GetColumnValue(benchmark::State& state) {
+    const size_t rows = static_cast<size_t>(state.range(0));
+    const tsproc::TimeSeries& ts = tsbench::cached_series(rows);
+    tsbench::LoopCounters counters;
+    for (auto _ : state) {
+        double sum = 0.0;
+        for (const auto& r : ts) sum += tsproc::indicators::get_column_value(r, "close");
+        benchmark::DoNotOptimize(sum);
+    }
+    tsbench::set_throughput(state, counters, static_cast<int64_t>(rows),
+                            static_cast<int64_t>(rows * sizeof(double)));
+}
+
+// Raw rolling mean/std kernel on one column, per dispatched ISA variant
+void BM_KernelRollMeanStd(benchmark::State& state, tsproc::kernels::Isa isa) {
+    const size_t rows = static_cast<size_t>(state.range(0));
+    const size_t window = static_cast<size_t>(state.range(1));
+    const tsproc::kernels::Isa saved = tsproc::kernels::active_isa();
+    if (!tsproc::kernels::set_isa(isa)) {
+        state.SkipWithError("ISA not supported on this CPU");
+        return;
+    }
+    const tsproc::TimeSeries& ts = tsbench::cached_series(rows);
+    std::vector<double> close(rows), mean(rows), sd(rows);
+    for (size_t i = 0; i < rows; ++i) close[i] = ts[i].close;
+
+    tsbench::LoopCounters counters;
+    for (auto _ : state) {
+        tsproc::kernels::rolling_mean_std(close.data(), rows, window, mean.data(), sd.data());
+        benchmark::ClobberMemory();
+    }
+    tsbench::set_throughput(state, counters, static_cast<int64_t>(rows),
+                            static_cast<int64_t>(rows * sizeof(double)));
+    tsproc::kernels::set_isa(saved);
+}
+
+// Quote features (mid, spread, microprice, imbalance), per dispatched ISA variant
+void BM_KernelQuoteFeatures(benchmark::State& state, tsproc::kernels::Isa isa) {
+    const size_t rows = static_cast<size_t>(state.range(0));
+    const tsproc::kernels::Isa saved = tsproc::kernels::active_isa();
+    if (!tsproc::kernels::set_isa(isa)) {
+        state.SkipWithError("ISA not supported on this CPU");
+        return;
+    }
+    const tsproc::TimeSeries& ts = tsbench::cached_series(rows);
+    std::vector<double> bid(rows), ask(rows), bid_size(rows), ask_size(rows);
+    for (size_t i = 0; i < rows; ++i) {
+        bid[i] = ts[i].low;
+        ask[i] = ts[i].high;
+        bid_size[i] = ts[i].volume;
+        ask_size[i] = ts[i].volume * 0.5 + static_cast<double>(i % 100);
+    }
+    std::vector<double> mid(rows), spread(rows), micro(rows), imbalance(rows);
+
+    tsbench::LoopCounters counters;
+    for (auto _ : state) {
+        tsproc::kernels::quote_features(bid.data(), ask.data(), bid_size.data(), ask_size.data(),
+                                        rows, mid.data(), spread.data(), micro.data(),
+                                        imbalance.data());
+        benchmark::ClobberMemory();
+    }
+    tsbench::set_throughput(state, counters, static_cast<int64_t>(rows),
+                            static_cast<int64_t>(rows * 8 * sizeof(double)));
+    tsproc::kernels::set_isa(saved);
+}
+
+} // namespace
+
+#define TSBENCH_INDICATOR(name, fn)                                                     \
+    BENCHMARK_TEMPLATE(BM_Indicator, fn)                                                \
+        ->Name(name)                                                                    \
+        ->ArgsProduct({tsbench::row_counts(), tsbench::windows()})                      \
+        ->ArgNames({"rows", "window"})                                                  \
+        ->Unit(benchmark::kMillisecond)
+
+TSBENCH_INDICATOR("BM_SMA", tsproc::indicators::add_sma);
+TSBENCH_INDICATOR("BM_RollMeanStd", tsproc::indicators::add_roll_mean_std);
+TSBENCH_INDICATOR("BM_RollMoments", tsproc::indicators::add_roll_moments);
+TSBENCH_INDICATOR("BM_ZScore", tsproc::indicators::add_zscore);
+TSBENCH_INDICATOR("BM_EMA", tsproc::indicators::add_ema);
+TSBENCH_INDICATOR("BM_RollSum", tsproc::indicators::add_roll_sum);
+TSBENCH_INDICATOR("BM_Volatility", add_volatility);
+TSBENCH_INDICATOR("BM_RangeVolatility", add_range_volatility);
+BENCHMARK(BM_GetColumnValue)->ArgsProduct({tsbench::row_counts()})->Unit(benchmark::kMillisecond);
+
+#define TSBENCH_KERNEL_ISA(label, isa)                                                  \
+    BENCHMARK_CAPTURE(BM_KernelRollMeanStd, label, isa)                                 \
+        ->ArgsProduct({tsbench::row_counts(), {20}})                                    \
+        ->ArgNames({"rows", "window"})                                                  \
+        ->Unit(benchmark::kMillisecond)
+
+TSBENCH_KERNEL_ISA(generic, tsproc::kernels::Isa::Generic);
+TSBENCH_KERNEL_ISA(sse42, tsproc::kernels::Isa::SSE42);
+TSBENCH_KERNEL_ISA(avx2, tsproc::kernels::Isa::AVX2);
+TSBENCH_KERNEL_ISA(avx512, tsproc::kernels::Isa::AVX512);
+
+#define TSBENCH_QUOTE_ISA(label, isa)                                                   \
+    BENCHMARK_CAPTURE(BM_KernelQuoteFeatures, label, isa)                               \
+        ->ArgsProduct({tsbench::row_counts()})                                          \
+        ->ArgNames({"rows"})                                                            \
+        ->Unit(benchmark::kMillisecond)
+
+TSBENCH_QUOTE_ISA(generic, tsproc::kernels::Isa::Generic);
+TSBENCH_QUOTE_ISA(avx2, tsproc::kernels::Isa::AVX2);
+TSBENCH_QUOTE_ISA(avx512, tsproc::kernels::Isa::AVX512);
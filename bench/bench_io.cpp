@@ -0,0 +1,78 @@
+#include "bench_common.hpp"
+#include "io.hpp"
+#include <filesystem>
+
+namespace {
+
+std::string output_path(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+void BM_CSVWriter(benchmark::State& state) {
+    const size_t rows = static_cast<size_t>(state.range(0));
+    const tsproc::TimeSeries& ts = tsbench::cached_series(rows);
+    const std::string path = output_path("tsbench_out.csv");
+    tsbench::LoopCounters counters;
+    for (auto _ : state) {
+        tsproc::CSVWriter writer(path);
+        benchmark::DoNotOptimize(writer.write(ts));
+    }
+    tsbench::set_throughput(state, counters, static_cast<int64_t>(rows), tsbench::file_bytes(path));
+    std::filesystem::remove(path);
+}
+
+void BM_BinaryWriter(benchmark::State& state) {
+    const size_t rows = static_cast<size_t>(state.range(0));
+    const tsproc::TimeSeries& ts = tsbench::cached_series(rows);
+    const std::string path = output_path("tsbench_out.bin");
+    tsbench::LoopCounters counters;
+    for (auto _ : state) {
+        tsproc::BinaryWriter writer(path);
+        benchmark::DoNotOptimize(writer.write(ts));
+    }
+    tsbench::set_throughput(state, counters, static_cast<int64_t>(rows), tsbench::file_bytes(path));
+    std::filesystem::remove(path);
+}
+
+void BM_BinaryReader(benchmark::State& state) {
+    const size_t rows = static_cast<size_t>(state.range(0));
+    const std::string path = output_path("tsbench_in.bin");
+    tsproc::BinaryWriter(path).write(tsbench::cached_series(rows));
+    tsbench::LoopCounters counters;
+    for (auto _ : state) {
+        tsproc::BinaryReader reader(path);
+        tsproc::TimeSeries ts = reader.read();
+        benchmark::DoNotOptimize(ts.size());
+    }
+    tsbench::set_throughput(state, counters, static_cast<int64_t>(rows), tsbench::file_bytes(path));
+    std::filesystem::remove(path);
+}
+
+void BM_BinaryReader_Range(benchmark::State& state) {
+    const size_t rows = static_cast<size_t>(state.range(0));
+    const std::string path = output_path("tsbench_range.bin");
+    const tsproc::TimeSeries& ts = tsbench::cached_series(rows);
+    tsproc::BinaryWriter(path).write(ts);
+
+    // Read the middle 1% of the file
+    const size_t first = rows / 2;
+    const size_t count = std::max<size_t>(1, rows / 100);
+    const int64_t from = tsproc::to_timestamp(ts[first].date);
+    const int64_t to = tsproc::to_timestamp(ts[first + count - 1].date) + 1;
+    tsbench::LoopCounters counters;
+    for (auto _ : state) {
+        tsproc::BinaryReader reader(path);
+        tsproc::TimeSeries slice = reader.read_range(from, to);
+        benchmark::DoNotOptimize(slice.size());
+    }
+    tsbench::set_throughput(state, counters, static_cast<int64_t>(count),
+                            static_cast<int64_t>(count) * 8 * static_cast<int64_t>(sizeof(double)));
+    std::filesystem::remove(path);
+}
+
+} // namespace
+
+BENCHMARK(BM_CSVWriter)->ArgsProduct({tsbench::row_counts()})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BinaryWriter)->ArgsProduct({tsbench::row_counts()})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BinaryReader)->ArgsProduct({tsbench::row_counts()})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BinaryReader_Range)->ArgsProduct({tsbench::row_counts()})->Unit(benchmark::kMillisecond);
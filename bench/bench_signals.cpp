@@ -0,0 +1,75 @@
+#include "bench_common.hpp"
+#include "indicators.hpp"
+#include "signals.hpp"
+
+namespace {
+
+void BM_SMACrossover(benchmark::State& state) {
+    const size_t rows = static_cast<size_t>(state.range(0));
+    const size_t slow = static_cast<size_t>(state.range(1));
+    const size_t fast = std::max<size_t>(1, slow / 4);
+    tsproc::TimeSeries& ts = tsbench::cached_series(rows);
+    tsproc::indicators::add_sma(ts, fast);
+    tsproc::indicators::add_sma(ts, slow);
+    tsbench::LoopCounters counters;
+    for (auto _ : state) {
+        tsproc::signals::sma_crossover(ts, fast, slow);
+        benchmark::ClobberMemory();
+    }
+    tsbench::set_throughput(state, counters, static_cast<int64_t>(rows),
+                            static_cast<int64_t>(rows * 2 * sizeof(double)));
+}
+
+void BM_ZScoreMeanReversion(benchmark::State& state) {
+    const size_t rows = static_cast<size_t>(state.range(0));
+    const size_t window = static_cast<size_t>(state.range(1));
+    tsproc::TimeSeries& ts = tsbench::cached_series(rows);
+    tsproc::indicators::add_zscore(ts, window);
+    tsbench::LoopCounters counters;
+    for (auto _ : state) {
+        tsproc::signals::zscore_mean_reversion(ts, window, 2.0, 0.5);
+        benchmark::ClobberMemory();
+    }
+    tsbench::set_throughput(state, counters, static_cast<int64_t>(rows),
+                            static_cast<int64_t>(rows * sizeof(double)));
+}
+
+void BM_Momentum(benchmark::State& state) {
+    const size_t rows = static_cast<size_t>(state.range(0));
+    const size_t window = static_cast<size_t>(state.range(1));
+    tsproc::TimeSeries& ts = tsbench::cached_series(rows);
+    tsbench::LoopCounters counters;
+    for (auto _ : state) {
+        tsproc::signals::momentum_strategy(ts, window, 0.01, -0.01);
+        benchmark::ClobberMemory();
+    }
+    tsbench::set_throughput(state, counters, static_cast<int64_t>(rows),
+                            static_cast<int64_t>(rows * sizeof(double)));
+}
+
+void BM_BollingerBreakout(benchmark::State& state) {
+    const size_t rows = static_cast<size_t>(state.range(0));
+    const size_t window = static_cast<size_t>(state.range(1));
+    tsproc::TimeSeries& ts = tsbench::cached_series(rows);
+    tsproc::indicators::add_roll_mean_std(ts, window);
+    tsbench::LoopCounters counters;
+    for (auto _ : state) {
+        tsproc::signals::bollinger_breakout(ts, window, 2.0);
+        benchmark::ClobberMemory();
+    }
+    tsbench::set_throughput(state, counters, static_cast<int64_t>(rows),
+                            static_cast<int64_t>(rows * 3 * sizeof(double)));
+}
+
+} // namespace
+
+#define TSBENCH_SIGNAL(fn)                                                              \
+    BENCHMARK(fn)                                                                       \
+        ->ArgsProduct({tsbench::row_counts(), tsbench::windows()})                      \
+        ->ArgNames({"rows", "window"})                                                  \
+        ->Unit(benchmark::kMillisecond)
+
+TSBENCH_SIGNAL(BM_SMACrossover);
+TSBENCH_SIGNAL(BM_ZScoreMeanReversion);
+TSBENCH_SIGNAL(BM_Momentum);
+TSBENCH_SIGNAL(BM_BollingerBreakout);
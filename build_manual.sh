@@ -11,7 +11,7 @@ echo "==========================================="
 # Compiler settings
 CXX="g++"
 CXXFLAGS="-std=c++17 -O3 -Wall -Wextra -Wpedantic -Iinclude"
-LDFLAGS=""
+LDFLAGS="-pthread"
 
 # Create output directories
 mkdir -p build/obj
@@ -35,6 +35,76 @@ $CXX $CXXFLAGS -c src/signals.cpp -o build/obj/signals.o
 echo "  -> io.cpp"
 $CXX $CXXFLAGS -c src/io.cpp -o build/obj/io.o
 
+echo "  -> datetime.cpp"
+$CXX $CXXFLAGS -c src/datetime.cpp -o build/obj/datetime.o
+
+echo "  -> streaming.cpp"
+$CXX $CXXFLAGS -c src/streaming.cpp -o build/obj/streaming.o
+
+echo "  -> replay.cpp"
+$CXX $CXXFLAGS -c src/replay.cpp -o build/obj/replay.o
+
+echo "  -> downsample.cpp"
+$CXX $CXXFLAGS -c src/downsample.cpp -o build/obj/downsample.o
+
+echo "  -> pyramid.cpp"
+$CXX $CXXFLAGS -c src/pyramid.cpp -o build/obj/pyramid.o
+
+echo "  -> csv_index.cpp"
+$CXX $CXXFLAGS -c src/csv_index.cpp -o build/obj/csv_index.o
+
+echo "  -> gaps.cpp"
+$CXX $CXXFLAGS -c src/gaps.cpp -o build/obj/gaps.o
+
+echo "  -> duplicates.cpp"
+$CXX $CXXFLAGS -c src/duplicates.cpp -o build/obj/duplicates.o
+
+echo "  -> synthetic.cpp"
+$CXX $CXXFLAGS -c src/synthetic.cpp -o build/obj/synthetic.o
+
+echo "  -> profiler.cpp"
+$CXX $CXXFLAGS -c src/profiler.cpp -o build/obj/profiler.o
+
+echo "  -> trace.cpp"
+$CXX $CXXFLAGS -c src/trace.cpp -o build/obj/trace.o
+
+echo "  -> kernels.cpp (+ SSE4.2/AVX2/AVX-512 variants)"
+KERNELFLAGS="-ffp-contract=off -fno-math-errno -fno-trapping-math"
+$CXX $CXXFLAGS $KERNELFLAGS -DTSPROC_KERNEL_DISPATCH -c src/kernels.cpp -o build/obj/kernels.o
+$CXX $CXXFLAGS $KERNELFLAGS -msse4.2 -c src/kernels_sse42.cpp -o build/obj/kernels_sse42.o
+$CXX $CXXFLAGS $KERNELFLAGS -mavx2 -c src/kernels_avx2.cpp -o build/obj/kernels_avx2.o
+$CXX $CXXFLAGS $KERNELFLAGS -mavx512f -c src/kernels_avx512.cpp -o build/obj/kernels_avx512.o
+
+echo "  -> histogram.cpp"
+$CXX $CXXFLAGS -c src/histogram.cpp -o build/obj/histogram.o
+
+echo "  -> scheduler.cpp"
+$CXX $CXXFLAGS -c src/scheduler.cpp -o build/obj/scheduler.o
+
+echo "  -> numa.cpp"
+$CXX $CXXFLAGS -c src/numa.cpp -o build/obj/numa.o
+
+echo "  -> column_buffer.cpp"
+$CXX $CXXFLAGS -c src/column_buffer.cpp -o build/obj/column_buffer.o
+
+echo "  -> pages.cpp"
+$CXX $CXXFLAGS -c src/pages.cpp -o build/obj/pages.o
+
+echo "  -> bar.cpp"
+$CXX $CXXFLAGS -c src/bar.cpp -o build/obj/bar.o
+
+echo "  -> panel.cpp"
+$CXX $CXXFLAGS -c src/panel.cpp -o build/obj/panel.o
+
+echo "  -> ticks.cpp"
+$CXX $CXXFLAGS -c src/ticks.cpp -o build/obj/ticks.o
+
+echo "  -> order_book.cpp"
+$CXX $CXXFLAGS -c src/order_book.cpp -o build/obj/order_book.o
+
+echo "  -> realized.cpp"
+$CXX $CXXFLAGS -c src/realized.cpp -o build/obj/realized.o
+
 echo "  -> main.cpp"
 $CXX $CXXFLAGS -c src/main.cpp -o build/obj/main.o
 
@@ -42,6 +112,14 @@ echo ""
 echo "Linking executable..."
 $CXX build/obj/*.o -o build/bin/tsproc.exe $LDFLAGS
 
+echo "Linking data generator..."
+$CXX $CXXFLAGS -c tools/tsgen.cpp -o build/tsgen.o
+$CXX build/tsgen.o $(ls build/obj/*.o | grep -v main.o) -o build/bin/tsgen.exe $LDFLAGS
+
+echo "Linking perf harness..."
+$CXX $CXXFLAGS -DTSPERF_BUILD_TYPE='"Release"' -c tools/tsperf.cpp -o build/tsperf.o
+$CXX build/tsperf.o $(ls build/obj/*.o | grep -v main.o) -o build/bin/tsperf.exe $LDFLAGS
+
 echo ""
 echo "==========================================="
 echo "Build complete!"
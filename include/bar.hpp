@@ -0,0 +1,47 @@
+#pragma once
+
+#include "timeseries.hpp"
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace tsproc {
+
+/**
+ * @brief Compact OHLCV row: an int64 timestamp and six doubles
+ *
+ * Trivially copyable and 56 bytes, so arrays of bars move with memcpy and
+ * vectorize cleanly, unlike Record (a date string plus an indicators map).
+ * The fields are laid out exactly like the first seven columns of a binary
+ * file row, so a BinaryReader row copies straight into a Bar. The stream
+ * pipeline, replay and binary I/O paths use Bar; Record stays the type for
+ * indicator-annotated series, and to_bar()/to_record() convert between them.
+ */
+struct Bar {
+    int64_t ts = 0;         ///< Nanoseconds since epoch (kInvalidTimestamp if unknown)
+    double open = 0.0;
+    double high = 0.0;
+    double low = 0.0;
+    double close = 0.0;
+    double adj_close = 0.0;
+    double volume = 0.0;
+};
+
+static_assert(std::is_trivially_copyable<Bar>::value, "Bar must stay memcpy-able");
+static_assert(std::is_standard_layout<Bar>::value, "Bar must keep its binary layout");
+static_assert(sizeof(Bar) == 7 * sizeof(double), "Bar must have no padding");
+
+/**
+ * @brief Bar from a record; the date is parsed (kInvalidTimestamp on failure)
+ */
+Bar to_bar(const Record& r);
+
+/**
+ * @brief Record from a bar, with the timestamp formatted by format_datetime()
+ */
+Record to_record(const Bar& b);
+
+std::vector<Bar> to_bars(const TimeSeries& ts);
+TimeSeries to_series(const std::vector<Bar>& bars);
+
+} // namespace tsproc
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "pages.hpp"
+#include "scheduler.hpp"
+#include <cstddef>
+
+namespace tsproc {
+
+/**
+ * @brief Page-aligned double column whose pages are placed by first touch
+ *
+ * The constructor zero-fills the buffer, and the thread that first touches
+ * a page decides which NUMA node it is allocated on. Pick the placement
+ * from how the column is computed on:
+ *
+ * - FirstTouch::Caller zero-fills on the constructing thread, so the whole
+ *   column sits on that thread's node. Use it for columns a serial kernel
+ *   or state machine scans on the calling thread.
+ * - FirstTouch::Parallel zero-fills through parallel_for, so each page is
+ *   allocated on the node that numa::node_for() assigns to its rows. Use it
+ *   only for columns later computed on by parallel_for over the same range,
+ *   whose chunks run on those same nodes.
+ *
+ * Storage comes from pages::allocate(), so columns of a few MiB or more
+ * sit on 2 MiB huge pages when pages::huge_pages() allows it, which cuts
+ * TLB misses on long scans. Placement is then decided per huge page.
+ */
+class ColumnBuffer {
+public:
+    static constexpr size_t kAlignment = pages::kPageSize;
+
+    /// Which threads first touch a new buffer's pages
+    enum class FirstTouch {
+        Caller,    ///< The constructing thread
+        Parallel   ///< parallel_for chunks, by row range
+    };
+
+    ColumnBuffer() = default;
+
+    /**
+     * @brief Allocate `size` zeroed values with the given first-touch placement
+     */
+    explicit ColumnBuffer(size_t size, FirstTouch touch = FirstTouch::Caller,
+                          exec::Scheduler& scheduler = exec::Scheduler::global());
+    ~ColumnBuffer();
+
+    ColumnBuffer(ColumnBuffer&& other) noexcept;
+    ColumnBuffer& operator=(ColumnBuffer&& other) noexcept;
+    ColumnBuffer(const ColumnBuffer&) = delete;
+    ColumnBuffer& operator=(const ColumnBuffer&) = delete;
+
+    double* data() { return data_; }
+    const double* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    pages::Backing backing() const { return block_.backing; }
+
+    double& operator[](size_t i) { return data_[i]; }
+    const double& operator[](size_t i) const { return data_[i]; }
+
+    double* begin() { return data_; }
+    double* end() { return data_ + size_; }
+    const double* begin() const { return data_; }
+    const double* end() const { return data_ + size_; }
+
+private:
+    void release();
+
+    pages::Block block_;
+    double* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+} // namespace tsproc
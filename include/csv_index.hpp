@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace tsproc {
+
+/**
+ * @brief Sparse line-offset index for CSV files
+ *
+ * Records the byte offset and timestamp of every Nth data line (the
+ * header is not counted, blank lines are skipped), plus the total number
+ * of data lines. Stored as a binary sidecar next to the CSV
+ * ("prices.csv" -> "prices.csv.idx") and tagged with the CSV file size
+ * and modification time so a stale index is ignored.
+ *
+ * Used by CSVReader to start reading at any row, to split the file into
+ * row-balanced chunks for parallel parsing, to seed date-range reads, and
+ * to answer row counts without parsing.
+ */
+class CSVIndex {
+public:
+    /// One sample per `stride` data lines
+    struct Entry {
+        uint64_t offset;    ///< Byte offset of the line start
+        int64_t timestamp;  ///< Parsed date of that line (kInvalidTimestamp if unparseable)
+    };
+
+    static constexpr size_t kDefaultStride = 1024;
+
+    CSVIndex() = default;
+
+    /**
+     * @brief Build the index by scanning the CSV (dates are the only field parsed)
+     *
+     * @param csv_path CSV file to index
+     * @param stride Lines between samples
+     * @param delimiter Column delimiter
+     * @return true if the file could be read
+     */
+    bool build(const std::string& csv_path, size_t stride = kDefaultStride, char delimiter = ',');
+
+    /**
+     * @brief Write the index to a sidecar file
+     */
+    bool save(const std::string& index_path) const;
+
+    /**
+     * @brief Load an index, rejecting it if it does not match the CSV's size
+     *        and modification time or its entry count disagrees with its length
+     *
+     * @param index_path Sidecar file
+     * @param csv_path CSV file the index must describe
+     * @return true if a fresh index was loaded
+     */
+    bool load(const std::string& index_path, const std::string& csv_path);
+
+    /**
+     * @brief Default sidecar location for a CSV file
+     */
+    static std::string sidecar_path(const std::string& csv_path) { return csv_path + ".idx"; }
+
+    /**
+     * @brief Modification time of a file in nanoseconds (0 if unavailable)
+     */
+    static int64_t modified_ns(const std::string& path);
+
+    /**
+     * @brief Incremental construction used while parsing: call for every data line
+     */
+    void start(size_t stride, uint64_t file_size, int64_t modified_ns);
+    void add_line(uint64_t offset, int64_t timestamp);
+
+    size_t row_count() const { return rows_; }
+    size_t stride() const { return stride_; }
+    uint64_t file_size() const { return file_size_; }
+    const std::vector<Entry>& entries() const { return entries_; }
+    bool empty() const { return entries_.empty(); }
+
+    /**
+     * @brief Closest indexed position at or before a row
+     *
+     * @param row Target data row
+     * @param row_at_offset Output: data row that starts at the returned offset
+     * @return Byte offset of row_at_offset
+     */
+    uint64_t seek_row(size_t row, size_t& row_at_offset) const;
+
+    /**
+     * @brief Offset of the last indexed line whose timestamp is < from_ns
+     *
+     * Reading forward from here visits every row >= from_ns. Returns the
+     * first entry's offset when no sample is earlier.
+     */
+    uint64_t seek_timestamp(int64_t from_ns) const;
+
+    /**
+     * @brief Split the data into byte ranges holding near-equal row counts
+     *
+     * @param chunks Desired number of chunks
+     * @return [begin, end) byte ranges starting at line boundaries
+     */
+    std::vector<std::pair<uint64_t, uint64_t>> split(size_t chunks) const;
+
+private:
+    size_t stride_ = kDefaultStride;
+    size_t rows_ = 0;
+    uint64_t file_size_ = 0;
+    int64_t modified_ns_ = 0;
+    std::vector<Entry> entries_;
+};
+
+} // namespace tsproc
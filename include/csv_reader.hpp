@@ -1,8 +1,15 @@
 #pragma once
 
 #include "timeseries.hpp"
+#include "csv_index.hpp"
+#include "duplicates.hpp"
+#include "panel.hpp"
 #include <string>
+#include <cstdint>
 #include <functional>
+#include <istream>
+#include <utility>
+#include <vector>
 
 namespace tsproc {
 
@@ -45,6 +52,95 @@ public:
      */
     void stream_to(std::function<void(const Record&)> callback, bool drop_na = true);
 
+    /**
+     * @brief Parse only the rows whose timestamp falls in [from_ns, to_ns)
+     * 
+     * Requires the file to be sorted by date. The first matching row is
+     * located by bisecting on byte offsets (a handful of seeks, each
+     * reading one line), and reading stops at the first row at or after
+     * to_ns, so work scales with the selected range rather than file size.
+     * Rows with unparseable dates are skipped.
+     * 
+     * @param from_ns Inclusive lower bound (nanoseconds since epoch)
+     * @param to_ns Exclusive upper bound (nanoseconds since epoch)
+     * @param drop_na If true, skip rows with missing/invalid numeric values
+     * @return TimeSeries with the rows in range
+     */
+    TimeSeries read_range(int64_t from_ns, int64_t to_ns, bool drop_na = true);
+
+    /**
+     * @brief Parse `count` data rows starting at data row `start_row`
+     * 
+     * Rows are numbered from 0 over non-blank data lines, including rows
+     * later dropped by drop_na. With a sidecar index (see CSVIndex) the
+     * reader seeks to the nearest indexed row instead of scanning.
+     */
+    TimeSeries read_rows(size_t start_row, size_t count, bool drop_na = true);
+
+    /**
+     * @brief Parse the file on several threads and merge in file order
+     * 
+     * Chunks are row-balanced using the sidecar index when present,
+     * otherwise byte-balanced and aligned to line starts.
+     * 
+     * @param threads Number of chunks (0 = scheduler concurrency)
+     * @param drop_na If true, skip rows with missing/invalid numeric values
+     */
+    TimeSeries read_parallel(size_t threads = 0, bool drop_na = true);
+
+    /**
+     * @brief Parse a long-format file into per-symbol columns in one pass
+     * 
+     * Long-format files carry a symbol column with all tickers interleaved,
+     * e.g. "Symbol,Date,Open,High,Low,Close,Adj Close,Volume". The symbol
+     * column is found by name in the header (case-insensitive); the other
+     * columns are read in order as Date, Open, High, Low, Close, Adj Close,
+     * Volume. Each chunk (split as in read_parallel()) dictionary-encodes
+     * symbols into its own table and routes rows into its own per-symbol
+     * columns, and the partial panels are merged afterwards, so the file is
+     * read once with no pre-split step. Rows without a symbol are skipped.
+     * Duplicate timestamps are kept here; Panel::series() resolves them
+     * per symbol.
+     * 
+     * @param symbol_column Header name of the symbol column
+     * @param threads Number of chunks (0 = scheduler concurrency)
+     * @param drop_na If true, skip rows with missing/invalid numeric values
+     * @return Panel with one entry per symbol (empty if the column is missing)
+     */
+    Panel read_panel(const std::string& symbol_column = "Symbol", size_t threads = 0,
+                     bool drop_na = true);
+
+    /**
+     * @brief Number of non-blank data lines
+     * 
+     * Answered from the sidecar index without reading the CSV when a fresh
+     * index exists; otherwise the file is scanned for line breaks.
+     */
+    size_t row_count() const;
+
+    /**
+     * @brief Write a sidecar index while read_to_timeseries() parses
+     * 
+     * Only takes effect when no fresh index exists yet.
+     * 
+     * @param enable Build the index during the next full parse
+     * @param stride Data lines between index samples
+     */
+    void set_build_index(bool enable, size_t stride = CSVIndex::kDefaultStride);
+
+    /**
+     * @brief Resolve rows with duplicate timestamps while reading
+     * 
+     * Applies to read_to_timeseries(), read_range(), read_rows() and
+     * read_parallel(). See DuplicateResolver for the sorted/unsorted paths.
+     */
+    void set_duplicate_policy(DuplicatePolicy policy) { duplicate_policy_ = policy; }
+
+    /**
+     * @brief Number of duplicate rows resolved by the last read
+     */
+    size_t duplicates_resolved() const { return duplicates_resolved_; }
+
     /**
      * @brief Check if the file was opened successfully
      */
@@ -53,34 +149,112 @@ public:
 private:
     std::string path_;
     char delimiter_;
+    bool build_index_ = false;
+    size_t index_stride_ = CSVIndex::kDefaultStride;
+    DuplicatePolicy duplicate_policy_ = DuplicatePolicy::KeepAll;
+    size_t duplicates_resolved_ = 0;
+
+    /**
+     * @brief Load the sidecar index if it exists and matches the file
+     */
+    bool load_index(CSVIndex& index) const;
+
+    /**
+     * @brief Parse the data lines in the byte range [begin, end)
+     */
+    void parse_chunk(uint64_t begin, uint64_t end, bool drop_na, TimeSeries& out) const;
+
+    /**
+     * @brief Parse the long-format lines in [begin, end) into `out`
+     */
+    void parse_panel_chunk(uint64_t begin, uint64_t end, size_t symbol_field, bool drop_na,
+                           Panel& out) const;
+
+    /**
+     * @brief Cut the data lines into up to `threads` contiguous byte ranges
+     * 
+     * @return false if the file cannot be opened
+     */
+    bool split_ranges(size_t threads, std::vector<std::pair<uint64_t, uint64_t>>& ranges) const;
+
+    /**
+     * @brief Position of a header column (case-insensitive), or SIZE_MAX if absent
+     */
+    size_t find_column(const std::string& name) const;
+
+    /// Byte range [begin, end) of one field within a line
+    struct FieldRange {
+        size_t begin;
+        size_t end;
+    };
+
+    /// Fields parse_record() reads: Date, Open, High, Low, Close, Adj Close, Volume
+    static constexpr size_t kRecordFields = 7;
 
     /**
-     * @brief Fast line splitting without stringstream overhead
+     * @brief Locate the first `max_fields` fields of a line without copying them
      * 
      * @param line Input line to split
-     * @param delim Delimiter character
-     * @return Vector of column strings
+     * @param fields Output ranges (at least max_fields entries)
+     * @param max_fields Number of fields wanted
+     * @return Number of fields found (<= max_fields)
      */
-    std::vector<std::string> split_line_fast(const std::string& line, char delim) const;
+    size_t split_fields(const std::string& line, FieldRange* fields, size_t max_fields) const;
 
     /**
      * @brief Parse a CSV row into a Record object
      * 
-     * @param columns Vector of column strings
+     * @param line Line the fields point into
+     * @param fields Field ranges from split_fields()
+     * @param count Number of fields
      * @param record Output record
      * @return true if parsing succeeded, false if invalid data
      */
-    bool parse_record(const std::vector<std::string>& columns, Record& record) const;
+    bool parse_record(const std::string& line, const FieldRange* fields, size_t count,
+                      Record& record) const;
+
+    /**
+     * @brief Parse the fields of a long-format row, skipping the symbol field
+     * 
+     * Same checks as parse_record(); `date` is a reused scratch buffer.
+     * 
+     * @return true if all values parsed
+     */
+    bool parse_bar(const std::string& line, const FieldRange* fields, size_t count,
+                   size_t symbol_field, std::string& date, Bar& bar) const;
+
+    /**
+     * @brief Split and parse one data line
+     * 
+     * @return true if the record should be emitted (valid, or kept NaN row)
+     */
+    bool parse_line(const std::string& line, Record& record, bool drop_na) const;
+
+    /**
+     * @brief Timestamp of a line's first column, kInvalidTimestamp if unparseable
+     */
+    int64_t line_timestamp(const std::string& line) const;
+
+    /**
+     * @brief Byte offset of a line start at or before the first row >= from_ns
+     */
+    std::streamoff seek_first_at_or_after(std::istream& file, std::streamoff data_start,
+                                          std::streamoff file_size, int64_t from_ns) const;
+
+    /**
+     * @brief Shrink a field range to exclude surrounding whitespace
+     */
+    static FieldRange trim(const std::string& line, FieldRange field);
 
     /**
-     * @brief Trim whitespace from string
+     * @brief Whether a line holds only whitespace
      */
-    std::string trim(const std::string& str) const;
+    static bool is_blank(const std::string& line);
 
     /**
-     * @brief Convert string to double, returns NaN on failure
+     * @brief Convert a field to double, returns NaN on failure
      */
-    double safe_stod(const std::string& str) const;
+    static double parse_double(const std::string& line, FieldRange field);
 };
 
 } // namespace tsproc
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace tsproc {
+
+/// Sentinel timestamp used when a date string cannot be parsed
+constexpr int64_t kInvalidTimestamp = INT64_MIN;
+
+/**
+ * @brief Integer division rounded towards negative infinity
+ *
+ * Buckets timestamps before 1970 the same way as later ones,
+ * e.g. floor_div(-1, 60) == -1.
+ */
+inline int64_t floor_div(int64_t a, int64_t b) {
+    int64_t q = a / b;
+    return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+}
+
+/**
+ * @brief Parse an ISO-like date/time string into nanoseconds since the Unix epoch (UTC)
+ *
+ * Accepted formats:
+ * - YYYY-MM-DD
+ * - YYYY-MM-DD HH:MM[:SS[.fffffffff]]
+ * - YYYY-MM-DDTHH:MM[:SS[.fffffffff]][Z]
+ *
+ * '/' is also accepted as the date separator. Days past the end of the
+ * month (e.g. "2023-02-30") and dates outside the int64 nanosecond range
+ * (1677-09-21 to 2262-04-11) are rejected.
+ *
+ * @param str Input date string
+ * @param out_ns Output timestamp in nanoseconds
+ * @return true if parsing succeeded, false otherwise (out_ns untouched)
+ */
+bool parse_datetime(const std::string& str, int64_t& out_ns);
+
+/**
+ * @brief Parse a date string, returning kInvalidTimestamp on failure
+ */
+int64_t to_timestamp(const std::string& str);
+
+/**
+ * @brief Format nanoseconds since epoch as a date string
+ *
+ * Produces "YYYY-MM-DD" for timestamps at midnight, otherwise
+ * "YYYY-MM-DD HH:MM:SS" with a fractional part only when non-zero.
+ * kInvalidTimestamp formats as an empty string.
+ */
+std::string format_datetime(int64_t ns);
+
+/**
+ * @brief Parse a duration such as "30s", "5m", "1h" or "1d" into nanoseconds
+ *
+ * A bare number is taken as seconds. Units: ms, s, m, h, d, w.
+ *
+ * @param str Duration string
+ * @param out_ns Output duration in nanoseconds (must be positive)
+ * @return true if parsing succeeded and the duration fits in int64_t nanoseconds
+ */
+bool parse_duration(const std::string& str, int64_t& out_ns);
+
+/**
+ * @brief Format a duration using the largest unit that divides it exactly
+ *
+ * Inverse of parse_duration(), e.g. 300e9 -> "5m", 86400e9 -> "1d".
+ */
+std::string format_duration(int64_t ns);
+
+/**
+ * @brief Parse a daily session such as "09:30-16:00"
+ *
+ * @param str Session string (HH:MM-HH:MM, close may be 24:00)
+ * @param open_ns Output session start as an offset from midnight
+ * @param close_ns Output session end (exclusive) as an offset from midnight
+ * @return true if parsing succeeded and open < close
+ */
+bool parse_session(const std::string& str, int64_t& open_ns, int64_t& close_ns);
+
+} // namespace tsproc
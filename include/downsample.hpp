@@ -0,0 +1,90 @@
+#pragma once
+
+#include "timeseries.hpp"
+#include <string>
+#include <vector>
+
+namespace tsproc {
+namespace downsample {
+
+/**
+ * @brief Largest-Triangle-Three-Buckets point selection
+ *
+ * Keeps the first and last points and, for each of the (threshold - 2)
+ * inner buckets, the point forming the largest triangle with the point
+ * chosen in the previous bucket and the average of the next bucket.
+ * NaN y-values are never selected unless a bucket is all NaN.
+ *
+ * All-NaN buckets are skipped: the bucket before one uses the average of
+ * the next bucket with data, and the anchor carries over it unchanged.
+ *
+ * Deviation from canonical LTTB: buckets are split into fixed ranges of
+ * about 64K input rows, processed in parallel. Each range after the first
+ * anchors its first bucket on the centroid of the preceding bucket instead
+ * of the (not yet known) selected point, so results can differ from the
+ * sequential algorithm at range boundaries. The ranges depend only on the
+ * input length and threshold, never on `threads`, so the output is the same
+ * on every machine; inputs under 64K rows get the classic LTTB.
+ *
+ * @param x X coordinates (e.g. timestamps or row numbers), ascending
+ * @param y Y values (same length as x)
+ * @param threshold Number of points to keep
+ * @param threads Parallel tasks (0 = scheduler concurrency); does not change the output
+ * @return Selected row indices in ascending order
+ */
+std::vector<size_t> lttb_indices(const std::vector<double>& x, const std::vector<double>& y,
+                                 size_t threshold, size_t threads = 0);
+
+/**
+ * @brief Min/max/first/last decimation (M4)
+ *
+ * Splits the series into equal-count buckets and keeps, per bucket, the
+ * first, last, minimum and maximum rows. Output has at most 4 * buckets
+ * rows and preserves every visible extreme of a line chart.
+ *
+ * @param y Values to decimate (NaN values are ignored for min/max)
+ * @param buckets Number of buckets
+ * @param threads Parallel tasks (0 = scheduler concurrency)
+ * @return Selected row indices in ascending order, without duplicates
+ */
+std::vector<size_t> minmax_indices(const std::vector<double>& y, size_t buckets, size_t threads = 0);
+
+/**
+ * @brief Downsample a TimeSeries with LTTB over the given column
+ *
+ * X coordinates are the parsed timestamps when every date parses,
+ * otherwise row numbers.
+ *
+ * @param ts Input series
+ * @param threshold Number of rows to keep
+ * @param col OHLCV column name or indicator name (default: "close")
+ * @param threads Parallel tasks (0 = scheduler concurrency)
+ * @return New series containing the selected rows (indicators included)
+ */
+TimeSeries lttb(const TimeSeries& ts, size_t threshold, const std::string& col = "close",
+                size_t threads = 0);
+
+/**
+ * @brief Downsample a TimeSeries with min/max/first/last decimation
+ *
+ * @param ts Input series
+ * @param buckets Number of buckets (output has at most 4 * buckets rows)
+ * @param col OHLCV column name or indicator name (default: "close")
+ * @param threads Parallel tasks (0 = scheduler concurrency)
+ * @return New series containing the selected rows (indicators included)
+ */
+TimeSeries minmax(const TimeSeries& ts, size_t buckets, const std::string& col = "close",
+                  size_t threads = 0);
+
+/**
+ * @brief Copy the given rows of a series into a new series
+ */
+TimeSeries select_rows(const TimeSeries& ts, const std::vector<size_t>& indices);
+
+/**
+ * @brief Extract an OHLCV or indicator column; missing indicators read as NaN
+ */
+std::vector<double> column_values(const TimeSeries& ts, const std::string& col);
+
+} // namespace downsample
+} // namespace tsproc
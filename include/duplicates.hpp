@@ -0,0 +1,78 @@
+#pragma once
+
+#include "timeseries.hpp"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace tsproc {
+
+/**
+ * @brief How rows sharing a timestamp are resolved at ingest
+ */
+enum class DuplicatePolicy {
+    KeepAll,    ///< No deduplication (default)
+    KeepFirst,  ///< Keep the first row seen for a timestamp
+    KeepLast,   ///< Later rows replace earlier ones (vendor corrections)
+    Aggregate   ///< Merge as one OHLCV bar: first open, max high, min low, last close, summed volume
+};
+
+/**
+ * @brief Parse "keep", "first", "last" or "aggregate"
+ *
+ * @throws std::invalid_argument for an unknown name
+ */
+DuplicatePolicy parse_duplicate_policy(const std::string& name);
+
+/**
+ * @brief Streaming duplicate-timestamp resolver feeding a TimeSeries
+ *
+ * While timestamps arrive in non-decreasing order only the last
+ * timestamp is tracked and a duplicate is merged into the last row
+ * (O(1) state). The first out-of-order row switches the resolver to a
+ * hash map from timestamp to output row, built once over the rows
+ * already written; from then on duplicates are found anywhere in the
+ * output, which keeps first-seen order. Rows with unparseable dates are
+ * never treated as duplicates.
+ */
+class DuplicateResolver {
+public:
+    /**
+     * @param out Series rows are appended to
+     * @param policy Resolution policy
+     */
+    DuplicateResolver(TimeSeries& out, DuplicatePolicy policy);
+
+    /**
+     * @brief Add a row whose timestamp is already known
+     */
+    void push(const Record& record, int64_t ts_ns);
+
+    /**
+     * @brief Add a row, parsing its date
+     */
+    void push(const Record& record);
+
+    /**
+     * @brief Rows merged into or dropped in favour of an earlier row
+     */
+    size_t duplicates() const { return duplicates_; }
+
+    /**
+     * @brief False once an out-of-order timestamp switched to the hash path
+     */
+    bool sorted() const { return sorted_; }
+
+private:
+    TimeSeries& out_;
+    DuplicatePolicy policy_;
+    int64_t last_ns_;
+    bool sorted_ = true;
+    size_t duplicates_ = 0;
+    std::unordered_map<int64_t, size_t> rows_by_ts_;
+
+    void merge(Record& kept, const Record& incoming) const;
+    void switch_to_hash();
+};
+
+} // namespace tsproc
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "timeseries.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tsproc {
+namespace gaps {
+
+constexpr int64_t kDayNs = 24LL * 3600LL * 1000000000LL;
+
+/**
+ * @brief Expected bar schedule
+ *
+ * Bars are expected every `frequency_ns`, aligned to the session open of
+ * each trading day. With the defaults (whole-day session, every day a
+ * trading day) the grid is aligned to the Unix epoch, like resample().
+ */
+struct Calendar {
+    int64_t frequency_ns = 0;           ///< Expected spacing between bars
+    int64_t session_open_ns = 0;        ///< Session start, offset from UTC midnight
+    int64_t session_close_ns = kDayNs;  ///< Session end (exclusive), offset from UTC midnight
+    bool weekdays_only = false;         ///< Skip Saturdays and Sundays
+    std::vector<int64_t> holidays;      ///< Non-trading days (any timestamp within the day)
+
+    /**
+     * @brief Whether the UTC day containing `day_index` * kDayNs is a trading day
+     */
+    bool is_trading_day(int64_t day_index) const;
+
+    /**
+     * @brief First expected bar strictly after grid slot `slot_ns`
+     */
+    int64_t next_slot(int64_t slot_ns) const;
+
+    /**
+     * @brief Grid slot containing timestamp `ns` (floored to the frequency)
+     */
+    int64_t slot_of(int64_t ns) const;
+};
+
+/**
+ * @brief A run of expected bars missing between two observed rows
+ */
+struct Gap {
+    size_t prev_row;     ///< Index of the last valid row before the gap
+    size_t row;          ///< Index of the first row after the gap
+    int64_t prev_ns;     ///< Timestamp of prev_row
+    int64_t start_ns;    ///< First missing slot
+    int64_t end_ns;      ///< Timestamp of the row after the gap
+    size_t missing;      ///< Number of missing slots
+};
+
+enum class FillMethod {
+    ForwardFill,  ///< Flat bar at the previous close, zero volume
+    NaN,          ///< All values NaN
+    Linear        ///< Prices interpolated in time from the previous close to the next open, zero volume
+};
+
+/**
+ * @brief Parse "ffill", "nan" or "linear"
+ *
+ * @throws std::invalid_argument for an unknown name
+ */
+FillMethod parse_fill_method(const std::string& name);
+
+/**
+ * @brief Parse the timestamp column (kInvalidTimestamp for unparseable dates)
+ */
+std::vector<int64_t> timestamps(const TimeSeries& ts);
+
+/**
+ * @brief Most common positive spacing between consecutive timestamps
+ *
+ * @return 0 if fewer than two valid timestamps
+ */
+int64_t infer_frequency(const std::vector<int64_t>& ts_ns);
+
+/**
+ * @brief Find missing bars in a time-ordered timestamp column
+ *
+ * A first branch-free pass over slot differences flags candidate rows;
+ * only flagged rows are checked against the calendar, counting missing
+ * slots a day at a time. Rows with invalid timestamps, duplicates and
+ * out-of-order rows never form gaps.
+ *
+ * @param ts_ns Timestamps in ascending order
+ * @param calendar Expected schedule (frequency_ns must be > 0)
+ * @return Gaps in row order
+ * @throws std::invalid_argument if calendar.frequency_ns <= 0
+ */
+std::vector<Gap> detect(const std::vector<int64_t>& ts_ns, const Calendar& calendar);
+
+/**
+ * @brief Detect gaps in a TimeSeries
+ */
+std::vector<Gap> detect(const TimeSeries& ts, const Calendar& calendar);
+
+/**
+ * @brief Total number of missing slots across gaps
+ */
+size_t total_missing(const std::vector<Gap>& gaps);
+
+/**
+ * @brief Materialize the missing rows
+ *
+ * Builds the output in a single pass, sized up front from the gap list;
+ * dates are not re-parsed.
+ * Filled rows carry no indicators and signal 0.
+ *
+ * @param ts Input series (the one passed to detect())
+ * @param gaps Result of detect() for this series and calendar
+ * @param calendar Schedule used for detection
+ * @param method How filled values are produced
+ * @return Series with one row per expected slot in the observed span
+ */
+TimeSeries fill(const TimeSeries& ts, const std::vector<Gap>& gaps, const Calendar& calendar,
+                FillMethod method);
+
+/**
+ * @brief Write gaps as CSV (row,start,end,missing)
+ *
+ * @return true if the file was written
+ */
+bool write_report(const std::string& path, const std::vector<Gap>& gaps);
+
+} // namespace gaps
+} // namespace tsproc
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace tsproc {
+
+/**
+ * @brief Summary of per-event processing latency in nanoseconds
+ */
+struct LatencyStats {
+    size_t count = 0;
+    double min_ns = 0.0;
+    double mean_ns = 0.0;
+    double p50_ns = 0.0;
+    double p90_ns = 0.0;
+    double p99_ns = 0.0;
+    double p999_ns = 0.0;
+    double p9999_ns = 0.0;
+    double max_ns = 0.0;
+};
+
+/**
+ * @brief HDR-style log-linear latency histogram
+ *
+ * Values below 2^kSubBucketBits nanoseconds get one bucket each; above
+ * that every power-of-two range is split into 2^(kSubBucketBits - 1)
+ * buckets, so a reported percentile is within 1/128 (< 0.8%) of the true
+ * value across the whole int64 range. Buckets live inline in the object,
+ * so record() never allocates. It only does relaxed atomic increments,
+ * which makes it safe to call from several threads while another thread
+ * reads stats().
+ *
+ * Percentiles report the upper bound of the bucket holding the requested
+ * rank, clamped to the recorded maximum.
+ */
+class LatencyHistogram {
+public:
+    static constexpr int kSubBucketBits = 8;
+    static constexpr size_t kSubBuckets = size_t(1) << kSubBucketBits;
+    static constexpr size_t kHalfSubBuckets = kSubBuckets / 2;
+    static constexpr size_t kBucketCount = kSubBuckets + (64 - kSubBucketBits) * kHalfSubBuckets;
+
+    LatencyHistogram();
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    /**
+     * @brief Record one latency (negative values count as 0)
+     */
+    void record(int64_t ns) {
+        const uint64_t v = ns > 0 ? static_cast<uint64_t>(ns) : 0;
+        counts_[bucket_index(v)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(v, std::memory_order_relaxed);
+        update_min(v);
+        update_max(v);
+    }
+
+    /**
+     * @brief Add another histogram's counts into this one
+     */
+    void merge(const LatencyHistogram& other);
+
+    void reset();
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Value at quantile q in [0, 1] (0 when empty)
+     */
+    double percentile(double q) const;
+
+    /**
+     * @brief Count, min/mean/max and the p50..p99.99 percentiles
+     */
+    LatencyStats stats() const;
+
+    /// Bucket holding value v
+    static size_t bucket_index(uint64_t v) {
+        if (v < kSubBuckets) return static_cast<size_t>(v);
+        const int msb = 63 - __builtin_clzll(v);
+        const int shift = msb - kSubBucketBits + 1;
+        return kSubBuckets + static_cast<size_t>(shift - 1) * kHalfSubBuckets +
+               static_cast<size_t>((v >> shift) - kHalfSubBuckets);
+    }
+
+    /// Largest value that maps to bucket `index`
+    static uint64_t bucket_upper(size_t index);
+
+private:
+    void update_min(uint64_t v) {
+        uint64_t cur = min_.load(std::memory_order_relaxed);
+        while (v < cur && !min_.compare_exchange_weak(cur, v, std::memory_order_relaxed)) {
+        }
+    }
+
+    void update_max(uint64_t v) {
+        uint64_t cur = max_.load(std::memory_order_relaxed);
+        while (v > cur && !max_.compare_exchange_weak(cur, v, std::memory_order_relaxed)) {
+        }
+    }
+
+    std::array<std::atomic<uint64_t>, kBucketCount> counts_;
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> min_;
+    std::atomic<uint64_t> max_{0};
+};
+
+/**
+ * @brief Write named latency summaries as a JSON object
+ *
+ * Produces {"<name>": {"count": ..., "min_ns": ..., "p50_ns": ..., ...}, ...}
+ * in the given order.
+ */
+void write_latency_json(std::ostream& os,
+                        const std::vector<std::pair<std::string, LatencyStats>>& entries);
+
+} // namespace tsproc
@@ -32,6 +32,22 @@ void add_sma(TimeSeries& ts, size_t window, const std::string& col = "close");
  */
 void add_roll_mean_std(TimeSeries& ts, size_t window, const std::string& col = "close");
 
+/**
+ * @brief Compute rolling mean, standard deviation, skewness and kurtosis
+ * 
+ * Adds "ROLL_MEAN_{window}" and "ROLL_STD_{window}" (identical to
+ * add_roll_mean_std()) plus "ROLL_SKEW_{window}" and "ROLL_KURT_{window}"
+ * (excess kurtosis), all from one fused pass over the column. Records
+ * before window size, and windows with zero variance, have NaN skew and
+ * kurtosis.
+ * O(n) time complexity.
+ * 
+ * @param ts TimeSeries to process (modified in-place)
+ * @param window Window size
+ * @param col Column name to compute on (default: "close")
+ */
+void add_roll_moments(TimeSeries& ts, size_t window, const std::string& col = "close");
+
 /**
  * @brief Compute rolling z-score
  * 
@@ -83,10 +99,31 @@ void add_roll_sum(TimeSeries& ts, size_t window, const std::string& col = "volum
 void add_volatility(TimeSeries& ts, size_t window, const std::string& col = "close", 
                     double periods_per_year = 252.0);
 
+/**
+ * @brief Compute rolling OHLC range volatility estimators (annualized)
+ * 
+ * Adds "VOL_PARK_{window}" (Parkinson), "VOL_GK_{window}" (Garman-Klass),
+ * "VOL_RS_{window}" (Rogers-Satchell) and "VOL_YZ_{window}" (Yang-Zhang).
+ * All four come from one pass over the open, high, low and close columns
+ * (see kernels::range_volatility()). Using the intrabar range, they reach
+ * the accuracy of close-to-close volatility with several times fewer bars.
+ * Yang-Zhang also uses the previous close, so it starts one bar later and
+ * is NaN for window 1.
+ * 
+ * @param ts TimeSeries to process (modified in-place)
+ * @param window Window size
+ * @param periods_per_year Trading periods per year (default: 252 for daily)
+ */
+void add_range_volatility(TimeSeries& ts, size_t window, double periods_per_year = 252.0);
+
 /**
  * @brief Helper: Get column value from a record
  * 
- * Internal utility to extract numeric value from different columns
+ * Internal utility to extract numeric value from different columns.
+ * Names other than the OHLCV columns are looked up in Record::indicators,
+ * so derived series (e.g. book features) can be used as inputs.
+ *
+ * @throws std::invalid_argument if the column is unknown
  */
 double get_column_value(const Record& r, const std::string& col);
 
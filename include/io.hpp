@@ -1,6 +1,9 @@
 #pragma once
 
+#include "bar.hpp"
 #include "timeseries.hpp"
+#include <cstdint>
+#include <ostream>
 #include <string>
 #include <vector>
 
@@ -53,13 +56,21 @@ private:
      * @brief Escape CSV field if needed (contains comma, quote, or newline)
      */
     std::string escape_csv_field(const std::string& field) const;
+
+    /**
+     * @brief Format one data row (OHLCV, signal, then `indicators` in order)
+     */
+    void write_row(std::ostream& out, const Record& r, const std::vector<std::string>& indicators) const;
 };
 
 /**
  * @brief Binary writer for compact storage
  * 
  * Writes time-series data in a simple binary format for faster I/O.
- * Format: [header: num_rows, num_cols] [col_names] [data_matrix]
+ * Format: [header: num_rows, num_cols] [data_matrix]
+ *
+ * Each row is num_cols 8-byte fields: timestamp (int64 nanoseconds since
+ * epoch), open, high, low, close, adj_close, volume, signal (doubles).
  */
 class BinaryWriter {
 public:
@@ -79,12 +90,38 @@ public:
      */
     bool write(const TimeSeries& ts, bool include_indicators = true);
 
+    /**
+     * @brief Write bars to binary file (signal column 0)
+     * 
+     * Each bar is copied into its row as is, with no date parsing.
+     * 
+     * @param bars Bars to write
+     * @return true if write succeeded, false otherwise
+     */
+    bool write(const std::vector<Bar>& bars);
+
+    /**
+     * @brief Append rows to an existing binary file (creates it if missing)
+     * 
+     * Rows are written in place after the existing data and the header row
+     * count is updated, so existing rows are never rewritten.
+     * 
+     * @param ts Rows to append
+     * @param replace_last If true, the first appended row overwrites the
+     *                     current last row (used to extend a partial bar)
+     * @return true if append succeeded, false otherwise
+     */
+    bool append(const TimeSeries& ts, bool replace_last = false);
+
 private:
     std::string out_path_;
 };
 
 /**
  * @brief Binary reader for loading binary time-series files
+ *
+ * Also accepts legacy 7-column files without a timestamp column
+ * (dates are left empty).
  */
 class BinaryReader {
 public:
@@ -102,8 +139,63 @@ public:
      */
     TimeSeries read();
 
+    /**
+     * @brief Read a contiguous block of rows without loading the whole file
+     * 
+     * @param start Index of the first row
+     * @param count Maximum number of rows to read
+     * @return TimeSeries with the rows in [start, start + count)
+     */
+    TimeSeries read_rows(size_t start, size_t count);
+
+    /**
+     * @brief Read the rows whose timestamp falls in [from_ns, to_ns)
+     * 
+     * Binary-searches the timestamp column with O(log n) seeks and then
+     * reads only the matching block. Rows must be stored in time order.
+     * 
+     * @param from_ns Inclusive lower bound (nanoseconds since epoch)
+     * @param to_ns Exclusive upper bound (nanoseconds since epoch)
+     * @return TimeSeries with the rows in range
+     */
+    TimeSeries read_range(int64_t from_ns, int64_t to_ns);
+
+    /**
+     * @brief Read a contiguous block of rows as bars
+     * 
+     * Rows are copied straight into the bars, with no date formatting; the
+     * signal column is dropped. Legacy files give kInvalidTimestamp.
+     * 
+     * @param start Index of the first row
+     * @param count Maximum number of rows to read
+     * @return Bars for the rows in [start, start + count)
+     */
+    std::vector<Bar> read_bars(size_t start = 0, size_t count = SIZE_MAX);
+
+    /**
+     * @brief Bars whose timestamp falls in [from_ns, to_ns), as read_range()
+     */
+    std::vector<Bar> read_bars_range(int64_t from_ns, int64_t to_ns);
+
+    /**
+     * @brief Number of rows stored, read from the header only
+     */
+    size_t row_count() const;
+
 private:
+    /**
+     * @brief Binary-search the rows in [from_ns, to_ns) into [first, last)
+     * 
+     * @return false (after printing why) if the file cannot be searched
+     */
+    bool find_range(int64_t from_ns, int64_t to_ns, uint64_t& first, uint64_t& last);
+
     std::string path_;
 };
 
+/**
+ * @brief True if the path names a binary time-series file (".bin" suffix)
+ */
+bool is_binary_path(const std::string& path);
+
 } // namespace tsproc
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace tsproc {
+namespace kernels {
+
+/**
+ * @brief Column kernels behind the indicators:: functions
+ *
+ * Kernels read a contiguous input column and write caller-provided output
+ * buffers of the same length; they never allocate. Values before the first
+ * full window are NaN. Arithmetic follows the same add-then-evict order as
+ * the original deque implementations, so results are bit-identical.
+ *
+ * On x86-64 each kernel is compiled for several instruction sets and the
+ * best one the CPU supports is picked at startup, so one portable binary
+ * runs everywhere. Variants are built without FMA contraction, so every
+ * ISA produces the same bits.
+ */
+
+/**
+ * @brief Instruction set a kernel variant was compiled for
+ */
+enum class Isa {
+    Generic,  ///< Baseline target flags (SSE2 on x86-64)
+    SSE42,
+    AVX2,
+    AVX512
+};
+
+/**
+ * @brief Short name ("generic", "sse4.2", "avx2", "avx512")
+ */
+const char* isa_name(Isa isa);
+
+/**
+ * @brief Parse an ISA name as accepted by the TSPROC_ISA environment variable
+ *
+ * @return true if the name was recognized
+ */
+bool parse_isa(const char* name, Isa& isa);
+
+/**
+ * @brief Variants that are compiled in and supported by this CPU, best last
+ */
+std::vector<Isa> supported_isas();
+
+/**
+ * @brief Variant the kernels currently dispatch to
+ *
+ * Chosen on first use as the best supported ISA, or the one named in the
+ * TSPROC_ISA environment variable (capped at what the CPU supports).
+ */
+Isa active_isa();
+
+/**
+ * @brief Switch every kernel to another variant (for tests and benchmarks)
+ *
+ * @return false (and nothing changes) if the variant is not supported here
+ */
+bool set_isa(Isa isa);
+
+/**
+ * @brief Sum over the trailing `window` values
+ */
+void rolling_sum(const double* in, size_t n, size_t window, double* out);
+
+/**
+ * @brief Mean over the trailing `window` values
+ */
+void rolling_mean(const double* in, size_t n, size_t window, double* out);
+
+/**
+ * @brief Rolling mean and population standard deviation (sum of squares form)
+ */
+void rolling_mean_std(const double* in, size_t n, size_t window, double* mean, double* sd);
+
+/**
+ * @brief Rolling mean, standard deviation, skewness and excess kurtosis in one pass
+ *
+ * Mean and sd are bit-identical to rolling_mean_std(). Skewness is
+ * m3 / m2^1.5 and excess kurtosis m4 / m2^2 - 3, from population central
+ * moments. Both are NaN in the warm-up rows and for windows with no
+ * variance. Third and fourth power sums are kept about a shift that is
+ * moved to the window mean every `window` rows, so updates stay O(1)
+ * amortized without the cancellation raw price powers would suffer.
+ */
+void rolling_moments(const double* in, size_t n, size_t window, double* mean, double* sd,
+                     double* skew, double* kurt);
+
+/**
+ * @brief Exponential moving average, alpha = 2 / (window + 1), seeded with in[0]
+ */
+void ema(const double* in, size_t n, size_t window, double* out);
+
+/**
+ * @brief Quote-derived features in one pass over four quote columns
+ *
+ * - mid = (bid + ask) / 2
+ * - spread = ask - bid
+ * - microprice = (bid * ask_size + ask * bid_size) / (bid_size + ask_size),
+ *   the mid when both sizes are zero
+ * - imbalance = (bid_size - ask_size) / (bid_size + ask_size), in [-1, 1],
+ *   0 when both sizes are zero
+ *
+ * Element-wise, so every variant vectorizes it at full register width.
+ */
+void quote_features(const double* bid, const double* ask, const double* bid_size,
+                    const double* ask_size, size_t n, double* mid, double* spread,
+                    double* microprice, double* imbalance);
+
+/**
+ * @brief Rolling OHLC range volatilities (per bar, not annualized) in one pass
+ *
+ * Over the trailing `window` bars:
+ * - parkinson: high-low range, sqrt(mean(ln(H/L)^2) / (4 ln 2))
+ * - garman_klass: sqrt(mean(0.5 ln(H/L)^2 - (2 ln 2 - 1) ln(C/O)^2))
+ * - rogers_satchell: sqrt(mean(ln(H/C) ln(H/O) + ln(L/C) ln(L/O))), unbiased
+ *   under drift
+ * - yang_zhang: overnight (open vs previous close) and open-to-close sample
+ *   variances combined with Rogers-Satchell, k = 0.34 / (1.34 + (w+1)/(w-1));
+ *   starts one bar later than the others and needs window >= 2
+ *
+ * Prices must be positive. The loop-carried sums are serial; the evicted
+ * bar's log terms are recomputed rather than buffered.
+ */
+void range_volatility(const double* open, const double* high, const double* low,
+                      const double* close, size_t n, size_t window, double* parkinson,
+                      double* garman_klass, double* rogers_satchell, double* yang_zhang);
+
+} // namespace kernels
+} // namespace tsproc
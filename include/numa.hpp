@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace tsproc {
+namespace numa {
+
+/**
+ * @brief Parse a Linux cpulist ("0-3,8,10-11") into sorted CPU ids
+ *
+ * @throws std::invalid_argument on malformed input
+ */
+std::vector<int> parse_cpulist(const std::string& text);
+
+/**
+ * @brief NUMA nodes and the CPUs this process may run on in each
+ *
+ * Nodes are numbered densely from 0 in the order the kernel lists them,
+ * and only nodes with at least one allowed CPU are kept. Without NUMA
+ * information (non-Linux, containers hiding /sys) the topology is a single
+ * node holding every allowed CPU, so callers never special-case it.
+ */
+class Topology {
+public:
+    /**
+     * @brief Build from explicit per-node CPU lists (tests, simulations)
+     */
+    explicit Topology(std::vector<std::vector<int>> node_cpus);
+
+    /**
+     * @brief Read /sys/devices/system/node and the affinity mask
+     */
+    static Topology detect();
+
+    /**
+     * @brief Process-wide topology, detected once
+     */
+    static const Topology& system();
+
+    size_t node_count() const { return nodes_.size(); }
+    const std::vector<int>& cpus(size_t node) const { return nodes_[node]; }
+    size_t cpu_count() const;
+
+    /**
+     * @brief Node holding `cpu`, or -1 if the CPU is not in the topology
+     */
+    int node_of_cpu(int cpu) const;
+
+    /**
+     * @brief Node of the CPU the calling thread is running on (0 if unknown)
+     */
+    size_t current_node() const;
+
+private:
+    std::vector<std::vector<int>> nodes_;
+    std::vector<int> cpu_node_;  // indexed by CPU id, -1 for CPUs outside the topology
+};
+
+/**
+ * @brief Node that owns element `index` when [0, count) is split evenly over `nodes`
+ *
+ * Loaders and compute passes use the same mapping, so the thread that
+ * first touches a range of a column runs on the node that later computes
+ * on it.
+ */
+inline size_t node_for(size_t index, size_t count, size_t nodes) {
+    if (nodes <= 1 || count == 0) return 0;
+    const size_t per_node = (count + nodes - 1) / nodes;
+    return index / per_node;
+}
+
+/**
+ * @brief Restrict a thread to a set of CPUs (no-op returning false off Linux)
+ */
+bool bind_thread(std::thread& thread, const std::vector<int>& cpus);
+
+} // namespace numa
+} // namespace tsproc
@@ -0,0 +1,238 @@
+#pragma once
+
+#include "ticks.hpp"
+#include "timeseries.hpp"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tsproc {
+namespace book {
+
+using ticks::Side;
+
+/**
+ * @brief Kind of order event
+ *
+ * Events with an order id (L3) act on that order; events without one
+ * (order_id == kNoOrder, L2) act on the price level directly.
+ */
+enum class EventType : uint8_t {
+    Add,      ///< New resting order (L3), or size added to a level (L2)
+    Modify,   ///< New remaining size, and price if it moved (L3); new total size of a level (L2)
+    Cancel,   ///< Remove an order, or `size` of it when size > 0 (L3); remove size from a level (L2)
+    Execute,  ///< Fill of `size` against an order or level; counted as traded volume
+    Clear     ///< Empty the book (session start, snapshot refresh)
+};
+
+/**
+ * @brief Parse an event type: A/ADD/NEW, M/MODIFY/UPDATE/REPLACE, C/D/CANCEL/DELETE,
+ * E/X/T/EXECUTE/FILL/TRADE or R/CLEAR/RESET (case-insensitive)
+ *
+ * @return false if the name is not recognized
+ */
+bool parse_event_type(std::string_view s, EventType& type);
+
+/// Order id of level-based (L2) events
+constexpr uint64_t kNoOrder = 0;
+
+/**
+ * @brief One order event with a nanosecond timestamp
+ */
+struct OrderEvent {
+    int64_t ts = 0;                ///< Nanoseconds since epoch
+    uint64_t order_id = kNoOrder;
+    double price = 0.0;
+    double size = 0.0;
+    EventType type = EventType::Add;
+    Side side = Side::Unknown;
+};
+
+/**
+ * @brief Aggregate of one price level
+ */
+struct PriceLevel {
+    double price = 0.0;
+    double size = 0.0;
+    uint32_t orders = 0;           ///< Resting orders (0 for L2 levels)
+};
+
+/**
+ * @brief Limit order book rebuilt from order events
+ *
+ * Each side is a flat array of level sizes and order counts indexed by
+ * price in ticks from a base price, rather than a tree keyed by price.
+ * Updates are an index computation and a store, and the best price moves
+ * by scanning neighbouring slots, which sit in the same cache lines. The
+ * array starts as a window around the first price seen. It grows (and
+ * re-bases) when a price falls outside, up to `max_levels` slots per side;
+ * events beyond that are rejected.
+ *
+ * Live orders are kept in an open-addressing table keyed by order id
+ * (linear probing, no per-order allocation).
+ */
+class OrderBook {
+public:
+    static constexpr size_t kDefaultMaxLevels = 1 << 20;
+
+    /**
+     * @param tick_size Price increment; prices are rounded to a multiple of it
+     * @param max_levels Largest price span, in ticks, each side may cover
+     */
+    explicit OrderBook(double tick_size = 0.01, size_t max_levels = kDefaultMaxLevels);
+
+    /**
+     * @brief Apply one event
+     *
+     * @return false if the event was rejected: unknown or duplicate order
+     *         id, unknown side, or a price outside the level range
+     */
+    bool apply(const OrderEvent& e);
+
+    void clear();
+
+    /**
+     * @brief Best bid / ask price, NaN when that side is empty
+     */
+    double best_bid() const;
+    double best_ask() const;
+
+    /**
+     * @brief Size and order count at the best level of a side (0 when empty)
+     */
+    double best_size(Side side) const;
+    uint32_t best_orders(Side side) const;
+
+    /**
+     * @brief Up to `depth` non-empty levels of a side, best first
+     *
+     * @return Number of levels written to `out` (which is resized to fit)
+     */
+    size_t levels(Side side, size_t depth, std::vector<PriceLevel>& out) const;
+
+    /**
+     * @brief Total size over the best `depth` non-empty levels of a side
+     */
+    double depth(Side side, size_t depth) const;
+
+    size_t order_count() const { return orders_.count; }
+    double traded_volume() const { return traded_; }
+    uint64_t events() const { return events_; }
+    uint64_t rejected() const { return rejected_; }
+    double tick_size() const { return tick_size_; }
+
+private:
+    static constexpr int64_t kNone = INT64_MIN;
+
+    // One side: slot i holds the level at price tick base + i
+    struct Ladder {
+        bool bids = true;
+        int64_t base = 0;
+        std::vector<double> qty;
+        std::vector<uint32_t> orders;
+        int64_t best = kNone;
+        size_t occupied = 0;
+
+        bool covers(int64_t tick) const {
+            return tick >= base && tick < base + static_cast<int64_t>(qty.size());
+        }
+        bool better(int64_t a, int64_t b) const { return bids ? a > b : a < b; }
+        bool reserve(int64_t tick, size_t max_levels);
+        void add(int64_t tick, double size, int64_t order_delta);
+        void set(int64_t tick, double size);
+        void clear();
+        void settle(size_t i, bool was_empty);
+    };
+
+    // Live L3 orders: open addressing with linear probing
+    struct OrderTable {
+        struct Slot {
+            uint64_t id = kNoOrder;   // kNoOrder marks a free slot
+            int64_t tick = 0;
+            double size = 0.0;
+            Side side = Side::Unknown;
+        };
+        std::vector<Slot> slots;
+        size_t count = 0;
+
+        Slot* find(uint64_t id);
+        Slot* insert(uint64_t id);    // nullptr if the id is already present
+        void erase(Slot* slot);
+        void clear();
+    };
+
+    double tick_size_;
+    size_t max_levels_;
+    Ladder bids_;
+    Ladder asks_;
+    OrderTable orders_;
+    double traded_ = 0.0;
+    uint64_t events_ = 0;
+    uint64_t rejected_ = 0;
+
+    Ladder& ladder(Side side) { return side == Side::Buy ? bids_ : asks_; }
+    const Ladder& ladder(Side side) const { return side == Side::Buy ? bids_ : asks_; }
+    int64_t to_tick(double price) const;
+    double to_price(int64_t tick) const { return static_cast<double>(tick) * tick_size_; }
+    bool apply_order(const OrderEvent& e);
+    bool apply_level(const OrderEvent& e);
+};
+
+/**
+ * @brief Parse order events from CSV text with a header row
+ *
+ * Columns are found by header name (case-insensitive, any order): a
+ * timestamp (ts, timestamp, time, datetime or date), type (type, action
+ * or event), side, price (price or px), size (size, qty or quantity) and
+ * an optional order id (order_id, id or order; absent means L2 events).
+ * Timestamps follow ticks::parse_trades(). Rows that do not parse are
+ * skipped; Clear rows need only a timestamp and type. Large inputs are
+ * parsed in parallel chunks and concatenated in file order.
+ *
+ * @return false if a required column is missing
+ */
+bool parse_order_events(const char* data, size_t size, std::vector<OrderEvent>& out,
+                        size_t threads = 0, char delimiter = ',');
+
+/**
+ * @brief Read an order-event CSV file through a memory map
+ */
+bool read_order_events(const std::string& path, std::vector<OrderEvent>& out,
+                       size_t threads = 0, char delimiter = ',');
+
+/**
+ * @brief Replay events into `book`, calling `sample` at consistent points
+ *
+ * With interval_ns > 0, `sample` runs once per interval that saw events,
+ * after its last event, with the interval's start time. With interval_ns
+ * == 0 it runs after the last event of every distinct timestamp.
+ */
+void replay(const std::vector<OrderEvent>& events, OrderBook& book, int64_t interval_ns,
+            const std::function<void(int64_t ts, const OrderBook& book)>& sample);
+
+/**
+ * @brief Options for book_features()
+ */
+struct FeatureOptions {
+    int64_t interval_ns = 1'000'000'000;   ///< Sample period (0 = every timestamp)
+    size_t depth = 5;                      ///< Levels summed for the depth features
+};
+
+/**
+ * @brief Replay events and sample book features as a time series
+ *
+ * One Record per sample at which both sides are quoted. OHLC is the mid
+ * price over the interval, close the mid at the sample, and volume the
+ * size executed in the interval. Record::indicators holds "spread",
+ * "microprice", "bid_size" / "ask_size" and "bid_orders" / "ask_orders"
+ * (queue at the touch), "bid_depth" / "ask_depth" (best `depth` levels)
+ * and "depth_imbalance" ((bid - ask) / (bid + ask) over those levels). The
+ * indicator and signal functions take any of these names as their column.
+ */
+TimeSeries book_features(const std::vector<OrderEvent>& events, OrderBook& book,
+                         const FeatureOptions& options = FeatureOptions());
+
+} // namespace book
+} // namespace tsproc
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace tsproc {
+namespace pages {
+
+/**
+ * @brief How large buffers and mapped files use huge pages
+ */
+enum class HugePages {
+    Off,          ///< Normal pages everywhere
+    Transparent,  ///< madvise(MADV_HUGEPAGE): the kernel backs 2 MiB ranges when it can
+    Explicit      ///< MAP_HUGETLB from the reserved pool, falling back to Transparent
+};
+
+const char* huge_pages_name(HugePages mode);
+
+/**
+ * @brief Parse "off", "thp" or "hugetlb"
+ *
+ * @throws std::invalid_argument for any other name
+ */
+HugePages parse_huge_pages(const std::string& name);
+
+/**
+ * @brief Current mode: set_huge_pages(), else TSPROC_HUGE_PAGES, else Transparent
+ */
+HugePages huge_pages();
+void set_huge_pages(HugePages mode);
+
+constexpr size_t kPageSize = 4096;
+constexpr size_t kHugePageSize = size_t(2) << 20;
+
+/// Buffers below this size stay on the heap; a huge page would be mostly empty
+constexpr size_t kHugeThreshold = 2 * kHugePageSize;
+
+/**
+ * @brief Where a Block's memory came from
+ */
+enum class Backing { Heap, Transparent, Explicit };
+
+/**
+ * @brief Page-aligned memory from allocate(), released with release()
+ */
+struct Block {
+    void* data = nullptr;
+    size_t bytes = 0;   ///< Requested size
+    size_t mapped = 0;  ///< Bytes mapped (huge-page multiple) for mmap backings
+    Backing backing = Backing::Heap;
+};
+
+/**
+ * @brief Allocate at least `bytes`, aligned to kPageSize, without touching it
+ *
+ * Blocks of kHugeThreshold or more use huge pages according to
+ * huge_pages(); everything else, and every block off Linux, comes from the
+ * heap. Mapped blocks are aligned to kHugePageSize. Throws std::bad_alloc
+ * when no backing can provide the memory.
+ */
+Block allocate(size_t bytes);
+void release(Block& block);
+
+/**
+ * @brief Read-only mapping of a whole file
+ *
+ * Large mappings are advised MADV_HUGEPAGE unless huge pages are off; the
+ * kernel only honours that where file THP is supported, so huge() reports
+ * the request, not the backing. open() fails (returning false, without
+ * printing) on empty files and off Linux; callers fall back to streams.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool huge() const { return huge_; }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    bool huge_ = false;
+};
+
+/**
+ * @brief Allocation counters for --profile
+ */
+struct PageStats {
+    uint64_t heap_blocks = 0;
+    uint64_t heap_bytes = 0;
+    uint64_t transparent_blocks = 0;
+    uint64_t transparent_bytes = 0;
+    uint64_t explicit_blocks = 0;
+    uint64_t explicit_bytes = 0;
+    uint64_t explicit_fallbacks = 0;  ///< MAP_HUGETLB failures (pool empty or absent)
+    uint64_t mapped_files = 0;
+    uint64_t mapped_file_bytes = 0;
+    uint64_t huge_resident_bytes = 0;       ///< Huge-page-backed bytes resident now (Linux, else 0)
+    uint64_t huge_resident_peak_bytes = 0;  ///< Largest value seen, sampled at release while profiling
+};
+
+PageStats stats();
+void reset_stats();
+
+} // namespace pages
+} // namespace tsproc
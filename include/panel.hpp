@@ -0,0 +1,142 @@
+#pragma once
+
+#include "bar.hpp"
+#include "duplicates.hpp"
+#include "timeseries.hpp"
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace tsproc {
+
+/**
+ * @brief Dictionary encoding of symbol names to dense ids
+ *
+ * Ids are assigned 0, 1, 2, ... in order of first intern(). Lookups take a
+ * string_view into the caller's line buffer, so routing a row to its symbol
+ * allocates nothing once the symbol is known. Names live in a deque, which
+ * never relocates them, and the hash map keys view those stored names.
+ */
+class SymbolTable {
+public:
+    SymbolTable() = default;
+    SymbolTable(SymbolTable&&) = default;
+    SymbolTable& operator=(SymbolTable&&) = default;
+    SymbolTable(const SymbolTable&) = delete;
+    SymbolTable& operator=(const SymbolTable&) = delete;
+
+    /**
+     * @brief Id of `name`, adding it if it is new
+     */
+    uint32_t intern(std::string_view name);
+
+    /**
+     * @brief Look up an existing name
+     *
+     * @return true and sets `id` if the name is known
+     */
+    bool find(std::string_view name, uint32_t& id) const;
+
+    const std::string& name(uint32_t id) const { return names_[id]; }
+    size_t size() const { return names_.size(); }
+    bool empty() const { return names_.empty(); }
+
+private:
+    std::deque<std::string> names_;
+    std::unordered_map<std::string_view, uint32_t> ids_;
+};
+
+/**
+ * @brief Columnar OHLCV rows of one symbol, in file order
+ */
+struct SymbolColumns {
+    std::vector<int64_t> ts;
+    std::vector<double> open;
+    std::vector<double> high;
+    std::vector<double> low;
+    std::vector<double> close;
+    std::vector<double> adj_close;
+    std::vector<double> volume;
+
+    size_t size() const { return ts.size(); }
+    bool empty() const { return ts.empty(); }
+
+    void push(const Bar& b);
+    void reserve(size_t rows);
+
+    /**
+     * @brief Append `other`'s rows after this one's
+     */
+    void append(const SymbolColumns& other);
+
+    Bar bar(size_t i) const;
+    std::vector<Bar> to_bars() const;
+};
+
+/**
+ * @brief Multi-symbol dataset: a symbol table plus per-symbol columns
+ *
+ * Built from a long-format file (one Symbol column, all tickers
+ * interleaved) by CSVReader::read_panel(). Symbol ids follow the order in
+ * which symbols first appear in the file, and each symbol's rows keep
+ * their file order.
+ */
+class Panel {
+public:
+    Panel() = default;
+    Panel(Panel&&) = default;
+    Panel& operator=(Panel&&) = default;
+
+    /**
+     * @brief Id of `symbol`, creating empty columns for a new one
+     */
+    uint32_t add_symbol(std::string_view symbol);
+
+    void push(uint32_t id, const Bar& b) { columns_[id].push(b); }
+
+    const SymbolTable& symbols() const { return symbols_; }
+    size_t symbol_count() const { return columns_.size(); }
+
+    /**
+     * @brief Total rows over all symbols
+     */
+    size_t row_count() const;
+
+    const SymbolColumns& columns(uint32_t id) const { return columns_[id]; }
+
+    /**
+     * @brief Columns of `symbol`, nullptr if it never appeared
+     */
+    const SymbolColumns* find(std::string_view symbol) const;
+
+    /**
+     * @brief One symbol's rows as a Record series, for the indicator path
+     *
+     * @param id Symbol id
+     * @param policy How rows with repeated timestamps are resolved
+     * @param duplicates If set, receives the number of rows resolved
+     */
+    TimeSeries series(uint32_t id, DuplicatePolicy policy = DuplicatePolicy::KeepAll,
+                      size_t* duplicates = nullptr) const;
+
+    /**
+     * @brief Merge partial panels, such as one per parsed chunk, in order
+     *
+     * Each part has its own symbol table. Part ids are remapped onto one
+     * global table (interned in part order, so first appearance in the file
+     * still decides the id), then every symbol's columns are concatenated
+     * over the parts on the scheduler, one task per symbol. The first
+     * part's columns are moved rather than copied, and each part's columns
+     * are freed as soon as they are appended.
+     */
+    static Panel merge(std::vector<Panel>& parts);
+
+private:
+    SymbolTable symbols_;
+    std::vector<SymbolColumns> columns_;
+};
+
+} // namespace tsproc
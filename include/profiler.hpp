@@ -0,0 +1,230 @@
+#pragma once
+
+#include "histogram.hpp"
+#include "trace.hpp"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace tsproc {
+namespace profiling {
+
+/**
+ * @brief Hardware events counted around each profiled stage
+ */
+enum Event : size_t {
+    kCycles,
+    kInstructions,
+    kL1DMisses,     ///< L1 data cache read misses
+    kLLCMisses,     ///< Last-level cache misses
+    kBranchMisses,
+    kEventCount
+};
+
+/**
+ * @brief Short column name of an event ("cycles", "instructions", ...)
+ */
+const char* event_name(size_t event);
+
+/**
+ * @brief Event counts; events the host could not count are marked invalid
+ */
+struct CounterSample {
+    uint64_t values[kEventCount] = {};
+    bool valid[kEventCount] = {};
+
+    /// Per-event difference this - earlier (valid where both are)
+    CounterSample since(const CounterSample& earlier) const;
+    CounterSample& operator+=(const CounterSample& other);
+    bool any_valid() const;
+};
+
+/**
+ * @brief perf_event_open counters for the calling thread
+ *
+ * Each event is opened separately, user space only, so a host that lacks
+ * one event (LLC misses in many VMs) still reports the others. Counters run
+ * from construction; read() returns cumulative counts, scaled when the
+ * kernel multiplexed them. Construction never fails: when counters are not
+ * permitted (perf_event_paranoid, seccomp, non-Linux builds) available()
+ * is false and status() says why.
+ */
+class PerfCounters {
+public:
+    PerfCounters();
+    ~PerfCounters();
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool available() const;
+    const std::string& status() const { return status_; }
+
+    /**
+     * @brief Cumulative counts since construction
+     */
+    CounterSample read() const;
+
+private:
+    int fds_[kEventCount];
+    std::string status_;
+};
+
+/**
+ * @brief Accumulated cost of one profiled stage
+ */
+struct StageStats {
+    std::string path;     ///< Slash-separated nesting, e.g. "indicators/sma(20)"
+    size_t depth = 0;     ///< Nesting level (0 = top-level stage)
+    size_t calls = 0;
+    size_t rows = 0;      ///< Rows processed, summed over calls
+    double seconds = 0.0;
+    CounterSample counters;  ///< Calling thread plus pool tasks spawned under the stage
+};
+
+/// No stage open (see current_stage())
+constexpr size_t kNoStage = SIZE_MAX;
+
+/**
+ * @brief Stage that work on this thread is charged to
+ *
+ * The innermost open Scope, or while a pool task runs the stage it was
+ * spawned under; kNoStage when neither.
+ */
+size_t current_stage();
+
+/**
+ * @brief Process-wide collector behind --profile
+ *
+ * Disabled by default, in which case Scope costs one relaxed atomic load.
+ * Stages are listed in the order they were first entered.
+ */
+class Profiler {
+public:
+    static Profiler& instance();
+
+    /**
+     * @brief Start collecting; hardware counters are used when permitted
+     */
+    void enable(bool hardware_counters = true);
+    void disable() { enabled_.store(false, std::memory_order_relaxed); }
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+    bool counters_enabled() const { return counters_; }
+
+    /**
+     * @brief Why counters are off ("" when they are on)
+     */
+    const std::string& counter_status() const { return counter_status_; }
+
+    void reset();
+
+    /**
+     * @brief Snapshot of all stages, in first-entered order
+     */
+    std::vector<StageStats> stages() const;
+
+    /**
+     * @brief Print the stage table (time, rows, and per-row counters when available)
+     */
+    void report(std::ostream& os) const;
+
+    /**
+     * @brief Attach a latency summary (e.g. "replay/sma") printed after the stage table
+     *
+     * Re-adding a name replaces its summary.
+     */
+    void add_latency(const std::string& name, const LatencyStats& stats);
+
+    /**
+     * @brief Latency summaries in the order they were added
+     */
+    std::vector<std::pair<std::string, LatencyStats>> latencies() const;
+
+    /// Used by Scope: index of the stage at `path`, created on first use
+    size_t stage_index(const std::string& path, size_t depth);
+    /// Used by Scope: add one call's cost to a stage
+    void add(size_t index, size_t rows, double seconds, const CounterSample& counters);
+    /// Used by TaskScope: add counts from another thread to a stage and its parents
+    void add_counters(size_t index, const CounterSample& counters);
+
+private:
+    Profiler() = default;
+
+    std::atomic<bool> enabled_{false};
+    bool counters_ = false;
+    std::string counter_status_;
+    mutable std::mutex mutex_;
+    std::vector<StageStats> stages_;
+    std::vector<size_t> parents_;  // index of the enclosing stage, kNoStage at top level
+    std::vector<std::pair<std::string, LatencyStats>> latencies_;
+};
+
+/**
+ * @brief RAII stage measurement, nested scopes on a thread form a path
+ *
+ * Also emits a trace span ("stage", or "kernel" when a parameter is given)
+ * while tracing is enabled.
+ *
+ * @code
+ * profiling::Scope scope("sma", window, ts.size());   // "sma(20)"
+ * @endcode
+ */
+class Scope {
+public:
+    explicit Scope(const char* name, size_t rows = 0);
+    Scope(const char* name, size_t param, size_t rows);
+    ~Scope();
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+    /**
+     * @brief Set the row count once it is known (e.g. after loading)
+     */
+    void set_rows(size_t rows) {
+        rows_ = rows;
+        span_.set_rows(static_cast<int64_t>(rows));
+    }
+
+private:
+    void begin(std::string label, size_t rows);
+
+    bool active_ = false;
+    size_t index_ = 0;
+    size_t rows_ = 0;
+    size_t saved_path_length_ = 0;
+    size_t saved_stage_ = kNoStage;
+    int64_t start_ns_ = 0;
+    CounterSample start_counters_;
+    tracing::Span span_;
+};
+
+/**
+ * @brief Charges a pool task's hardware counts to the stage that spawned it
+ *
+ * Counters are per thread, so a Scope alone misses work its stage hands to
+ * pool workers. The scheduler records current_stage() and the spawning
+ * thread with each task and runs the task inside a TaskScope. On any other
+ * thread the task's counter deltas are added to that stage and the stages
+ * enclosing it (without adding a call); on the spawning thread its own
+ * Scope already counts them. Tasks spawned from inside are charged to the
+ * same stage.
+ */
+class TaskScope {
+public:
+    TaskScope(size_t stage, std::thread::id spawner);
+    ~TaskScope();
+    TaskScope(const TaskScope&) = delete;
+    TaskScope& operator=(const TaskScope&) = delete;
+
+private:
+    size_t stage_;
+    size_t saved_stage_ = kNoStage;
+    bool counting_ = false;
+    CounterSample start_counters_;
+};
+
+} // namespace profiling
+} // namespace tsproc
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "timeseries.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tsproc {
+
+/**
+ * @brief Aggregate bars into fixed-period OHLCV buckets
+ *
+ * Buckets are aligned to multiples of the period since the Unix epoch
+ * (so "1d" buckets start at UTC midnight). Each bucket takes the first
+ * open, the max high, the min low, the last close/adj_close and the
+ * summed volume. Rows whose date cannot be parsed are skipped.
+ *
+ * @param ts Input series, in time order
+ * @param period_ns Bucket width in nanoseconds
+ * @return Aggregated series dated at bucket start
+ */
+TimeSeries resample(const TimeSeries& ts, int64_t period_ns);
+
+/**
+ * @brief Multi-resolution OHLCV pyramid stored alongside a binary dataset
+ *
+ * For a base file "prices.bin", each level is a regular binary file
+ * "prices.bin.pyr-<period>" (e.g. "prices.bin.pyr-5m") and the list of
+ * levels is kept in the text manifest "prices.bin.pyr". Levels are built
+ * from the base data, extended incrementally on append (only the last,
+ * possibly partial, bucket of a level is ever rewritten), and queries read
+ * the coarsest level that evenly divides the requested resolution.
+ */
+class Pyramid {
+public:
+    /**
+     * @brief Open (or prepare to create) the pyramid for a base binary file
+     *
+     * @param base_path Path of the base binary dataset
+     */
+    explicit Pyramid(const std::string& base_path);
+
+    /**
+     * @brief Build all levels from the base series and write the manifest
+     *
+     * Also writes the base series to base_path.
+     *
+     * @param base Full-resolution series
+     * @param periods_ns Level periods in nanoseconds (any order)
+     * @return true if every file was written
+     */
+    bool build(const TimeSeries& base, std::vector<int64_t> periods_ns);
+
+    /**
+     * @brief Append new bars to the base file and update every level
+     *
+     * New bars must not be older than the last stored bar.
+     *
+     * @return true on success, false on I/O error or out-of-order input
+     */
+    bool append(const TimeSeries& rows);
+
+    /**
+     * @brief Build the given levels that are not stored yet from the base file
+     *
+     * @return true if every new level and the manifest were written
+     */
+    bool add_levels(std::vector<int64_t> periods_ns);
+
+    /**
+     * @brief Read bars at the requested resolution
+     *
+     * Uses the coarsest stored level whose period divides resolution_ns
+     * (falling back to the base data) and resamples from there if needed.
+     * from_ns is rounded down and to_ns up to multiples of resolution_ns,
+     * so every bucket overlapping [from_ns, to_ns) is returned whole, and
+     * only stored rows in the widened range are read, located by binary
+     * search.
+     */
+    TimeSeries query(int64_t resolution_ns, int64_t from_ns = INT64_MIN,
+                     int64_t to_ns = INT64_MAX) const;
+
+    /**
+     * @brief Period of the level query() would read (0 = base data)
+     */
+    int64_t select_level(int64_t resolution_ns) const;
+
+    /**
+     * @brief Stored level periods, ascending
+     */
+    const std::vector<int64_t>& levels() const { return levels_; }
+
+    /**
+     * @brief File path of the level with the given period
+     */
+    std::string level_path(int64_t period_ns) const;
+
+    /**
+     * @brief Path of the manifest file listing the levels
+     */
+    std::string manifest_path() const { return base_path_ + ".pyr"; }
+
+private:
+    std::string base_path_;
+    std::vector<int64_t> levels_;
+
+    bool write_manifest() const;
+};
+
+} // namespace tsproc
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "timeseries.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tsproc {
+namespace realized {
+
+/**
+ * @brief Grouping for realized measures and the intraday profile
+ */
+struct Options {
+    int64_t bucket_ns = 5LL * 60 * 1000000000;  ///< Time-of-day bucket width
+    int64_t day_offset_ns = 0;                  ///< Trading day start, offset from UTC midnight
+    std::string col = "close";                  ///< Price column returns are taken on
+};
+
+/**
+ * @brief Intraday seasonality of one time-of-day bucket, averaged over days
+ */
+struct SeasonalBucket {
+    int64_t offset_ns = 0;          ///< Bucket start, offset from the trading day start
+    size_t bars = 0;                ///< Bars that fell in the bucket
+    size_t returns = 0;             ///< Intraday returns that ended in the bucket
+    double mean_volume = 0.0;       ///< Average bar volume
+    double mean_sq_return = 0.0;    ///< Average squared log return
+    double volume_factor = 0.0;     ///< mean_volume relative to the average bucket
+    double volatility_factor = 0.0; ///< sqrt(mean_sq_return) relative to the average bucket
+};
+
+/**
+ * @brief Daily series and seasonal profile from one pass over intraday bars
+ */
+struct Result {
+    /**
+     * One Record per trading day, dated at the day start: OHLC and summed
+     * volume of the day's bars, plus indicators "RV" (realized variance,
+     * sum of squared intraday log returns), "BV" (bipower variation,
+     * pi/2 * sum |r_t| |r_t-1|), "JUMP" (max(RV - BV, 0)), "RVOL"
+     * (sqrt(RV)) and "RETURNS" (number of intraday returns).
+     */
+    TimeSeries daily;
+
+    /// Buckets that saw at least one bar, by time of day
+    std::vector<SeasonalBucket> profile;
+};
+
+/**
+ * @brief Realized variance, bipower variation and intraday seasonality
+ *
+ * Bars are grouped by trading day (UTC days shifted by day_offset_ns) and
+ * by bucket_ns buckets within the day. Returns are log returns of `col`
+ * between consecutive bars of the same day, so overnight gaps are left
+ * out. Dates are parsed in parallel, day boundaries are found in one scan
+ * of the timestamp column, and days are then processed in parallel, each
+ * chunk filling its own bucket accumulators, which are summed at the end.
+ * Rows with unparseable dates are skipped.
+ *
+ * @param ts Intraday bars in time order
+ * @throws std::invalid_argument if bucket_ns does not lie in (0, 1 day]
+ *         or `col` is unknown
+ */
+Result compute(const TimeSeries& ts, const Options& options = Options());
+
+/**
+ * @brief Write a seasonal profile as CSV
+ *        (offset,bars,returns,mean_volume,mean_sq_return,volume_factor,volatility_factor)
+ *
+ * @return true if the file was written
+ */
+bool write_profile(const std::string& path, const std::vector<SeasonalBucket>& profile);
+
+} // namespace realized
+} // namespace tsproc
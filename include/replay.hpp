@@ -0,0 +1,131 @@
+#pragma once
+
+#include "bar.hpp"
+#include "timeseries.hpp"
+#include "duplicates.hpp"
+#include "histogram.hpp"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace tsproc {
+
+/**
+ * @brief Pacing mode for historical replay
+ */
+enum class ReplaySpeed {
+    AsFastAsPossible,  ///< Emit events back-to-back, ignoring timestamps
+    RealTime,          ///< Emit events at their recorded inter-arrival times
+    Scaled             ///< Recorded inter-arrival times divided by a factor
+};
+
+/**
+ * @brief Options controlling a replay run
+ */
+struct ReplayOptions {
+    ReplaySpeed speed = ReplaySpeed::AsFastAsPossible;
+    double factor = 1.0;    ///< Speed-up factor for ReplaySpeed::Scaled (e.g. 10 = 10x faster)
+    bool drop_na = true;    ///< Passed through to the CSV reader
+    char delimiter = ',';   ///< Passed through to the CSV reader
+    DuplicatePolicy duplicates = DuplicatePolicy::KeepAll;  ///< Passed through to the CSV reader
+    int64_t from_ns = INT64_MIN;  ///< Only replay rows at or after this time
+    int64_t to_ns = INT64_MAX;    ///< Only replay rows before this time
+};
+
+/**
+ * @brief Historical replay source for driving the streaming path
+ *
+ * Loads a stored series (CSV, or the binary format when the path ends in
+ * ".bin") up front as compact Bars, then emits them one at a time to a
+ * callback, paced by their recorded timestamps. The time spent inside the
+ * callback (ingest to signal) is recorded per event into a
+ * LatencyHistogram, which gives a reproducible latency benchmark without a
+ * live feed. Binary inputs are read straight into Bars, with no dates
+ * formatted; Records are only built if series() or the Record overload of
+ * run() asks for them.
+ *
+ * Bars whose dates cannot be parsed are emitted immediately.
+ */
+class ReplaySource {
+public:
+    /**
+     * @brief Construct a replay source
+     *
+     * @param path Input file (CSV or .bin)
+     * @param options Pacing and reader options
+     */
+    explicit ReplaySource(const std::string& path, const ReplayOptions& options = ReplayOptions());
+
+    /**
+     * @brief Load the input file (called implicitly by run() if needed)
+     *
+     * @return Number of bars available for replay
+     */
+    size_t load();
+
+    /**
+     * @brief Replay all bars through the callback
+     *
+     * @param callback Function called for each bar, in file order
+     * @return Number of bars emitted
+     */
+    size_t run(const std::function<void(const Bar&)>& callback);
+
+    /**
+     * @brief Replay as Records (compatibility adapter; builds series() first)
+     */
+    size_t run(const std::function<void(const Record&)>& callback);
+
+    /**
+     * @brief Loaded bars, in replay order
+     */
+    const std::vector<Bar>& bars() const { return bars_; }
+
+    /**
+     * @brief Loaded rows as Records, built from the bars on first use for binary input
+     */
+    const TimeSeries& series();
+
+    /**
+     * @brief Per-event callback latencies from the last run, in nanoseconds
+     */
+    const LatencyHistogram& latency() const { return latency_; }
+
+    /**
+     * @brief Summary statistics of the last run's latencies
+     */
+    LatencyStats latency_stats() const;
+
+    /**
+     * @brief Wall-clock duration of the last run in seconds
+     */
+    double elapsed_seconds() const { return elapsed_s_; }
+
+private:
+    std::string path_;
+    ReplayOptions options_;
+    template <typename Emit>
+    size_t replay(Emit&& emit);
+
+    std::vector<Bar> bars_;
+    TimeSeries series_;          // CSV rows as read, or built lazily by series()
+    bool series_ready_ = false;
+    LatencyHistogram latency_;
+    double elapsed_s_ = 0.0;
+    bool loaded_ = false;
+};
+
+/**
+ * @brief Parse a replay speed specification
+ *
+ * Accepts "fast" (as fast as possible), "realtime", or a numeric factor
+ * with an optional trailing 'x' (e.g. "60" or "60x" = 60 times real time).
+ *
+ * @param text Speed specification
+ * @param options Output options (speed and factor are updated)
+ * @return true if the specification was valid
+ */
+bool parse_replay_speed(const std::string& text, ReplayOptions& options);
+
+} // namespace tsproc
@@ -0,0 +1,253 @@
+#pragma once
+
+#include "numa.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tsproc {
+namespace exec {
+
+/**
+ * @brief Options for a Scheduler
+ */
+struct SchedulerOptions {
+    size_t threads = 0;        ///< Threads including the caller (0 = hardware concurrency)
+    bool pin_threads = false;  ///< Pin each worker to one CPU (Linux only)
+    bool numa_aware = true;    ///< Keep workers on a NUMA node and honour task node affinity
+    const numa::Topology* topology = nullptr;  ///< nullptr = numa::Topology::system()
+};
+
+class TaskGroup;
+
+/**
+ * @brief Work-stealing thread pool behind all parallel work in the library
+ *
+ * A pool of `threads - 1` workers, each with its own task deque. Tasks
+ * spawned on a worker go to the back of that worker's deque and are taken
+ * LIFO. Idle workers steal from the front of other deques, or take tasks
+ * submitted by outside threads from a shared queue. The thread that waits
+ * on a TaskGroup runs queued tasks itself and blocks only when there are
+ * none. That makes nested parallelism (a parallel_for inside a task) safe:
+ * the thread count stays fixed and waits cannot deadlock.
+ *
+ * With threads = 1 there are no workers and every task runs inline on the
+ * spawning thread.
+ *
+ * On multi-node machines workers are spread over the NUMA nodes in
+ * proportion to their CPUs and kept on their node's CPUs. Tasks spawned
+ * with a node go to that node's queue, which its workers drain before
+ * stealing elsewhere. parallel_for gives each chunk the node that owns it
+ * under numa::node_for(), so a column first touched by one parallel pass
+ * is later computed on by threads of the same node.
+ */
+class Scheduler {
+public:
+    explicit Scheduler(const SchedulerOptions& options = SchedulerOptions());
+    ~Scheduler();
+
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+
+    /**
+     * @brief Process-wide scheduler used by the library
+     *
+     * Created on first use with TSPROC_THREADS threads if that environment
+     * variable is set, hardware concurrency otherwise.
+     */
+    static Scheduler& global();
+
+    /**
+     * @brief Replace the global scheduler (e.g. from --threads)
+     *
+     * Must not be called while work is running on the current one.
+     */
+    static void configure_global(const SchedulerOptions& options);
+
+    /// Threads that execute tasks: the workers plus the waiting caller
+    size_t concurrency() const { return workers_.size() + 1; }
+
+    bool pinned() const { return pinned_; }
+
+    /// NUMA nodes the workers are spread over (1 when not NUMA-aware)
+    size_t node_count() const { return node_queues_.size(); }
+
+    /// Node of worker `index` (0 .. concurrency() - 2)
+    size_t worker_node(size_t index) const { return worker_node_[index]; }
+
+    /// Node of the calling thread: its worker's node, or where it runs now
+    size_t current_node() const;
+
+    /**
+     * @brief Run one queued task on the calling thread
+     *
+     * @return false if no task was available
+     */
+    bool run_one();
+
+private:
+    friend class TaskGroup;
+
+    struct Task {
+        std::function<void()> fn;
+        TaskGroup* group = nullptr;
+        size_t stage = SIZE_MAX;   ///< Profiled stage of the spawner (profiling::TaskScope)
+        std::thread::id spawner;
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        std::thread thread;
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void submit(Task task, long node);
+    bool steal(Task& task, long self, size_t node, bool same_node);
+    bool take(Task& task);
+    void execute(Task& task);
+    void worker_loop(size_t index);
+
+    numa::Topology topology_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<size_t> worker_node_;
+    std::vector<std::unique_ptr<Queue>> node_queues_;
+    std::mutex injected_mutex_;
+    std::deque<Task> injected_;
+
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    std::atomic<size_t> queued_{0};
+    std::atomic<bool> stop_{false};
+    bool pinned_ = false;
+};
+
+/**
+ * @brief Set of tasks that can be waited on together
+ *
+ * wait() runs queued tasks while the group is unfinished, sleeps when
+ * there is nothing to run until the last task finishes or new work is
+ * queued, and rethrows the first exception any of its tasks threw. The
+ * destructor waits too (and drops exceptions), so a group never outlives
+ * the tasks that reference its stack frame.
+ */
+class TaskGroup {
+public:
+    explicit TaskGroup(Scheduler& scheduler = Scheduler::global());
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    /**
+     * @brief Queue a task, optionally with affinity to a NUMA node (-1 = none)
+     */
+    void spawn(std::function<void()> fn, long node = -1);
+    void wait();
+
+    Scheduler& scheduler() { return scheduler_; }
+
+private:
+    friend class Scheduler;
+
+    void finish(std::exception_ptr error);
+
+    Scheduler& scheduler_;
+    std::atomic<size_t> outstanding_{0};
+    std::mutex error_mutex_;
+    std::exception_ptr error_;
+};
+
+/**
+ * @brief Run fn(chunk_begin, chunk_end) over [begin, end) on the scheduler
+ *
+ * The range is cut into contiguous chunks of at least `grain` elements,
+ * capped at four chunks per thread so late chunks can be stolen to
+ * balance load. Ranges no longer than `grain` run inline on the caller.
+ */
+template <typename Fn>
+void parallel_for(size_t begin, size_t end, size_t grain, Fn&& fn,
+                  Scheduler& scheduler = Scheduler::global()) {
+    if (end <= begin) return;
+    const size_t n = end - begin;
+    grain = std::max<size_t>(grain, 1);
+    if (n <= grain || scheduler.concurrency() == 1) {
+        fn(begin, end);
+        return;
+    }
+
+    const size_t chunks = std::min((n + grain - 1) / grain, 4 * scheduler.concurrency());
+    const size_t chunk = (n + chunks - 1) / chunks;
+    const size_t nodes = scheduler.node_count();
+    TaskGroup group(scheduler);
+    if (nodes > 1) {
+        // Every chunk goes to the node owning it; the caller only helps
+        for (size_t b = begin; b < end; b += chunk) {
+            const size_t e = std::min(end, b + chunk);
+            group.spawn([&fn, b, e] { fn(b, e); }, static_cast<long>(numa::node_for(b - begin, n, nodes)));
+        }
+        group.wait();
+        return;
+    }
+    for (size_t b = begin + chunk; b < end; b += chunk) {
+        const size_t e = std::min(end, b + chunk);
+        group.spawn([&fn, b, e] { fn(b, e); });
+    }
+    fn(begin, std::min(end, begin + chunk));
+    group.wait();
+}
+
+/**
+ * @brief Dependency graph of tasks, run on a scheduler
+ *
+ * Nodes may only depend on nodes added before them, so a graph is acyclic
+ * by construction. A node starts once all its dependencies finished; if a
+ * node throws, its dependents are skipped and run() rethrows the first
+ * exception after everything else has finished.
+ */
+class TaskGraph {
+public:
+    using NodeId = size_t;
+
+    /**
+     * @brief Add a node
+     *
+     * @throws std::invalid_argument if a dependency id is not an earlier node
+     */
+    NodeId add(std::function<void()> fn, const std::vector<NodeId>& dependencies = {});
+
+    size_t size() const { return nodes_.size(); }
+
+    /**
+     * @brief Execute every node once, respecting dependencies
+     */
+    void run(Scheduler& scheduler = Scheduler::global());
+
+private:
+    struct Node {
+        std::function<void()> fn;
+        std::vector<NodeId> successors;
+        size_t dependencies = 0;
+        std::atomic<size_t> remaining{0};
+    };
+
+    void start(TaskGroup& group, NodeId id);
+
+    std::deque<Node> nodes_;  // deque: nodes hold atomics and must not move
+};
+
+} // namespace exec
+} // namespace tsproc
@@ -0,0 +1,150 @@
+#pragma once
+
+#include "bar.hpp"
+#include "histogram.hpp"
+#include "record.hpp"
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace tsproc {
+namespace streaming {
+
+/**
+ * @brief Fixed-size rolling window with running sum and sum of squares
+ *
+ * Ring buffer allocated once at construction, so push() never allocates.
+ * Mean/std follow the same formulas as indicators::add_roll_mean_std().
+ */
+class RollingWindow {
+public:
+    explicit RollingWindow(size_t window);
+
+    /**
+     * @brief Add a value, evicting the oldest one once the window is full
+     */
+    void push(double v);
+
+    bool full() const { return count_ == buf_.size(); }
+    size_t size() const { return count_; }
+    double sum() const { return sum_; }
+
+    /**
+     * @brief Rolling mean, NaN until the window is full
+     */
+    double mean() const;
+
+    /**
+     * @brief Rolling population std, NaN until the window is full
+     */
+    double stddev() const;
+
+private:
+    std::vector<double> buf_;
+    size_t head_ = 0;
+    size_t count_ = 0;
+    double sum_ = 0.0;
+    double sumsq_ = 0.0;
+};
+
+/**
+ * @brief Configuration for the streaming pipeline (mirrors the batch CLI options)
+ */
+struct StreamConfig {
+    std::vector<size_t> sma_windows;
+    size_t zscore_window = 0;
+    double zscore_entry = 2.0;
+    double zscore_exit = 0.5;
+    size_t fast_sma = 0;
+    size_t slow_sma = 0;
+    bool sma_crossover = false;
+    bool zscore_signal = false;
+};
+
+/**
+ * @brief Incremental indicator and signal pipeline
+ *
+ * Processes one record at a time with O(1) work per update and produces
+ * the same values as the batch indicators/signals functions. Output names
+ * match the batch column names ("SMA_20", "Z_20", "signal_z", ...) and are
+ * fixed at construction; update() only overwrites values.
+ */
+class StreamPipeline {
+public:
+    explicit StreamPipeline(const StreamConfig& config);
+
+    /**
+     * @brief Feed the next bar
+     *
+     * @return Current position signal (-1, 0, +1). When both strategies are
+     *         enabled the z-score signal wins, as in the batch CLI.
+     */
+    int update(const Bar& b) { return update_price(b.close); }
+
+    /**
+     * @brief Feed the next record (compatibility adapter, same as the Bar overload)
+     */
+    int update(const Record& r) { return update_price(r.close); }
+
+    /**
+     * @brief Latest values as (name, value) pairs, in a stable order
+     */
+    const std::vector<std::pair<std::string, double>>& values() const { return values_; }
+
+    /**
+     * @brief Copy latest values and signal into a record's indicators map
+     */
+    void annotate(Record& r) const;
+
+    int signal() const { return signal_; }
+
+    /**
+     * @brief Time each stage of update() into its own LatencyHistogram
+     *
+     * Stages are "sma", "sma_crossover" and "zscore" (rolling stats plus
+     * the z-score signal); disabled stages record nothing. The histograms
+     * are allocated here, so update() stays allocation-free. Costs two
+     * clock reads per stage, so it is off by default.
+     */
+    void enable_stage_latency();
+
+    /**
+     * @brief Per-stage latency summaries, empty unless enabled
+     */
+    std::vector<std::pair<std::string, LatencyStats>> stage_latency() const;
+
+private:
+    struct StageLatency {
+        LatencyHistogram sma;
+        LatencyHistogram crossover;
+        LatencyHistogram zscore;
+    };
+
+    int update_price(double price);
+    void update_sma(double price);
+    void update_crossover();
+    void update_zscore(double price);
+
+    StreamConfig config_;
+    std::vector<RollingWindow> sma_;
+    RollingWindow zwin_;
+    size_t fast_slot_ = 0;
+    size_t slow_slot_ = 0;
+
+    std::vector<std::pair<std::string, double>> values_;
+    size_t zscore_slot_ = 0;
+    size_t sma_signal_slot_ = 0;
+    size_t z_signal_slot_ = 0;
+
+    double prev_fast_;
+    double prev_slow_;
+    int sma_position_ = 0;
+    int z_position_ = 0;
+    int signal_ = 0;
+
+    std::unique_ptr<StageLatency> latency_;
+};
+
+} // namespace streaming
+} // namespace tsproc
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "bar.hpp"
+#include "timeseries.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tsproc {
+namespace synthetic {
+
+/**
+ * @brief Parameters of a synthetic OHLCV corpus
+ *
+ * Every random draw is a pure function of (seed, symbol, row, draw), so
+ * any row can be generated independently of the others and output is
+ * identical for any thread count.
+ */
+struct GeneratorConfig {
+    uint64_t seed = 42;
+    size_t rows = 10000;               ///< Bars per symbol (before gaps/duplicates)
+    size_t symbols = 1;
+    std::string start = "2020-01-01";  ///< First trading day
+    int64_t frequency_ns = 24LL * 3600LL * 1000000000LL;  ///< Bar spacing
+    bool weekdays_only = false;        ///< Skip Saturdays and Sundays
+    int64_t session_open_ns = 0;       ///< Intraday session start (offset from UTC midnight)
+    int64_t session_close_ns = 24LL * 3600LL * 1000000000LL;  ///< Session end (exclusive)
+
+    double start_price = 100.0;
+    double trend = 0.0001;             ///< Mean log return per bar
+    double volatility = 0.02;          ///< Base standard deviation of log returns per bar
+    double half_life = 0.0;            ///< Bars for deviations from trend to halve (0 = random walk)
+    double vol_cluster = 0.0;          ///< Log-vol swing (0 = constant volatility)
+    size_t cluster_length = 250;       ///< Bars between volatility knots
+
+    double gap_rate = 0.0;             ///< Probability a bar is missing
+    double nan_rate = 0.0;             ///< Probability a bar has a missing close
+    double duplicate_rate = 0.0;       ///< Probability a bar is followed by a corrected duplicate
+};
+
+/**
+ * @brief Counter-based generator for one configuration
+ *
+ * The log price is start + trend * row + x, where the deviation x follows
+ * x[i] = phi * x[i-1] + noise (phi = 1 gives a random walk; a half-life
+ * keeps very long corpora within a realistic price range). Blocks of rows
+ * are generated in parallel: a first pass reduces each block to its
+ * contribution to x, a scan gives every block its starting deviation, and
+ * a second pass produces the bars. Volatility clustering multiplies the
+ * base volatility by exp(vol_cluster * noise), where the noise is
+ * interpolated between random knots every cluster_length bars.
+ */
+class Generator {
+public:
+    /**
+     * @throws std::invalid_argument on an invalid configuration, including
+     *         one whose last row would be dated past the int64 nanosecond
+     *         range (year 2262)
+     */
+    explicit Generator(const GeneratorConfig& config);
+
+    /**
+     * @brief Generate rows [first, first + count) of a symbol
+     *
+     * Missing bars (gaps) are omitted, NaN bars carry a NaN close and a
+     * duplicate follows its original with a slightly corrected close.
+     *
+     * @param symbol Symbol number (< symbols)
+     * @param first First row
+     * @param count Number of rows
+     * @param start_state Deviation before row `first` (see block_start_states())
+     * @param out Output bars (appended)
+     */
+    void generate(size_t symbol, size_t first, size_t count, double start_state,
+                  std::vector<Bar>& out) const;
+
+    /**
+     * @brief Deviation from trend before each block of `block_rows` rows of a symbol
+     *
+     * @param threads Parallel tasks (0 = scheduler concurrency)
+     */
+    std::vector<double> block_start_states(size_t symbol, size_t block_rows, size_t threads) const;
+
+    /**
+     * @brief Timestamp of row `row` on the bar schedule
+     */
+    int64_t timestamp(size_t row) const;
+
+    /**
+     * @brief Ticker used for a symbol number ("SYM0000", "SYM0001", ...)
+     */
+    static std::string symbol_name(size_t symbol);
+
+    const GeneratorConfig& config() const { return config_; }
+
+private:
+    GeneratorConfig config_;
+    int64_t first_day_;
+    size_t slots_per_day_;
+    double log_start_;
+    double phi_;
+
+    int64_t trading_day(int64_t day_n) const;
+    double innovation(size_t symbol, size_t row) const;
+    double volatility(size_t symbol, size_t row) const;
+};
+
+/**
+ * @brief Output encodings supported by write()
+ */
+enum class OutputFormat { CSV, CompressedCSV, Binary };
+
+/**
+ * @brief Choose a format from the file name (".gz" -> compressed CSV, ".bin" -> binary)
+ */
+OutputFormat format_for_path(const std::string& path);
+
+/**
+ * @brief Whether compressed CSV output was compiled in (requires zlib)
+ */
+bool compression_available();
+
+/**
+ * @brief Generate the whole corpus and write it to `path`
+ *
+ * Blocks are generated and encoded in parallel and written in order, so
+ * memory stays bounded regardless of row count. With one symbol the CSV
+ * layout is the regular Date,Open,High,Low,Close,Adj Close,Volume; with
+ * several symbols a Symbol column follows Date and bars are interleaved
+ * by time. Binary output with several symbols writes one file per symbol
+ * ("out.bin" -> "out.SYM0000.bin", ...).
+ *
+ * @param threads Parallel tasks (0 = scheduler concurrency)
+ * @return Rows written (all files), or 0 on I/O error
+ */
+size_t write(const GeneratorConfig& config, const std::string& path, OutputFormat format,
+             size_t threads = 0);
+
+/**
+ * @brief Generate one symbol in memory (for tests and benchmarks)
+ */
+TimeSeries generate_series(const GeneratorConfig& config, size_t symbol = 0);
+
+} // namespace synthetic
+} // namespace tsproc
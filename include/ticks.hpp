@@ -0,0 +1,173 @@
+#pragma once
+
+#include "column_buffer.hpp"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tsproc {
+namespace ticks {
+
+/**
+ * @brief Trade aggressor side
+ */
+enum class Side : int8_t {
+    Sell = -1,
+    Unknown = 0,
+    Buy = 1
+};
+
+/**
+ * @brief Parse a side field: B/BUY/1 and S/SELL/-1 (case-insensitive); others are Unknown
+ */
+Side parse_side(std::string_view s);
+
+/**
+ * @brief "buy", "sell" or "unknown"
+ */
+const char* side_name(Side side);
+
+/**
+ * @brief One trade print with a nanosecond timestamp
+ */
+struct Trade {
+    int64_t ts = 0;      ///< Nanoseconds since epoch
+    double price = 0.0;
+    double size = 0.0;
+    Side side = Side::Unknown;
+};
+
+/**
+ * @brief One top-of-book quote with a nanosecond timestamp
+ */
+struct Quote {
+    int64_t ts = 0;      ///< Nanoseconds since epoch
+    double bid = 0.0;
+    double ask = 0.0;
+    double bid_size = 0.0;
+    double ask_size = 0.0;
+};
+
+/**
+ * @brief Columnar trades, in file order
+ */
+struct TradeColumns {
+    std::vector<int64_t> ts;
+    std::vector<double> price;
+    std::vector<double> size;
+    std::vector<int8_t> side;   ///< Side values
+
+    size_t rows() const { return ts.size(); }
+    bool empty() const { return ts.empty(); }
+
+    void push(const Trade& t);
+    void reserve(size_t rows);
+    void append(const TradeColumns& other);
+    Trade at(size_t i) const;
+};
+
+/**
+ * @brief Columnar quotes, in file order
+ */
+struct QuoteColumns {
+    std::vector<int64_t> ts;
+    std::vector<double> bid;
+    std::vector<double> ask;
+    std::vector<double> bid_size;
+    std::vector<double> ask_size;
+
+    size_t rows() const { return ts.size(); }
+    bool empty() const { return ts.empty(); }
+
+    void push(const Quote& q);
+    void reserve(size_t rows);
+    void append(const QuoteColumns& other);
+    Quote at(size_t i) const;
+};
+
+/**
+ * @brief Parse trades from CSV text with a header row
+ *
+ * Columns are found by header name (case-insensitive, any order, extra
+ * columns ignored): a timestamp (ts, timestamp, time, datetime or date),
+ * price (price or px), size (size, qty, quantity or volume) and an
+ * optional side (side or aggressor). Timestamps are either integer
+ * nanoseconds since the epoch or dates accepted by parse_datetime(), with
+ * up to nine fractional digits. Rows with a bad timestamp, price or size
+ * are skipped.
+ *
+ * Lines are tokenized in place, and plain decimals of up to 15 digits are
+ * converted without strtod (the result is the same correctly rounded
+ * value), so ingest allocates nothing per row. Text of more than a few MiB
+ * is cut at line starts and parsed on up to `threads` scheduler tasks
+ * (0 = scheduler concurrency), then concatenated in order.
+ *
+ * @param out Columns the rows are appended to
+ * @return false if a required column is missing
+ */
+bool parse_trades(const char* data, size_t size, TradeColumns& out, size_t threads = 0,
+                  char delimiter = ',');
+
+/**
+ * @brief Parse quotes from CSV text with a header row
+ *
+ * As parse_trades(), with columns bid (bid, bid_price or bid_px), ask
+ * (ask, ask_price, ask_px or offer), bid_size (bid_size, bid_qty or
+ * bidsize) and ask_size (ask_size, ask_qty or asksize). Rows with a bad
+ * timestamp or any bad value are skipped.
+ */
+bool parse_quotes(const char* data, size_t size, QuoteColumns& out, size_t threads = 0,
+                  char delimiter = ',');
+
+/**
+ * @brief Read a trade CSV file through a memory map (see parse_trades())
+ *
+ * @return false if the file cannot be opened or a required column is missing
+ */
+bool read_trades(const std::string& path, TradeColumns& out, size_t threads = 0,
+                 char delimiter = ',');
+
+/**
+ * @brief Read a quote CSV file through a memory map (see parse_quotes())
+ */
+bool read_quotes(const std::string& path, QuoteColumns& out, size_t threads = 0,
+                 char delimiter = ',');
+
+/**
+ * @brief Quote-derived feature columns (see kernels::quote_features())
+ */
+struct QuoteFeatures {
+    ColumnBuffer mid;
+    ColumnBuffer spread;
+    ColumnBuffer microprice;
+    ColumnBuffer imbalance;
+};
+
+/**
+ * @brief Mid, spread, microprice and order imbalance for every quote
+ *
+ * Runs the dispatched kernel over row blocks with parallel_for; outputs
+ * are first-touched on the same blocks.
+ */
+QuoteFeatures quote_features(const QuoteColumns& quotes);
+
+/**
+ * @brief Features of one quote
+ */
+struct QuoteMetrics {
+    double mid = 0.0;
+    double spread = 0.0;
+    double microprice = 0.0;
+    double imbalance = 0.0;
+};
+
+/**
+ * @brief Features of a single quote, for streaming use
+ *
+ * Calls the same kernel as the batch path, so values are bit-identical.
+ */
+QuoteMetrics quote_metrics(const Quote& q);
+
+} // namespace ticks
+} // namespace tsproc
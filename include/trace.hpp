@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace tsproc {
+namespace tracing {
+
+/**
+ * @brief One completed span
+ *
+ * Names and categories must be string literals (or otherwise outlive the
+ * tracer); they are stored as pointers so recording never allocates a string.
+ */
+struct Event {
+    const char* category;
+    const char* name;
+    int64_t start_ns;     ///< Relative to Tracer::enable()
+    int64_t duration_ns;
+    int64_t param;        ///< Optional argument (window, chunk, block), -1 = none
+    int64_t rows;         ///< Optional row/byte count, -1 = none
+};
+
+/**
+ * @brief Process-wide span collector behind --trace
+ *
+ * Every thread appends to its own buffer, registered under a lock only the
+ * first time the thread records, so the hot path takes no locks. Buffers
+ * outlive their threads, so spans from joined workers are still exported.
+ * write() and clear() must only run while no traced work is in flight.
+ */
+class Tracer {
+public:
+    static Tracer& instance();
+
+    /**
+     * @brief Start recording; timestamps are relative to this call
+     */
+    void enable();
+    void disable() { enabled_.store(false, std::memory_order_relaxed); }
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Append a span to the calling thread's buffer
+     */
+    void record(const Event& event);
+
+    /**
+     * @brief Label the calling thread in the timeline (default "thread-N")
+     */
+    void set_thread_name(const std::string& name);
+
+    /**
+     * @brief Nanoseconds since enable()
+     */
+    int64_t now() const;
+
+    size_t event_count() const;
+    void clear();
+
+    /**
+     * @brief Export as Chrome trace-event JSON (chrome://tracing, ui.perfetto.dev)
+     */
+    void write(std::ostream& os) const;
+
+    /**
+     * @return true if the file was written
+     */
+    bool write(const std::string& path) const;
+
+private:
+    struct ThreadBuffer {
+        uint32_t tid;
+        std::string name;
+        std::vector<Event> events;
+    };
+
+    Tracer() = default;
+    ThreadBuffer& local();
+
+    std::atomic<bool> enabled_{false};
+    int64_t epoch_ns_ = 0;
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+};
+
+/**
+ * @brief RAII span; records nothing unless tracing is enabled
+ *
+ * @code
+ * tracing::Span span("csv", "parse_chunk", chunk);
+ * @endcode
+ */
+class Span {
+public:
+    explicit Span(const char* category, const char* name, int64_t param = -1, int64_t rows = -1);
+    ~Span();
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+    void set_rows(int64_t rows) { event_.rows = rows; }
+
+private:
+    bool active_;
+    Event event_{};
+};
+
+} // namespace tracing
+} // namespace tsproc
@@ -0,0 +1,44 @@
+#include "bar.hpp"
+#include "datetime.hpp"
+
+namespace tsproc {
+
+Bar to_bar(const Record& r) {
+    Bar b;
+    b.ts = to_timestamp(r.date);
+    b.open = r.open;
+    b.high = r.high;
+    b.low = r.low;
+    b.close = r.close;
+    b.adj_close = r.adj_close;
+    b.volume = r.volume;
+    return b;
+}
+
+Record to_record(const Bar& b) {
+    Record r;
+    r.date = format_datetime(b.ts);
+    r.open = b.open;
+    r.high = b.high;
+    r.low = b.low;
+    r.close = b.close;
+    r.adj_close = b.adj_close;
+    r.volume = b.volume;
+    return r;
+}
+
+std::vector<Bar> to_bars(const TimeSeries& ts) {
+    std::vector<Bar> bars;
+    bars.reserve(ts.size());
+    for (const auto& r : ts) bars.push_back(to_bar(r));
+    return bars;
+}
+
+TimeSeries to_series(const std::vector<Bar>& bars) {
+    TimeSeries ts;
+    ts.reserve(bars.size());
+    for (const Bar& b : bars) ts.push(to_record(b));
+    return ts;
+}
+
+} // namespace tsproc
@@ -0,0 +1,55 @@
+#include "column_buffer.hpp"
+#include <utility>
+
+namespace tsproc {
+
+namespace {
+
+// Values zeroed per first-touch task: 64 pages of 4 KiB
+constexpr size_t kTouchGrain = 64 * ColumnBuffer::kAlignment / sizeof(double);
+
+} // namespace
+
+ColumnBuffer::ColumnBuffer(size_t size, FirstTouch touch, exec::Scheduler& scheduler)
+    : size_(size) {
+    if (size == 0) return;
+    // Allocation only reserves address space; no page is touched here
+    block_ = pages::allocate(size * sizeof(double));
+    data_ = static_cast<double*>(block_.data);
+    double* data = data_;
+    auto zero = [data](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) data[i] = 0.0;
+    };
+    if (touch == FirstTouch::Parallel) {
+        exec::parallel_for(0, size, kTouchGrain, zero, scheduler);
+    } else {
+        zero(0, size);
+    }
+}
+
+ColumnBuffer::~ColumnBuffer() {
+    release();
+}
+
+ColumnBuffer::ColumnBuffer(ColumnBuffer&& other) noexcept
+    : block_(std::exchange(other.block_, pages::Block())),
+      data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)) {}
+
+ColumnBuffer& ColumnBuffer::operator=(ColumnBuffer&& other) noexcept {
+    if (this != &other) {
+        release();
+        block_ = std::exchange(other.block_, pages::Block());
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+}
+
+void ColumnBuffer::release() {
+    pages::release(block_);
+    data_ = nullptr;
+    size_ = 0;
+}
+
+} // namespace tsproc
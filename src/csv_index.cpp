@@ -0,0 +1,185 @@
+#include "csv_index.hpp"
+#include "datetime.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace tsproc {
+
+namespace {
+
+const char kIndexMagic[8] = {'T', 'S', 'I', 'D', 'X', '0', '0', '2'};
+
+// stride, file size, mtime, rows, entry count
+constexpr size_t kHeaderFields = 5;
+
+uint64_t file_size_of(const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) return 0;
+    std::streamoff size = file.tellg();
+    return size < 0 ? 0 : static_cast<uint64_t>(size);
+}
+
+bool is_blank(const std::string& line) {
+    return line.find_first_not_of(" \t\r\n") == std::string::npos;
+}
+
+} // namespace
+
+int64_t CSVIndex::modified_ns(const std::string& path) {
+    std::error_code ec;
+    auto stamp = std::filesystem::last_write_time(path, ec);
+    if (ec) return 0;
+    return static_cast<int64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(stamp.time_since_epoch()).count());
+}
+
+void CSVIndex::start(size_t stride, uint64_t file_size, int64_t modified_ns) {
+    stride_ = stride == 0 ? kDefaultStride : stride;
+    file_size_ = file_size;
+    modified_ns_ = modified_ns;
+    rows_ = 0;
+    entries_.clear();
+}
+
+void CSVIndex::add_line(uint64_t offset, int64_t timestamp) {
+    if (rows_ % stride_ == 0) {
+        entries_.push_back({offset, timestamp});
+    }
+    ++rows_;
+}
+
+bool CSVIndex::build(const std::string& csv_path, size_t stride, char delimiter) {
+    std::ifstream file(csv_path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file: " << csv_path << std::endl;
+        return false;
+    }
+
+    start(stride, file_size_of(csv_path), modified_ns(csv_path));
+
+    std::string line;
+    uint64_t offset = 0;
+    bool is_header = true;
+    while (std::getline(file, line)) {
+        uint64_t line_start = offset;
+        offset += line.size() + 1;
+
+        if (is_header) {
+            is_header = false;
+            continue;
+        }
+        if (is_blank(line)) continue;
+
+        // Only the date column of sampled lines is parsed
+        int64_t ts = kInvalidTimestamp;
+        if (rows_ % stride_ == 0) {
+            ts = to_timestamp(line.substr(0, line.find(delimiter)));
+        }
+        add_line(line_start, ts);
+    }
+    return true;
+}
+
+bool CSVIndex::save(const std::string& index_path) const {
+    std::ofstream file(index_path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not write index file: " << index_path << std::endl;
+        return false;
+    }
+
+    uint64_t header[kHeaderFields] = {static_cast<uint64_t>(stride_), file_size_,
+                                      static_cast<uint64_t>(modified_ns_),
+                                      static_cast<uint64_t>(rows_),
+                                      static_cast<uint64_t>(entries_.size())};
+    file.write(kIndexMagic, sizeof(kIndexMagic));
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    for (const auto& e : entries_) {
+        file.write(reinterpret_cast<const char*>(&e.offset), sizeof(e.offset));
+        file.write(reinterpret_cast<const char*>(&e.timestamp), sizeof(e.timestamp));
+    }
+    return file.good();
+}
+
+bool CSVIndex::load(const std::string& index_path, const std::string& csv_path) {
+    std::ifstream file(index_path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) return false;
+    const std::streamoff index_size = file.tellg();
+    file.seekg(0);
+
+    char magic[8];
+    uint64_t header[kHeaderFields];
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!file || std::memcmp(magic, kIndexMagic, sizeof(magic)) != 0 || header[0] == 0) {
+        return false;
+    }
+
+    // A different size or modification time means the CSV changed since indexing
+    if (header[1] != file_size_of(csv_path) ||
+        static_cast<int64_t>(header[2]) != modified_ns(csv_path)) {
+        return false;
+    }
+
+    // The entry count must account for exactly the rest of the file
+    const uint64_t entry_bytes = sizeof(uint64_t) + sizeof(int64_t);
+    const uint64_t body = static_cast<uint64_t>(index_size) - sizeof(magic) - sizeof(header);
+    if (header[4] != body / entry_bytes || body % entry_bytes != 0) {
+        return false;
+    }
+
+    std::vector<Entry> entries(static_cast<size_t>(header[4]));
+    for (auto& e : entries) {
+        file.read(reinterpret_cast<char*>(&e.offset), sizeof(e.offset));
+        file.read(reinterpret_cast<char*>(&e.timestamp), sizeof(e.timestamp));
+    }
+    if (!file) return false;
+
+    stride_ = static_cast<size_t>(header[0]);
+    file_size_ = header[1];
+    modified_ns_ = static_cast<int64_t>(header[2]);
+    rows_ = static_cast<size_t>(header[3]);
+    entries_ = std::move(entries);
+    return true;
+}
+
+uint64_t CSVIndex::seek_row(size_t row, size_t& row_at_offset) const {
+    if (entries_.empty()) {
+        row_at_offset = 0;
+        return 0;
+    }
+    size_t e = std::min(row / stride_, entries_.size() - 1);
+    row_at_offset = e * stride_;
+    return entries_[e].offset;
+}
+
+uint64_t CSVIndex::seek_timestamp(int64_t from_ns) const {
+    if (entries_.empty()) return 0;
+
+    // Last sample strictly before from_ns; rows between samples are not
+    // indexed, so reading must start there to catch every row >= from_ns
+    auto it = std::lower_bound(entries_.begin(), entries_.end(), from_ns,
+                               [](const Entry& e, int64_t t) { return e.timestamp < t; });
+    if (it == entries_.begin()) return it->offset;
+    return std::prev(it)->offset;
+}
+
+std::vector<std::pair<uint64_t, uint64_t>> CSVIndex::split(size_t chunks) const {
+    std::vector<std::pair<uint64_t, uint64_t>> ranges;
+    if (entries_.empty() || chunks == 0) return ranges;
+
+    chunks = std::min(chunks, entries_.size());
+    for (size_t c = 0; c < chunks; ++c) {
+        size_t first = c * entries_.size() / chunks;
+        size_t last = (c + 1) * entries_.size() / chunks;
+        uint64_t begin = entries_[first].offset;
+        uint64_t end = last < entries_.size() ? entries_[last].offset : file_size_;
+        ranges.emplace_back(begin, end);
+    }
+    return ranges;
+}
+
+} // namespace tsproc
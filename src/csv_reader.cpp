@@ -1,8 +1,13 @@
 #include "csv_reader.hpp"
+#include "datetime.hpp"
+#include "scheduler.hpp"
+#include "trace.hpp"
 #include <fstream>
 #include <sstream>
 #include <algorithm>
 #include <cctype>
+#include <cerrno>
+#include <cstdlib>
 #include <cmath>
 #include <iostream>
 
@@ -17,51 +22,63 @@ bool CSVReader::is_open() const {
     return file.is_open();
 }
 
-std::vector<std::string> CSVReader::split_line_fast(const std::string& line, char delim) const {
-    std::vector<std::string> out;
-    out.reserve(8);  // Typical OHLCV has 7 columns
+// Parsing works on field ranges into the line buffer, so a steady-state
+// parse allocates nothing per line (dates that fit the small-string buffer,
+// as YYYY-MM-DD does, are not even copied to the heap)
+size_t CSVReader::split_fields(const std::string& line, FieldRange* fields, size_t max_fields) const {
+    size_t count = 0;
     size_t start = 0;
     
-    for (size_t i = 0; i <= line.size(); ++i) {
-        if (i == line.size() || line[i] == delim) {
-            out.emplace_back(line.substr(start, i - start));
+    for (size_t i = 0; i <= line.size() && count < max_fields; ++i) {
+        if (i == line.size() || line[i] == delimiter_) {
+            fields[count++] = {start, i};
             start = i + 1;
         }
     }
     
-    return out;
+    return count;
 }
 
-std::string CSVReader::trim(const std::string& str) const {
-    size_t first = str.find_first_not_of(" \t\r\n");
-    if (first == std::string::npos) return "";
-    size_t last = str.find_last_not_of(" \t\r\n");
-    return str.substr(first, last - first + 1);
+CSVReader::FieldRange CSVReader::trim(const std::string& line, FieldRange field) {
+    auto is_space = [](char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; };
+    while (field.begin < field.end && is_space(line[field.begin])) ++field.begin;
+    while (field.end > field.begin && is_space(line[field.end - 1])) --field.end;
+    return field;
 }
 
-double CSVReader::safe_stod(const std::string& str) const {
-    try {
-        std::string trimmed = trim(str);
-        if (trimmed.empty()) return NAN;
-        return std::stod(trimmed);
-    } catch (...) {
-        return NAN;
-    }
+bool CSVReader::is_blank(const std::string& line) {
+    FieldRange whole = trim(line, {0, line.size()});
+    return whole.begin == whole.end;
 }
 
-bool CSVReader::parse_record(const std::vector<std::string>& columns, Record& record) const {
+double CSVReader::parse_double(const std::string& line, FieldRange field) {
+    field = trim(line, field);
+    if (field.begin == field.end) return NAN;
+    
+    // Same rules as std::stod without the exceptions: no digits or out of range -> NaN
+    const char* begin = line.c_str() + field.begin;
+    char* end = nullptr;
+    errno = 0;
+    double value = std::strtod(begin, &end);
+    if (end == begin || errno == ERANGE) return NAN;
+    return value;
+}
+
+bool CSVReader::parse_record(const std::string& line, const FieldRange* fields, size_t count,
+                             Record& record) const {
     // Expect at least 7 columns: Date, Open, High, Low, Close, Adj Close, Volume
-    if (columns.size() < 7) {
+    if (count < kRecordFields) {
         return false;
     }
 
-    record.date = trim(columns[0]);
-    record.open = safe_stod(columns[1]);
-    record.high = safe_stod(columns[2]);
-    record.low = safe_stod(columns[3]);
-    record.close = safe_stod(columns[4]);
-    record.adj_close = safe_stod(columns[5]);
-    record.volume = safe_stod(columns[6]);
+    FieldRange date = trim(line, fields[0]);
+    record.date.assign(line, date.begin, date.end - date.begin);
+    record.open = parse_double(line, fields[1]);
+    record.high = parse_double(line, fields[2]);
+    record.low = parse_double(line, fields[3]);
+    record.close = parse_double(line, fields[4]);
+    record.adj_close = parse_double(line, fields[5]);
+    record.volume = parse_double(line, fields[6]);
 
     // Check for NaN values
     bool has_nan = std::isnan(record.open) || std::isnan(record.high) ||
@@ -71,53 +88,371 @@ bool CSVReader::parse_record(const std::vector<std::string>& columns, Record& re
     return !has_nan;
 }
 
+bool CSVReader::parse_line(const std::string& line, Record& record, bool drop_na) const {
+    // Skip empty lines
+    if (is_blank(line)) {
+        return false;
+    }
+
+    FieldRange fields[kRecordFields];
+    size_t count = split_fields(line, fields, kRecordFields);
+    
+    bool valid = parse_record(line, fields, count, record);
+    
+    if (!valid && drop_na) {
+        // Skip invalid records
+        return false;
+    } else if (!valid && !drop_na) {
+        // Keep invalid records with NaN values
+        FieldRange date = trim(line, fields[0]);
+        record.date.assign(line, date.begin, date.end - date.begin);
+        if (count < kRecordFields) {
+            // Short rows were never parsed; don't leak values from a reused record
+            record.open = record.high = record.low = record.close = 0.0;
+            record.adj_close = record.volume = 0.0;
+        }
+    }
+    
+    return true;
+}
+
+bool CSVReader::parse_bar(const std::string& line, const FieldRange* fields, size_t count,
+                          size_t symbol_field, std::string& date, Bar& bar) const {
+    // The record fields are every field but the symbol, in file order
+    FieldRange record[kRecordFields];
+    size_t n = 0;
+    for (size_t f = 0; f < count && n < kRecordFields; ++f) {
+        if (f != symbol_field) record[n++] = fields[f];
+    }
+    if (n < kRecordFields) {
+        return false;
+    }
+
+    FieldRange d = trim(line, record[0]);
+    date.assign(line, d.begin, d.end - d.begin);
+    bar.ts = to_timestamp(date);
+    bar.open = parse_double(line, record[1]);
+    bar.high = parse_double(line, record[2]);
+    bar.low = parse_double(line, record[3]);
+    bar.close = parse_double(line, record[4]);
+    bar.adj_close = parse_double(line, record[5]);
+    bar.volume = parse_double(line, record[6]);
+
+    return !(std::isnan(bar.open) || std::isnan(bar.high) || std::isnan(bar.low) ||
+             std::isnan(bar.close) || std::isnan(bar.adj_close) || std::isnan(bar.volume));
+}
+
 TimeSeries CSVReader::read_to_timeseries(bool drop_na) {
     TimeSeries ts;
-    std::ifstream file(path_);
+    std::ifstream file(path_, std::ios::binary);
     
     if (!file.is_open()) {
         std::cerr << "Error: Could not open file: " << path_ << std::endl;
         return ts;
     }
 
+    // Build the sidecar index during this parse if requested and missing
+    CSVIndex index;
+    bool indexing = build_index_ && !load_index(index);
+    if (indexing) {
+        file.seekg(0, std::ios::end);
+        index.start(index_stride_, static_cast<uint64_t>(file.tellg()), CSVIndex::modified_ns(path_));
+        file.seekg(0);
+    }
+
     std::string line;
     bool is_header = true;
-    size_t line_num = 0;
+    uint64_t offset = 0;
+    DuplicateResolver rows(ts, duplicate_policy_);
 
     while (std::getline(file, line)) {
-        line_num++;
-        
+        uint64_t line_start = offset;
+        offset += line.size() + 1;
+
         // Skip header row
         if (is_header) {
             is_header = false;
             continue;
         }
 
-        // Skip empty lines
-        if (trim(line).empty()) {
-            continue;
+        if (indexing && !is_blank(line)) {
+            bool sampled = index.row_count() % index.stride() == 0;
+            index.add_line(line_start, sampled ? line_timestamp(line) : kInvalidTimestamp);
         }
 
-        std::vector<std::string> columns = split_line_fast(line, delimiter_);
         Record record;
-        
-        bool valid = parse_record(columns, record);
-        
-        if (!valid && drop_na) {
-            // Skip invalid records
-            continue;
-        } else if (!valid && !drop_na) {
-            // Keep invalid records with NaN values
-            record.date = columns.size() > 0 ? trim(columns[0]) : "";
+        if (parse_line(line, record, drop_na)) {
+            rows.push(record);
         }
-        
-        ts.push(record);
     }
 
     file.close();
+    duplicates_resolved_ = rows.duplicates();
+
+    if (indexing) {
+        index.save(CSVIndex::sidecar_path(path_));
+    }
+    return ts;
+}
+
+void CSVReader::set_build_index(bool enable, size_t stride) {
+    build_index_ = enable;
+    index_stride_ = stride == 0 ? CSVIndex::kDefaultStride : stride;
+}
+
+bool CSVReader::load_index(CSVIndex& index) const {
+    return index.load(CSVIndex::sidecar_path(path_), path_);
+}
+
+size_t CSVReader::row_count() const {
+    CSVIndex index;
+    if (load_index(index)) {
+        return index.row_count();
+    }
+    if (!index.build(path_, CSVIndex::kDefaultStride, delimiter_)) {
+        return 0;
+    }
+    return index.row_count();
+}
+
+void CSVReader::parse_chunk(uint64_t begin, uint64_t end, bool drop_na, TimeSeries& out) const {
+    tracing::Span span("csv", "parse_chunk", static_cast<int64_t>(begin));
+    std::ifstream file(path_, std::ios::binary);
+    if (!file.is_open()) return;
+
+    file.seekg(static_cast<std::streamoff>(begin));
+    std::string line;
+    uint64_t offset = begin;
+    while (offset < end && std::getline(file, line)) {
+        offset += line.size() + 1;
+        Record record;
+        if (parse_line(line, record, drop_na)) {
+            out.push(record);
+        }
+    }
+    span.set_rows(static_cast<int64_t>(out.size()));
+}
+
+TimeSeries CSVReader::read_rows(size_t start_row, size_t count, bool drop_na) {
+    TimeSeries ts;
+    std::ifstream file(path_, std::ios::binary);
+    
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file: " << path_ << std::endl;
+        return ts;
+    }
+
+    std::string line;
+    size_t row = 0;
+    DuplicateResolver rows(ts, duplicate_policy_);
+    CSVIndex index;
+    if (load_index(index) && !index.empty()) {
+        file.seekg(static_cast<std::streamoff>(index.seek_row(start_row, row)));
+    } else {
+        std::getline(file, line);  // Skip header row
+    }
+
+    while (count > 0 && std::getline(file, line)) {
+        if (is_blank(line)) continue;
+        if (row++ < start_row) continue;
+
+        --count;
+        Record record;
+        if (parse_line(line, record, drop_na)) {
+            rows.push(record);
+        }
+    }
+
+    duplicates_resolved_ = rows.duplicates();
+    return ts;
+}
+
+bool CSVReader::split_ranges(size_t threads,
+                             std::vector<std::pair<uint64_t, uint64_t>>& ranges) const {
+    if (threads == 0) {
+        threads = exec::Scheduler::global().concurrency();
+    }
+
+    CSVIndex index;
+    if (load_index(index)) {
+        ranges = index.split(threads);
+        return true;
+    }
+
+    // No index: cut at equal byte offsets, moved forward to line starts
+    std::ifstream file(path_, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file: " << path_ << std::endl;
+        return false;
+    }
+    std::string line;
+    std::getline(file, line);  // Skip header row
+    std::streamoff data_start = file.tellg();
+    file.seekg(0, std::ios::end);
+    std::streamoff file_size = file.tellg();
+    if (data_start < 0 || data_start >= file_size) {
+        return true;
+    }
+
+    std::vector<uint64_t> cuts = {static_cast<uint64_t>(data_start)};
+    for (size_t t = 1; t < threads; ++t) {
+        std::streamoff target = data_start + (file_size - data_start) * static_cast<std::streamoff>(t) /
+                                             static_cast<std::streamoff>(threads);
+        file.clear();
+        file.seekg(target - 1);
+        std::getline(file, line);
+        std::streamoff cut = file.tellg();
+        if (cut < 0) cut = file_size;
+        if (static_cast<uint64_t>(cut) > cuts.back()) cuts.push_back(static_cast<uint64_t>(cut));
+    }
+    cuts.push_back(static_cast<uint64_t>(file_size));
+    for (size_t c = 0; c + 1 < cuts.size(); ++c) {
+        if (cuts[c] < cuts[c + 1]) ranges.emplace_back(cuts[c], cuts[c + 1]);
+    }
+    return true;
+}
+
+TimeSeries CSVReader::read_parallel(size_t threads, bool drop_na) {
+    std::vector<std::pair<uint64_t, uint64_t>> ranges;
+    if (!split_ranges(threads, ranges)) {
+        return TimeSeries();
+    }
+
+    // Each part is parsed, and so first touched, on the node that owns its rows
+    std::vector<TimeSeries> parts(ranges.size());
+    exec::TaskGroup group;
+    const size_t nodes = group.scheduler().node_count();
+    for (size_t c = 1; c < ranges.size(); ++c) {
+        group.spawn([&, c] { parse_chunk(ranges[c].first, ranges[c].second, drop_na, parts[c]); },
+                    static_cast<long>(numa::node_for(c, ranges.size(), nodes)));
+    }
+    if (!ranges.empty()) {
+        parse_chunk(ranges[0].first, ranges[0].second, drop_na, parts[0]);
+    }
+    {
+        tracing::Span wait("csv", "join_wait");
+        group.wait();
+    }
+
+    // Chunks are contiguous and ordered, so concatenation preserves file order
+    TimeSeries ts;
+    size_t total = 0;
+    for (const auto& part : parts) total += part.size();
+    ts.reserve(total);
+    tracing::Span merge("csv", "merge", -1, static_cast<int64_t>(total));
+    DuplicateResolver rows(ts, duplicate_policy_);
+    for (const auto& part : parts) {
+        for (const auto& r : part) rows.push(r);
+    }
+    duplicates_resolved_ = rows.duplicates();
     return ts;
 }
 
+size_t CSVReader::find_column(const std::string& name) const {
+    std::ifstream file(path_, std::ios::binary);
+    std::string header;
+    if (!file.is_open() || !std::getline(file, header)) {
+        return SIZE_MAX;
+    }
+
+    auto lower = [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); };
+    size_t start = 0;
+    for (size_t column = 0; start <= header.size(); ++column) {
+        size_t end = header.find(delimiter_, start);
+        if (end == std::string::npos) end = header.size();
+        FieldRange field = trim(header, {start, end});
+        if (field.end - field.begin == name.size() &&
+            std::equal(name.begin(), name.end(), header.begin() + static_cast<std::ptrdiff_t>(field.begin),
+                       [&](char a, char b) { return lower(a) == lower(b); })) {
+            return column;
+        }
+        start = end + 1;
+    }
+    return SIZE_MAX;
+}
+
+void CSVReader::parse_panel_chunk(uint64_t begin, uint64_t end, size_t symbol_field, bool drop_na,
+                                  Panel& out) const {
+    tracing::Span span("csv", "parse_panel_chunk", static_cast<int64_t>(begin));
+    std::ifstream file(path_, std::ios::binary);
+    if (!file.is_open()) return;
+
+    file.seekg(static_cast<std::streamoff>(begin));
+    std::string line;
+    std::string date;
+    uint64_t offset = begin;
+    size_t rows = 0;
+    FieldRange fields[kRecordFields + 1];
+    while (offset < end && std::getline(file, line)) {
+        offset += line.size() + 1;
+        if (is_blank(line)) continue;
+
+        size_t count = split_fields(line, fields, kRecordFields + 1);
+        if (count <= symbol_field) continue;
+        FieldRange symbol = trim(line, fields[symbol_field]);
+        if (symbol.begin == symbol.end) continue;  // Nowhere to route the row
+
+        Bar bar;
+        if (!parse_bar(line, fields, count, symbol_field, date, bar)) {
+            if (drop_na) continue;
+            if (count < kRecordFields + 1) {
+                // Short rows keep their date and zeroed values, as parse_line() does
+                const size_t date_field = symbol_field == 0 ? 1 : 0;
+                bar = Bar();
+                bar.ts = kInvalidTimestamp;
+                if (date_field < count) {
+                    FieldRange d = trim(line, fields[date_field]);
+                    bar.ts = to_timestamp(date.assign(line, d.begin, d.end - d.begin));
+                }
+            }
+        }
+        const uint32_t id = out.add_symbol(
+            std::string_view(line.data() + symbol.begin, symbol.end - symbol.begin));
+        out.push(id, bar);
+        ++rows;
+    }
+    span.set_rows(static_cast<int64_t>(rows));
+}
+
+Panel CSVReader::read_panel(const std::string& symbol_column, size_t threads, bool drop_na) {
+    const size_t symbol_field = find_column(symbol_column);
+    if (symbol_field == SIZE_MAX) {
+        std::cerr << "Error: No '" << symbol_column << "' column in: " << path_ << std::endl;
+        return Panel();
+    }
+    if (symbol_field > kRecordFields) {
+        std::cerr << "Error: '" << symbol_column << "' must be one of the first "
+                  << (kRecordFields + 1) << " columns" << std::endl;
+        return Panel();
+    }
+
+    std::vector<std::pair<uint64_t, uint64_t>> ranges;
+    if (!split_ranges(threads, ranges)) {
+        return Panel();
+    }
+
+    // One partial panel (own symbol table and columns) per chunk, so the
+    // parse needs no shared state; merge() remaps and concatenates them
+    std::vector<Panel> parts(ranges.size());
+    exec::TaskGroup group;
+    const size_t nodes = group.scheduler().node_count();
+    for (size_t c = 1; c < ranges.size(); ++c) {
+        group.spawn([&, c] {
+            parse_panel_chunk(ranges[c].first, ranges[c].second, symbol_field, drop_na, parts[c]);
+        }, static_cast<long>(numa::node_for(c, ranges.size(), nodes)));
+    }
+    if (!ranges.empty()) {
+        parse_panel_chunk(ranges[0].first, ranges[0].second, symbol_field, drop_na, parts[0]);
+    }
+    {
+        tracing::Span wait("csv", "join_wait");
+        group.wait();
+    }
+
+    duplicates_resolved_ = 0;
+    return Panel::merge(parts);
+}
+
 void CSVReader::stream_to(std::function<void(const Record&)> callback, bool drop_na) {
     std::ifstream file(path_);
     
@@ -128,6 +463,7 @@ void CSVReader::stream_to(std::function<void(const Record&)> callback, bool drop
 
     std::string line;
     bool is_header = true;
+    Record record;  // reused, so steady-state streaming allocates nothing per row
 
     while (std::getline(file, line)) {
         // Skip header row
@@ -136,22 +472,107 @@ void CSVReader::stream_to(std::function<void(const Record&)> callback, bool drop
             continue;
         }
 
-        // Skip empty lines
-        if (trim(line).empty()) {
+        if (parse_line(line, record, drop_na)) {
+            callback(record);
+        }
+    }
+
+    file.close();
+}
+
+int64_t CSVReader::line_timestamp(const std::string& line) const {
+    size_t end = line.find(delimiter_);
+    return to_timestamp(line.substr(0, end));
+}
+
+std::streamoff CSVReader::seek_first_at_or_after(std::istream& file, std::streamoff data_start,
+                                                 std::streamoff file_size, int64_t from_ns) const {
+    // Invariant: every line starting before `lo` has a timestamp < from_ns and
+    // `lo` is a line start. Each probe jumps to the first line start after the
+    // midpoint; the final stretch is scanned linearly by the caller.
+    constexpr std::streamoff kLinearScanBytes = 64 * 1024;
+    std::streamoff lo = data_start;
+    std::streamoff hi = file_size;
+    std::string line;
+
+    while (hi - lo > kLinearScanBytes) {
+        std::streamoff mid = lo + (hi - lo) / 2;
+
+        file.clear();
+        file.seekg(mid - 1);
+        std::getline(file, line);  // Discard the tail of the line containing mid - 1
+
+        // First line with a parseable timestamp at or after mid
+        std::streamoff line_start = file.tellg();
+        int64_t t = kInvalidTimestamp;
+        std::streamoff line_end = line_start;
+        while (line_start >= 0 && line_start < hi && std::getline(file, line)) {
+            line_end = file.tellg();
+            t = line_timestamp(line);
+            if (t != kInvalidTimestamp) break;
+            line_start = line_end;
+        }
+
+        if (t == kInvalidTimestamp || line_start < 0 || line_start >= hi) {
+            break;  // No usable line start in [mid, hi): finish linearly from lo
+        }
+
+        if (t < from_ns) {
+            lo = (line_end < 0) ? file_size : line_end;
+        } else {
+            hi = line_start;
+        }
+    }
+
+    return lo;
+}
+
+TimeSeries CSVReader::read_range(int64_t from_ns, int64_t to_ns, bool drop_na) {
+    TimeSeries ts;
+    std::ifstream file(path_, std::ios::binary);
+    
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file: " << path_ << std::endl;
+        return ts;
+    }
+
+    std::string line;
+    if (!std::getline(file, line)) {
+        return ts;  // No header
+    }
+    std::streamoff data_start = file.tellg();
+    file.seekg(0, std::ios::end);
+    std::streamoff file_size = file.tellg();
+    if (data_start < 0) {
+        return ts;  // Header only, without trailing newline
+    }
+
+    // A fresh sidecar index gives the start directly; otherwise bisect
+    CSVIndex index;
+    std::streamoff start = (load_index(index) && !index.empty())
+        ? static_cast<std::streamoff>(index.seek_timestamp(from_ns))
+        : seek_first_at_or_after(file, data_start, file_size, from_ns);
+    file.clear();
+    file.seekg(start);
+
+    DuplicateResolver rows(ts, duplicate_policy_);
+    while (std::getline(file, line)) {
+        int64_t t = line_timestamp(line);
+        if (t == kInvalidTimestamp || t < from_ns) {
             continue;
         }
+        if (t >= to_ns) {
+            break;  // Input is sorted, nothing later can match
+        }
 
-        std::vector<std::string> columns = split_line_fast(line, delimiter_);
         Record record;
-        
-        bool valid = parse_record(columns, record);
-        
-        if (valid || !drop_na) {
-            callback(record);
+        if (parse_line(line, record, drop_na)) {
+            rows.push(record, t);
         }
     }
 
-    file.close();
+    duplicates_resolved_ = rows.duplicates();
+    return ts;
 }
 
 } // namespace tsproc
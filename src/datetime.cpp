@@ -0,0 +1,236 @@
+#include "datetime.hpp"
+#include <cstdio>
+
+namespace tsproc {
+
+namespace {
+
+constexpr int64_t kNanosPerSecond = 1000000000LL;
+constexpr int64_t kSecondsPerDay = 86400LL;
+
+// Howard Hinnant's days_from_civil: proleptic Gregorian date -> days since 1970-01-01
+int64_t days_from_civil(int64_t y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+void civil_from_days(int64_t z, int64_t& y, unsigned& m, unsigned& d) {
+    z += 719468;
+    const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    d = doy - (153 * mp + 2) / 5 + 1;
+    m = mp < 10 ? mp + 3 : mp - 9;
+    y = static_cast<int64_t>(yoe) + era * 400 + (m <= 2);
+}
+
+unsigned days_in_month(int64_t y, unsigned m) {
+    static const unsigned kDays[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    const bool leap = y % 4 == 0 && (y % 100 != 0 || y % 400 == 0);
+    return m == 2 && leap ? 29 : kDays[m - 1];
+}
+
+// Parse exactly `count` digits starting at pos; advances pos on success
+bool read_digits(const std::string& s, size_t& pos, size_t count, int64_t& out) {
+    if (pos + count > s.size()) return false;
+    int64_t v = 0;
+    for (size_t i = 0; i < count; ++i) {
+        char c = s[pos + i];
+        if (c < '0' || c > '9') return false;
+        v = v * 10 + (c - '0');
+    }
+    out = v;
+    pos += count;
+    return true;
+}
+
+} // namespace
+
+bool parse_datetime(const std::string& str, int64_t& out_ns) {
+    size_t first = str.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos) return false;
+    size_t last = str.find_last_not_of(" \t\r\n");
+    const std::string s = str.substr(first, last - first + 1);
+
+    size_t pos = 0;
+    int64_t year = 0, month = 0, day = 0;
+    if (!read_digits(s, pos, 4, year)) return false;
+    if (pos >= s.size() || (s[pos] != '-' && s[pos] != '/')) return false;
+    ++pos;
+    if (!read_digits(s, pos, 2, month)) return false;
+    if (pos >= s.size() || (s[pos] != '-' && s[pos] != '/')) return false;
+    ++pos;
+    if (!read_digits(s, pos, 2, day)) return false;
+    if (month < 1 || month > 12 || day < 1 ||
+        day > days_in_month(year, static_cast<unsigned>(month))) {
+        return false;
+    }
+
+    int64_t hour = 0, minute = 0, second = 0, frac_ns = 0;
+    if (pos < s.size()) {
+        if (s[pos] != ' ' && s[pos] != 'T') return false;
+        ++pos;
+        if (!read_digits(s, pos, 2, hour)) return false;
+        if (pos >= s.size() || s[pos] != ':') return false;
+        ++pos;
+        if (!read_digits(s, pos, 2, minute)) return false;
+        if (pos < s.size() && s[pos] == ':') {
+            ++pos;
+            if (!read_digits(s, pos, 2, second)) return false;
+            if (pos < s.size() && s[pos] == '.') {
+                ++pos;
+                int64_t scale = 100000000LL;
+                size_t digits = 0;
+                while (pos < s.size() && s[pos] >= '0' && s[pos] <= '9') {
+                    if (digits < 9) {
+                        frac_ns += (s[pos] - '0') * scale;
+                        scale /= 10;
+                    }
+                    ++digits;
+                    ++pos;
+                }
+                if (digits == 0) return false;
+            }
+        }
+        if (pos < s.size() && s[pos] == 'Z') ++pos;
+        if (pos != s.size()) return false;
+        if (hour > 23 || minute > 59 || second > 60) return false;
+    }
+
+    int64_t days = days_from_civil(year, static_cast<unsigned>(month), static_cast<unsigned>(day));
+    int64_t secs = days * kSecondsPerDay + hour * 3600 + minute * 60 + second;
+    // int64 nanoseconds span 1677-09-21 to 2262-04-11; reject instead of wrapping
+    if (secs < INT64_MIN / kNanosPerSecond || secs > (INT64_MAX - frac_ns) / kNanosPerSecond) {
+        return false;
+    }
+    out_ns = secs * kNanosPerSecond + frac_ns;
+    return true;
+}
+
+int64_t to_timestamp(const std::string& str) {
+    int64_t ns;
+    return parse_datetime(str, ns) ? ns : kInvalidTimestamp;
+}
+
+std::string format_datetime(int64_t ns) {
+    if (ns == kInvalidTimestamp) return "";
+
+    const int64_t secs = floor_div(ns, kNanosPerSecond);
+    const int64_t frac = ns - secs * kNanosPerSecond;
+    const int64_t days = floor_div(secs, kSecondsPerDay);
+    const int64_t sod = secs - days * kSecondsPerDay;
+
+    int64_t y;
+    unsigned m, d;
+    civil_from_days(days, y, m, d);
+
+    char buf[48];
+    if (sod == 0 && frac == 0) {
+        std::snprintf(buf, sizeof(buf), "%04lld-%02u-%02u",
+                      static_cast<long long>(y), m, d);
+    } else if (frac == 0) {
+        std::snprintf(buf, sizeof(buf), "%04lld-%02u-%02u %02lld:%02lld:%02lld",
+                      static_cast<long long>(y), m, d,
+                      static_cast<long long>(sod / 3600),
+                      static_cast<long long>((sod / 60) % 60),
+                      static_cast<long long>(sod % 60));
+    } else {
+        std::snprintf(buf, sizeof(buf), "%04lld-%02u-%02u %02lld:%02lld:%02lld.%09lld",
+                      static_cast<long long>(y), m, d,
+                      static_cast<long long>(sod / 3600),
+                      static_cast<long long>((sod / 60) % 60),
+                      static_cast<long long>(sod % 60),
+                      static_cast<long long>(frac));
+        // Trim trailing zeros of the fractional part
+        std::string out(buf);
+        while (out.back() == '0') out.pop_back();
+        return out;
+    }
+    return std::string(buf);
+}
+
+namespace {
+
+struct DurationUnit {
+    const char* suffix;
+    int64_t ns;
+};
+
+// Largest unit first so format_duration() picks the coarsest exact unit
+const DurationUnit kDurationUnits[] = {
+    {"w", 7 * kSecondsPerDay * kNanosPerSecond},
+    {"d", kSecondsPerDay * kNanosPerSecond},
+    {"h", 3600 * kNanosPerSecond},
+    {"m", 60 * kNanosPerSecond},
+    {"s", kNanosPerSecond},
+    {"ms", 1000000LL},
+};
+
+} // namespace
+
+bool parse_duration(const std::string& str, int64_t& out_ns) {
+    if (str.empty()) return false;
+
+    size_t digits = 0;
+    while (digits < str.size() && str[digits] >= '0' && str[digits] <= '9') ++digits;
+    if (digits == 0 || digits > 12) return false;
+
+    int64_t count = std::stoll(str.substr(0, digits));
+    std::string suffix = str.substr(digits);
+    int64_t unit = 0;
+    if (suffix.empty()) {
+        unit = kNanosPerSecond;
+    } else {
+        for (const auto& u : kDurationUnits) {
+            if (suffix == u.suffix) {
+                unit = u.ns;
+                break;
+            }
+        }
+    }
+    if (unit == 0 || count <= 0 || count > INT64_MAX / unit) return false;
+
+    out_ns = count * unit;
+    return true;
+}
+
+std::string format_duration(int64_t ns) {
+    if (ns <= 0) return std::to_string(ns) + "ns";
+
+    for (const auto& u : kDurationUnits) {
+        if (ns % u.ns == 0) {
+            return std::to_string(ns / u.ns) + u.suffix;
+        }
+    }
+    return std::to_string(ns) + "ns";
+}
+
+bool parse_session(const std::string& str, int64_t& open_ns, int64_t& close_ns) {
+    // HH:MM-HH:MM
+    size_t pos = 0;
+    int64_t open_h, open_m, close_h, close_m;
+    if (!read_digits(str, pos, 2, open_h) || pos >= str.size() || str[pos++] != ':' ||
+        !read_digits(str, pos, 2, open_m) || pos >= str.size() || str[pos++] != '-' ||
+        !read_digits(str, pos, 2, close_h) || pos >= str.size() || str[pos++] != ':' ||
+        !read_digits(str, pos, 2, close_m) || pos != str.size()) {
+        return false;
+    }
+    if (open_m > 59 || close_m > 59) return false;
+
+    const int64_t minute = 60 * kNanosPerSecond;
+    int64_t open = (open_h * 60 + open_m) * minute;
+    int64_t close = (close_h * 60 + close_m) * minute;
+    if (open >= close || close > kSecondsPerDay * kNanosPerSecond) return false;
+
+    open_ns = open;
+    close_ns = close;
+    return true;
+}
+
+} // namespace tsproc
@@ -0,0 +1,267 @@
+#include "downsample.hpp"
+#include "datetime.hpp"
+#include "scheduler.hpp"
+#include "trace.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace tsproc {
+namespace downsample {
+
+namespace {
+
+// Below this many rows the work is too small to be worth splitting
+constexpr size_t kParallelMinRows = 1 << 16;
+
+size_t resolve_threads(size_t threads, size_t rows, size_t tasks) {
+    if (rows < kParallelMinRows) return 1;
+    if (threads == 0) {
+        threads = exec::Scheduler::global().concurrency();
+    }
+    return std::max<size_t>(1, std::min(threads, tasks));
+}
+
+// Run fn(begin, end) over [0, count) split into `threads` contiguous ranges
+template <typename Fn>
+void parallel_ranges(size_t count, size_t threads, Fn fn) {
+    if (threads <= 1 || count <= 1) {
+        fn(size_t(0), count);
+        return;
+    }
+
+    auto traced = [&fn](size_t begin, size_t end) {
+        tracing::Span span("downsample", "range", static_cast<int64_t>(begin),
+                           static_cast<int64_t>(end - begin));
+        fn(begin, end);
+    };
+    exec::TaskGroup group;
+    const size_t nodes = group.scheduler().node_count();
+    size_t chunk = (count + threads - 1) / threads;
+    for (size_t t = 1; t < threads; ++t) {
+        size_t begin = std::min(count, t * chunk);
+        size_t end = std::min(count, begin + chunk);
+        if (begin < end) {
+            group.spawn([&traced, begin, end] { traced(begin, end); },
+                        static_cast<long>(numa::node_for(begin, count, nodes)));
+        }
+    }
+    traced(size_t(0), std::min(count, chunk));
+    tracing::Span wait("downsample", "join_wait");
+    group.wait();
+}
+
+bool is_ohlcv(const std::string& col) {
+    return col == "open" || col == "high" || col == "low" || col == "close" ||
+           col == "adj_close" || col == "volume";
+}
+
+} // namespace
+
+std::vector<double> column_values(const TimeSeries& ts, const std::string& col) {
+    if (is_ohlcv(col)) {
+        return ts.get_column(col);
+    }
+
+    std::vector<double> out;
+    out.reserve(ts.size());
+    for (const auto& r : ts) {
+        auto it = r.indicators.find(col);
+        out.push_back(it != r.indicators.end() ? it->second : NAN);
+    }
+    return out;
+}
+
+std::vector<size_t> lttb_indices(const std::vector<double>& x, const std::vector<double>& y,
+                                 size_t threshold, size_t threads) {
+    if (x.size() != y.size()) {
+        throw std::invalid_argument("lttb: x and y must have the same length");
+    }
+
+    const size_t n = y.size();
+    std::vector<size_t> out;
+    if (threshold >= n || threshold < 3) {
+        if (threshold >= n || threshold == 0) {
+            out.resize(n);
+            for (size_t i = 0; i < n; ++i) out[i] = i;
+        } else {
+            // Degenerate request: just the end points
+            out.push_back(0);
+            if (threshold == 2 && n > 1) out.push_back(n - 1);
+        }
+        return out;
+    }
+
+    const size_t inner = threshold - 2;
+    const double every = static_cast<double>(n - 2) / static_cast<double>(inner);
+
+    auto bucket_begin = [&](size_t b) { return static_cast<size_t>(std::floor(b * every)) + 1; };
+    auto bucket_end = [&](size_t b) {
+        return std::min(n - 1, static_cast<size_t>(std::floor((b + 1) * every)) + 1);
+    };
+
+    // Average point of every bucket, plus the virtual bucket `inner` holding
+    // the last point. valid[b] is false when bucket b is all NaN.
+    std::vector<double> cx(inner + 1), cy(inner + 1);
+    std::vector<char> valid(inner + 1, 1);
+    cx[inner] = x[n - 1];
+    cy[inner] = y[n - 1];
+    parallel_ranges(inner, resolve_threads(threads, n, inner), [&](size_t begin, size_t end) {
+        for (size_t b = begin; b < end; ++b) {
+            double sx = 0.0, sy = 0.0;
+            size_t cnt = 0;
+            for (size_t j = bucket_begin(b); j < bucket_end(b); ++j) {
+                if (std::isnan(y[j])) continue;
+                sx += x[j];
+                sy += y[j];
+                ++cnt;
+            }
+            valid[b] = cnt > 0;
+            cx[b] = cnt > 0 ? sx / static_cast<double>(cnt) : NAN;
+            cy[b] = cnt > 0 ? sy / static_cast<double>(cnt) : NAN;
+        }
+    });
+
+    // An all-NaN bucket borrows the centroid of the next bucket with data
+    std::vector<double> next_x = cx, next_y = cy;
+    for (size_t b = inner; b-- > 0;) {
+        if (!valid[b]) {
+            next_x[b] = next_x[b + 1];
+            next_y[b] = next_y[b + 1];
+        }
+    }
+
+    // Ranges of buckets anchored independently. Each spans about
+    // kParallelMinRows input rows, so the split depends only on n and
+    // threshold and smaller inputs run as a single sequential range.
+    const size_t range_buckets =
+        std::max<size_t>(1, static_cast<size_t>(static_cast<double>(kParallelMinRows) / every));
+    const size_t ranges = (inner + range_buckets - 1) / range_buckets;
+
+    std::vector<size_t> selected(inner);
+    parallel_ranges(ranges, resolve_threads(threads, n, ranges), [&](size_t range_begin,
+                                                                      size_t range_end) {
+        for (size_t r = range_begin; r < range_end; ++r) {
+            const size_t begin = r * range_buckets;
+            const size_t end = std::min(inner, begin + range_buckets);
+
+            // The first range starts from the first point; later ones from the
+            // centroid of the nearest preceding bucket with data
+            double ax = x[0], ay = y[0];
+            for (size_t b = begin; b-- > 0;) {
+                if (valid[b]) {
+                    ax = cx[b];
+                    ay = cy[b];
+                    break;
+                }
+            }
+
+            for (size_t b = begin; b < end; ++b) {
+                const double nx = next_x[b + 1];
+                const double ny = next_y[b + 1];
+
+                size_t best = bucket_begin(b);
+                double best_area = -1.0;
+                for (size_t j = bucket_begin(b); j < bucket_end(b); ++j) {
+                    if (std::isnan(y[j])) continue;
+                    double area = std::abs((ax - nx) * (y[j] - ay) - (ax - x[j]) * (ny - ay));
+                    if (area > best_area) {
+                        best_area = area;
+                        best = j;
+                    }
+                }
+
+                selected[b] = best;
+                if (valid[b]) {
+                    ax = x[best];
+                    ay = y[best];
+                }
+            }
+        }
+    });
+
+    out.reserve(threshold);
+    out.push_back(0);
+    out.insert(out.end(), selected.begin(), selected.end());
+    out.push_back(n - 1);
+    return out;
+}
+
+std::vector<size_t> minmax_indices(const std::vector<double>& y, size_t buckets, size_t threads) {
+    const size_t n = y.size();
+    std::vector<size_t> out;
+    if (n == 0 || buckets == 0) return out;
+    if (buckets * 4 >= n) {
+        out.resize(n);
+        for (size_t i = 0; i < n; ++i) out[i] = i;
+        return out;
+    }
+
+    // Four slots per bucket: first, min, max, last
+    std::vector<size_t> picks(buckets * 4);
+    size_t nthreads = resolve_threads(threads, n, buckets);
+
+    parallel_ranges(buckets, nthreads, [&](size_t begin, size_t end) {
+        for (size_t b = begin; b < end; ++b) {
+            size_t lo = b * n / buckets;
+            size_t hi = (b + 1) * n / buckets;
+            size_t imin = lo, imax = lo;
+            double vmin = INFINITY, vmax = -INFINITY;
+            for (size_t j = lo; j < hi; ++j) {
+                double v = y[j];
+                if (v < vmin) { vmin = v; imin = j; }
+                if (v > vmax) { vmax = v; imax = j; }
+            }
+            size_t* slot = &picks[b * 4];
+            slot[0] = lo;
+            slot[1] = std::min(imin, imax);
+            slot[2] = std::max(imin, imax);
+            slot[3] = hi - 1;
+        }
+    });
+
+    // Slots are ascending within a bucket and buckets are ordered, so only
+    // adjacent duplicates need removing
+    out.reserve(picks.size());
+    for (size_t idx : picks) {
+        if (out.empty() || out.back() != idx) out.push_back(idx);
+    }
+    return out;
+}
+
+TimeSeries select_rows(const TimeSeries& ts, const std::vector<size_t>& indices) {
+    TimeSeries out;
+    out.reserve(indices.size());
+    for (size_t i : indices) {
+        out.push(ts[i]);
+    }
+    return out;
+}
+
+TimeSeries lttb(const TimeSeries& ts, size_t threshold, const std::string& col, size_t threads) {
+    std::vector<double> y = column_values(ts, col);
+    std::vector<double> x(ts.size());
+
+    bool all_valid = true;
+    for (size_t i = 0; i < ts.size(); ++i) {
+        int64_t t = to_timestamp(ts[i].date);
+        if (t == kInvalidTimestamp) {
+            all_valid = false;
+            break;
+        }
+        x[i] = static_cast<double>(t);
+    }
+    if (!all_valid) {
+        for (size_t i = 0; i < x.size(); ++i) x[i] = static_cast<double>(i);
+    }
+
+    return select_rows(ts, lttb_indices(x, y, threshold, threads));
+}
+
+TimeSeries minmax(const TimeSeries& ts, size_t buckets, const std::string& col, size_t threads) {
+    std::vector<double> y = column_values(ts, col);
+    return select_rows(ts, minmax_indices(y, buckets, threads));
+}
+
+} // namespace downsample
+} // namespace tsproc
@@ -0,0 +1,82 @@
+#include "duplicates.hpp"
+#include "datetime.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace tsproc {
+
+DuplicatePolicy parse_duplicate_policy(const std::string& name) {
+    if (name == "keep") return DuplicatePolicy::KeepAll;
+    if (name == "first") return DuplicatePolicy::KeepFirst;
+    if (name == "last") return DuplicatePolicy::KeepLast;
+    if (name == "aggregate") return DuplicatePolicy::Aggregate;
+    throw std::invalid_argument("Unknown duplicate policy: " + name);
+}
+
+DuplicateResolver::DuplicateResolver(TimeSeries& out, DuplicatePolicy policy)
+    : out_(out), policy_(policy), last_ns_(kInvalidTimestamp) {}
+
+void DuplicateResolver::push(const Record& record) {
+    push(record, policy_ == DuplicatePolicy::KeepAll ? kInvalidTimestamp : to_timestamp(record.date));
+}
+
+void DuplicateResolver::push(const Record& record, int64_t ts_ns) {
+    if (policy_ == DuplicatePolicy::KeepAll || ts_ns == kInvalidTimestamp) {
+        out_.push(record);
+        return;
+    }
+
+    if (sorted_) {
+        if (last_ns_ != kInvalidTimestamp && ts_ns == last_ns_) {
+            ++duplicates_;
+            merge(out_[out_.size() - 1], record);
+            return;
+        }
+        if (last_ns_ == kInvalidTimestamp || ts_ns > last_ns_) {
+            last_ns_ = ts_ns;
+            out_.push(record);
+            return;
+        }
+        switch_to_hash();
+    }
+
+    auto it = rows_by_ts_.find(ts_ns);
+    if (it != rows_by_ts_.end()) {
+        ++duplicates_;
+        merge(out_[it->second], record);
+        return;
+    }
+    rows_by_ts_.emplace(ts_ns, out_.size());
+    out_.push(record);
+}
+
+void DuplicateResolver::switch_to_hash() {
+    sorted_ = false;
+    rows_by_ts_.reserve(out_.size() * 2);
+    for (size_t i = 0; i < out_.size(); ++i) {
+        int64_t t = to_timestamp(out_[i].date);
+        if (t != kInvalidTimestamp) {
+            rows_by_ts_.emplace(t, i);
+        }
+    }
+}
+
+void DuplicateResolver::merge(Record& kept, const Record& incoming) const {
+    switch (policy_) {
+        case DuplicatePolicy::KeepAll:
+        case DuplicatePolicy::KeepFirst:
+            break;
+        case DuplicatePolicy::KeepLast:
+            kept = incoming;
+            break;
+        case DuplicatePolicy::Aggregate:
+            kept.high = std::max(kept.high, incoming.high);
+            kept.low = std::min(kept.low, incoming.low);
+            kept.close = incoming.close;
+            kept.adj_close = incoming.adj_close;
+            kept.volume += incoming.volume;
+            break;
+    }
+}
+
+} // namespace tsproc
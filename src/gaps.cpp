@@ -0,0 +1,239 @@
+#include "gaps.hpp"
+#include "datetime.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+namespace tsproc {
+namespace gaps {
+
+namespace {
+
+void validate(const Calendar& calendar) {
+    if (calendar.frequency_ns <= 0) {
+        throw std::invalid_argument("Gap detection requires a positive frequency");
+    }
+    if (calendar.session_open_ns < 0 || calendar.session_close_ns > kDayNs ||
+        calendar.session_open_ns >= calendar.session_close_ns) {
+        throw std::invalid_argument("Session must satisfy 0 <= open < close <= 24h");
+    }
+}
+
+// Expected slots strictly between grid slots a and b, counted per day
+size_t count_between(const Calendar& calendar, int64_t a, int64_t b) {
+    const int64_t freq = calendar.frequency_ns;
+    size_t count = 0;
+    int64_t s = calendar.next_slot(a);
+    while (s < b) {
+        int64_t day_close = floor_div(s, kDayNs) * kDayNs + calendar.session_close_ns;
+        int64_t limit = std::min(day_close, b);
+        int64_t n = (limit - s + freq - 1) / freq;
+        count += static_cast<size_t>(n);
+        if (b <= day_close) break;
+        s = calendar.next_slot(s + (n - 1) * freq);
+    }
+    return count;
+}
+
+Record filled_row(int64_t slot, const Record& prev, const Record& next, double weight,
+                  FillMethod method) {
+    Record r;
+    r.date = format_datetime(slot);
+    switch (method) {
+        case FillMethod::ForwardFill:
+            r.open = r.high = r.low = r.close = prev.close;
+            r.adj_close = prev.adj_close;
+            r.volume = 0.0;
+            break;
+        case FillMethod::NaN:
+            r.open = r.high = r.low = r.close = r.adj_close = r.volume = NAN;
+            break;
+        case FillMethod::Linear: {
+            auto lerp = [weight](double x, double y) { return x + (y - x) * weight; };
+            r.open = lerp(prev.close, next.open);
+            r.close = lerp(prev.close, next.open);
+            r.high = r.close;
+            r.low = r.close;
+            r.adj_close = lerp(prev.adj_close, next.adj_close);
+            r.volume = 0.0;
+            break;
+        }
+    }
+    return r;
+}
+
+} // namespace
+
+bool Calendar::is_trading_day(int64_t day_index) const {
+    if (weekdays_only) {
+        // 1970-01-01 was a Thursday; 0 = Sunday, 6 = Saturday
+        int64_t dow = ((day_index + 4) % 7 + 7) % 7;
+        if (dow == 0 || dow == 6) return false;
+    }
+    for (int64_t h : holidays) {
+        if (floor_div(h, kDayNs) == day_index) return false;
+    }
+    return true;
+}
+
+int64_t Calendar::next_slot(int64_t slot_ns) const {
+    int64_t n = slot_ns + frequency_ns;
+    int64_t day = floor_div(n, kDayNs);
+    int64_t tod = n - day * kDayNs;
+    if (tod < session_open_ns) {
+        n = day * kDayNs + session_open_ns;
+    } else if (tod >= session_close_ns) {
+        ++day;
+        n = day * kDayNs + session_open_ns;
+    }
+    while (!is_trading_day(day)) {
+        ++day;
+        n = day * kDayNs + session_open_ns;
+    }
+    return n;
+}
+
+int64_t Calendar::slot_of(int64_t ns) const {
+    int64_t day = floor_div(ns, kDayNs);
+    int64_t tod = ns - day * kDayNs;
+    return day * kDayNs + session_open_ns +
+           floor_div(tod - session_open_ns, frequency_ns) * frequency_ns;
+}
+
+FillMethod parse_fill_method(const std::string& name) {
+    if (name == "ffill") return FillMethod::ForwardFill;
+    if (name == "nan") return FillMethod::NaN;
+    if (name == "linear") return FillMethod::Linear;
+    throw std::invalid_argument("Unknown gap fill method: " + name);
+}
+
+std::vector<int64_t> timestamps(const TimeSeries& ts) {
+    std::vector<int64_t> out;
+    out.reserve(ts.size());
+    for (const auto& r : ts) {
+        out.push_back(to_timestamp(r.date));
+    }
+    return out;
+}
+
+int64_t infer_frequency(const std::vector<int64_t>& ts_ns) {
+    std::vector<int64_t> diffs;
+    diffs.reserve(ts_ns.size());
+    int64_t prev = kInvalidTimestamp;
+    for (int64_t t : ts_ns) {
+        if (t == kInvalidTimestamp) continue;
+        if (prev != kInvalidTimestamp && t > prev) diffs.push_back(t - prev);
+        prev = t;
+    }
+    if (diffs.empty()) return 0;
+
+    std::sort(diffs.begin(), diffs.end());
+    int64_t best = diffs[0];
+    size_t best_run = 0;
+    for (size_t i = 0; i < diffs.size();) {
+        size_t j = i;
+        while (j < diffs.size() && diffs[j] == diffs[i]) ++j;
+        if (j - i > best_run) {
+            best_run = j - i;
+            best = diffs[i];
+        }
+        i = j;
+    }
+    return best;
+}
+
+std::vector<Gap> detect(const std::vector<int64_t>& ts_ns, const Calendar& calendar) {
+    validate(calendar);
+    std::vector<Gap> result;
+    const size_t n = ts_ns.size();
+
+    auto first_valid = std::find_if(ts_ns.begin(), ts_ns.end(),
+                                    [](int64_t t) { return t != kInvalidTimestamp; });
+    if (first_valid == ts_ns.end()) return result;
+
+    // Grid slot per row; invalid rows repeat the previous slot so they
+    // never open a gap and the next valid row compares against the last one
+    std::vector<int64_t> slots(n);
+    std::vector<size_t> last_valid(n);
+    int64_t carry = calendar.slot_of(*first_valid);
+    size_t carry_row = static_cast<size_t>(first_valid - ts_ns.begin());
+    for (size_t i = 0; i < n; ++i) {
+        if (ts_ns[i] != kInvalidTimestamp) {
+            carry = calendar.slot_of(ts_ns[i]);
+            carry_row = i;
+        }
+        slots[i] = carry;
+        last_valid[i] = carry_row;
+    }
+
+    // Branch-free candidate pass: a step larger than one slot may be a gap
+    const int64_t freq = calendar.frequency_ns;
+    std::vector<uint8_t> candidate(n, 0);
+    for (size_t i = 1; i < n; ++i) {
+        candidate[i] = static_cast<uint8_t>(slots[i] - slots[i - 1] > freq);
+    }
+
+    for (size_t i = 1; i < n; ++i) {
+        if (!candidate[i]) continue;
+        size_t missing = count_between(calendar, slots[i - 1], slots[i]);
+        if (missing > 0) {
+            size_t prev = last_valid[i - 1];
+            result.push_back({prev, i, ts_ns[prev], calendar.next_slot(slots[i - 1]),
+                              ts_ns[i], missing});
+        }
+    }
+    return result;
+}
+
+std::vector<Gap> detect(const TimeSeries& ts, const Calendar& calendar) {
+    return detect(timestamps(ts), calendar);
+}
+
+size_t total_missing(const std::vector<Gap>& gaps) {
+    size_t total = 0;
+    for (const auto& g : gaps) total += g.missing;
+    return total;
+}
+
+TimeSeries fill(const TimeSeries& ts, const std::vector<Gap>& gaps, const Calendar& calendar,
+                FillMethod method) {
+    validate(calendar);
+    TimeSeries out;
+    out.reserve(ts.size() + total_missing(gaps));
+
+    size_t g = 0;
+    for (size_t i = 0; i < ts.size(); ++i) {
+        if (g < gaps.size() && gaps[g].row == i) {
+            const Gap& gap = gaps[g++];
+            double span = static_cast<double>(gap.end_ns - gap.prev_ns);
+            int64_t slot = gap.start_ns;
+            for (size_t k = 0; k < gap.missing; ++k) {
+                double weight = static_cast<double>(slot - gap.prev_ns) / span;
+                out.push(filled_row(slot, ts[gap.prev_row], ts[i], weight, method));
+                slot = calendar.next_slot(slot);
+            }
+        }
+        out.push(ts[i]);
+    }
+    return out;
+}
+
+bool write_report(const std::string& path, const std::vector<Gap>& gaps) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file for writing: " << path << std::endl;
+        return false;
+    }
+
+    file << "row,start,end,missing\n";
+    for (const auto& g : gaps) {
+        file << g.row << "," << format_datetime(g.start_ns) << "," << format_datetime(g.end_ns)
+             << "," << g.missing << "\n";
+    }
+    return file.good();
+}
+
+} // namespace gaps
+} // namespace tsproc
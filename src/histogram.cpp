@@ -0,0 +1,94 @@
+#include "histogram.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace tsproc {
+
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+void LatencyHistogram::reset() {
+    for (auto& c : counts_) c.store(0, std::memory_order_relaxed);
+    count_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    min_.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        uint64_t c = other.counts_[i].load(std::memory_order_relaxed);
+        if (c != 0) counts_[i].fetch_add(c, std::memory_order_relaxed);
+    }
+    count_.fetch_add(other.count_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    sum_.fetch_add(other.sum_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    update_min(other.min_.load(std::memory_order_relaxed));
+    update_max(other.max_.load(std::memory_order_relaxed));
+}
+
+uint64_t LatencyHistogram::bucket_upper(size_t index) {
+    if (index < kSubBuckets) return index;
+    const size_t k = index - kSubBuckets;
+    const int shift = static_cast<int>(k / kHalfSubBuckets) + 1;
+    const uint64_t mantissa = k % kHalfSubBuckets + kHalfSubBuckets;
+    // Wraps to UINT64_MAX for the very last bucket, which is the right answer
+    return ((mantissa + 1) << shift) - 1;
+}
+
+double LatencyHistogram::percentile(double q) const {
+    const uint64_t total = count();
+    if (total == 0) return 0.0;
+    q = std::min(std::max(q, 0.0), 1.0);
+
+    // Same nearest-rank definition the sorted-vector version used
+    uint64_t rank = static_cast<uint64_t>(std::ceil(q * static_cast<double>(total)));
+    rank = std::max<uint64_t>(rank, 1);
+
+    const uint64_t max = max_.load(std::memory_order_relaxed);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        seen += counts_[i].load(std::memory_order_relaxed);
+        if (seen >= rank) return static_cast<double>(std::min(bucket_upper(i), max));
+    }
+    return static_cast<double>(max);
+}
+
+LatencyStats LatencyHistogram::stats() const {
+    LatencyStats stats;
+    stats.count = count();
+    if (stats.count == 0) return stats;
+
+    stats.min_ns = static_cast<double>(min_.load(std::memory_order_relaxed));
+    stats.max_ns = static_cast<double>(max_.load(std::memory_order_relaxed));
+    stats.mean_ns = static_cast<double>(sum_.load(std::memory_order_relaxed)) /
+                    static_cast<double>(stats.count);
+    stats.p50_ns = percentile(0.50);
+    stats.p90_ns = percentile(0.90);
+    stats.p99_ns = percentile(0.99);
+    stats.p999_ns = percentile(0.999);
+    stats.p9999_ns = percentile(0.9999);
+    return stats;
+}
+
+void write_latency_json(std::ostream& os,
+                        const std::vector<std::pair<std::string, LatencyStats>>& entries) {
+    os << "{";
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const LatencyStats& s = entries[i].second;
+        os << (i ? ",\n" : "\n") << "  \"" << entries[i].first << "\": {"
+           << "\"count\": " << s.count
+           << ", \"min_ns\": " << s.min_ns
+           << ", \"mean_ns\": " << s.mean_ns
+           << ", \"p50_ns\": " << s.p50_ns
+           << ", \"p90_ns\": " << s.p90_ns
+           << ", \"p99_ns\": " << s.p99_ns
+           << ", \"p999_ns\": " << s.p999_ns
+           << ", \"p9999_ns\": " << s.p9999_ns
+           << ", \"max_ns\": " << s.max_ns << "}";
+    }
+    os << "\n}\n";
+}
+
+} // namespace tsproc
@@ -1,7 +1,11 @@
 #include "indicators.hpp"
-#include <deque>
+#include "column_buffer.hpp"
+#include "profiler.hpp"
+#include "kernels.hpp"
+#include "scheduler.hpp"
 #include <cmath>
 #include <stdexcept>
+#include <vector>
 
 namespace tsproc {
 namespace indicators {
@@ -13,74 +17,91 @@ double get_column_value(const Record& r, const std::string& col) {
     if (col == "close") return r.close;
     if (col == "adj_close") return r.adj_close;
     if (col == "volume") return r.volume;
+    auto it = r.indicators.find(col);
+    if (it != r.indicators.end()) return it->second;
     throw std::invalid_argument("Unknown column: " + col);
 }
 
+namespace {
+
+// Rows per scheduler task when touching Records; each task owns whole rows,
+// so tasks never share an indicators map
+constexpr size_t kRowGrain = 1 << 14;
+
+template <typename Fn>
+void for_rows(size_t rows, Fn&& fn) {
+    exec::parallel_for(0, rows, kRowGrain, [&fn](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) fn(i);
+    });
+}
+
+// Copy one OHLCV column into a contiguous buffer for the kernels. The
+// kernels scan it serially on this thread, so its pages stay on this
+// thread's node (ColumnBuffer's default placement) even though the copy
+// itself runs in parallel.
+ColumnBuffer column(const TimeSeries& ts, const std::string& col) {
+    ColumnBuffer out(ts.size());
+    for_rows(ts.size(), [&](size_t i) { out[i] = get_column_value(ts[i], col); });
+    return out;
+}
+
+} // namespace
+
 void add_sma(TimeSeries& ts, size_t window, const std::string& col) {
+    profiling::Scope scope("sma", window, ts.size());
     if (ts.size() == 0 || window == 0) return;
     
-    std::deque<double> q;
-    double sum = 0.0;
-    std::string indicator_name = "SMA_" + std::to_string(window);
+    ColumnBuffer in = column(ts, col);
+    ColumnBuffer out(in.size());
+    kernels::rolling_mean(in.data(), in.size(), window, out.data());
     
-    for (size_t i = 0; i < ts.size(); ++i) {
-        double val = get_column_value(ts[i], col);
-        
-        q.push_back(val);
-        sum += val;
-        
-        if (q.size() > window) {
-            sum -= q.front();
-            q.pop_front();
-        }
-        
-        if (q.size() == window) {
-            double sma = sum / static_cast<double>(window);
-            ts[i].indicators[indicator_name] = sma;
-        } else {
-            ts[i].indicators[indicator_name] = NAN;
-        }
-    }
+    std::string indicator_name = "SMA_" + std::to_string(window);
+    for_rows(ts.size(), [&](size_t i) { ts[i].indicators[indicator_name] = out[i]; });
 }
 
 void add_roll_mean_std(TimeSeries& ts, size_t window, const std::string& col) {
+    profiling::Scope scope("roll_mean_std", window, ts.size());
     if (ts.size() == 0 || window == 0) return;
     
-    std::deque<double> q;
-    double sum = 0.0;
-    double sumsq = 0.0;
+    ColumnBuffer in = column(ts, col);
+    ColumnBuffer mean(in.size());
+    ColumnBuffer sd(in.size());
+    kernels::rolling_mean_std(in.data(), in.size(), window, mean.data(), sd.data());
+    
     std::string mean_name = "ROLL_MEAN_" + std::to_string(window);
     std::string std_name = "ROLL_STD_" + std::to_string(window);
+    for_rows(ts.size(), [&](size_t i) {
+        ts[i].indicators[mean_name] = mean[i];
+        ts[i].indicators[std_name] = sd[i];
+    });
+}
+
+void add_roll_moments(TimeSeries& ts, size_t window, const std::string& col) {
+    profiling::Scope scope("roll_moments", window, ts.size());
+    if (ts.size() == 0 || window == 0) return;
     
-    for (size_t i = 0; i < ts.size(); ++i) {
-        double v = get_column_value(ts[i], col);
-        
-        q.push_back(v);
-        sum += v;
-        sumsq += v * v;
-        
-        if (q.size() > window) {
-            double old = q.front();
-            q.pop_front();
-            sum -= old;
-            sumsq -= old * old;
-        }
-        
-        if (q.size() == window) {
-            double mean = sum / static_cast<double>(window);
-            double variance = (sumsq / static_cast<double>(window)) - (mean * mean);
-            double sd = (variance > 0) ? std::sqrt(variance) : 0.0;
-            
-            ts[i].indicators[mean_name] = mean;
-            ts[i].indicators[std_name] = sd;
-        } else {
-            ts[i].indicators[mean_name] = NAN;
-            ts[i].indicators[std_name] = NAN;
-        }
-    }
+    ColumnBuffer in = column(ts, col);
+    ColumnBuffer mean(in.size());
+    ColumnBuffer sd(in.size());
+    ColumnBuffer skew(in.size());
+    ColumnBuffer kurt(in.size());
+    kernels::rolling_moments(in.data(), in.size(), window, mean.data(), sd.data(), skew.data(),
+                             kurt.data());
+    
+    std::string mean_name = "ROLL_MEAN_" + std::to_string(window);
+    std::string std_name = "ROLL_STD_" + std::to_string(window);
+    std::string skew_name = "ROLL_SKEW_" + std::to_string(window);
+    std::string kurt_name = "ROLL_KURT_" + std::to_string(window);
+    for_rows(ts.size(), [&](size_t i) {
+        ts[i].indicators[mean_name] = mean[i];
+        ts[i].indicators[std_name] = sd[i];
+        ts[i].indicators[skew_name] = skew[i];
+        ts[i].indicators[kurt_name] = kurt[i];
+    });
 }
 
 void add_zscore(TimeSeries& ts, size_t window, const std::string& col) {
+    profiling::Scope scope("zscore", window, ts.size());
     if (ts.size() == 0 || window == 0) return;
     
     // First compute rolling mean and std if not already present
@@ -94,7 +115,7 @@ void add_zscore(TimeSeries& ts, size_t window, const std::string& col) {
     
     std::string zscore_name = "Z_" + std::to_string(window);
     
-    for (size_t i = 0; i < ts.size(); ++i) {
+    for_rows(ts.size(), [&](size_t i) {
         auto& indicators = ts[i].indicators;
         
         if (indicators.find(mean_name) != indicators.end() && 
@@ -113,60 +134,36 @@ void add_zscore(TimeSeries& ts, size_t window, const std::string& col) {
         } else {
             indicators[zscore_name] = NAN;
         }
-    }
+    });
 }
 
 void add_ema(TimeSeries& ts, size_t window, const std::string& col) {
+    profiling::Scope scope("ema", window, ts.size());
     if (ts.size() == 0 || window == 0) return;
     
-    double alpha = 2.0 / (static_cast<double>(window) + 1.0);
-    std::string indicator_name = "EMA_" + std::to_string(window);
-    
-    double ema = 0.0;
-    bool initialized = false;
+    ColumnBuffer in = column(ts, col);
+    ColumnBuffer out(in.size());
+    kernels::ema(in.data(), in.size(), window, out.data());
     
-    for (size_t i = 0; i < ts.size(); ++i) {
-        double val = get_column_value(ts[i], col);
-        
-        if (!initialized) {
-            ema = val;
-            initialized = true;
-        } else {
-            ema = alpha * val + (1.0 - alpha) * ema;
-        }
-        
-        ts[i].indicators[indicator_name] = ema;
-    }
+    std::string indicator_name = "EMA_" + std::to_string(window);
+    for_rows(ts.size(), [&](size_t i) { ts[i].indicators[indicator_name] = out[i]; });
 }
 
 void add_roll_sum(TimeSeries& ts, size_t window, const std::string& col) {
+    profiling::Scope scope("roll_sum", window, ts.size());
     if (ts.size() == 0 || window == 0) return;
     
-    std::deque<double> q;
-    double sum = 0.0;
-    std::string indicator_name = "ROLL_SUM_" + std::to_string(window);
+    ColumnBuffer in = column(ts, col);
+    ColumnBuffer out(in.size());
+    kernels::rolling_sum(in.data(), in.size(), window, out.data());
     
-    for (size_t i = 0; i < ts.size(); ++i) {
-        double val = get_column_value(ts[i], col);
-        
-        q.push_back(val);
-        sum += val;
-        
-        if (q.size() > window) {
-            sum -= q.front();
-            q.pop_front();
-        }
-        
-        if (q.size() == window) {
-            ts[i].indicators[indicator_name] = sum;
-        } else {
-            ts[i].indicators[indicator_name] = NAN;
-        }
-    }
+    std::string indicator_name = "ROLL_SUM_" + std::to_string(window);
+    for_rows(ts.size(), [&](size_t i) { ts[i].indicators[indicator_name] = out[i]; });
 }
 
 void add_volatility(TimeSeries& ts, size_t window, const std::string& col, 
                     double periods_per_year) {
+    profiling::Scope scope("volatility", window, ts.size());
     if (ts.size() == 0 || window == 0) return;
     
     // First compute rolling std if not present
@@ -179,7 +176,7 @@ void add_volatility(TimeSeries& ts, size_t window, const std::string& col,
     std::string vol_name = "VOL_" + std::to_string(window);
     double annualization_factor = std::sqrt(periods_per_year);
     
-    for (size_t i = 0; i < ts.size(); ++i) {
+    for_rows(ts.size(), [&](size_t i) {
         auto& indicators = ts[i].indicators;
         
         if (indicators.find(std_name) != indicators.end()) {
@@ -192,7 +189,37 @@ void add_volatility(TimeSeries& ts, size_t window, const std::string& col,
         } else {
             indicators[vol_name] = NAN;
         }
-    }
+    });
+}
+
+void add_range_volatility(TimeSeries& ts, size_t window, double periods_per_year) {
+    profiling::Scope scope("range_volatility", window, ts.size());
+    if (ts.size() == 0 || window == 0) return;
+    
+    ColumnBuffer open = column(ts, "open");
+    ColumnBuffer high = column(ts, "high");
+    ColumnBuffer low = column(ts, "low");
+    ColumnBuffer close = column(ts, "close");
+    ColumnBuffer park(ts.size());
+    ColumnBuffer gk(ts.size());
+    ColumnBuffer rs(ts.size());
+    ColumnBuffer yz(ts.size());
+    kernels::range_volatility(open.data(), high.data(), low.data(), close.data(), ts.size(), window,
+                              park.data(), gk.data(), rs.data(), yz.data());
+    
+    const std::string suffix = "_" + std::to_string(window);
+    const std::string park_name = "VOL_PARK" + suffix;
+    const std::string gk_name = "VOL_GK" + suffix;
+    const std::string rs_name = "VOL_RS" + suffix;
+    const std::string yz_name = "VOL_YZ" + suffix;
+    const double annualization_factor = std::sqrt(periods_per_year);
+    for_rows(ts.size(), [&](size_t i) {
+        auto& indicators = ts[i].indicators;
+        indicators[park_name] = park[i] * annualization_factor;
+        indicators[gk_name] = gk[i] * annualization_factor;
+        indicators[rs_name] = rs[i] * annualization_factor;
+        indicators[yz_name] = yz[i] * annualization_factor;
+    });
 }
 
 } // namespace indicators
@@ -1,9 +1,16 @@
 #include "io.hpp"
+#include "datetime.hpp"
+#include "pages.hpp"
+#include "scheduler.hpp"
+#include "trace.hpp"
 #include <fstream>
+#include <sstream>
 #include <iostream>
 #include <set>
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 
 namespace tsproc {
 
@@ -11,6 +18,13 @@ namespace tsproc {
 // CSVWriter Implementation
 // ============================================================================
 
+namespace {
+
+// Rows formatted per scheduler task by CSVWriter::write()
+constexpr size_t kWriteBlockRows = 8192;
+
+} // namespace
+
 CSVWriter::CSVWriter(const std::string& out_path) : out_path_(out_path) {}
 
 std::string CSVWriter::escape_csv_field(const std::string& field) const {
@@ -42,7 +56,33 @@ std::vector<std::string> CSVWriter::collect_indicator_names(const TimeSeries& ts
     return std::vector<std::string>(indicator_set.begin(), indicator_set.end());
 }
 
+void CSVWriter::write_row(std::ostream& out, const Record& r,
+                          const std::vector<std::string>& indicators) const {
+    out << escape_csv_field(r.date) << ","
+        << r.open << ","
+        << r.high << ","
+        << r.low << ","
+        << r.close << ","
+        << r.adj_close << ","
+        << r.volume << ","
+        << r.signal;
+    
+    // Write indicator values
+    for (const auto& ind_name : indicators) {
+        out << ",";
+        auto it = r.indicators.find(ind_name);
+        if (it != r.indicators.end() && !std::isnan(it->second)) {
+            out << it->second;
+        } else {
+            out << "NaN";
+        }
+    }
+    
+    out << "\n";
+}
+
 bool CSVWriter::write(const TimeSeries& ts, const std::vector<std::string>& extra_cols) {
+    tracing::Span span("io", "csv_write", -1, static_cast<int64_t>(ts.size()));
     std::ofstream file(out_path_);
     
     if (!file.is_open()) {
@@ -65,33 +105,30 @@ bool CSVWriter::write(const TimeSeries& ts, const std::vector<std::string>& extr
     }
     file << "\n";
 
-    // Write data rows
-    for (size_t i = 0; i < ts.size(); ++i) {
-        const Record& r = ts[i];
-        
-        file << escape_csv_field(r.date) << ","
-             << r.open << ","
-             << r.high << ","
-             << r.low << ","
-             << r.close << ","
-             << r.adj_close << ","
-             << r.volume << ","
-             << r.signal;
-        
-        // Write indicator values
-        for (const auto& ind_name : indicators) {
-            file << ",";
-            auto it = r.indicators.find(ind_name);
-            if (it != r.indicators.end() && !std::isnan(it->second)) {
-                file << it->second;
-            } else {
-                file << "NaN";
+    // Format blocks of rows in parallel, then write them in file order. A
+    // wave holds a few blocks per thread, which bounds the buffered output.
+    const size_t wave_blocks = 4 * exec::Scheduler::global().concurrency();
+    std::vector<std::string> blocks(wave_blocks);
+    for (size_t wave = 0; wave < ts.size(); wave += wave_blocks * kWriteBlockRows) {
+        const size_t count = std::min(wave_blocks,
+                                      (ts.size() - wave + kWriteBlockRows - 1) / kWriteBlockRows);
+        exec::parallel_for(0, count, 1, [&](size_t first, size_t last) {
+            for (size_t b = first; b < last; ++b) {
+                const size_t begin = wave + b * kWriteBlockRows;
+                const size_t end = std::min(ts.size(), begin + kWriteBlockRows);
+                std::ostringstream out;
+                for (size_t i = begin; i < end; ++i) {
+                    write_row(out, ts[i], indicators);
+                }
+                blocks[b] = out.str();
             }
+        });
+        for (size_t b = 0; b < count; ++b) {
+            file.write(blocks[b].data(), static_cast<std::streamsize>(blocks[b].size()));
         }
-        
-        file << "\n";
     }
 
+    tracing::Span flush("io", "flush");
     file.close();
     return true;
 }
@@ -144,6 +181,101 @@ bool CSVWriter::write_columns(const TimeSeries& ts, const std::vector<std::strin
     return true;
 }
 
+// ============================================================================
+// Binary format helpers
+// ============================================================================
+
+namespace {
+
+constexpr uint64_t kBinaryColumns = 8;        // timestamp + OHLCV + signal
+constexpr uint64_t kLegacyBinaryColumns = 7;  // OHLCV + signal, no timestamp
+constexpr std::streamoff kBinaryHeaderBytes = 2 * sizeof(uint64_t);
+
+void write_binary_row(std::ostream& file, const Record& r) {
+    // Timestamp as int64 nanoseconds since epoch
+    int64_t timestamp = to_timestamp(r.date);
+    file.write(reinterpret_cast<const char*>(&timestamp), sizeof(timestamp));
+    
+    // OHLCV data as doubles
+    file.write(reinterpret_cast<const char*>(&r.open), sizeof(double));
+    file.write(reinterpret_cast<const char*>(&r.high), sizeof(double));
+    file.write(reinterpret_cast<const char*>(&r.low), sizeof(double));
+    file.write(reinterpret_cast<const char*>(&r.close), sizeof(double));
+    file.write(reinterpret_cast<const char*>(&r.adj_close), sizeof(double));
+    file.write(reinterpret_cast<const char*>(&r.volume), sizeof(double));
+    
+    // Signal as double
+    double signal_d = static_cast<double>(r.signal);
+    file.write(reinterpret_cast<const char*>(&signal_d), sizeof(double));
+}
+
+void read_binary_row(std::istream& file, bool has_timestamp, Record& r) {
+    if (has_timestamp) {
+        int64_t timestamp;
+        file.read(reinterpret_cast<char*>(&timestamp), sizeof(timestamp));
+        r.date = format_datetime(timestamp);
+    }
+    
+    file.read(reinterpret_cast<char*>(&r.open), sizeof(double));
+    file.read(reinterpret_cast<char*>(&r.high), sizeof(double));
+    file.read(reinterpret_cast<char*>(&r.low), sizeof(double));
+    file.read(reinterpret_cast<char*>(&r.close), sizeof(double));
+    file.read(reinterpret_cast<char*>(&r.adj_close), sizeof(double));
+    file.read(reinterpret_cast<char*>(&r.volume), sizeof(double));
+    
+    double signal_d;
+    file.read(reinterpret_cast<char*>(&signal_d), sizeof(double));
+    r.signal = static_cast<int>(signal_d);
+}
+
+bool read_binary_header(std::istream& file, uint64_t& num_rows, uint64_t& num_cols) {
+    file.read(reinterpret_cast<char*>(&num_rows), sizeof(num_rows));
+    file.read(reinterpret_cast<char*>(&num_cols), sizeof(num_cols));
+    return file.good() && (num_cols == kBinaryColumns || num_cols == kLegacyBinaryColumns);
+}
+
+// Same row layout, decoded from a mapped file
+void read_binary_row(const char* row, bool has_timestamp, Record& r) {
+    auto next = [&row](void* out) {
+        std::memcpy(out, row, sizeof(double));
+        row += sizeof(double);
+    };
+    if (has_timestamp) {
+        int64_t timestamp;
+        next(&timestamp);
+        r.date = format_datetime(timestamp);
+    }
+    next(&r.open);
+    next(&r.high);
+    next(&r.low);
+    next(&r.close);
+    next(&r.adj_close);
+    next(&r.volume);
+    double signal_d;
+    next(&signal_d);
+    r.signal = static_cast<int>(signal_d);
+}
+
+// Header of a mapped file. num_rows is clamped to the rows actually present,
+// so a truncated file reads like the stream path, which stops at EOF.
+bool read_binary_header(const pages::MappedFile& file, uint64_t& num_rows, uint64_t& num_cols) {
+    if (file.size() < static_cast<size_t>(kBinaryHeaderBytes)) return false;
+    std::memcpy(&num_rows, file.data(), sizeof(num_rows));
+    std::memcpy(&num_cols, file.data() + sizeof(num_rows), sizeof(num_cols));
+    if (num_cols != kBinaryColumns && num_cols != kLegacyBinaryColumns) return false;
+    const uint64_t present = (file.size() - kBinaryHeaderBytes) / (num_cols * sizeof(double));
+    num_rows = std::min(num_rows, present);
+    return true;
+}
+
+} // namespace
+
+bool is_binary_path(const std::string& path) {
+    const std::string suffix = ".bin";
+    return path.size() >= suffix.size() &&
+           path.compare(path.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
 // ============================================================================
 // BinaryWriter Implementation
 // ============================================================================
@@ -151,6 +283,7 @@ bool CSVWriter::write_columns(const TimeSeries& ts, const std::vector<std::strin
 BinaryWriter::BinaryWriter(const std::string& out_path) : out_path_(out_path) {}
 
 bool BinaryWriter::write(const TimeSeries& ts, bool include_indicators) {
+    tracing::Span span("io", "binary_write", -1, static_cast<int64_t>(ts.size()));
     std::ofstream file(out_path_, std::ios::binary);
     
     if (!file.is_open()) {
@@ -160,32 +293,92 @@ bool BinaryWriter::write(const TimeSeries& ts, bool include_indicators) {
 
     // Write dimensions
     uint64_t num_rows = ts.size();
-    uint64_t num_cols = 7;  // OHLCV + date (as index) + signal
+    uint64_t num_cols = kBinaryColumns;
     
     file.write(reinterpret_cast<const char*>(&num_rows), sizeof(num_rows));
     file.write(reinterpret_cast<const char*>(&num_cols), sizeof(num_cols));
 
     // Write data
     for (size_t i = 0; i < ts.size(); ++i) {
-        const Record& r = ts[i];
-        
-        // Write OHLCV data as doubles
-        file.write(reinterpret_cast<const char*>(&r.open), sizeof(double));
-        file.write(reinterpret_cast<const char*>(&r.high), sizeof(double));
-        file.write(reinterpret_cast<const char*>(&r.low), sizeof(double));
-        file.write(reinterpret_cast<const char*>(&r.close), sizeof(double));
-        file.write(reinterpret_cast<const char*>(&r.adj_close), sizeof(double));
-        file.write(reinterpret_cast<const char*>(&r.volume), sizeof(double));
-        
-        // Write signal as double
-        double signal_d = static_cast<double>(r.signal);
-        file.write(reinterpret_cast<const char*>(&signal_d), sizeof(double));
+        write_binary_row(file, ts[i]);
     }
 
     file.close();
     return true;
 }
 
+bool BinaryWriter::write(const std::vector<Bar>& bars) {
+    tracing::Span span("io", "binary_write", -1, static_cast<int64_t>(bars.size()));
+    std::ofstream file(out_path_, std::ios::binary);
+    
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open binary output file: " << out_path_ << std::endl;
+        return false;
+    }
+
+    uint64_t num_rows = bars.size();
+    uint64_t num_cols = kBinaryColumns;
+    file.write(reinterpret_cast<const char*>(&num_rows), sizeof(num_rows));
+    file.write(reinterpret_cast<const char*>(&num_cols), sizeof(num_cols));
+
+    // Rows are encoded in blocks: a bar is the row minus its signal column
+    constexpr size_t kRowBytes = kBinaryColumns * sizeof(double);
+    std::vector<char> block(std::min<size_t>(bars.size(), kWriteBlockRows) * kRowBytes);
+    const double signal = 0.0;
+    for (size_t begin = 0; begin < bars.size(); begin += kWriteBlockRows) {
+        const size_t end = std::min(bars.size(), begin + kWriteBlockRows);
+        char* p = block.data();
+        for (size_t i = begin; i < end; ++i, p += kRowBytes) {
+            std::memcpy(p, &bars[i], sizeof(Bar));
+            std::memcpy(p + sizeof(Bar), &signal, sizeof(signal));
+        }
+        file.write(block.data(), static_cast<std::streamsize>((end - begin) * kRowBytes));
+    }
+
+    file.close();
+    return !file.fail();
+}
+
+bool BinaryWriter::append(const TimeSeries& ts, bool replace_last) {
+    {
+        std::ifstream probe(out_path_, std::ios::binary);
+        if (!probe.is_open()) {
+            return replace_last ? false : write(ts);
+        }
+    }
+    
+    std::fstream file(out_path_, std::ios::binary | std::ios::in | std::ios::out);
+    
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open binary output file: " << out_path_ << std::endl;
+        return false;
+    }
+
+    uint64_t num_rows, num_cols;
+    if (!read_binary_header(file, num_rows, num_cols) || num_cols != kBinaryColumns) {
+        std::cerr << "Error: Cannot append to binary file with unsupported layout: "
+                  << out_path_ << std::endl;
+        return false;
+    }
+    if (replace_last && num_rows == 0) {
+        return false;
+    }
+
+    uint64_t start_row = replace_last ? num_rows - 1 : num_rows;
+    file.seekp(kBinaryHeaderBytes +
+               static_cast<std::streamoff>(start_row * kBinaryColumns * sizeof(double)));
+    for (size_t i = 0; i < ts.size(); ++i) {
+        write_binary_row(file, ts[i]);
+    }
+
+    num_rows = start_row + ts.size();
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&num_rows), sizeof(num_rows));
+
+    file.close();
+    return !file.fail();
+}
+
 // ============================================================================
 // BinaryReader Implementation
 // ============================================================================
@@ -193,7 +386,45 @@ bool BinaryWriter::write(const TimeSeries& ts, bool include_indicators) {
 BinaryReader::BinaryReader(const std::string& path) : path_(path) {}
 
 TimeSeries BinaryReader::read() {
+    return read_rows(0, SIZE_MAX);
+}
+
+size_t BinaryReader::row_count() const {
+    std::ifstream file(path_, std::ios::binary);
+    uint64_t num_rows, num_cols;
+    if (!file.is_open() || !read_binary_header(file, num_rows, num_cols)) {
+        return 0;
+    }
+    return static_cast<size_t>(num_rows);
+}
+
+TimeSeries BinaryReader::read_rows(size_t start, size_t count) {
     TimeSeries ts;
+
+    // Map the file when possible: no read() copies, and huge pages for large files
+    pages::MappedFile mapped;
+    if (mapped.open(path_)) {
+        uint64_t num_rows, num_cols;
+        if (!read_binary_header(mapped, num_rows, num_cols)) {
+            std::cerr << "Error: Invalid binary file header: " << path_ << std::endl;
+            return ts;
+        }
+        if (start >= num_rows) {
+            return ts;
+        }
+        uint64_t end = num_rows - start < count ? num_rows : start + count;
+        const size_t row_bytes = num_cols * sizeof(double);
+        const char* row = mapped.data() + kBinaryHeaderBytes + start * row_bytes;
+
+        ts.reserve(end - start);
+        for (uint64_t i = start; i < end; ++i, row += row_bytes) {
+            Record r;
+            read_binary_row(row, num_cols == kBinaryColumns, r);
+            ts.push(r);
+        }
+        return ts;
+    }
+
     std::ifstream file(path_, std::ios::binary);
     
     if (!file.is_open()) {
@@ -203,26 +434,27 @@ TimeSeries BinaryReader::read() {
 
     // Read dimensions
     uint64_t num_rows, num_cols;
-    file.read(reinterpret_cast<char*>(&num_rows), sizeof(num_rows));
-    file.read(reinterpret_cast<char*>(&num_cols), sizeof(num_cols));
+    if (!read_binary_header(file, num_rows, num_cols)) {
+        std::cerr << "Error: Invalid binary file header: " << path_ << std::endl;
+        return ts;
+    }
+    if (start >= num_rows) {
+        return ts;
+    }
+    uint64_t end = num_rows - start < count ? num_rows : start + count;
 
-    ts.reserve(num_rows);
+    // Files written before the timestamp column existed have 7 columns
+    bool has_timestamp = (num_cols == kBinaryColumns);
+
+    ts.reserve(end - start);
+    file.seekg(kBinaryHeaderBytes +
+               static_cast<std::streamoff>(start * num_cols * sizeof(double)));
 
     // Read data
-    for (uint64_t i = 0; i < num_rows; ++i) {
+    for (uint64_t i = start; i < end; ++i) {
         Record r;
-        
-        file.read(reinterpret_cast<char*>(&r.open), sizeof(double));
-        file.read(reinterpret_cast<char*>(&r.high), sizeof(double));
-        file.read(reinterpret_cast<char*>(&r.low), sizeof(double));
-        file.read(reinterpret_cast<char*>(&r.close), sizeof(double));
-        file.read(reinterpret_cast<char*>(&r.adj_close), sizeof(double));
-        file.read(reinterpret_cast<char*>(&r.volume), sizeof(double));
-        
-        double signal_d;
-        file.read(reinterpret_cast<char*>(&signal_d), sizeof(double));
-        r.signal = static_cast<int>(signal_d);
-        
+        read_binary_row(file, has_timestamp, r);
+        if (!file) break;
         ts.push(r);
     }
 
@@ -230,4 +462,133 @@ TimeSeries BinaryReader::read() {
     return ts;
 }
 
+std::vector<Bar> BinaryReader::read_bars(size_t start, size_t count) {
+    std::vector<Bar> bars;
+    pages::MappedFile mapped;
+    std::ifstream file;
+    uint64_t num_rows, num_cols;
+    bool valid;
+    if (mapped.open(path_)) {
+        valid = read_binary_header(mapped, num_rows, num_cols);
+    } else {
+        file.open(path_, std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Error: Could not open binary input file: " << path_ << std::endl;
+            return bars;
+        }
+        valid = read_binary_header(file, num_rows, num_cols);
+    }
+    if (!valid) {
+        std::cerr << "Error: Invalid binary file header: " << path_ << std::endl;
+        return bars;
+    }
+    if (start >= num_rows) {
+        return bars;
+    }
+    uint64_t end = num_rows - start < count ? num_rows : start + count;
+    const size_t row_bytes = num_cols * sizeof(double);
+    const bool has_timestamp = (num_cols == kBinaryColumns);
+
+    // Current rows start with exactly a Bar; legacy rows lack the timestamp
+    const size_t skip = has_timestamp ? 0 : sizeof(int64_t);
+    const size_t copy = sizeof(Bar) - skip;
+    auto decode = [&](const char* row, Bar& b) {
+        b.ts = kInvalidTimestamp;
+        std::memcpy(reinterpret_cast<char*>(&b) + skip, row, copy);
+    };
+
+    bars.resize(end - start);
+    if (mapped.data()) {
+        const char* row = mapped.data() + kBinaryHeaderBytes + start * row_bytes;
+        for (Bar& b : bars) {
+            decode(row, b);
+            row += row_bytes;
+        }
+        return bars;
+    }
+
+    file.seekg(kBinaryHeaderBytes + static_cast<std::streamoff>(start * row_bytes));
+    std::vector<char> row(row_bytes);
+    for (size_t i = 0; i < bars.size(); ++i) {
+        if (!file.read(row.data(), static_cast<std::streamsize>(row_bytes))) {
+            bars.resize(i);
+            break;
+        }
+        decode(row.data(), bars[i]);
+    }
+    return bars;
+}
+
+bool BinaryReader::find_range(int64_t from_ns, int64_t to_ns, uint64_t& first, uint64_t& last) {
+    pages::MappedFile mapped;
+    std::ifstream file;
+    uint64_t num_rows, num_cols;
+    bool valid;
+    if (mapped.open(path_)) {
+        valid = read_binary_header(mapped, num_rows, num_cols);
+    } else {
+        file.open(path_, std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Error: Could not open binary input file: " << path_ << std::endl;
+            return false;
+        }
+        valid = read_binary_header(file, num_rows, num_cols);
+    }
+    if (!valid) {
+        std::cerr << "Error: Invalid binary file header: " << path_ << std::endl;
+        return false;
+    }
+    if (num_cols != kBinaryColumns) {
+        std::cerr << "Error: Binary file has no timestamp column: " << path_ << std::endl;
+        return false;
+    }
+
+    const std::streamoff row_bytes = static_cast<std::streamoff>(kBinaryColumns * sizeof(double));
+    auto timestamp_at = [&](uint64_t row) {
+        int64_t timestamp = kInvalidTimestamp;
+        const std::streamoff offset = kBinaryHeaderBytes + static_cast<std::streamoff>(row) * row_bytes;
+        if (mapped.data()) {
+            std::memcpy(&timestamp, mapped.data() + offset, sizeof(timestamp));
+        } else {
+            file.seekg(offset);
+            file.read(reinterpret_cast<char*>(&timestamp), sizeof(timestamp));
+        }
+        return timestamp;
+    };
+
+    // Binary search on the timestamp column: first row with timestamp >= bound
+    auto lower_bound = [&](int64_t bound) {
+        uint64_t lo = 0, hi = num_rows;
+        while (lo < hi) {
+            uint64_t mid = lo + (hi - lo) / 2;
+            if (timestamp_at(mid) < bound) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return lo;
+    };
+
+    first = lower_bound(from_ns);
+    last = lower_bound(to_ns);
+    return true;
+}
+
+TimeSeries BinaryReader::read_range(int64_t from_ns, int64_t to_ns) {
+    uint64_t first, last;
+    if (!find_range(from_ns, to_ns, first, last) || first >= last) {
+        return TimeSeries();
+    }
+    return read_rows(static_cast<size_t>(first), static_cast<size_t>(last - first));
+}
+
+std::vector<Bar> BinaryReader::read_bars_range(int64_t from_ns, int64_t to_ns) {
+    uint64_t first, last;
+    if (!find_range(from_ns, to_ns, first, last) || first >= last) {
+        return {};
+    }
+    return read_bars(static_cast<size_t>(first), static_cast<size_t>(last - first));
+}
+
 } // namespace tsproc
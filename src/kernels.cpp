@@ -0,0 +1,169 @@
+#include "kernels.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+// Baseline variant, compiled with the library's own flags
+#define TSPROC_KERNEL_ISA generic
+#include "kernels_impl.hpp"
+
+namespace tsproc {
+namespace kernels {
+
+#if defined(TSPROC_KERNEL_DISPATCH)
+namespace sse42 { extern const KernelTable table; }
+namespace avx2 { extern const KernelTable table; }
+namespace avx512 { extern const KernelTable table; }
+#endif
+
+namespace {
+
+const KernelTable* table_for(Isa isa) {
+    switch (isa) {
+#if defined(TSPROC_KERNEL_DISPATCH)
+        case Isa::SSE42: return &sse42::table;
+        case Isa::AVX2: return &avx2::table;
+        case Isa::AVX512: return &avx512::table;
+#endif
+        default: return &generic::table;
+    }
+}
+
+bool cpu_supports(Isa isa) {
+#if defined(TSPROC_KERNEL_DISPATCH)
+    switch (isa) {
+        case Isa::Generic: return true;
+        case Isa::SSE42: return __builtin_cpu_supports("sse4.2");
+        case Isa::AVX2: return __builtin_cpu_supports("avx2");
+        case Isa::AVX512: return __builtin_cpu_supports("avx512f");
+    }
+    return false;
+#else
+    return isa == Isa::Generic;
+#endif
+}
+
+Isa select_isa() {
+    std::vector<Isa> supported = supported_isas();
+    Isa best = supported.back();
+
+    const char* env = std::getenv("TSPROC_ISA");
+    if (env == nullptr || *env == '\0') return best;
+
+    Isa requested;
+    if (!parse_isa(env, requested)) {
+        std::cerr << "Warning: Unknown TSPROC_ISA '" << env << "', using " << isa_name(best)
+                  << std::endl;
+        return best;
+    }
+    // Asking for more than the CPU has falls back to the best it does have
+    return static_cast<int>(requested) < static_cast<int>(best) ? requested : best;
+}
+
+struct Dispatch {
+    std::atomic<const KernelTable*> table;
+    std::atomic<Isa> isa;
+
+    Dispatch() {
+        Isa selected = select_isa();
+        table.store(table_for(selected), std::memory_order_relaxed);
+        isa.store(selected, std::memory_order_relaxed);
+    }
+};
+
+Dispatch& dispatch() {
+    static Dispatch instance;
+    return instance;
+}
+
+// Select at startup rather than on the first kernel call, which keeps CPUID
+// probing and the TSPROC_ISA lookup out of timed and allocation-free loops
+const bool selected_at_startup = (dispatch(), true);
+
+inline const KernelTable& active() {
+    return *dispatch().table.load(std::memory_order_relaxed);
+}
+
+} // namespace
+
+const char* isa_name(Isa isa) {
+    switch (isa) {
+        case Isa::Generic: return "generic";
+        case Isa::SSE42: return "sse4.2";
+        case Isa::AVX2: return "avx2";
+        case Isa::AVX512: return "avx512";
+    }
+    return "unknown";
+}
+
+bool parse_isa(const char* name, Isa& isa) {
+    for (Isa candidate : {Isa::Generic, Isa::SSE42, Isa::AVX2, Isa::AVX512}) {
+        if (std::strcmp(name, isa_name(candidate)) == 0) {
+            isa = candidate;
+            return true;
+        }
+    }
+    if (std::strcmp(name, "sse42") == 0) {
+        isa = Isa::SSE42;
+        return true;
+    }
+    return false;
+}
+
+std::vector<Isa> supported_isas() {
+    std::vector<Isa> isas;
+    for (Isa isa : {Isa::Generic, Isa::SSE42, Isa::AVX2, Isa::AVX512}) {
+        if (cpu_supports(isa)) isas.push_back(isa);
+    }
+    return isas;
+}
+
+Isa active_isa() {
+    return dispatch().isa.load(std::memory_order_relaxed);
+}
+
+bool set_isa(Isa isa) {
+    if (!cpu_supports(isa)) return false;
+    Dispatch& d = dispatch();
+    d.table.store(table_for(isa), std::memory_order_relaxed);
+    d.isa.store(isa, std::memory_order_relaxed);
+    return true;
+}
+
+void rolling_sum(const double* in, size_t n, size_t window, double* out) {
+    active().rolling_sum(in, n, window, out);
+}
+
+void rolling_mean(const double* in, size_t n, size_t window, double* out) {
+    active().rolling_mean(in, n, window, out);
+}
+
+void rolling_mean_std(const double* in, size_t n, size_t window, double* mean, double* sd) {
+    active().rolling_mean_std(in, n, window, mean, sd);
+}
+
+void rolling_moments(const double* in, size_t n, size_t window, double* mean, double* sd,
+                     double* skew, double* kurt) {
+    active().rolling_moments(in, n, window, mean, sd, skew, kurt);
+}
+
+void ema(const double* in, size_t n, size_t window, double* out) {
+    active().ema(in, n, window, out);
+}
+
+void quote_features(const double* bid, const double* ask, const double* bid_size,
+                    const double* ask_size, size_t n, double* mid, double* spread,
+                    double* microprice, double* imbalance) {
+    active().quote_features(bid, ask, bid_size, ask_size, n, mid, spread, microprice, imbalance);
+}
+
+void range_volatility(const double* open, const double* high, const double* low,
+                      const double* close, size_t n, size_t window, double* parkinson,
+                      double* garman_klass, double* rogers_satchell, double* yang_zhang) {
+    active().range_volatility(open, high, low, close, n, window, parkinson, garman_klass,
+                              rogers_satchell, yang_zhang);
+}
+
+} // namespace kernels
+} // namespace tsproc
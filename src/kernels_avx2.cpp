@@ -0,0 +1,4 @@
+// Compiled with the AVX2 flags from CMakeLists.txt; only called when the
+// CPU reports support (see kernels.cpp)
+#define TSPROC_KERNEL_ISA avx2
+#include "kernels_impl.hpp"
@@ -0,0 +1,284 @@
+// Kernel bodies shared by every ISA variant. Each kernels*.cpp translation
+// unit defines TSPROC_KERNEL_ISA to a namespace name and includes this file
+// once; CMake compiles the variant units with their own -m flags, so the
+// same source is vectorized for SSE4.2, AVX2 and AVX-512 side by side.
+//
+// The guarded part below is shared with the dispatcher in kernels.cpp.
+
+#ifndef TSPROC_KERNELS_IMPL_TABLE
+#define TSPROC_KERNELS_IMPL_TABLE
+
+#include <cmath>
+#include <cstddef>
+
+namespace tsproc {
+namespace kernels {
+
+/**
+ * @brief One ISA variant's entry points, selected at startup
+ */
+struct KernelTable {
+    void (*rolling_sum)(const double*, size_t, size_t, double*);
+    void (*rolling_mean)(const double*, size_t, size_t, double*);
+    void (*rolling_mean_std)(const double*, size_t, size_t, double*, double*);
+    void (*ema)(const double*, size_t, size_t, double*);
+    void (*quote_features)(const double*, const double*, const double*, const double*, size_t,
+                           double*, double*, double*, double*);
+    void (*range_volatility)(const double*, const double*, const double*, const double*, size_t,
+                             size_t, double*, double*, double*, double*);
+    void (*rolling_moments)(const double*, size_t, size_t, double*, double*, double*, double*);
+};
+
+} // namespace kernels
+} // namespace tsproc
+
+#endif // TSPROC_KERNELS_IMPL_TABLE
+
+#ifdef TSPROC_KERNEL_ISA
+
+namespace tsproc {
+namespace kernels {
+namespace TSPROC_KERNEL_ISA {
+
+void rolling_sum(const double* in, size_t n, size_t window, double* out) {
+    if (window == 0) return;
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        sum += in[i];
+        if (i >= window) sum -= in[i - window];
+        out[i] = i + 1 >= window ? sum : NAN;
+    }
+}
+
+// Rolling kernels run in two passes: a serial pass for the loop-carried
+// running sums, then an element-wise pass (divide, sqrt) that the compiler
+// vectorizes to the variant's register width. Each element sees the same
+// operations in the same order as a single fused loop.
+
+void rolling_mean(const double* in, size_t n, size_t window, double* out) {
+    if (window == 0) return;
+    rolling_sum(in, n, window, out);
+    const double w = static_cast<double>(window);
+    for (size_t i = window - 1; i < n; ++i) {
+        out[i] = out[i] / w;
+    }
+}
+
+void rolling_mean_std(const double* in, size_t n, size_t window, double* mean, double* sd) {
+    if (window == 0) return;
+    double sum = 0.0;
+    double sumsq = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        const double v = in[i];
+        sum += v;
+        sumsq += v * v;
+        if (i >= window) {
+            const double old = in[i - window];
+            sum -= old;
+            sumsq -= old * old;
+        }
+        mean[i] = i + 1 >= window ? sum : NAN;
+        sd[i] = i + 1 >= window ? sumsq : NAN;
+    }
+
+    const double w = static_cast<double>(window);
+    for (size_t i = window - 1; i < n; ++i) {
+        const double m = mean[i] / w;
+        const double variance = (sd[i] / w) - (m * m);
+        mean[i] = m;
+        sd[i] = variance > 0 ? std::sqrt(variance) : 0.0;
+    }
+}
+
+void rolling_moments(const double* in, size_t n, size_t window, double* mean, double* sd,
+                     double* skew, double* kurt) {
+    if (window == 0 || n == 0) return;
+    const double w = static_cast<double>(window);
+
+    // Mean and sd come from the same raw sums as rolling_mean_std. Raw third
+    // and fourth power sums of prices cancel badly, so those are kept about a
+    // shift that is moved to the window mean once per window, re-summing the
+    // window (amortized O(1) per row).
+    double sum = 0.0;
+    double sumsq = 0.0;
+    double shift = in[0];
+    double s1 = 0.0, s2 = 0.0, s3 = 0.0, s4 = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        const double v = in[i];
+        sum += v;
+        sumsq += v * v;
+        const double y = v - shift;
+        s1 += y;
+        s2 += y * y;
+        s3 += y * y * y;
+        s4 += (y * y) * (y * y);
+        if (i >= window) {
+            const double old = in[i - window];
+            sum -= old;
+            sumsq -= old * old;
+            const double z = old - shift;
+            s1 -= z;
+            s2 -= z * z;
+            s3 -= z * z * z;
+            s4 -= (z * z) * (z * z);
+        }
+        if (i + 1 < window) {
+            mean[i] = sd[i] = skew[i] = kurt[i] = NAN;
+            continue;
+        }
+        if ((i + 1) % window == 0) {
+            shift = sum / w;
+            s1 = s2 = s3 = s4 = 0.0;
+            for (size_t j = i + 1 - window; j <= i; ++j) {
+                const double y2 = in[j] - shift;
+                s1 += y2;
+                s2 += y2 * y2;
+                s3 += y2 * y2 * y2;
+                s4 += (y2 * y2) * (y2 * y2);
+            }
+        }
+
+        const double m = sum / w;
+        const double variance = (sumsq / w) - (m * m);
+        mean[i] = m;
+        sd[i] = variance > 0 ? std::sqrt(variance) : 0.0;
+
+        // Central moments from the shifted power sums
+        const double a = s1 / w;
+        const double b = s2 / w;
+        const double a2 = a * a;
+        const double m2 = b - a2;
+        const double m3 = s3 / w - 3.0 * a * b + 2.0 * a2 * a;
+        const double m4 = s4 / w - 4.0 * a * (s3 / w) + 6.0 * a2 * b - 3.0 * a2 * a2;
+        // A flat window (m2 at round-off level) has no defined shape
+        const bool flat = !(m2 > 1e-12 * b);
+        skew[i] = flat ? NAN : m3 / (m2 * std::sqrt(m2));
+        kurt[i] = flat ? NAN : m4 / (m2 * m2) - 3.0;
+    }
+}
+
+void ema(const double* in, size_t n, size_t window, double* out) {
+    if (n == 0) return;
+    const double alpha = 2.0 / (static_cast<double>(window) + 1.0);
+    double value = in[0];
+    out[0] = value;
+    for (size_t i = 1; i < n; ++i) {
+        value = alpha * in[i] + (1.0 - alpha) * value;
+        out[i] = value;
+    }
+}
+
+void quote_features(const double* __restrict bid, const double* __restrict ask,
+                    const double* __restrict bid_size, const double* __restrict ask_size, size_t n,
+                    double* __restrict mid, double* __restrict spread,
+                    double* __restrict microprice, double* __restrict imbalance) {
+    // Eight streams are too many for the compiler's runtime alias checks;
+    // the columns never overlap, which __restrict states outright
+    for (size_t i = 0; i < n; ++i) {
+        const double b = bid[i];
+        const double a = ask[i];
+        const double bs = bid_size[i];
+        const double as = ask_size[i];
+        const double m = 0.5 * (b + a);
+        const double total = bs + as;
+        // Divide unconditionally and select after, so the loop has no branch
+        const double micro = (b * as + a * bs) / total;
+        const double imb = (bs - as) / total;
+        mid[i] = m;
+        spread[i] = a - b;
+        microprice[i] = total > 0.0 ? micro : m;
+        imbalance[i] = total > 0.0 ? imb : 0.0;
+    }
+}
+
+namespace {
+
+// Per-bar terms of the range estimators, from logs relative to the open
+struct RangeTerms {
+    double hl2;         // ln(H/L)^2
+    double co;          // ln(C/O)
+    double rs;          // ln(H/C) ln(H/O) + ln(L/C) ln(L/O)
+    double overnight;   // ln(O / previous C), 0 on the first bar
+};
+
+inline RangeTerms range_terms(const double* open, const double* high, const double* low,
+                              const double* close, size_t i) {
+    const double o = open[i];
+    const double u = std::log(high[i] / o);
+    const double d = std::log(low[i] / o);
+    const double c = std::log(close[i] / o);
+    RangeTerms t;
+    t.hl2 = (u - d) * (u - d);
+    t.co = c;
+    t.rs = u * (u - c) + d * (d - c);
+    t.overnight = i > 0 ? std::log(o / close[i - 1]) : 0.0;
+    return t;
+}
+
+// Square root of a variance; round-off below zero is 0, NaN stays NaN
+inline double range_vol(double variance) {
+    return variance > 0 ? std::sqrt(variance) : (variance == variance ? 0.0 : variance);
+}
+
+} // namespace
+
+void range_volatility(const double* open, const double* high, const double* low,
+                      const double* close, size_t n, size_t window, double* parkinson,
+                      double* garman_klass, double* rogers_satchell, double* yang_zhang) {
+    if (window == 0) return;
+    const double ln2 = std::log(2.0);
+    const double gk_co = 2.0 * ln2 - 1.0;
+    const double w = static_cast<double>(window);
+    const double k = window > 1 ? 0.34 / (1.34 + (w + 1.0) / (w - 1.0)) : 0.0;
+
+    // Serial pass: six running sums. The evicted bar's terms are recomputed
+    // from the OHLC columns rather than buffered, so nothing is allocated.
+    double hl2 = 0.0, co = 0.0, co2 = 0.0, rs = 0.0, on = 0.0, on2 = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        const RangeTerms t = range_terms(open, high, low, close, i);
+        hl2 += t.hl2;
+        co += t.co;
+        co2 += t.co * t.co;
+        rs += t.rs;
+        on += t.overnight;
+        on2 += t.overnight * t.overnight;
+        if (i >= window) {
+            const RangeTerms old = range_terms(open, high, low, close, i - window);
+            hl2 -= old.hl2;
+            co -= old.co;
+            co2 -= old.co * old.co;
+            rs -= old.rs;
+            on -= old.overnight;
+            on2 -= old.overnight * old.overnight;
+        }
+        // Yang-Zhang needs the overnight return of every bar in the window,
+        // so its first value comes one bar later than the others
+        parkinson[i] = i + 1 >= window ? hl2 : NAN;
+        garman_klass[i] = i + 1 >= window ? 0.5 * hl2 - gk_co * co2 : NAN;
+        rogers_satchell[i] = i + 1 >= window ? rs : NAN;
+        yang_zhang[i] = i >= window && window > 1
+                            ? (on2 - on * on / w) + k * (co2 - co * co / w)
+                            : NAN;
+    }
+
+    // Element-wise pass: per-bar variances, then volatilities. Yang-Zhang is
+    // var_overnight + k var_open_close + (1 - k) var_rs, sample variances
+    const double park_scale = 1.0 / (4.0 * ln2 * w);
+    for (size_t i = window - 1; i < n; ++i) {
+        const double r = rogers_satchell[i] / w;
+        parkinson[i] = range_vol(parkinson[i] * park_scale);
+        garman_klass[i] = range_vol(garman_klass[i] / w);
+        rogers_satchell[i] = range_vol(r);
+        yang_zhang[i] = range_vol(yang_zhang[i] / (w - 1.0) + (1.0 - k) * r);
+    }
+}
+
+extern const KernelTable table;
+const KernelTable table = {rolling_sum, rolling_mean, rolling_mean_std, ema, quote_features,
+                           range_volatility, rolling_moments};
+
+} // namespace TSPROC_KERNEL_ISA
+} // namespace kernels
+} // namespace tsproc
+
+#endif // TSPROC_KERNEL_ISA
@@ -0,0 +1,4 @@
+// Compiled with the SSE4.2 flags from CMakeLists.txt; only called when the
+// CPU reports support (see kernels.cpp)
+#define TSPROC_KERNEL_ISA sse42
+#include "kernels_impl.hpp"
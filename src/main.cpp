@@ -1,12 +1,30 @@
 #include "csv_reader.hpp"
+#include "csv_index.hpp"
 #include "timeseries.hpp"
 #include "indicators.hpp"
 #include "signals.hpp"
 #include "io.hpp"
+#include "panel.hpp"
+#include "realized.hpp"
+#include "order_book.hpp"
+#include "downsample.hpp"
+#include "gaps.hpp"
+#include "pyramid.hpp"
+#include "datetime.hpp"
+#include "replay.hpp"
+#include "streaming.hpp"
+#include "profiler.hpp"
+#include "scheduler.hpp"
+#include "pages.hpp"
+#include "trace.hpp"
 #include <iostream>
+#include <fstream>
 #include <string>
 #include <vector>
 #include <cstring>
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
 
 namespace tsproc {
 
@@ -14,6 +32,7 @@ struct CLIConfig {
     std::string input_file;
     std::string output_file;
     std::vector<size_t> sma_windows;
+    std::vector<size_t> moment_windows;    // rolling mean/std/skew/kurtosis (batch mode)
     size_t zscore_window = 0;
     double zscore_entry = 2.0;
     double zscore_exit = 0.5;
@@ -25,16 +44,47 @@ struct CLIConfig {
     bool drop_na = true;
     bool binary_output = false;
     std::string mode = "batch"; // batch or stream
+    std::string replay_speed;   // stream mode pacing: fast, realtime or factor
+    size_t downsample_points = 0;
+    std::string downsample_method = "lttb"; // lttb or minmax
+    std::string downsample_col = "close";
+    std::vector<int64_t> pyramid_levels;   // periods to precompute with --binary
+    int64_t resample_period = 0;           // 0 = native resolution
+    bool append_binary = false;
+    int64_t from_ns = INT64_MIN;           // --from (inclusive)
+    int64_t to_ns = INT64_MAX;             // --to (exclusive bound after conversion)
+    bool build_index = false;              // write a CSV sidecar index while parsing
+    size_t index_stride = CSVIndex::kDefaultStride;
+    size_t parse_threads = 1;              // >1 parses the CSV in parallel chunks
+    bool threads_set = false;              // --threads given: also sizes the scheduler
+    bool pin_threads = false;              // pin scheduler workers to CPUs
+    std::string huge_pages;                // off, thp or hugetlb (empty = TSPROC_HUGE_PAGES or thp)
+    std::string gap_frequency;             // expected bar spacing, or "auto"
+    std::string gap_fill;                  // ffill, nan or linear (empty = report only)
+    std::string gap_report;                // CSV file listing detected gaps
+    gaps::Calendar calendar;
+    std::string duplicates = "keep";       // keep, first, last or aggregate
+    std::string symbol_column;             // long-format input: split rows per symbol
+    int64_t book_interval = -1;            // order-event input sampled every N ns (0 = per timestamp)
+    double tick_size = 0.01;
+    size_t book_depth = 5;
+    int64_t realized_bucket = 0;           // >0: daily realized measures, seasonality buckets
+    bool profile = false;                  // print per-stage time and hardware counters
+    std::string trace_file;                // Chrome trace-event JSON of the run
+    std::string latency_json;              // stream mode latency percentiles as JSON
 };
 
 void print_usage(const char* program_name) {
-    std::cout << "Usage: " << program_name << " [OPTIONS]\n\n"
+    std::cout << "Usage: " << program_name << " [OPTIONS]\n"
+              << "       " << program_name << " index FILE [--stride N]\n"
+              << "       " << program_name << " count FILE\n\n"
               << "High-Performance Time-Series Data Processor\n\n"
               << "Options:\n"
               << "  --input FILE          Input CSV file (required)\n"
               << "  --output FILE         Output CSV file (required)\n"
               << "  --sma N               Add SMA with window N (can specify multiple)\n"
               << "  --zwindow N           Compute rolling mean/std/zscore with window N\n"
+              << "  --moments N           Add rolling mean/std/skew/kurtosis with window N\n"
               << "  --zentry THRESHOLD    Z-score entry threshold (default: 2.0)\n"
               << "  --zexit THRESHOLD     Z-score exit threshold (default: 0.5)\n"
               << "  --signal-z            Generate zscore mean reversion signal\n"
@@ -42,13 +92,77 @@ void print_usage(const char* program_name) {
               << "  --slow-sma N          Slow SMA window for crossover\n"
               << "  --signal-sma          Generate SMA crossover signal\n"
               << "  --binary              Output binary format in addition to CSV\n"
+              << "  --pyramid LEVELS      Store OHLCV aggregates with the binary output (e.g. 5m,1h,1d)\n"
+              << "  --append              Append to an existing binary output and its pyramid\n"
+              << "  --resample PERIOD     Aggregate input to PERIOD bars (uses a stored pyramid\n"
+              << "                        when the input is a .bin dataset)\n"
               << "  --keep-na             Keep NaN values (default: drop)\n"
+              << "  --from DATE           Only read rows at or after DATE (sorted input)\n"
+              << "  --to DATE             Only read rows up to DATE, inclusive (a bare\n"
+              << "                        YYYY-MM-DD includes the whole day)\n"
+              << "  --index               Write a sidecar index (FILE.idx) during the first parse\n"
+              << "  --index-stride N      Data lines between index samples (default: 1024)\n"
+              << "  --threads N           Run on N threads and parse the input CSV in N chunks\n"
+              << "                        (0 = all cores; default: serial parse, all cores else)\n"
+              << "  --pin-threads         Pin worker threads to CPUs (Linux)\n"
+              << "  --huge-pages MODE     Huge pages for large columns and mapped binary input:\n"
+              << "                        off, thp or hugetlb (default: thp, Linux)\n"
+              << "  --duplicates POLICY   Resolve repeated timestamps: keep, first, last or\n"
+              << "                        aggregate (default: keep)\n"
+              << "  --symbol-column NAME  Long-format CSV input: route rows by the NAME column\n"
+              << "                        and process each symbol to OUTPUT_<SYMBOL>.csv\n"
+              << "  --book PERIOD         Input is an order-event CSV: rebuild the book and sample\n"
+              << "                        features every PERIOD (e.g. 1s, or 'tick' per timestamp)\n"
+              << "  --tick-size X         Book price increment (default: 0.01)\n"
+              << "  --book-depth N        Levels summed for bid/ask depth (default: 5)\n"
+              << "  --realized BUCKET     Reduce intraday bars to daily realized variance, bipower\n"
+              << "                        variation and jumps; write the BUCKET time-of-day\n"
+              << "                        volume/volatility profile to OUTPUT_seasonality.csv\n"
+              << "  --gaps FREQ           Report missing bars against FREQ (e.g. 1m, 1d or auto)\n"
+              << "  --fill-gaps METHOD    Insert missing bars: ffill, nan or linear (needs --gaps)\n"
+              << "  --gap-report FILE     Write detected gaps as CSV\n"
+              << "  --weekdays            Expect bars on Monday-Friday only\n"
+              << "  --session HH:MM-HH:MM Expect bars only inside this UTC session\n"
+              << "  --holidays FILE       Non-trading dates, one per line\n"
+              << "  --downsample N        Reduce output to about N rows for charting\n"
+              << "  --downsample-method M Downsampling method: lttb or minmax (default: lttb)\n"
+              << "  --downsample-col COL  Column or indicator to downsample on (default: close)\n"
               << "  --mode MODE           Processing mode: batch or stream (default: batch)\n"
+              << "  --replay SPEED        Replay input through the streaming pipeline:\n"
+              << "                        fast, realtime or a factor like 60x (implies --mode stream)\n"
+              << "  --profile             Print time and hardware counters per stage and kernel\n"
+              << "  --trace FILE          Write a Chrome trace-event timeline (open in Perfetto)\n"
+              << "  --latency-json FILE   Write stream mode latency percentiles (ingest-to-signal\n"
+              << "                        and per stage) as JSON\n"
               << "  --help                Show this help message\n\n"
               << "Examples:\n"
               << "  " << program_name << " --input data.csv --output out.csv --sma 20 --sma 50\n"
               << "  " << program_name << " --input data.csv --output out.csv --zwindow 20 --signal-z\n"
-              << "  " << program_name << " --input data.csv --output out.csv --fast-sma 10 --slow-sma 50 --signal-sma\n";
+              << "  " << program_name << " --input data.csv --output out.csv --fast-sma 10 --slow-sma 50 --signal-sma\n"
+              << "  " << program_name << " index data.csv\n";
+}
+
+bool load_holidays(const std::string& path, gaps::Calendar& calendar) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open holidays file: " << path << std::endl;
+        return false;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        int64_t day = to_timestamp(line);
+        if (day == kInvalidTimestamp) {
+            std::cerr << "Invalid holiday date: " << line << std::endl;
+            return false;
+        }
+        calendar.holidays.push_back(day);
+    }
+    return true;
+}
+
+bool has_range(const CLIConfig& config) {
+    return config.from_ns != INT64_MIN || config.to_ns != INT64_MAX;
 }
 
 bool parse_args(int argc, char* argv[], CLIConfig& config) {
@@ -71,6 +185,9 @@ bool parse_args(int argc, char* argv[], CLIConfig& config) {
         else if (arg == "--sma" && i + 1 < argc) {
             config.sma_windows.push_back(std::stoul(argv[++i]));
         }
+        else if (arg == "--moments" && i + 1 < argc) {
+            config.moment_windows.push_back(std::stoul(argv[++i]));
+        }
         else if (arg == "--zwindow" && i + 1 < argc) {
             config.zscore_window = std::stoul(argv[++i]);
             config.compute_rolling_stats = true;
@@ -96,12 +213,151 @@ bool parse_args(int argc, char* argv[], CLIConfig& config) {
         else if (arg == "--binary") {
             config.binary_output = true;
         }
+        else if (arg == "--pyramid" && i + 1 < argc) {
+            std::string levels = argv[++i];
+            size_t start = 0;
+            while (start <= levels.size()) {
+                size_t comma = levels.find(',', start);
+                if (comma == std::string::npos) comma = levels.size();
+                int64_t period;
+                if (!parse_duration(levels.substr(start, comma - start), period)) {
+                    std::cerr << "Invalid pyramid level in: " << levels << std::endl;
+                    return false;
+                }
+                config.pyramid_levels.push_back(period);
+                start = comma + 1;
+            }
+        }
+        else if (arg == "--from" && i + 1 < argc) {
+            config.from_ns = to_timestamp(argv[++i]);
+            if (config.from_ns == kInvalidTimestamp) {
+                std::cerr << "Invalid --from date: " << argv[i] << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "--to" && i + 1 < argc) {
+            std::string to = argv[++i];
+            int64_t t = to_timestamp(to);
+            if (t == kInvalidTimestamp) {
+                std::cerr << "Invalid --to date: " << to << std::endl;
+                return false;
+            }
+            // Inclusive bound: a bare date covers the whole day; saturates
+            // so a bound at the end of the int64 range means "to the end"
+            const int64_t span = (to.find_first_of(" T") == std::string::npos) ? gaps::kDayNs : 1;
+            config.to_ns = t > INT64_MAX - span ? INT64_MAX : t + span;
+        }
+        else if (arg == "--append") {
+            config.append_binary = true;
+        }
+        else if (arg == "--resample" && i + 1 < argc) {
+            if (!parse_duration(argv[++i], config.resample_period)) {
+                std::cerr << "Invalid resample period: " << argv[i] << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "--index") {
+            config.build_index = true;
+        }
+        else if (arg == "--index-stride" && i + 1 < argc) {
+            config.index_stride = std::stoul(argv[++i]);
+        }
+        else if (arg == "--threads" && i + 1 < argc) {
+            config.parse_threads = std::stoul(argv[++i]);
+            config.threads_set = true;
+        }
+        else if (arg == "--pin-threads") {
+            config.pin_threads = true;
+        }
+        else if (arg == "--huge-pages" && i + 1 < argc) {
+            config.huge_pages = argv[++i];
+        }
+        else if (arg == "--duplicates" && i + 1 < argc) {
+            config.duplicates = argv[++i];
+        }
+        else if (arg == "--symbol-column" && i + 1 < argc) {
+            config.symbol_column = argv[++i];
+        }
+        else if (arg == "--book" && i + 1 < argc) {
+            std::string period = argv[++i];
+            if (period == "tick") {
+                config.book_interval = 0;
+            } else if (!parse_duration(period, config.book_interval)) {
+                std::cerr << "Invalid book sample period: " << period << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "--realized" && i + 1 < argc) {
+            if (!parse_duration(argv[++i], config.realized_bucket) ||
+                config.realized_bucket > gaps::kDayNs) {
+                std::cerr << "Invalid realized bucket: " << argv[i] << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "--tick-size" && i + 1 < argc) {
+            config.tick_size = std::stod(argv[++i]);
+        }
+        else if (arg == "--book-depth" && i + 1 < argc) {
+            config.book_depth = std::stoul(argv[++i]);
+        }
+        else if (arg == "--gaps" && i + 1 < argc) {
+            config.gap_frequency = argv[++i];
+            int64_t freq = 0;
+            if (config.gap_frequency != "auto" && !parse_duration(config.gap_frequency, freq)) {
+                std::cerr << "Invalid gap frequency: " << config.gap_frequency << std::endl;
+                return false;
+            }
+            config.calendar.frequency_ns = freq;
+        }
+        else if (arg == "--fill-gaps" && i + 1 < argc) {
+            config.gap_fill = argv[++i];
+        }
+        else if (arg == "--gap-report" && i + 1 < argc) {
+            config.gap_report = argv[++i];
+        }
+        else if (arg == "--weekdays") {
+            config.calendar.weekdays_only = true;
+        }
+        else if (arg == "--session" && i + 1 < argc) {
+            if (!parse_session(argv[++i], config.calendar.session_open_ns,
+                               config.calendar.session_close_ns)) {
+                std::cerr << "Invalid session (expected HH:MM-HH:MM): " << argv[i] << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "--holidays" && i + 1 < argc) {
+            if (!load_holidays(argv[++i], config.calendar)) {
+                return false;
+            }
+        }
         else if (arg == "--keep-na") {
             config.drop_na = false;
         }
+        else if (arg == "--downsample" && i + 1 < argc) {
+            config.downsample_points = std::stoul(argv[++i]);
+        }
+        else if (arg == "--downsample-method" && i + 1 < argc) {
+            config.downsample_method = argv[++i];
+        }
+        else if (arg == "--downsample-col" && i + 1 < argc) {
+            config.downsample_col = argv[++i];
+        }
         else if (arg == "--mode" && i + 1 < argc) {
             config.mode = argv[++i];
         }
+        else if (arg == "--replay" && i + 1 < argc) {
+            config.replay_speed = argv[++i];
+            config.mode = "stream";
+        }
+        else if (arg == "--profile") {
+            config.profile = true;
+        }
+        else if (arg == "--trace" && i + 1 < argc) {
+            config.trace_file = argv[++i];
+        }
+        else if (arg == "--latency-json" && i + 1 < argc) {
+            config.latency_json = argv[++i];
+        }
         else {
             std::cerr << "Unknown argument: " << arg << std::endl;
             return false;
@@ -114,81 +370,611 @@ bool parse_args(int argc, char* argv[], CLIConfig& config) {
         return false;
     }
     
+    if (config.downsample_method != "lttb" && config.downsample_method != "minmax") {
+        std::cerr << "Error: --downsample-method must be lttb or minmax\n";
+        return false;
+    }
+    
+    if (!config.huge_pages.empty() && config.huge_pages != "off" && config.huge_pages != "thp" &&
+        config.huge_pages != "hugetlb") {
+        std::cerr << "Error: --huge-pages must be off, thp or hugetlb\n";
+        return false;
+    }
+    
+    if (config.duplicates != "keep" && config.duplicates != "first" && config.duplicates != "last" &&
+        config.duplicates != "aggregate") {
+        std::cerr << "Error: --duplicates must be keep, first, last or aggregate\n";
+        return false;
+    }
+    
+    if (!config.gap_fill.empty() && config.gap_fill != "ffill" && config.gap_fill != "nan" &&
+        config.gap_fill != "linear") {
+        std::cerr << "Error: --fill-gaps must be ffill, nan or linear\n";
+        return false;
+    }
+    
+    if (!config.symbol_column.empty() &&
+        (config.mode != "batch" || is_binary_path(config.input_file) || has_range(config) ||
+         config.append_binary)) {
+        std::cerr << "Error: --symbol-column needs batch mode over a CSV input, without "
+                     "--from/--to or --append\n";
+        return false;
+    }
+    
+    if (config.book_interval >= 0 &&
+        (config.mode != "batch" || is_binary_path(config.input_file) || has_range(config) ||
+         !config.symbol_column.empty() || config.resample_period > 0)) {
+        std::cerr << "Error: --book needs batch mode over a CSV input, without --from/--to, "
+                     "--symbol-column or --resample\n";
+        return false;
+    }
+    
+    if (config.book_interval >= 0 && !(config.tick_size > 0.0)) {
+        std::cerr << "Error: --tick-size must be positive\n";
+        return false;
+    }
+    
+    if (config.realized_bucket > 0 && config.mode != "batch") {
+        std::cerr << "Error: --realized needs batch mode\n";
+        return false;
+    }
+    
+    if (!config.moment_windows.empty() && config.mode != "batch") {
+        std::cerr << "Error: --moments needs batch mode\n";
+        return false;
+    }
+    
+    if (!config.gap_fill.empty() && config.gap_frequency.empty()) {
+        std::cerr << "Error: --fill-gaps requires --gaps\n";
+        return false;
+    }
+    
+    if (config.mode != "batch" && config.mode != "stream") {
+        std::cerr << "Error: --mode must be batch or stream\n";
+        return false;
+    }
+    
     return true;
 }
 
-int run_cli(int argc, char* argv[]) {
-    CLIConfig config;
+TimeSeries load_input(const CLIConfig& config) {
+    if (is_binary_path(config.input_file)) {
+        Pyramid pyramid(config.input_file);
+        if (config.resample_period > 0) {
+            int64_t level = pyramid.select_level(config.resample_period);
+            std::cout << "Reading " << format_duration(config.resample_period) << " bars from "
+                      << (level > 0 ? format_duration(level) + " pyramid level" : "base data")
+                      << std::endl;
+            return pyramid.query(config.resample_period, config.from_ns, config.to_ns);
+        }
+        BinaryReader reader(config.input_file);
+        return has_range(config) ? reader.read_range(config.from_ns, config.to_ns) : reader.read();
+    }
     
-    if (!parse_args(argc, argv, config)) {
-        print_usage(argv[0]);
+    CSVReader reader(config.input_file);
+    reader.set_build_index(config.build_index, config.index_stride);
+    reader.set_duplicate_policy(parse_duplicate_policy(config.duplicates));
+    TimeSeries ts;
+    if (has_range(config)) {
+        ts = reader.read_range(config.from_ns, config.to_ns, config.drop_na);
+    } else if (config.parse_threads != 1) {
+        ts = reader.read_parallel(config.parse_threads, config.drop_na);
+    } else {
+        ts = reader.read_to_timeseries(config.drop_na);
+    }
+    if (reader.duplicates_resolved() > 0) {
+        std::cout << "Resolved " << reader.duplicates_resolved() << " duplicate timestamps ("
+                  << config.duplicates << ")" << std::endl;
+    }
+    if (config.resample_period > 0) {
+        std::cout << "Resampling to " << format_duration(config.resample_period) << " bars" << std::endl;
+        ts = resample(ts, config.resample_period);
+    }
+    return ts;
+}
+
+bool write_binary_output(const CLIConfig& config, const TimeSeries& ts) {
+    std::string binary_path = config.output_file + ".bin";
+    Pyramid pyramid(binary_path);
+    
+    if (config.append_binary) {
+        std::cout << "Appending binary output to: " << binary_path;
+        if (!pyramid.levels().empty()) {
+            std::cout << " (updating " << pyramid.levels().size() << " pyramid levels)";
+        }
+        std::cout << std::endl;
+        return pyramid.append(ts) && pyramid.add_levels(config.pyramid_levels);
+    }
+    
+    if (!config.pyramid_levels.empty()) {
+        std::cout << "Writing binary output with " << config.pyramid_levels.size()
+                  << " pyramid levels to: " << binary_path << std::endl;
+        return pyramid.build(ts, config.pyramid_levels);
+    }
+    
+    std::cout << "Writing binary output to: " << binary_path << std::endl;
+    BinaryWriter bin_writer(binary_path);
+    return bin_writer.write(ts);
+}
+
+bool write_outputs(const CLIConfig& config, const TimeSeries& ts) {
+    profiling::Scope scope("write", ts.size());
+    std::cout << "Writing output to: " << config.output_file << std::endl;
+    
+    // Both outputs only read the series, so they are written side by side
+    bool binary_ok = true;
+    exec::TaskGraph graph;
+    graph.add([&] { CSVWriter(config.output_file).write(ts); });
+    if (config.binary_output) {
+        graph.add([&] { binary_ok = write_binary_output(config, ts); });
+    }
+    graph.run();
+    
+    if (!binary_ok) {
+        std::cerr << "Error: Failed to write binary output" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void apply_gaps(const CLIConfig& config, TimeSeries& ts) {
+    if (config.gap_frequency.empty()) return;
+    profiling::Scope scope("gaps", ts.size());
+    
+    std::vector<int64_t> stamps = gaps::timestamps(ts);
+    gaps::Calendar calendar = config.calendar;
+    if (config.gap_frequency == "auto") {
+        calendar.frequency_ns = gaps::infer_frequency(stamps);
+        if (calendar.frequency_ns == 0) {
+            std::cerr << "Warning: could not infer bar frequency, skipping gap detection" << std::endl;
+            return;
+        }
+        std::cout << "Inferred bar frequency: " << format_duration(calendar.frequency_ns) << std::endl;
+    }
+    
+    std::vector<gaps::Gap> found = gaps::detect(stamps, calendar);
+    std::cout << "Found " << found.size() << " gaps (" << gaps::total_missing(found)
+              << " missing bars)" << std::endl;
+    const size_t shown = std::min<size_t>(found.size(), 10);
+    for (size_t i = 0; i < shown; ++i) {
+        std::cout << "  " << format_datetime(found[i].start_ns) << " .. "
+                  << format_datetime(found[i].end_ns) << ": " << found[i].missing << " bars\n";
+    }
+    if (found.size() > shown) {
+        std::cout << "  ... " << (found.size() - shown) << " more" << std::endl;
+    }
+    
+    if (!config.gap_report.empty()) {
+        gaps::write_report(config.gap_report, found);
+    }
+    
+    if (!config.gap_fill.empty() && !found.empty()) {
+        std::cout << "Filling gaps (" << config.gap_fill << ")..." << std::endl;
+        ts = gaps::fill(ts, found, calendar, gaps::parse_fill_method(config.gap_fill));
+        std::cout << "Now " << ts.size() << " records" << std::endl;
+    }
+}
+
+void apply_downsample(const CLIConfig& config, TimeSeries& ts) {
+    if (config.downsample_points == 0) return;
+    profiling::Scope scope("downsample", ts.size());
+    
+    std::cout << "Downsampling " << config.downsample_col << " to "
+              << config.downsample_points << " points (" << config.downsample_method
+              << ")..." << std::endl;
+    if (config.downsample_method == "minmax") {
+        size_t buckets = std::max<size_t>(1, config.downsample_points / 4);
+        ts = downsample::minmax(ts, buckets, config.downsample_col);
+    } else {
+        ts = downsample::lttb(ts, config.downsample_points, config.downsample_col);
+    }
+    std::cout << "Kept " << ts.size() << " records" << std::endl;
+}
+
+int run_stream(const CLIConfig& config) {
+    ReplayOptions options;
+    options.drop_na = config.drop_na;
+    options.duplicates = parse_duplicate_policy(config.duplicates);
+    options.from_ns = config.from_ns;
+    options.to_ns = config.to_ns;
+    if (!config.replay_speed.empty() && !parse_replay_speed(config.replay_speed, options)) {
+        std::cerr << "Error: Invalid replay speed: " << config.replay_speed << std::endl;
         return 1;
     }
     
-    try {
-        std::cout << "Loading data from: " << config.input_file << std::endl;
-        
-        // Read CSV
-        CSVReader reader(config.input_file);
-        TimeSeries ts = reader.read_to_timeseries(config.drop_na);
-        
-        std::cout << "Loaded " << ts.size() << " records" << std::endl;
-        
-        if (ts.size() == 0) {
-            std::cerr << "Error: No data loaded from input file" << std::endl;
-            return 1;
+    streaming::StreamConfig stream_config;
+    stream_config.sma_windows = config.sma_windows;
+    stream_config.zscore_window = config.compute_rolling_stats ? config.zscore_window : 0;
+    stream_config.zscore_entry = config.zscore_entry;
+    stream_config.zscore_exit = config.zscore_exit;
+    stream_config.fast_sma = config.fast_sma;
+    stream_config.slow_sma = config.slow_sma;
+    stream_config.sma_crossover = config.generate_sma_crossover;
+    stream_config.zscore_signal = config.generate_zscore_signal;
+    
+    std::cout << "Loading data from: " << config.input_file << std::endl;
+    ReplaySource source(config.input_file, options);
+    size_t n = 0;
+    {
+        profiling::Scope scope("load");
+        n = source.load();
+        scope.set_rows(n);
+    }
+    std::cout << "Loaded " << n << " records" << std::endl;
+    
+    if (n == 0) {
+        std::cerr << "Error: No data loaded from input file" << std::endl;
+        return 1;
+    }
+    
+    streaming::StreamPipeline pipeline(stream_config);
+    const bool stage_latency = config.profile || !config.latency_json.empty();
+    if (stage_latency) {
+        pipeline.enable_stage_latency();
+    }
+    const size_t width = pipeline.values().size();
+    
+    // Outputs are captured into a preallocated buffer so the measured
+    // callback only covers the pipeline update itself
+    std::vector<double> outputs(n * width);
+    std::vector<int> signals(n);
+    size_t row = 0;
+    
+    std::cout << "Replaying through streaming pipeline..." << std::endl;
+    {
+        profiling::Scope scope("replay", n);
+        source.run([&](const Bar& bar) {
+            signals[row] = pipeline.update(bar);
+            const auto& values = pipeline.values();
+            for (size_t j = 0; j < width; ++j) {
+                outputs[row * width + j] = values[j].second;
+            }
+            ++row;
+        });
+    }
+    
+    LatencyStats stats = source.latency_stats();
+    std::cout << "Replayed " << stats.count << " events in " << source.elapsed_seconds() << "s\n"
+              << "Latency (ns): min=" << stats.min_ns << " mean=" << stats.mean_ns
+              << " p50=" << stats.p50_ns << " p99=" << stats.p99_ns
+              << " p99.9=" << stats.p999_ns << " max=" << stats.max_ns << std::endl;
+    
+    if (stage_latency) {
+        std::vector<std::pair<std::string, LatencyStats>> latency = {{"ingest_to_signal", stats}};
+        for (const auto& stage : pipeline.stage_latency()) {
+            latency.push_back(stage);
         }
-        
-        // Compute indicators
+        for (const auto& entry : latency) {
+            profiling::Profiler::instance().add_latency("replay/" + entry.first, entry.second);
+        }
+        if (!config.latency_json.empty()) {
+            std::ofstream out(config.latency_json);
+            if (!out) {
+                std::cerr << "Error: Cannot open latency file: " << config.latency_json << std::endl;
+                return 1;
+            }
+            write_latency_json(out, latency);
+            std::cout << "Wrote latency stats to: " << config.latency_json << std::endl;
+        }
+    }
+    
+    // Rebuild the annotated series for output
+    const TimeSeries& rows = source.series();
+    TimeSeries ts;
+    ts.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        Record out = rows[i];
+        for (size_t j = 0; j < width; ++j) {
+            out.indicators[pipeline.values()[j].first] = outputs[i * width + j];
+        }
+        out.signal = signals[i];
+        ts.push(out);
+    }
+    
+    apply_downsample(config, ts);
+    
+    if (!write_outputs(config, ts)) {
+        return 1;
+    }
+    
+    std::cout << "Processing complete!" << std::endl;
+    return 0;
+}
+
+// out.csv + AAPL -> out_AAPL.csv; characters unsafe in file names become '_'
+std::string symbol_path(const std::string& path, const std::string& symbol) {
+    std::string safe = symbol;
+    for (char& c : safe) {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '-' && c != '.') c = '_';
+    }
+    std::filesystem::path p(path);
+    std::filesystem::path name = p.stem().string() + "_" + safe + p.extension().string();
+    return (p.parent_path() / name).string();
+}
+
+bool apply_realized(const CLIConfig& config, TimeSeries& ts) {
+    if (config.realized_bucket <= 0) return true;
+    
+    realized::Options options;
+    options.bucket_ns = config.realized_bucket;
+    realized::Result result = realized::compute(ts, options);
+    std::cout << "Computed realized measures for " << result.daily.size() << " days ("
+              << result.profile.size() << " seasonal buckets)" << std::endl;
+    
+    const std::string profile_path = symbol_path(config.output_file, "seasonality");
+    if (!realized::write_profile(profile_path, result.profile)) {
+        return false;
+    }
+    std::cout << "Wrote seasonal profile to: " << profile_path << std::endl;
+    ts = std::move(result.daily);
+    return true;
+}
+
+// Gaps, indicators, signals, downsampling and output for one loaded series
+bool process_series(const CLIConfig& config, TimeSeries& ts) {
+    // Detect (and optionally fill) missing bars before count-based windows
+    apply_gaps(config, ts);
+    
+    // Intraday bars -> one row per day
+    if (!apply_realized(config, ts)) {
+        return false;
+    }
+    
+    // Compute indicators
+    {
+        profiling::Scope scope("indicators", ts.size());
         for (size_t window : config.sma_windows) {
             std::cout << "Computing SMA(" << window << ")..." << std::endl;
             indicators::add_sma(ts, window, "close");
         }
-        
+    
+        for (size_t window : config.moment_windows) {
+            std::cout << "Computing rolling moments(" << window << ")..." << std::endl;
+            indicators::add_roll_moments(ts, window, "close");
+        }
+    
         if (config.compute_rolling_stats && config.zscore_window > 0) {
             std::cout << "Computing rolling mean/std(" << config.zscore_window << ")..." << std::endl;
             indicators::add_roll_mean_std(ts, config.zscore_window, "close");
-            
+        
             std::cout << "Computing Z-score(" << config.zscore_window << ")..." << std::endl;
             indicators::add_zscore(ts, config.zscore_window, "close");
         }
-        
-        // Generate signals
+    }
+    
+    // Generate signals
+    {
+        profiling::Scope scope("signals", ts.size());
         if (config.generate_sma_crossover && config.fast_sma > 0 && config.slow_sma > 0) {
             std::cout << "Generating SMA crossover signal (fast=" << config.fast_sma 
                       << ", slow=" << config.slow_sma << ")..." << std::endl;
             signals::sma_crossover(ts, config.fast_sma, config.slow_sma, "signal_sma");
         }
-        
+    
         if (config.generate_zscore_signal && config.zscore_window > 0) {
             std::cout << "Generating Z-score mean reversion signal (entry=" 
                       << config.zscore_entry << ", exit=" << config.zscore_exit << ")..." << std::endl;
             signals::zscore_mean_reversion(ts, config.zscore_window, 
                                           config.zscore_entry, config.zscore_exit, "signal_z");
         }
-        
-        // Write output
-        std::cout << "Writing output to: " << config.output_file << std::endl;
-        CSVWriter writer(config.output_file);
-        writer.write(ts);
-        
-        if (config.binary_output) {
-            std::string binary_path = config.output_file + ".bin";
-            std::cout << "Writing binary output to: " << binary_path << std::endl;
-            BinaryWriter bin_writer(binary_path);
-            bin_writer.write(ts);
+    }
+    
+    // Downsample for visualization
+    apply_downsample(config, ts);
+    
+    // Write output
+    return write_outputs(config, ts);
+}
+
+int run_panel(const CLIConfig& config) {
+    std::cout << "Loading long-format data from: " << config.input_file << std::endl;
+    
+    Panel panel;
+    {
+        profiling::Scope scope("load");
+        panel = CSVReader(config.input_file).read_panel(config.symbol_column, config.parse_threads,
+                                                        config.drop_na);
+        scope.set_rows(panel.row_count());
+    }
+    
+    std::cout << "Loaded " << panel.row_count() << " records for " << panel.symbol_count()
+              << " symbols" << std::endl;
+    
+    if (panel.row_count() == 0) {
+        std::cerr << "Error: No data loaded from input file" << std::endl;
+        return 1;
+    }
+    
+    for (uint32_t id = 0; id < panel.symbol_count(); ++id) {
+        const std::string& symbol = panel.symbols().name(id);
+        CLIConfig per_symbol = config;
+        per_symbol.output_file = symbol_path(config.output_file, symbol);
+        if (!config.gap_report.empty()) {
+            per_symbol.gap_report = symbol_path(config.gap_report, symbol);
         }
         
-        std::cout << "Processing complete!" << std::endl;
-        
-    } catch (const std::exception& e) {
-        std::cerr << "Error: " << e.what() << std::endl;
+        std::cout << "\n[" << symbol << "] " << panel.columns(id).size() << " records" << std::endl;
+        size_t duplicates = 0;
+        TimeSeries ts = panel.series(id, parse_duplicate_policy(config.duplicates), &duplicates);
+        if (duplicates > 0) {
+            std::cout << "Resolved " << duplicates << " duplicate timestamps (" << config.duplicates
+                      << ")" << std::endl;
+        }
+        if (config.resample_period > 0) {
+            ts = resample(ts, config.resample_period);
+        }
+        if (!process_series(per_symbol, ts)) {
+            return 1;
+        }
+    }
+    
+    std::cout << "Processing complete!" << std::endl;
+    return 0;
+}
+
+int run_book(const CLIConfig& config) {
+    std::cout << "Loading order events from: " << config.input_file << std::endl;
+    
+    std::vector<book::OrderEvent> events;
+    {
+        profiling::Scope scope("load");
+        if (!book::read_order_events(config.input_file, events, config.parse_threads)) {
+            return 1;
+        }
+        scope.set_rows(events.size());
+    }
+    
+    std::cout << "Loaded " << events.size() << " order events" << std::endl;
+    
+    book::OrderBook order_book(config.tick_size);
+    book::FeatureOptions options;
+    options.interval_ns = config.book_interval;
+    options.depth = config.book_depth;
+    TimeSeries ts;
+    {
+        profiling::Scope scope("book", events.size());
+        ts = book::book_features(events, order_book, options);
+    }
+    
+    std::cout << "Replayed " << order_book.events() << " events (" << order_book.rejected()
+              << " rejected) into " << ts.size() << " samples" << std::endl;
+    
+    if (ts.size() == 0) {
+        std::cerr << "Error: No two-sided book samples in input file" << std::endl;
+        return 1;
+    }
+    
+    if (!process_series(config, ts)) {
+        return 1;
+    }
+    
+    std::cout << "Processing complete!" << std::endl;
+    return 0;
+}
+
+int run_batch(const CLIConfig& config) {
+    if (!config.symbol_column.empty()) {
+        return run_panel(config);
+    }
+    if (config.book_interval >= 0) {
+        return run_book(config);
+    }
+    
+    std::cout << "Loading data from: " << config.input_file << std::endl;
+    
+    // Read CSV (or binary dataset)
+    TimeSeries ts;
+    {
+        profiling::Scope scope("load");
+        ts = load_input(config);
+        scope.set_rows(ts.size());
+    }
+    
+    std::cout << "Loaded " << ts.size() << " records" << std::endl;
+    
+    if (ts.size() == 0) {
+        std::cerr << "Error: No data loaded from input file" << std::endl;
+        return 1;
+    }
+    
+    if (!process_series(config, ts)) {
         return 1;
     }
     
+    std::cout << "Processing complete!" << std::endl;
     return 0;
 }
 
+// tsproc index FILE [--stride N] / tsproc count FILE
+int run_index_command(int argc, char* argv[]) {
+    std::string command = argv[1];
+    if (argc < 3) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    std::string path = argv[2];
+    
+    if (command == "count") {
+        CSVReader reader(path);
+        if (!reader.is_open()) {
+            std::cerr << "Error: Could not open file: " << path << std::endl;
+            return 1;
+        }
+        std::cout << reader.row_count() << std::endl;
+        return 0;
+    }
+    
+    size_t stride = CSVIndex::kDefaultStride;
+    for (int i = 3; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--stride" && i + 1 < argc) {
+            stride = std::stoul(argv[++i]);
+        } else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return 1;
+        }
+    }
+    
+    CSVIndex index;
+    if (!index.build(path, stride) || !index.save(CSVIndex::sidecar_path(path))) {
+        return 1;
+    }
+    std::cout << "Indexed " << index.row_count() << " rows (" << index.entries().size()
+              << " entries) to: " << CSVIndex::sidecar_path(path) << std::endl;
+    return 0;
+}
+
+int run_cli(int argc, char* argv[]) {
+    CLIConfig config;
+    
+    if (argc > 1 && (std::strcmp(argv[1], "index") == 0 || std::strcmp(argv[1], "count") == 0)) {
+        try {
+            return run_index_command(argc, argv);
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+    
+    if (!parse_args(argc, argv, config)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    
+    if (config.profile) {
+        profiling::Profiler::instance().enable();
+    }
+    if (!config.trace_file.empty()) {
+        tracing::Tracer::instance().enable();
+    }
+    if (!config.huge_pages.empty()) {
+        pages::set_huge_pages(pages::parse_huge_pages(config.huge_pages));
+    }
+    if (config.threads_set || config.pin_threads) {
+        exec::SchedulerOptions options;
+        options.threads = config.threads_set ? config.parse_threads : 0;
+        options.pin_threads = config.pin_threads;
+        exec::Scheduler::configure_global(options);
+    }
+    
+    try {
+        int status = config.mode == "stream" ? run_stream(config) : run_batch(config);
+        if (config.profile) {
+            profiling::Profiler::instance().report(std::cout);
+        }
+        if (!config.trace_file.empty()) {
+            tracing::Tracer& tracer = tracing::Tracer::instance();
+            if (!tracer.write(config.trace_file)) return 1;
+            std::cout << "Wrote " << tracer.event_count() << " trace events to: "
+                      << config.trace_file << std::endl;
+        }
+        return status;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
 } // namespace tsproc
 
 int main(int argc, char* argv[]) {
@@ -0,0 +1,165 @@
+#include "numa.hpp"
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace tsproc {
+namespace numa {
+
+namespace {
+
+int parse_cpu(const std::string& text, const std::string& list) {
+    if (text.empty() || !std::all_of(text.begin(), text.end(), [](unsigned char c) { return std::isdigit(c); })) {
+        throw std::invalid_argument("Invalid cpulist: " + list);
+    }
+    return std::stoi(text);
+}
+
+// CPUs the process may run on, or an empty list when unknown
+std::vector<int> allowed_cpus() {
+    std::vector<int> cpus;
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+        }
+    }
+#endif
+    if (cpus.empty()) {
+        unsigned n = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned cpu = 0; cpu < n; ++cpu) cpus.push_back(static_cast<int>(cpu));
+    }
+    return cpus;
+}
+
+bool read_line(const std::string& path, std::string& line) {
+    std::ifstream file(path);
+    return file.is_open() && std::getline(file, line) && !line.empty();
+}
+
+} // namespace
+
+std::vector<int> parse_cpulist(const std::string& text) {
+    std::vector<int> cpus;
+    std::stringstream ss(text);
+    std::string part;
+    while (std::getline(ss, part, ',')) {
+        part.erase(std::remove_if(part.begin(), part.end(), [](unsigned char c) { return std::isspace(c); }),
+                   part.end());
+        if (part.empty()) continue;
+        size_t dash = part.find('-');
+        if (dash == std::string::npos) {
+            cpus.push_back(parse_cpu(part, text));
+            continue;
+        }
+        int first = parse_cpu(part.substr(0, dash), text);
+        int last = parse_cpu(part.substr(dash + 1), text);
+        if (last < first) throw std::invalid_argument("Invalid cpulist: " + text);
+        for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+    }
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return cpus;
+}
+
+// ============================================================================
+// Topology Implementation
+// ============================================================================
+
+Topology::Topology(std::vector<std::vector<int>> node_cpus) {
+    for (auto& cpus : node_cpus) {
+        if (!cpus.empty()) nodes_.push_back(std::move(cpus));
+    }
+    if (nodes_.empty()) {
+        throw std::invalid_argument("Topology needs at least one CPU");
+    }
+    for (size_t node = 0; node < nodes_.size(); ++node) {
+        for (int cpu : nodes_[node]) {
+            if (cpu < 0) throw std::invalid_argument("Negative CPU id in topology");
+            if (static_cast<size_t>(cpu) >= cpu_node_.size()) cpu_node_.resize(cpu + 1, -1);
+            cpu_node_[cpu] = static_cast<int>(node);
+        }
+    }
+}
+
+Topology Topology::detect() {
+    const std::vector<int> allowed = allowed_cpus();
+    std::vector<std::vector<int>> nodes;
+
+    std::string online;
+    if (read_line("/sys/devices/system/node/online", online)) {
+        try {
+            for (int node : parse_cpulist(online)) {
+                std::string list;
+                std::string path = "/sys/devices/system/node/node" + std::to_string(node) + "/cpulist";
+                if (!read_line(path, list)) continue;
+                std::vector<int> cpus;
+                for (int cpu : parse_cpulist(list)) {
+                    if (std::binary_search(allowed.begin(), allowed.end(), cpu)) cpus.push_back(cpu);
+                }
+                nodes.push_back(std::move(cpus));
+            }
+        } catch (const std::invalid_argument&) {
+            nodes.clear();
+        }
+    }
+
+    // Fall back to one node when /sys is missing or disagrees with the mask
+    size_t covered = 0;
+    for (const auto& cpus : nodes) covered += cpus.size();
+    if (covered == 0) return Topology({allowed});
+    return Topology(std::move(nodes));
+}
+
+const Topology& Topology::system() {
+    static const Topology topology = detect();
+    return topology;
+}
+
+size_t Topology::cpu_count() const {
+    size_t n = 0;
+    for (const auto& cpus : nodes_) n += cpus.size();
+    return n;
+}
+
+int Topology::node_of_cpu(int cpu) const {
+    if (cpu < 0 || static_cast<size_t>(cpu) >= cpu_node_.size()) return -1;
+    return cpu_node_[cpu];
+}
+
+size_t Topology::current_node() const {
+    if (nodes_.size() == 1) return 0;
+#if defined(__linux__)
+    int node = node_of_cpu(sched_getcpu());
+    if (node >= 0) return static_cast<size_t>(node);
+#endif
+    return 0;
+}
+
+bool bind_thread(std::thread& thread, const std::vector<int>& cpus) {
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+    }
+    if (CPU_COUNT(&set) == 0) return false;
+    return pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set) == 0;
+#else
+    (void)thread;
+    (void)cpus;
+    return false;
+#endif
+}
+
+} // namespace numa
+} // namespace tsproc
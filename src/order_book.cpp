@@ -0,0 +1,570 @@
+#include "order_book.hpp"
+#include "datetime.hpp"
+#include "tick_parse.hpp"
+#include "trace.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <stdexcept>
+
+namespace tsproc {
+namespace book {
+
+using namespace ticks::detail;
+
+namespace {
+
+// Slots in a side's first window around the touch
+constexpr size_t kInitialLevels = 4096;
+
+// Remaining sizes below this are treated as zero (fractional size residue)
+constexpr double kEmpty = 1e-9;
+
+uint64_t hash(uint64_t id) {
+    id ^= id >> 33;
+    id *= 0xff51afd7ed558ccdULL;
+    id ^= id >> 33;
+    return id;
+}
+
+// Replays `events`, calling on_event after each and on_sample(ts) at each
+// consistent point (see replay())
+template <typename OnEvent, typename OnSample>
+void replay_events(const std::vector<OrderEvent>& events, OrderBook& book, int64_t interval_ns,
+                   OnEvent&& on_event, OnSample&& on_sample) {
+    tracing::Span span("book", "replay", -1, static_cast<int64_t>(events.size()));
+    auto key = [interval_ns](int64_t ts) {
+        return interval_ns > 0 ? floor_div(ts, interval_ns) * interval_ns : ts;
+    };
+    for (size_t i = 0; i < events.size(); ++i) {
+        book.apply(events[i]);
+        on_event(events[i]);
+        const int64_t k = key(events[i].ts);
+        if (i + 1 == events.size() || key(events[i + 1].ts) != k) {
+            on_sample(k);
+        }
+    }
+}
+
+} // namespace
+
+bool parse_event_type(std::string_view s, EventType& type) {
+    if (s.size() > 8) return false;
+    char lower[8];
+    for (size_t i = 0; i < s.size(); ++i) {
+        lower[i] = static_cast<char>(std::tolower(static_cast<unsigned char>(s[i])));
+    }
+    const std::string_view v(lower, s.size());
+    if (v == "a" || v == "add" || v == "new") {
+        type = EventType::Add;
+    } else if (v == "m" || v == "modify" || v == "update" || v == "replace") {
+        type = EventType::Modify;
+    } else if (v == "c" || v == "d" || v == "cancel" || v == "delete") {
+        type = EventType::Cancel;
+    } else if (v == "e" || v == "x" || v == "t" || v == "execute" || v == "fill" || v == "trade") {
+        type = EventType::Execute;
+    } else if (v == "r" || v == "clear" || v == "reset") {
+        type = EventType::Clear;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Ladder
+// ---------------------------------------------------------------------------
+
+bool OrderBook::Ladder::reserve(int64_t tick, size_t max_levels) {
+    if (covers(tick)) return true;
+    if (qty.empty()) {
+        const size_t len = std::min(kInitialLevels, max_levels);
+        base = tick - static_cast<int64_t>(len / 2);
+        qty.assign(len, 0.0);
+        orders.assign(len, 0);
+        return true;
+    }
+
+    // Grow to cover both the old range and `tick`, with slack on each side
+    const int64_t end = base + static_cast<int64_t>(qty.size());
+    const int64_t lo = std::min(base, tick);
+    const int64_t hi = std::max(end, tick + 1);
+    const size_t needed = static_cast<size_t>(hi - lo);
+    if (needed > max_levels) return false;
+    const size_t len = std::min(std::max(2 * qty.size(), needed + qty.size()), max_levels);
+    const int64_t new_base = lo - static_cast<int64_t>((len - needed) / 2);
+
+    std::vector<double> new_qty(len, 0.0);
+    std::vector<uint32_t> new_orders(len, 0);
+    const size_t offset = static_cast<size_t>(base - new_base);
+    std::copy(qty.begin(), qty.end(), new_qty.begin() + static_cast<std::ptrdiff_t>(offset));
+    std::copy(orders.begin(), orders.end(), new_orders.begin() + static_cast<std::ptrdiff_t>(offset));
+    qty.swap(new_qty);
+    orders.swap(new_orders);
+    base = new_base;
+    return true;
+}
+
+// Fix up the occupancy count and best price after slot i changed
+void OrderBook::Ladder::settle(size_t i, bool was_empty) {
+    const int64_t tick = base + static_cast<int64_t>(i);
+    if (qty[i] < kEmpty) {
+        qty[i] = 0.0;
+        orders[i] = 0;
+    }
+    const bool now_empty = qty[i] == 0.0;
+    if (was_empty == now_empty) return;
+
+    if (!now_empty) {
+        ++occupied;
+        if (best == kNone || better(tick, best)) best = tick;
+        return;
+    }
+
+    --occupied;
+    if (tick != best) return;
+    if (occupied == 0) {
+        best = kNone;
+        return;
+    }
+    // The next level is usually a few slots away from the touch
+    if (bids) {
+        size_t j = i;
+        while (qty[--j] == 0.0) {}
+        best = base + static_cast<int64_t>(j);
+    } else {
+        size_t j = i;
+        while (qty[++j] == 0.0) {}
+        best = base + static_cast<int64_t>(j);
+    }
+}
+
+void OrderBook::Ladder::add(int64_t tick, double size, int64_t order_delta) {
+    const size_t i = static_cast<size_t>(tick - base);
+    const bool was_empty = qty[i] == 0.0;
+    qty[i] += size;
+    orders[i] = static_cast<uint32_t>(std::max<int64_t>(0, static_cast<int64_t>(orders[i]) + order_delta));
+    settle(i, was_empty);
+}
+
+void OrderBook::Ladder::set(int64_t tick, double size) {
+    const size_t i = static_cast<size_t>(tick - base);
+    const bool was_empty = qty[i] == 0.0;
+    qty[i] = size;
+    settle(i, was_empty);
+}
+
+void OrderBook::Ladder::clear() {
+    std::fill(qty.begin(), qty.end(), 0.0);
+    std::fill(orders.begin(), orders.end(), 0);
+    best = kNone;
+    occupied = 0;
+}
+
+// ---------------------------------------------------------------------------
+// OrderTable
+// ---------------------------------------------------------------------------
+
+OrderBook::OrderTable::Slot* OrderBook::OrderTable::find(uint64_t id) {
+    if (slots.empty()) return nullptr;
+    const size_t mask = slots.size() - 1;
+    for (size_t i = hash(id) & mask;; i = (i + 1) & mask) {
+        if (slots[i].id == id) return &slots[i];
+        if (slots[i].id == kNoOrder) return nullptr;
+    }
+}
+
+OrderBook::OrderTable::Slot* OrderBook::OrderTable::insert(uint64_t id) {
+    // Keep the load factor at or below 1/2 so probe runs stay short
+    if (2 * (count + 1) > slots.size()) {
+        std::vector<Slot> old;
+        old.swap(slots);
+        slots.assign(std::max<size_t>(64, 2 * old.size()), Slot());
+        const size_t mask = slots.size() - 1;
+        for (const Slot& s : old) {
+            if (s.id == kNoOrder) continue;
+            size_t i = hash(s.id) & mask;
+            while (slots[i].id != kNoOrder) i = (i + 1) & mask;
+            slots[i] = s;
+        }
+    }
+
+    const size_t mask = slots.size() - 1;
+    size_t i = hash(id) & mask;
+    for (; slots[i].id != kNoOrder; i = (i + 1) & mask) {
+        if (slots[i].id == id) return nullptr;
+    }
+    slots[i].id = id;
+    ++count;
+    return &slots[i];
+}
+
+void OrderBook::OrderTable::erase(Slot* slot) {
+    // Backward-shift deletion: later entries of the probe run move up, so
+    // lookups never need tombstones
+    const size_t mask = slots.size() - 1;
+    size_t hole = static_cast<size_t>(slot - slots.data());
+    for (size_t i = (hole + 1) & mask; slots[i].id != kNoOrder; i = (i + 1) & mask) {
+        const size_t home = hash(slots[i].id) & mask;
+        // Move slot i into the hole unless its home lies cyclically in (hole, i]
+        const bool stays = hole <= i ? (home > hole && home <= i) : (home > hole || home <= i);
+        if (!stays) {
+            slots[hole] = slots[i];
+            hole = i;
+        }
+    }
+    slots[hole] = Slot();
+    --count;
+}
+
+void OrderBook::OrderTable::clear() {
+    std::fill(slots.begin(), slots.end(), Slot());
+    count = 0;
+}
+
+// ---------------------------------------------------------------------------
+// OrderBook
+// ---------------------------------------------------------------------------
+
+OrderBook::OrderBook(double tick_size, size_t max_levels)
+    : tick_size_(tick_size), max_levels_(max_levels) {
+    if (!(tick_size > 0.0)) {
+        throw std::invalid_argument("OrderBook tick size must be positive");
+    }
+    if (max_levels == 0) {
+        throw std::invalid_argument("OrderBook needs at least one price level");
+    }
+    bids_.bids = true;
+    asks_.bids = false;
+}
+
+int64_t OrderBook::to_tick(double price) const {
+    return static_cast<int64_t>(std::llround(price / tick_size_));
+}
+
+void OrderBook::clear() {
+    bids_.clear();
+    asks_.clear();
+    orders_.clear();
+}
+
+bool OrderBook::apply(const OrderEvent& e) {
+    ++events_;
+    bool ok = true;
+    if (e.type == EventType::Clear) {
+        clear();
+    } else if (e.side != Side::Buy && e.side != Side::Sell) {
+        ok = false;
+    } else {
+        ok = e.order_id == kNoOrder ? apply_level(e) : apply_order(e);
+    }
+    if (!ok) ++rejected_;
+    return ok;
+}
+
+bool OrderBook::apply_level(const OrderEvent& e) {
+    Ladder& side = ladder(e.side);
+    const int64_t tick = to_tick(e.price);
+    if (!side.reserve(tick, max_levels_)) return false;
+
+    switch (e.type) {
+        case EventType::Add:
+            side.add(tick, e.size, 0);
+            break;
+        case EventType::Modify:
+            side.set(tick, e.size);
+            break;
+        case EventType::Execute:
+            traded_ += e.size;
+            side.add(tick, -e.size, 0);
+            break;
+        case EventType::Cancel:
+            side.add(tick, -e.size, 0);
+            break;
+        case EventType::Clear:
+            break;
+    }
+    return true;
+}
+
+bool OrderBook::apply_order(const OrderEvent& e) {
+    if (e.type == EventType::Add) {
+        Ladder& side = ladder(e.side);
+        const int64_t tick = to_tick(e.price);
+        if (!side.reserve(tick, max_levels_)) return false;
+        OrderTable::Slot* order = orders_.insert(e.order_id);
+        if (order == nullptr) return false;
+        order->tick = tick;
+        order->size = e.size;
+        order->side = e.side;
+        side.add(tick, e.size, 1);
+        return true;
+    }
+
+    OrderTable::Slot* order = orders_.find(e.order_id);
+    if (order == nullptr) return false;
+    Ladder& side = ladder(order->side);
+
+    double remaining = order->size;
+    switch (e.type) {
+        case EventType::Modify: {
+            const int64_t tick = e.price > 0.0 ? to_tick(e.price) : order->tick;
+            if (tick != order->tick) {
+                if (!side.reserve(tick, max_levels_)) return false;
+                side.add(order->tick, -order->size, -1);
+                side.add(tick, e.size, 1);
+                order->tick = tick;
+                order->size = e.size;
+            } else {
+                side.add(tick, e.size - order->size, 0);
+                order->size = e.size;
+            }
+            remaining = e.size;
+            break;
+        }
+        case EventType::Cancel: {
+            const double removed = e.size > 0.0 ? std::min(e.size, order->size) : order->size;
+            remaining = order->size - removed;
+            side.add(order->tick, -removed, remaining < kEmpty ? -1 : 0);
+            order->size = remaining;
+            break;
+        }
+        case EventType::Execute: {
+            const double filled = std::min(e.size, order->size);
+            traded_ += filled;
+            remaining = order->size - filled;
+            side.add(order->tick, -filled, remaining < kEmpty ? -1 : 0);
+            order->size = remaining;
+            break;
+        }
+        default:
+            break;
+    }
+    if (remaining < kEmpty) {
+        if (e.type == EventType::Modify) side.add(order->tick, 0.0, -1);
+        orders_.erase(order);
+    }
+    return true;
+}
+
+double OrderBook::best_bid() const {
+    return bids_.best == kNone ? NAN : to_price(bids_.best);
+}
+
+double OrderBook::best_ask() const {
+    return asks_.best == kNone ? NAN : to_price(asks_.best);
+}
+
+double OrderBook::best_size(Side side) const {
+    const Ladder& l = ladder(side);
+    return l.best == kNone ? 0.0 : l.qty[static_cast<size_t>(l.best - l.base)];
+}
+
+uint32_t OrderBook::best_orders(Side side) const {
+    const Ladder& l = ladder(side);
+    return l.best == kNone ? 0 : l.orders[static_cast<size_t>(l.best - l.base)];
+}
+
+size_t OrderBook::levels(Side side, size_t depth, std::vector<PriceLevel>& out) const {
+    out.clear();
+    const Ladder& l = ladder(side);
+    if (l.best == kNone) return 0;
+    const int64_t step = l.bids ? -1 : 1;
+    const int64_t end = l.base + static_cast<int64_t>(l.qty.size());
+    for (int64_t tick = l.best; tick >= l.base && tick < end && out.size() < depth; tick += step) {
+        const size_t i = static_cast<size_t>(tick - l.base);
+        if (l.qty[i] == 0.0) continue;
+        PriceLevel level;
+        level.price = to_price(tick);
+        level.size = l.qty[i];
+        level.orders = l.orders[i];
+        out.push_back(level);
+    }
+    return out.size();
+}
+
+double OrderBook::depth(Side side, size_t depth) const {
+    const Ladder& l = ladder(side);
+    if (l.best == kNone) return 0.0;
+    const int64_t step = l.bids ? -1 : 1;
+    const int64_t end = l.base + static_cast<int64_t>(l.qty.size());
+    double total = 0.0;
+    size_t seen = 0;
+    for (int64_t tick = l.best; tick >= l.base && tick < end && seen < depth; tick += step) {
+        const double q = l.qty[static_cast<size_t>(tick - l.base)];
+        if (q == 0.0) continue;
+        total += q;
+        ++seen;
+    }
+    return total;
+}
+
+// ---------------------------------------------------------------------------
+// Ingest and replay
+// ---------------------------------------------------------------------------
+
+namespace {
+
+struct EventLayout {
+    size_t ts;
+    size_t type;
+    size_t side;
+    size_t price;
+    size_t size;
+    size_t order_id;   // SIZE_MAX when absent (L2)
+    size_t fields;
+};
+
+// Chunk of parsed events, in the shape parse_chunks() appends
+struct EventBatch {
+    std::vector<OrderEvent> events;
+
+    size_t rows() const { return events.size(); }
+    void reserve(size_t rows) { events.reserve(rows); }
+    void append(const EventBatch& other) {
+        events.insert(events.end(), other.events.begin(), other.events.end());
+    }
+};
+
+bool parse_order_id(Field f, uint64_t& out) {
+    f = trim(f);
+    if (f.begin == f.end || f.end - f.begin > 19) return false;
+    uint64_t id = 0;
+    for (const char* p = f.begin; p < f.end; ++p) {
+        if (*p < '0' || *p > '9') return false;
+        id = id * 10 + static_cast<uint64_t>(*p - '0');
+    }
+    out = id;
+    return true;
+}
+
+void parse_event_chunk(const char* begin, const char* end, char delimiter, const EventLayout& layout,
+                       EventBatch& out) {
+    tracing::Span span("book", "parse_events");
+    std::string scratch;
+    for_each_row(begin, end, delimiter, layout.fields, [&](const Field* f, size_t count) {
+        if (count <= std::max(layout.ts, layout.type)) return;
+        OrderEvent e;
+        Field type = trim(f[layout.type]);
+        if (!parse_timestamp(f[layout.ts], scratch, e.ts) ||
+            !parse_event_type(std::string_view(type.begin, static_cast<size_t>(type.end - type.begin)),
+                              e.type)) {
+            return;
+        }
+        if (e.type != EventType::Clear) {
+            if (count < layout.fields) return;
+            Field side = trim(f[layout.side]);
+            e.side = ticks::parse_side(std::string_view(side.begin, static_cast<size_t>(side.end - side.begin)));
+            Field size = trim(f[layout.size]);
+            const bool size_ok = size.begin == size.end ? (e.size = 0.0, true) : parse_number(size, e.size);
+            if (!parse_number(f[layout.price], e.price) || !size_ok) return;
+            if (layout.order_id != SIZE_MAX && !parse_order_id(f[layout.order_id], e.order_id)) return;
+        }
+        out.events.push_back(e);
+    });
+    span.set_rows(static_cast<int64_t>(out.rows()));
+}
+
+} // namespace
+
+bool parse_order_events(const char* data, size_t size, std::vector<OrderEvent>& out,
+                        size_t threads, char delimiter) {
+    Field header[kMaxFields];
+    const char* rows = nullptr;
+    const size_t count = read_header(data, size, delimiter, header, rows);
+
+    EventLayout layout;
+    layout.ts = find_column(header, count, {"ts", "timestamp", "time", "datetime", "date"});
+    layout.type = find_column(header, count, {"type", "action", "event"});
+    layout.side = find_column(header, count, {"side"});
+    layout.price = find_column(header, count, {"price", "px"});
+    layout.size = find_column(header, count, {"size", "qty", "quantity"});
+    layout.order_id = find_column(header, count, {"order_id", "id", "order"});
+    if (missing(layout.ts, "timestamp") || missing(layout.type, "type") ||
+        missing(layout.side, "side") || missing(layout.price, "price") || missing(layout.size, "size")) {
+        return false;
+    }
+    layout.fields = std::max({layout.ts, layout.type, layout.side, layout.price, layout.size,
+                              layout.order_id == SIZE_MAX ? 0 : layout.order_id}) + 1;
+
+    EventBatch batch;
+    batch.events.swap(out);
+    parse_chunks(rows, data + size, threads, batch,
+                 [&](const char* begin, const char* end, EventBatch& part) {
+                     parse_event_chunk(begin, end, delimiter, layout, part);
+                 });
+    out.swap(batch.events);
+    return true;
+}
+
+bool read_order_events(const std::string& path, std::vector<OrderEvent>& out, size_t threads,
+                       char delimiter) {
+    pages::MappedFile mapped;
+    std::string buffer;
+    const char* data = nullptr;
+    size_t size = 0;
+    return load_file(path, mapped, buffer, data, size) &&
+           parse_order_events(data, size, out, threads, delimiter);
+}
+
+void replay(const std::vector<OrderEvent>& events, OrderBook& book, int64_t interval_ns,
+            const std::function<void(int64_t ts, const OrderBook& book)>& sample) {
+    replay_events(events, book, interval_ns, [](const OrderEvent&) {},
+                  [&](int64_t ts) { sample(ts, book); });
+}
+
+TimeSeries book_features(const std::vector<OrderEvent>& events, OrderBook& book,
+                         const FeatureOptions& options) {
+    TimeSeries ts;
+    Record bar;
+    bool open = false;          // a mid has been seen in the current interval
+    double traded_at_start = book.traded_volume();
+
+    auto on_event = [&](const OrderEvent&) {
+        const double bid = book.best_bid();
+        const double ask = book.best_ask();
+        if (std::isnan(bid) || std::isnan(ask)) return;
+        const double mid = 0.5 * (bid + ask);
+        if (!open) {
+            bar.open = bar.high = bar.low = mid;
+            open = true;
+        }
+        bar.high = std::max(bar.high, mid);
+        bar.low = std::min(bar.low, mid);
+    };
+
+    auto on_sample = [&](int64_t t) {
+        const double bid = book.best_bid();
+        const double ask = book.best_ask();
+        if (open && !std::isnan(bid) && !std::isnan(ask)) {
+            const ticks::Quote q{t, bid, ask, book.best_size(Side::Buy), book.best_size(Side::Sell)};
+            const ticks::QuoteMetrics m = ticks::quote_metrics(q);
+            const double bid_depth = book.depth(Side::Buy, options.depth);
+            const double ask_depth = book.depth(Side::Sell, options.depth);
+            const double total = bid_depth + ask_depth;
+
+            bar.date = format_datetime(t);
+            bar.close = bar.adj_close = m.mid;
+            bar.volume = book.traded_volume() - traded_at_start;
+            bar.indicators.clear();
+            bar.indicators["spread"] = m.spread;
+            bar.indicators["microprice"] = m.microprice;
+            bar.indicators["bid_size"] = q.bid_size;
+            bar.indicators["ask_size"] = q.ask_size;
+            bar.indicators["bid_orders"] = book.best_orders(Side::Buy);
+            bar.indicators["ask_orders"] = book.best_orders(Side::Sell);
+            bar.indicators["bid_depth"] = bid_depth;
+            bar.indicators["ask_depth"] = ask_depth;
+            bar.indicators["depth_imbalance"] = total > 0.0 ? (bid_depth - ask_depth) / total : 0.0;
+            ts.push(bar);
+        }
+        open = false;
+        traded_at_start = book.traded_volume();
+    };
+
+    replay_events(events, book, options.interval_ns, on_event, on_sample);
+    return ts;
+}
+
+} // namespace book
+} // namespace tsproc
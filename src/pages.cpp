@@ -0,0 +1,273 @@
+#include "pages.hpp"
+#include "profiler.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <initializer_list>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace tsproc {
+namespace pages {
+
+namespace {
+
+struct Counters {
+    std::atomic<uint64_t> heap_blocks{0};
+    std::atomic<uint64_t> heap_bytes{0};
+    std::atomic<uint64_t> transparent_blocks{0};
+    std::atomic<uint64_t> transparent_bytes{0};
+    std::atomic<uint64_t> explicit_blocks{0};
+    std::atomic<uint64_t> explicit_bytes{0};
+    std::atomic<uint64_t> explicit_fallbacks{0};
+    std::atomic<uint64_t> mapped_files{0};
+    std::atomic<uint64_t> mapped_file_bytes{0};
+    std::atomic<uint64_t> huge_resident_peak{0};
+};
+
+Counters& counters() {
+    static Counters c;
+    return c;
+}
+
+HugePages default_mode() {
+    if (const char* env = std::getenv("TSPROC_HUGE_PAGES")) {
+        try {
+            return parse_huge_pages(env);
+        } catch (const std::invalid_argument&) {
+        }
+    }
+    return HugePages::Transparent;
+}
+
+std::atomic<int>& mode_slot() {
+    static std::atomic<int> mode{static_cast<int>(default_mode())};
+    return mode;
+}
+
+size_t round_up(size_t bytes, size_t unit) {
+    return (bytes + unit - 1) / unit * unit;
+}
+
+void count(std::atomic<uint64_t>& blocks, std::atomic<uint64_t>& total, size_t bytes) {
+    blocks.fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+#if defined(__linux__)
+// Sum of the given "Name:  N kB" fields of /proc/self/smaps_rollup
+uint64_t smaps_bytes(std::initializer_list<const char*> fields) {
+    std::ifstream file("/proc/self/smaps_rollup");
+    std::string line;
+    uint64_t total = 0;
+    while (std::getline(file, line)) {
+        for (const char* field : fields) {
+            const std::string prefix = std::string(field) + ":";
+            if (line.compare(0, prefix.size(), prefix) != 0) continue;
+            std::istringstream ss(line.substr(prefix.size()));
+            uint64_t kb = 0;
+            if (ss >> kb) total += kb * 1024;
+        }
+    }
+    return total;
+}
+
+// Huge-page-backed bytes resident now, folded into the peak
+uint64_t sample_huge_resident() {
+    const uint64_t now = smaps_bytes({"AnonHugePages", "FilePmdMapped", "Private_Hugetlb"});
+    std::atomic<uint64_t>& peak = counters().huge_resident_peak;
+    uint64_t seen = peak.load(std::memory_order_relaxed);
+    while (now > seen && !peak.compare_exchange_weak(seen, now, std::memory_order_relaxed)) {
+    }
+    return now;
+}
+
+// Anonymous mapping of `mapped` bytes aligned to kHugePageSize, or nullptr
+void* map_aligned(size_t mapped) {
+    const size_t span = mapped + kHugePageSize;
+    void* raw = mmap(nullptr, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) return nullptr;
+    // Trim the unaligned head and the tail so the kernel can use whole huge pages
+    const uintptr_t base = reinterpret_cast<uintptr_t>(raw);
+    const uintptr_t aligned = (base + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+    if (aligned > base) munmap(raw, aligned - base);
+    const size_t tail = span - (aligned - base) - mapped;
+    if (tail > 0) munmap(reinterpret_cast<void*>(aligned + mapped), tail);
+    return reinterpret_cast<void*>(aligned);
+}
+#endif
+
+} // namespace
+
+const char* huge_pages_name(HugePages mode) {
+    switch (mode) {
+        case HugePages::Off: return "off";
+        case HugePages::Transparent: return "thp";
+        case HugePages::Explicit: return "hugetlb";
+    }
+    return "off";
+}
+
+HugePages parse_huge_pages(const std::string& name) {
+    if (name == "off") return HugePages::Off;
+    if (name == "thp") return HugePages::Transparent;
+    if (name == "hugetlb") return HugePages::Explicit;
+    throw std::invalid_argument("Unknown huge page mode: " + name + " (expected off, thp or hugetlb)");
+}
+
+HugePages huge_pages() {
+    return static_cast<HugePages>(mode_slot().load(std::memory_order_relaxed));
+}
+
+void set_huge_pages(HugePages mode) {
+    mode_slot().store(static_cast<int>(mode), std::memory_order_relaxed);
+}
+
+// ============================================================================
+// Block allocation
+// ============================================================================
+
+Block allocate(size_t bytes) {
+    Block block;
+    block.bytes = bytes;
+    if (bytes == 0) return block;
+
+    Counters& c = counters();
+#if defined(__linux__)
+    const HugePages mode = huge_pages();
+    if (bytes >= kHugeThreshold && mode != HugePages::Off) {
+        const size_t mapped = round_up(bytes, kHugePageSize);
+        if (mode == HugePages::Explicit) {
+            void* p = mmap(nullptr, mapped, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (p != MAP_FAILED) {
+                block.data = p;
+                block.mapped = mapped;
+                block.backing = Backing::Explicit;
+                count(c.explicit_blocks, c.explicit_bytes, mapped);
+                return block;
+            }
+            c.explicit_fallbacks.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (void* p = map_aligned(mapped)) {
+            madvise(p, mapped, MADV_HUGEPAGE);  // best effort: THP may be disabled
+            block.data = p;
+            block.mapped = mapped;
+            block.backing = Backing::Transparent;
+            count(c.transparent_blocks, c.transparent_bytes, mapped);
+            return block;
+        }
+    }
+#endif
+    block.data = ::operator new(bytes, std::align_val_t(kPageSize));
+    count(c.heap_blocks, c.heap_bytes, bytes);
+    return block;
+}
+
+void release(Block& block) {
+    if (!block.data) return;
+#if defined(__linux__)
+    if (block.backing != Backing::Heap) {
+        // Sampled before unmapping, while the block still counts; the smaps
+        // read only feeds the --profile peak, so it is skipped otherwise
+        if (profiling::Profiler::instance().enabled()) sample_huge_resident();
+        munmap(block.data, block.mapped);
+        block = Block();
+        return;
+    }
+#endif
+    ::operator delete(block.data, std::align_val_t(kPageSize));
+    block = Block();
+}
+
+// ============================================================================
+// MappedFile Implementation
+// ============================================================================
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& path) {
+    close();
+#if defined(__linux__)
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+    const size_t size = static_cast<size_t>(st.st_size);
+    void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // the mapping keeps the file referenced
+    if (p == MAP_FAILED) return false;
+
+    data_ = static_cast<const char*>(p);
+    size_ = size;
+    if (size >= kHugeThreshold && huge_pages() != HugePages::Off) {
+        huge_ = madvise(p, size, MADV_HUGEPAGE) == 0;
+    }
+    Counters& c = counters();
+    count(c.mapped_files, c.mapped_file_bytes, size);
+    return true;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+void MappedFile::close() {
+#if defined(__linux__)
+    if (data_) {
+        if (huge_ && profiling::Profiler::instance().enabled()) sample_huge_resident();
+        munmap(const_cast<char*>(data_), size_);
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    huge_ = false;
+}
+
+// ============================================================================
+// Statistics
+// ============================================================================
+
+PageStats stats() {
+    const Counters& c = counters();
+    PageStats s;
+    s.heap_blocks = c.heap_blocks.load();
+    s.heap_bytes = c.heap_bytes.load();
+    s.transparent_blocks = c.transparent_blocks.load();
+    s.transparent_bytes = c.transparent_bytes.load();
+    s.explicit_blocks = c.explicit_blocks.load();
+    s.explicit_bytes = c.explicit_bytes.load();
+    s.explicit_fallbacks = c.explicit_fallbacks.load();
+    s.mapped_files = c.mapped_files.load();
+    s.mapped_file_bytes = c.mapped_file_bytes.load();
+#if defined(__linux__)
+    s.huge_resident_bytes = sample_huge_resident();
+#endif
+    s.huge_resident_peak_bytes = c.huge_resident_peak.load();
+    return s;
+}
+
+void reset_stats() {
+    Counters& c = counters();
+    for (auto* counter : {&c.heap_blocks, &c.heap_bytes, &c.transparent_blocks, &c.transparent_bytes,
+                          &c.explicit_blocks, &c.explicit_bytes, &c.explicit_fallbacks,
+                          &c.mapped_files, &c.mapped_file_bytes, &c.huge_resident_peak}) {
+        counter->store(0);
+    }
+}
+
+} // namespace pages
+} // namespace tsproc
@@ -0,0 +1,148 @@
+#include "panel.hpp"
+#include "scheduler.hpp"
+#include "trace.hpp"
+#include <utility>
+
+namespace tsproc {
+
+uint32_t SymbolTable::intern(std::string_view name) {
+    auto it = ids_.find(name);
+    if (it != ids_.end()) return it->second;
+
+    const uint32_t id = static_cast<uint32_t>(names_.size());
+    names_.emplace_back(name);
+    ids_.emplace(std::string_view(names_.back()), id);
+    return id;
+}
+
+bool SymbolTable::find(std::string_view name, uint32_t& id) const {
+    auto it = ids_.find(name);
+    if (it == ids_.end()) return false;
+    id = it->second;
+    return true;
+}
+
+void SymbolColumns::push(const Bar& b) {
+    ts.push_back(b.ts);
+    open.push_back(b.open);
+    high.push_back(b.high);
+    low.push_back(b.low);
+    close.push_back(b.close);
+    adj_close.push_back(b.adj_close);
+    volume.push_back(b.volume);
+}
+
+void SymbolColumns::reserve(size_t rows) {
+    ts.reserve(rows);
+    open.reserve(rows);
+    high.reserve(rows);
+    low.reserve(rows);
+    close.reserve(rows);
+    adj_close.reserve(rows);
+    volume.reserve(rows);
+}
+
+void SymbolColumns::append(const SymbolColumns& other) {
+    ts.insert(ts.end(), other.ts.begin(), other.ts.end());
+    open.insert(open.end(), other.open.begin(), other.open.end());
+    high.insert(high.end(), other.high.begin(), other.high.end());
+    low.insert(low.end(), other.low.begin(), other.low.end());
+    close.insert(close.end(), other.close.begin(), other.close.end());
+    adj_close.insert(adj_close.end(), other.adj_close.begin(), other.adj_close.end());
+    volume.insert(volume.end(), other.volume.begin(), other.volume.end());
+}
+
+Bar SymbolColumns::bar(size_t i) const {
+    Bar b;
+    b.ts = ts[i];
+    b.open = open[i];
+    b.high = high[i];
+    b.low = low[i];
+    b.close = close[i];
+    b.adj_close = adj_close[i];
+    b.volume = volume[i];
+    return b;
+}
+
+std::vector<Bar> SymbolColumns::to_bars() const {
+    std::vector<Bar> bars;
+    bars.reserve(size());
+    for (size_t i = 0; i < size(); ++i) bars.push_back(bar(i));
+    return bars;
+}
+
+uint32_t Panel::add_symbol(std::string_view symbol) {
+    const uint32_t id = symbols_.intern(symbol);
+    if (id == columns_.size()) columns_.emplace_back();
+    return id;
+}
+
+size_t Panel::row_count() const {
+    size_t total = 0;
+    for (const auto& c : columns_) total += c.size();
+    return total;
+}
+
+const SymbolColumns* Panel::find(std::string_view symbol) const {
+    uint32_t id = 0;
+    return symbols_.find(symbol, id) ? &columns_[id] : nullptr;
+}
+
+TimeSeries Panel::series(uint32_t id, DuplicatePolicy policy, size_t* duplicates) const {
+    const SymbolColumns& c = columns_[id];
+    TimeSeries ts;
+    ts.reserve(c.size());
+    DuplicateResolver rows(ts, policy);
+    for (size_t i = 0; i < c.size(); ++i) rows.push(to_record(c.bar(i)), c.ts[i]);
+    if (duplicates) *duplicates = rows.duplicates();
+    return ts;
+}
+
+Panel Panel::merge(std::vector<Panel>& parts) {
+    Panel out;
+    if (parts.empty()) return out;
+
+    // Remap every part's local ids onto the global table, in part order,
+    // and list for each global symbol the (part, local id) pairs feeding it
+    struct Source {
+        size_t part;
+        uint32_t id;
+    };
+    std::vector<std::vector<Source>> sources;
+    for (size_t p = 0; p < parts.size(); ++p) {
+        const SymbolTable& local = parts[p].symbols_;
+        for (uint32_t id = 0; id < local.size(); ++id) {
+            const uint32_t global = out.add_symbol(local.name(id));
+            if (global == sources.size()) sources.emplace_back();
+            sources[global].push_back({p, id});
+        }
+    }
+
+    tracing::Span span("panel", "merge", -1, static_cast<int64_t>(out.symbol_count()));
+    exec::parallel_for(0, out.columns_.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t g = begin; g < end; ++g) {
+            const std::vector<Source>& from = sources[g];
+            SymbolColumns& dst = out.columns_[g];
+
+            // The first part interned first, so its ids are global ids too
+            size_t next = 0;
+            if (from.front().part == 0) {
+                dst = std::move(parts[0].columns_[from.front().id]);
+                next = 1;
+            }
+            size_t total = dst.size();
+            for (size_t s = next; s < from.size(); ++s) {
+                total += parts[from[s].part].columns_[from[s].id].size();
+            }
+            dst.reserve(total);
+            for (size_t s = next; s < from.size(); ++s) {
+                SymbolColumns& src = parts[from[s].part].columns_[from[s].id];
+                dst.append(src);
+                src = SymbolColumns();
+            }
+        }
+    });
+    return out;
+}
+
+} // namespace tsproc
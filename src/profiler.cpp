@@ -0,0 +1,389 @@
+#include "profiler.hpp"
+#include "kernels.hpp"
+#include "pages.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace tsproc {
+namespace profiling {
+
+namespace {
+
+const char* const kEventNames[kEventCount] = {
+    "cycles", "instructions", "L1d-misses", "LLC-misses", "branch-misses"};
+
+int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+#ifdef __linux__
+struct EventSpec {
+    uint32_t type;
+    uint64_t config;
+};
+
+EventSpec event_spec(size_t event) {
+    switch (event) {
+        case kCycles:
+            return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES};
+        case kInstructions:
+            return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS};
+        case kL1DMisses:
+            return {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D |
+                                            (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                            (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)};
+        case kLLCMisses:
+            return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES};
+        default:
+            return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES};
+    }
+}
+
+int open_event(size_t event) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    EventSpec spec = event_spec(event);
+    attr.size = sizeof(attr);
+    attr.type = spec.type;
+    attr.config = spec.config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+#endif
+
+// Nesting of the scopes open on this thread
+thread_local std::string tls_path;
+thread_local size_t tls_depth = 0;
+thread_local size_t tls_stage = kNoStage;
+
+// Counters are per thread; opened on first use by a profiled thread
+PerfCounters& thread_counters() {
+    thread_local PerfCounters counters;
+    return counters;
+}
+
+} // namespace
+
+size_t current_stage() {
+    return tls_stage;
+}
+
+const char* event_name(size_t event) {
+    return event < kEventCount ? kEventNames[event] : "?";
+}
+
+CounterSample CounterSample::since(const CounterSample& earlier) const {
+    CounterSample d;
+    for (size_t e = 0; e < kEventCount; ++e) {
+        d.valid[e] = valid[e] && earlier.valid[e];
+        d.values[e] = d.valid[e] && values[e] >= earlier.values[e] ? values[e] - earlier.values[e] : 0;
+    }
+    return d;
+}
+
+CounterSample& CounterSample::operator+=(const CounterSample& other) {
+    for (size_t e = 0; e < kEventCount; ++e) {
+        values[e] += other.values[e];
+        valid[e] = valid[e] || other.valid[e];
+    }
+    return *this;
+}
+
+bool CounterSample::any_valid() const {
+    for (bool v : valid) {
+        if (v) return true;
+    }
+    return false;
+}
+
+PerfCounters::PerfCounters() {
+    for (int& fd : fds_) fd = -1;
+#ifdef __linux__
+    int first_error = 0;
+    for (size_t e = 0; e < kEventCount; ++e) {
+        fds_[e] = open_event(e);
+        if (fds_[e] < 0 && first_error == 0) first_error = errno;
+    }
+    if (!available()) {
+        status_ = std::string("perf_event_open: ") + std::strerror(first_error);
+        if (first_error == EACCES || first_error == EPERM) {
+            status_ += " (check /proc/sys/kernel/perf_event_paranoid)";
+        }
+    }
+#else
+    status_ = "hardware counters require Linux perf_event_open";
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+    for (int fd : fds_) {
+        if (fd >= 0) close(fd);
+    }
+#endif
+}
+
+bool PerfCounters::available() const {
+    for (int fd : fds_) {
+        if (fd >= 0) return true;
+    }
+    return false;
+}
+
+CounterSample PerfCounters::read() const {
+    CounterSample sample;
+#ifdef __linux__
+    for (size_t e = 0; e < kEventCount; ++e) {
+        if (fds_[e] < 0) continue;
+        uint64_t buf[3];  // value, time enabled, time running
+        if (::read(fds_[e], buf, sizeof(buf)) != static_cast<ssize_t>(sizeof(buf)) ||
+            buf[2] == 0) {
+            continue;  // never scheduled onto the PMU
+        }
+        double scale = buf[2] < buf[1] ? static_cast<double>(buf[1]) / static_cast<double>(buf[2]) : 1.0;
+        sample.values[e] = static_cast<uint64_t>(static_cast<double>(buf[0]) * scale);
+        sample.valid[e] = true;
+    }
+#endif
+    return sample;
+}
+
+Profiler& Profiler::instance() {
+    static Profiler profiler;
+    return profiler;
+}
+
+void Profiler::enable(bool hardware_counters) {
+    counters_ = false;
+    counter_status_ = hardware_counters ? "" : "disabled";
+    if (hardware_counters) {
+        const PerfCounters& counters = thread_counters();
+        counters_ = counters.available();
+        counter_status_ = counters.status();
+    }
+    enabled_.store(true, std::memory_order_relaxed);
+}
+
+void Profiler::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stages_.clear();
+    parents_.clear();
+    latencies_.clear();
+}
+
+std::vector<StageStats> Profiler::stages() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stages_;
+}
+
+size_t Profiler::stage_index(const std::string& path, size_t depth) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < stages_.size(); ++i) {
+        if (stages_[i].path == path) return i;
+    }
+    StageStats s;
+    s.path = path;
+    s.depth = depth;
+    // The enclosing scope is open, so its stage exists
+    size_t parent = kNoStage;
+    const size_t slash = path.rfind('/');
+    if (slash != std::string::npos) {
+        for (size_t i = 0; i < stages_.size(); ++i) {
+            if (stages_[i].path.compare(0, std::string::npos, path, 0, slash) == 0) parent = i;
+        }
+    }
+    stages_.push_back(s);
+    parents_.push_back(parent);
+    return stages_.size() - 1;
+}
+
+void Profiler::add(size_t index, size_t rows, double seconds, const CounterSample& counters) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    StageStats& s = stages_[index];
+    ++s.calls;
+    s.rows += rows;
+    s.seconds += seconds;
+    s.counters += counters;
+}
+
+void Profiler::add_counters(size_t index, const CounterSample& counters) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Nested stages are part of their parents, as when counted on one thread
+    for (; index < stages_.size(); index = parents_[index]) stages_[index].counters += counters;
+}
+
+void Profiler::add_latency(const std::string& name, const LatencyStats& stats) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& entry : latencies_) {
+        if (entry.first == name) {
+            entry.second = stats;
+            return;
+        }
+    }
+    latencies_.emplace_back(name, stats);
+}
+
+std::vector<std::pair<std::string, LatencyStats>> Profiler::latencies() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return latencies_;
+}
+
+void Profiler::report(std::ostream& os) const {
+    std::vector<StageStats> snapshot = stages();
+    char line[256];
+
+    os << "\nProfile (kernels: " << kernels::isa_name(kernels::active_isa()) << ")";
+    if (!counters_) {
+        os << " (hardware counters unavailable: " << counter_status_ << ")";
+    }
+    os << "\n";
+
+    int n = std::snprintf(line, sizeof(line), "%-28s %6s %10s %11s", "stage", "calls", "time ms",
+                          "rows");
+    os.write(line, n);
+    if (counters_) {
+        n = std::snprintf(line, sizeof(line), " %11s %6s %11s %11s %11s", "cycles/row", "IPC",
+                          "L1d/row", "LLC/row", "brmiss/row");
+        os.write(line, n);
+    }
+    os << "\n";
+
+    for (const auto& s : snapshot) {
+        size_t slash = s.path.rfind('/');
+        std::string label = std::string(2 * s.depth, ' ') +
+                            (slash == std::string::npos ? s.path : s.path.substr(slash + 1));
+        n = std::snprintf(line, sizeof(line), "%-28s %6zu %10.3f %11zu", label.c_str(), s.calls,
+                          s.seconds * 1e3, s.rows);
+        os.write(line, n);
+        if (counters_) {
+            auto per_row = [&](size_t e) {
+                if (!s.counters.valid[e] || s.rows == 0) return std::nan("");
+                return static_cast<double>(s.counters.values[e]) / static_cast<double>(s.rows);
+            };
+            double ipc = s.counters.valid[kCycles] && s.counters.valid[kInstructions] &&
+                                 s.counters.values[kCycles] > 0
+                             ? static_cast<double>(s.counters.values[kInstructions]) /
+                                   static_cast<double>(s.counters.values[kCycles])
+                             : std::nan("");
+            n = std::snprintf(line, sizeof(line), " %11.2f %6.2f %11.3f %11.3f %11.3f",
+                              per_row(kCycles), ipc, per_row(kL1DMisses), per_row(kLLCMisses),
+                              per_row(kBranchMisses));
+            os.write(line, n);
+        }
+        os << "\n";
+    }
+
+    const pages::PageStats page = pages::stats();
+    const double mib = 1.0 / (1 << 20);
+    os << "\nPages (huge pages: " << pages::huge_pages_name(pages::huge_pages()) << ")\n";
+    n = std::snprintf(line, sizeof(line), "%-28s %10s %12s\n", "backing", "buffers", "MiB");
+    os.write(line, n);
+    const struct {
+        const char* name;
+        uint64_t count;
+        uint64_t bytes;
+    } rows[] = {
+        {"4k (heap)", page.heap_blocks, page.heap_bytes},
+        {"thp (madvise)", page.transparent_blocks, page.transparent_bytes},
+        {"hugetlb", page.explicit_blocks, page.explicit_bytes},
+        {"mapped files", page.mapped_files, page.mapped_file_bytes},
+    };
+    for (const auto& row : rows) {
+        n = std::snprintf(line, sizeof(line), "%-28s %10llu %12.1f\n", row.name,
+                          static_cast<unsigned long long>(row.count), static_cast<double>(row.bytes) * mib);
+        os.write(line, n);
+    }
+    n = std::snprintf(line, sizeof(line),
+                      "huge-page resident %.1f MiB (peak %.1f MiB), hugetlb fallbacks %llu\n",
+                      static_cast<double>(page.huge_resident_bytes) * mib,
+                      static_cast<double>(page.huge_resident_peak_bytes) * mib,
+                      static_cast<unsigned long long>(page.explicit_fallbacks));
+    os.write(line, n);
+
+    std::vector<std::pair<std::string, LatencyStats>> latency = latencies();
+    if (latency.empty()) return;
+
+    os << "\nLatency (ns)\n";
+    n = std::snprintf(line, sizeof(line), "%-28s %10s %9s %9s %9s %9s %9s %9s %9s\n", "path",
+                      "count", "min", "mean", "p50", "p99", "p99.9", "p99.99", "max");
+    os.write(line, n);
+    for (const auto& entry : latency) {
+        const LatencyStats& l = entry.second;
+        n = std::snprintf(line, sizeof(line),
+                          "%-28s %10zu %9.0f %9.0f %9.0f %9.0f %9.0f %9.0f %9.0f\n",
+                          entry.first.c_str(), l.count, l.min_ns, l.mean_ns, l.p50_ns, l.p99_ns,
+                          l.p999_ns, l.p9999_ns, l.max_ns);
+        os.write(line, n);
+    }
+}
+
+Scope::Scope(const char* name, size_t rows)
+    : span_("stage", name, -1, rows > 0 ? static_cast<int64_t>(rows) : -1) {
+    if (Profiler::instance().enabled()) begin(name, rows);
+}
+
+Scope::Scope(const char* name, size_t param, size_t rows)
+    : span_("kernel", name, static_cast<int64_t>(param), static_cast<int64_t>(rows)) {
+    if (Profiler::instance().enabled()) {
+        begin(std::string(name) + "(" + std::to_string(param) + ")", rows);
+    }
+}
+
+void Scope::begin(std::string label, size_t rows) {
+    Profiler& profiler = Profiler::instance();
+    saved_path_length_ = tls_path.size();
+    if (!tls_path.empty()) tls_path += '/';
+    tls_path += label;
+    index_ = profiler.stage_index(tls_path, tls_depth++);
+    saved_stage_ = tls_stage;
+    tls_stage = index_;
+    rows_ = rows;
+    active_ = true;
+    if (profiler.counters_enabled()) start_counters_ = thread_counters().read();
+    start_ns_ = now_ns();
+}
+
+Scope::~Scope() {
+    if (!active_) return;
+    int64_t end_ns = now_ns();
+    Profiler& profiler = Profiler::instance();
+    CounterSample delta;
+    if (profiler.counters_enabled()) delta = thread_counters().read().since(start_counters_);
+    profiler.add(index_, rows_, static_cast<double>(end_ns - start_ns_) * 1e-9, delta);
+    tls_path.resize(saved_path_length_);
+    --tls_depth;
+    tls_stage = saved_stage_;
+}
+
+TaskScope::TaskScope(size_t stage, std::thread::id spawner) : stage_(stage) {
+    if (stage_ == kNoStage) return;
+    saved_stage_ = tls_stage;
+    tls_stage = stage_;
+    const Profiler& profiler = Profiler::instance();
+    counting_ = profiler.counters_enabled() && spawner != std::this_thread::get_id();
+    if (counting_) start_counters_ = thread_counters().read();
+}
+
+TaskScope::~TaskScope() {
+    if (stage_ == kNoStage) return;
+    if (counting_) {
+        Profiler::instance().add_counters(stage_, thread_counters().read().since(start_counters_));
+    }
+    tls_stage = saved_stage_;
+}
+
+} // namespace profiling
+} // namespace tsproc
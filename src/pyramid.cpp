@@ -0,0 +1,229 @@
+#include "pyramid.hpp"
+#include "datetime.hpp"
+#include "io.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+namespace tsproc {
+
+namespace {
+
+int64_t bucket_start(int64_t ts, int64_t period_ns) {
+    return floor_div(ts, period_ns) * period_ns;
+}
+
+// Fold a later bar (or partial bucket) into an accumulated bucket
+void merge_bar(Record& acc, const Record& r) {
+    acc.high = std::fmax(acc.high, r.high);
+    acc.low = std::fmin(acc.low, r.low);
+    acc.close = r.close;
+    acc.adj_close = r.adj_close;
+    acc.volume += r.volume;
+    acc.signal = r.signal;
+}
+
+} // namespace
+
+TimeSeries resample(const TimeSeries& ts, int64_t period_ns) {
+    if (period_ns <= 0) {
+        throw std::invalid_argument("resample: period must be positive");
+    }
+
+    TimeSeries out;
+    Record acc;
+    int64_t current = kInvalidTimestamp;
+
+    for (const auto& r : ts) {
+        int64_t t = to_timestamp(r.date);
+        if (t == kInvalidTimestamp) continue;
+
+        int64_t b = bucket_start(t, period_ns);
+        if (current != kInvalidTimestamp && b == current) {
+            merge_bar(acc, r);
+            continue;
+        }
+
+        if (current != kInvalidTimestamp) {
+            out.push(acc);
+        }
+        acc = Record();
+        acc.date = format_datetime(b);
+        acc.open = r.open;
+        acc.high = r.high;
+        acc.low = r.low;
+        acc.close = r.close;
+        acc.adj_close = r.adj_close;
+        acc.volume = r.volume;
+        acc.signal = r.signal;
+        current = b;
+    }
+
+    if (current != kInvalidTimestamp) {
+        out.push(acc);
+    }
+    return out;
+}
+
+// ============================================================================
+// Pyramid Implementation
+// ============================================================================
+
+Pyramid::Pyramid(const std::string& base_path) : base_path_(base_path) {
+    std::ifstream manifest(manifest_path());
+    std::string line;
+    while (std::getline(manifest, line)) {
+        int64_t period;
+        if (parse_duration(line, period)) {
+            levels_.push_back(period);
+        }
+    }
+    std::sort(levels_.begin(), levels_.end());
+}
+
+std::string Pyramid::level_path(int64_t period_ns) const {
+    return base_path_ + ".pyr-" + format_duration(period_ns);
+}
+
+bool Pyramid::write_manifest() const {
+    std::ofstream manifest(manifest_path());
+    if (!manifest.is_open()) {
+        std::cerr << "Error: Could not write pyramid manifest: " << manifest_path() << std::endl;
+        return false;
+    }
+    for (int64_t period : levels_) {
+        manifest << format_duration(period) << "\n";
+    }
+    return true;
+}
+
+bool Pyramid::build(const TimeSeries& base, std::vector<int64_t> periods_ns) {
+    std::sort(periods_ns.begin(), periods_ns.end());
+    periods_ns.erase(std::unique(periods_ns.begin(), periods_ns.end()), periods_ns.end());
+    levels_.clear();
+
+    BinaryWriter base_writer(base_path_);
+    if (!base_writer.write(base)) return false;
+
+    // Each level is aggregated from the next finer one when it divides evenly,
+    // which keeps the total work close to a single pass over the base data
+    TimeSeries finer;
+    int64_t finer_period = 0;
+    for (int64_t period : periods_ns) {
+        if (period <= 0) continue;
+        const bool from_finer = finer_period > 0 && period % finer_period == 0;
+        TimeSeries level = resample(from_finer ? finer : base, period);
+
+        BinaryWriter writer(level_path(period));
+        if (!writer.write(level)) return false;
+
+        levels_.push_back(period);
+        finer = std::move(level);
+        finer_period = period;
+    }
+
+    return write_manifest();
+}
+
+bool Pyramid::append(const TimeSeries& rows) {
+    if (rows.empty()) return true;
+
+    BinaryReader base_reader(base_path_);
+    size_t base_rows = base_reader.row_count();
+    if (base_rows > 0) {
+        TimeSeries last = base_reader.read_rows(base_rows - 1, 1);
+        if (!last.empty() && to_timestamp(rows[0].date) < to_timestamp(last[0].date)) {
+            std::cerr << "Error: Appended rows are older than the stored data" << std::endl;
+            return false;
+        }
+    }
+
+    BinaryWriter base_writer(base_path_);
+    if (!base_writer.append(rows)) return false;
+
+    for (int64_t period : levels_) {
+        TimeSeries fresh = resample(rows, period);
+        if (fresh.empty()) continue;
+
+        const std::string path = level_path(period);
+        BinaryReader reader(path);
+        size_t n = reader.row_count();
+        bool replace_last = false;
+
+        if (n > 0) {
+            TimeSeries tail = reader.read_rows(n - 1, 1);
+            if (!tail.empty() && tail[0].date == fresh[0].date) {
+                // First new bucket continues the stored partial bucket
+                Record merged = tail[0];
+                merge_bar(merged, fresh[0]);
+                fresh[0] = merged;
+                replace_last = true;
+            }
+        }
+
+        BinaryWriter writer(path);
+        if (!writer.append(fresh, replace_last)) return false;
+    }
+
+    return true;
+}
+
+bool Pyramid::add_levels(std::vector<int64_t> periods_ns) {
+    std::vector<int64_t> missing;
+    for (int64_t period : periods_ns) {
+        if (period > 0 && !std::binary_search(levels_.begin(), levels_.end(), period)) {
+            missing.push_back(period);
+        }
+    }
+    std::sort(missing.begin(), missing.end());
+    missing.erase(std::unique(missing.begin(), missing.end()), missing.end());
+    if (missing.empty()) return true;
+
+    BinaryReader reader(base_path_);
+    TimeSeries base = reader.read();
+    for (int64_t period : missing) {
+        BinaryWriter writer(level_path(period));
+        if (!writer.write(resample(base, period))) return false;
+        levels_.push_back(period);
+    }
+    std::sort(levels_.begin(), levels_.end());
+
+    return write_manifest();
+}
+
+int64_t Pyramid::select_level(int64_t resolution_ns) const {
+    int64_t best = 0;
+    for (int64_t period : levels_) {
+        if (period <= resolution_ns && resolution_ns % period == 0) {
+            best = period;
+        }
+    }
+    return best;
+}
+
+TimeSeries Pyramid::query(int64_t resolution_ns, int64_t from_ns, int64_t to_ns) const {
+    int64_t level = select_level(resolution_ns);
+
+    // Widen the range to whole output buckets so edge buckets are complete
+    // and the answer does not depend on which levels are stored
+    if (from_ns != INT64_MIN) {
+        from_ns = bucket_start(from_ns, resolution_ns);
+    }
+    if (to_ns != INT64_MAX) {
+        const int64_t start = bucket_start(to_ns, resolution_ns);
+        to_ns = start == to_ns || start > INT64_MAX - resolution_ns ? to_ns : start + resolution_ns;
+    }
+
+    BinaryReader reader(level == 0 ? base_path_ : level_path(level));
+    const bool bounded = from_ns != INT64_MIN || to_ns != INT64_MAX;
+    TimeSeries src = bounded ? reader.read_range(from_ns, to_ns) : reader.read();
+
+    if (level == resolution_ns) {
+        return src;
+    }
+    return resample(src, resolution_ns);
+}
+
+} // namespace tsproc
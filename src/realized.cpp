@@ -0,0 +1,227 @@
+#include "realized.hpp"
+#include "datetime.hpp"
+#include "gaps.hpp"
+#include "indicators.hpp"
+#include "profiler.hpp"
+#include "scheduler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+namespace tsproc {
+namespace realized {
+
+namespace {
+
+// Rows per task when parsing dates
+constexpr size_t kRowGrain = 1 << 14;
+
+// Trading days per task; each task owns one set of bucket accumulators
+constexpr size_t kDayGrain = 8;
+
+// 1 / mu1^2 with mu1 = E|Z| = sqrt(2 / pi): scales bipower variation to variance
+constexpr double kBipowerScale = 1.5707963267948966;
+
+struct Accumulator {
+    size_t bars = 0;
+    size_t returns = 0;
+    double volume = 0.0;
+    double sq_return = 0.0;
+};
+
+// Columns read once, in parallel, before grouping
+struct Columns {
+    std::vector<int64_t> stamps;
+    std::vector<double> price;
+};
+
+// Daily record and bucket sums for rows [begin, end) of one trading day
+Record day_record(const TimeSeries& ts, const Columns& cols, size_t begin, size_t end,
+                  int64_t day_start, int64_t bucket_ns, std::vector<Accumulator>& buckets) {
+    Record day;
+    day.date = format_datetime(day_start);
+    day.open = day.high = day.low = day.close = day.adj_close = NAN;
+    day.volume = 0.0;
+
+    double rv = 0.0;
+    double bv = 0.0;
+    size_t returns = 0;
+    bool first = true;
+    double prev_price = 0.0;
+    double prev_abs = NAN;   // |previous return|, NaN when there is none
+    for (size_t i = begin; i < end; ++i) {
+        const int64_t t = cols.stamps[i];
+        if (t == kInvalidTimestamp) continue;
+        const Record& r = ts[i];
+        Accumulator& acc = buckets[static_cast<size_t>((t - day_start) / bucket_ns)];
+        ++acc.bars;
+        acc.volume += r.volume;
+
+        if (first) {
+            day.open = r.open;
+            day.high = r.high;
+            day.low = r.low;
+        } else {
+            day.high = std::max(day.high, r.high);
+            day.low = std::min(day.low, r.low);
+        }
+        day.close = r.close;
+        day.adj_close = r.adj_close;
+        day.volume += r.volume;
+
+        const double p = cols.price[i];
+        if (!first) {
+            const double ret = std::log(p / prev_price);
+            if (std::isfinite(ret)) {
+                const double sq = ret * ret;
+                const double abs_ret = std::fabs(ret);
+                rv += sq;
+                if (!std::isnan(prev_abs)) bv += abs_ret * prev_abs;
+                ++returns;
+                ++acc.returns;
+                acc.sq_return += sq;
+                prev_abs = abs_ret;
+            } else {
+                prev_abs = NAN;
+            }
+        }
+        prev_price = p;
+        first = false;
+    }
+
+    bv *= kBipowerScale;
+    day.indicators["RV"] = rv;
+    day.indicators["BV"] = bv;
+    day.indicators["JUMP"] = std::max(rv - bv, 0.0);
+    day.indicators["RVOL"] = std::sqrt(rv);
+    day.indicators["RETURNS"] = static_cast<double>(returns);
+    return day;
+}
+
+std::vector<SeasonalBucket> build_profile(const std::vector<std::vector<Accumulator>>& partial,
+                                          size_t bucket_count, int64_t bucket_ns) {
+    std::vector<Accumulator> total(bucket_count);
+    for (const auto& part : partial) {
+        for (size_t b = 0; b < bucket_count; ++b) {
+            total[b].bars += part[b].bars;
+            total[b].returns += part[b].returns;
+            total[b].volume += part[b].volume;
+            total[b].sq_return += part[b].sq_return;
+        }
+    }
+
+    std::vector<SeasonalBucket> profile;
+    double volume_sum = 0.0;
+    double sq_sum = 0.0;
+    size_t with_returns = 0;
+    for (size_t b = 0; b < bucket_count; ++b) {
+        const Accumulator& acc = total[b];
+        if (acc.bars == 0) continue;
+        SeasonalBucket s;
+        s.offset_ns = static_cast<int64_t>(b) * bucket_ns;
+        s.bars = acc.bars;
+        s.returns = acc.returns;
+        s.mean_volume = acc.volume / static_cast<double>(acc.bars);
+        s.mean_sq_return = acc.returns > 0 ? acc.sq_return / static_cast<double>(acc.returns) : 0.0;
+        volume_sum += s.mean_volume;
+        if (acc.returns > 0) {
+            sq_sum += s.mean_sq_return;
+            ++with_returns;
+        }
+        profile.push_back(s);
+    }
+
+    const double mean_volume = profile.empty() ? 0.0 : volume_sum / static_cast<double>(profile.size());
+    const double mean_sq = with_returns > 0 ? sq_sum / static_cast<double>(with_returns) : 0.0;
+    for (auto& s : profile) {
+        s.volume_factor = mean_volume > 0.0 ? s.mean_volume / mean_volume : 0.0;
+        s.volatility_factor = mean_sq > 0.0 ? std::sqrt(s.mean_sq_return / mean_sq) : 0.0;
+    }
+    return profile;
+}
+
+} // namespace
+
+Result compute(const TimeSeries& ts, const Options& options) {
+    if (options.bucket_ns <= 0 || options.bucket_ns > gaps::kDayNs) {
+        throw std::invalid_argument("Realized measures need a bucket width in (0, 1d]");
+    }
+    profiling::Scope scope("realized", ts.size());
+    Result result;
+    const size_t n = ts.size();
+    if (n == 0) return result;
+    indicators::get_column_value(ts[0], options.col);   // reject an unknown column up front
+
+    Columns cols;
+    cols.stamps.resize(n);
+    cols.price.resize(n);
+    exec::parallel_for(0, n, kRowGrain, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            cols.stamps[i] = to_timestamp(ts[i].date);
+            cols.price[i] = indicators::get_column_value(ts[i], options.col);
+        }
+    });
+
+    // First row of each trading day
+    std::vector<size_t> starts;
+    std::vector<int64_t> day_starts;
+    int64_t current = kInvalidTimestamp;
+    for (size_t i = 0; i < n; ++i) {
+        const int64_t t = cols.stamps[i];
+        if (t == kInvalidTimestamp) continue;
+        const int64_t day = floor_div(t - options.day_offset_ns, gaps::kDayNs);
+        if (day != current) {
+            starts.push_back(i);
+            day_starts.push_back(day * gaps::kDayNs + options.day_offset_ns);
+            current = day;
+        }
+    }
+    const size_t days = starts.size();
+    starts.push_back(n);
+
+    const size_t bucket_count =
+        static_cast<size_t>((gaps::kDayNs + options.bucket_ns - 1) / options.bucket_ns);
+    const size_t chunks = (days + kDayGrain - 1) / kDayGrain;
+    std::vector<Record> records(days);
+    std::vector<std::vector<Accumulator>> partial(chunks);
+    exec::parallel_for(0, chunks, 1, [&](size_t chunk_begin, size_t chunk_end) {
+        for (size_t c = chunk_begin; c < chunk_end; ++c) {
+            partial[c].assign(bucket_count, Accumulator());
+            const size_t last = std::min(days, (c + 1) * kDayGrain);
+            for (size_t d = c * kDayGrain; d < last; ++d) {
+                records[d] = day_record(ts, cols, starts[d], starts[d + 1], day_starts[d],
+                                        options.bucket_ns, partial[c]);
+            }
+        }
+    });
+
+    result.daily.reserve(days);
+    for (const auto& r : records) result.daily.push(r);
+    result.profile = build_profile(partial, bucket_count, options.bucket_ns);
+    return result;
+}
+
+bool write_profile(const std::string& path, const std::vector<SeasonalBucket>& profile) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file for writing: " << path << std::endl;
+        return false;
+    }
+
+    file << "offset,bars,returns,mean_volume,mean_sq_return,volume_factor,volatility_factor\n";
+    for (const auto& s : profile) {
+        const int64_t seconds = s.offset_ns / 1000000000;
+        char offset[32];
+        std::snprintf(offset, sizeof(offset), "%02d:%02d:%02d", static_cast<int>(seconds / 3600),
+                      static_cast<int>(seconds / 60 % 60), static_cast<int>(seconds % 60));
+        file << offset << "," << s.bars << "," << s.returns << "," << s.mean_volume << ","
+             << s.mean_sq_return << "," << s.volume_factor << "," << s.volatility_factor << "\n";
+    }
+    return file.good();
+}
+
+} // namespace realized
+} // namespace tsproc
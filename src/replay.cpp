@@ -0,0 +1,129 @@
+#include "replay.hpp"
+#include "csv_reader.hpp"
+#include "datetime.hpp"
+#include "io.hpp"
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+namespace tsproc {
+
+ReplaySource::ReplaySource(const std::string& path, const ReplayOptions& options)
+    : path_(path), options_(options) {
+    if (options_.speed == ReplaySpeed::Scaled && !(options_.factor > 0.0)) {
+        throw std::invalid_argument("Replay speed factor must be positive");
+    }
+}
+
+size_t ReplaySource::load() {
+    const bool bounded = options_.from_ns != INT64_MIN || options_.to_ns != INT64_MAX;
+    series_ = TimeSeries();
+    if (is_binary_path(path_)) {
+        BinaryReader reader(path_);
+        bars_ = bounded ? reader.read_bars_range(options_.from_ns, options_.to_ns) : reader.read_bars();
+        series_ready_ = false;
+    } else {
+        CSVReader reader(path_, options_.delimiter);
+        reader.set_duplicate_policy(options_.duplicates);
+        series_ = bounded ? reader.read_range(options_.from_ns, options_.to_ns, options_.drop_na)
+                          : reader.read_to_timeseries(options_.drop_na);
+        bars_ = to_bars(series_);
+        series_ready_ = true;  // keep the dates exactly as written in the file
+    }
+
+    loaded_ = true;
+    return bars_.size();
+}
+
+const TimeSeries& ReplaySource::series() {
+    if (!loaded_) load();
+    if (!series_ready_) {
+        series_ = to_series(bars_);
+        series_ready_ = true;
+    }
+    return series_;
+}
+
+size_t ReplaySource::run(const std::function<void(const Bar&)>& callback) {
+    if (!loaded_) load();
+    return replay([&](size_t i) { callback(bars_[i]); });
+}
+
+size_t ReplaySource::run(const std::function<void(const Record&)>& callback) {
+    const TimeSeries& records = series();
+    return replay([&](size_t i) { callback(records[i]); });
+}
+
+template <typename Emit>
+size_t ReplaySource::replay(Emit&& emit) {
+    using clock = std::chrono::steady_clock;
+
+    latency_.reset();
+
+    const bool paced = options_.speed != ReplaySpeed::AsFastAsPossible;
+    const double scale = options_.speed == ReplaySpeed::Scaled ? 1.0 / options_.factor : 1.0;
+
+    // First valid timestamp anchors the replay clock
+    int64_t origin_ts = kInvalidTimestamp;
+    for (const Bar& b : bars_) {
+        if (b.ts != kInvalidTimestamp) {
+            origin_ts = b.ts;
+            break;
+        }
+    }
+
+    const auto start = clock::now();
+
+    for (size_t i = 0; i < bars_.size(); ++i) {
+        const int64_t ts = bars_[i].ts;
+        if (paced && origin_ts != kInvalidTimestamp && ts != kInvalidTimestamp) {
+            double offset_ns = static_cast<double>(ts - origin_ts) * scale;
+            auto due = start + std::chrono::nanoseconds(static_cast<int64_t>(offset_ns));
+            if (due > clock::now()) {
+                std::this_thread::sleep_until(due);
+            }
+        }
+
+        auto t0 = clock::now();
+        emit(i);
+        auto t1 = clock::now();
+
+        latency_.record(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+    }
+
+    elapsed_s_ = std::chrono::duration<double>(clock::now() - start).count();
+    return bars_.size();
+}
+
+LatencyStats ReplaySource::latency_stats() const {
+    return latency_.stats();
+}
+
+bool parse_replay_speed(const std::string& text, ReplayOptions& options) {
+    if (text == "fast" || text == "max") {
+        options.speed = ReplaySpeed::AsFastAsPossible;
+        return true;
+    }
+    if (text == "realtime" || text == "1x") {
+        options.speed = ReplaySpeed::RealTime;
+        options.factor = 1.0;
+        return true;
+    }
+
+    std::string num = text;
+    if (!num.empty() && (num.back() == 'x' || num.back() == 'X')) {
+        num.pop_back();
+    }
+    try {
+        size_t used = 0;
+        double factor = std::stod(num, &used);
+        if (used != num.size() || !(factor > 0.0)) return false;
+        options.speed = ReplaySpeed::Scaled;
+        options.factor = factor;
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+} // namespace tsproc
@@ -0,0 +1,339 @@
+#include "scheduler.hpp"
+#include "profiler.hpp"
+#include "trace.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+namespace tsproc {
+namespace exec {
+
+namespace {
+
+// Scheduler and worker slot of the calling thread (-1 outside any pool)
+thread_local Scheduler* tls_scheduler = nullptr;
+thread_local long tls_worker = -1;
+
+std::mutex global_mutex;
+std::unique_ptr<Scheduler> global_scheduler;
+
+size_t default_threads() {
+    if (const char* env = std::getenv("TSPROC_THREADS")) {
+        char* end = nullptr;
+        unsigned long n = std::strtoul(env, &end, 10);
+        if (end != env && *end == '\0') return n;
+    }
+    return 0;
+}
+
+// Pop the oldest task of a mutex-guarded queue
+template <typename Deque>
+bool pop_front(std::mutex& mutex, Deque& tasks, typename Deque::value_type& task, std::atomic<size_t>& queued) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (tasks.empty()) return false;
+    task = std::move(tasks.front());
+    tasks.pop_front();
+    queued.fetch_sub(1);
+    return true;
+}
+
+// Topology the workers are placed on; one node holding every CPU when not NUMA-aware
+numa::Topology scheduler_topology(const SchedulerOptions& options) {
+    const numa::Topology& topology = options.topology ? *options.topology : numa::Topology::system();
+    if (options.numa_aware) return topology;
+    std::vector<int> cpus;
+    for (size_t node = 0; node < topology.node_count(); ++node) {
+        cpus.insert(cpus.end(), topology.cpus(node).begin(), topology.cpus(node).end());
+    }
+    std::sort(cpus.begin(), cpus.end());
+    return numa::Topology({cpus});
+}
+
+} // namespace
+
+// ============================================================================
+// Scheduler Implementation
+// ============================================================================
+
+Scheduler::Scheduler(const SchedulerOptions& options) : topology_(scheduler_topology(options)) {
+    size_t threads = options.threads;
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // CPUs grouped by node. Worker i takes slot i + 1 (the caller usually runs
+    // on the first), so workers fill nodes in proportion to their CPU counts.
+    std::vector<int> slots;
+    for (size_t node = 0; node < topology_.node_count(); ++node) {
+        slots.insert(slots.end(), topology_.cpus(node).begin(), topology_.cpus(node).end());
+    }
+
+    for (size_t node = 0; node < topology_.node_count(); ++node) {
+        node_queues_.push_back(std::make_unique<Queue>());
+    }
+    workers_.reserve(threads - 1);
+    worker_node_.reserve(threads - 1);
+    for (size_t i = 0; i + 1 < threads; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+        const int cpu = slots[(i + 1) % slots.size()];
+        worker_node_.push_back(static_cast<size_t>(topology_.node_of_cpu(cpu)));
+    }
+
+    // Threads start only after every deque exists, since they steal from all of them
+    pinned_ = options.pin_threads;
+    for (size_t i = 0; i < workers_.size(); ++i) {
+        workers_[i]->thread = std::thread(&Scheduler::worker_loop, this, i);
+        if (options.pin_threads) {
+            if (!numa::bind_thread(workers_[i]->thread, {slots[(i + 1) % slots.size()]})) pinned_ = false;
+        } else if (node_count() > 1) {
+            // Free to move between the CPUs of its node, never off it
+            numa::bind_thread(workers_[i]->thread, topology_.cpus(worker_node_[i]));
+        }
+    }
+}
+
+Scheduler::~Scheduler() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        stop_.store(true);
+    }
+    wake_.notify_all();
+    for (auto& w : workers_) {
+        if (w->thread.joinable()) w->thread.join();
+    }
+}
+
+Scheduler& Scheduler::global() {
+    std::lock_guard<std::mutex> lock(global_mutex);
+    if (!global_scheduler) {
+        SchedulerOptions options;
+        options.threads = default_threads();
+        global_scheduler = std::make_unique<Scheduler>(options);
+    }
+    return *global_scheduler;
+}
+
+void Scheduler::configure_global(const SchedulerOptions& options) {
+    std::unique_ptr<Scheduler> old;
+    {
+        std::lock_guard<std::mutex> lock(global_mutex);
+        old = std::move(global_scheduler);
+        global_scheduler = std::make_unique<Scheduler>(options);
+    }
+    // old joins its (idle) workers here, outside the lock
+}
+
+size_t Scheduler::current_node() const {
+    if (tls_scheduler == this && tls_worker >= 0) return worker_node_[static_cast<size_t>(tls_worker)];
+    return topology_.current_node();
+}
+
+void Scheduler::submit(Task task, long node) {
+    if (node >= 0 && node_count() > 1) {
+        Queue& q = *node_queues_[static_cast<size_t>(node) % node_count()];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        q.tasks.push_back(std::move(task));
+    } else if (tls_scheduler == this && tls_worker >= 0) {
+        Worker& self = *workers_[static_cast<size_t>(tls_worker)];
+        std::lock_guard<std::mutex> lock(self.mutex);
+        self.tasks.push_back(std::move(task));
+    } else {
+        std::lock_guard<std::mutex> lock(injected_mutex_);
+        injected_.push_back(std::move(task));
+    }
+    {
+        // Taken so a worker between its empty check and wait() cannot miss this
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        queued_.fetch_add(1);
+    }
+    wake_.notify_one();
+}
+
+bool Scheduler::steal(Task& task, long self, size_t node, bool same_node) {
+    // Oldest task of another worker, starting after our own slot
+    const size_t n = workers_.size();
+    const size_t start = self >= 0 ? static_cast<size_t>(self) + 1 : 0;
+    for (size_t k = 0; k < n; ++k) {
+        const size_t victim = (start + k) % n;
+        if ((worker_node_[victim] == node) != same_node) continue;
+        Worker& w = *workers_[victim];
+        if (pop_front(w.mutex, w.tasks, task, queued_)) return true;
+    }
+    return false;
+}
+
+bool Scheduler::take(Task& task) {
+    if (queued_.load() == 0) return false;
+
+    const long self = tls_scheduler == this ? tls_worker : -1;
+
+    // Own deque first, newest task (its data is still in cache)
+    if (self >= 0) {
+        Worker& w = *workers_[static_cast<size_t>(self)];
+        std::lock_guard<std::mutex> lock(w.mutex);
+        if (!w.tasks.empty()) {
+            task = std::move(w.tasks.back());
+            w.tasks.pop_back();
+            queued_.fetch_sub(1);
+            return true;
+        }
+    }
+
+    // Then work that lives on our node, then anything else
+    const size_t node = current_node();
+    Queue& local = *node_queues_[node];
+    if (pop_front(local.mutex, local.tasks, task, queued_)) return true;
+    if (pop_front(injected_mutex_, injected_, task, queued_)) return true;
+    if (steal(task, self, node, true)) return true;
+    for (size_t k = 1; k < node_count(); ++k) {
+        Queue& remote = *node_queues_[(node + k) % node_count()];
+        if (pop_front(remote.mutex, remote.tasks, task, queued_)) return true;
+    }
+    return steal(task, self, node, false);
+}
+
+void Scheduler::execute(Task& task) {
+    std::exception_ptr error;
+    {
+        // Closed before finish() so the counts land before the waiter returns
+        profiling::TaskScope profile(task.stage, task.spawner);
+        try {
+            task.fn();
+        } catch (...) {
+            error = std::current_exception();
+        }
+    }
+    task.fn = nullptr;  // release captures before the group can be destroyed
+    task.group->finish(error);
+}
+
+bool Scheduler::run_one() {
+    Task task;
+    if (!take(task)) return false;
+    execute(task);
+    return true;
+}
+
+void Scheduler::worker_loop(size_t index) {
+    tls_scheduler = this;
+    tls_worker = static_cast<long>(index);
+    if (tracing::Tracer::instance().enabled()) {
+        tracing::Tracer::instance().set_thread_name("exec worker " + std::to_string(index + 1));
+    }
+
+    while (true) {
+        if (run_one()) continue;
+
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        wake_.wait(lock, [this] { return stop_.load() || queued_.load() > 0; });
+        if (stop_.load()) return;
+    }
+}
+
+// ============================================================================
+// TaskGroup Implementation
+// ============================================================================
+
+TaskGroup::TaskGroup(Scheduler& scheduler) : scheduler_(scheduler) {}
+
+TaskGroup::~TaskGroup() {
+    try {
+        wait();
+    } catch (...) {
+    }
+}
+
+void TaskGroup::spawn(std::function<void()> fn, long node) {
+    if (scheduler_.workers_.empty()) {
+        // Single-threaded scheduler: run inline, but report errors from wait() as usual
+        try {
+            fn();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(error_mutex_);
+            if (!error_) error_ = std::current_exception();
+        }
+        return;
+    }
+    outstanding_.fetch_add(1);
+    scheduler_.submit(Scheduler::Task{std::move(fn), this, profiling::current_stage(),
+                                      std::this_thread::get_id()},
+                      node);
+}
+
+void TaskGroup::finish(std::exception_ptr error) {
+    if (error) {
+        std::lock_guard<std::mutex> lock(error_mutex_);
+        if (!error_) error_ = error;
+    }
+    // The waiter may destroy the group as soon as the count reaches zero
+    Scheduler& scheduler = scheduler_;
+    if (outstanding_.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> lock(scheduler.sleep_mutex_);
+        scheduler.wake_.notify_all();
+    }
+}
+
+void TaskGroup::wait() {
+    while (outstanding_.load() > 0) {
+        // Help instead of blocking: this is what keeps nested waits deadlock-free
+        if (scheduler_.run_one()) continue;
+
+        // Nothing to run: sleep until the group finishes or new work is queued
+        std::unique_lock<std::mutex> lock(scheduler_.sleep_mutex_);
+        scheduler_.wake_.wait(lock, [this] {
+            return outstanding_.load() == 0 || scheduler_.queued_.load() > 0;
+        });
+    }
+
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(error_mutex_);
+        std::swap(error, error_);
+    }
+    if (error) std::rethrow_exception(error);
+}
+
+// ============================================================================
+// TaskGraph Implementation
+// ============================================================================
+
+TaskGraph::NodeId TaskGraph::add(std::function<void()> fn, const std::vector<NodeId>& dependencies) {
+    const NodeId id = nodes_.size();
+    for (NodeId dep : dependencies) {
+        if (dep >= id) {
+            throw std::invalid_argument("TaskGraph dependency must be an earlier node");
+        }
+    }
+    nodes_.emplace_back();
+    Node& node = nodes_.back();
+    node.fn = std::move(fn);
+    node.dependencies = dependencies.size();
+    for (NodeId dep : dependencies) {
+        nodes_[dep].successors.push_back(id);
+    }
+    return id;
+}
+
+void TaskGraph::start(TaskGroup& group, NodeId id) {
+    group.spawn([this, &group, id] {
+        nodes_[id].fn();
+        // Only reached on success, so dependents of a failed node never start
+        for (NodeId next : nodes_[id].successors) {
+            if (nodes_[next].remaining.fetch_sub(1) == 1) start(group, next);
+        }
+    });
+}
+
+void TaskGraph::run(Scheduler& scheduler) {
+    for (Node& node : nodes_) node.remaining.store(node.dependencies);
+
+    TaskGroup group(scheduler);
+    for (NodeId id = 0; id < nodes_.size(); ++id) {
+        if (nodes_[id].dependencies == 0) start(group, id);
+    }
+    group.wait();
+}
+
+} // namespace exec
+} // namespace tsproc
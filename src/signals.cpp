@@ -1,13 +1,58 @@
 #include "signals.hpp"
 #include "indicators.hpp"
+#include "column_buffer.hpp"
+#include "profiler.hpp"
+#include "scheduler.hpp"
 #include <cmath>
 #include <algorithm>
+#include <vector>
 
 namespace tsproc {
 namespace signals {
 
+namespace {
+
+// Rows per scheduler task. Strategies keep position state, so only the
+// indicator lookups and the final writes run in parallel; the state
+// machine itself is a serial scan over plain doubles.
+constexpr size_t kRowGrain = 1 << 14;
+
+// Indicator column as doubles, NaN where a row lacks it. The state machines
+// read it serially on this thread, so it is first-touched here.
+ColumnBuffer gather(const TimeSeries& ts, const std::string& name) {
+    ColumnBuffer out(ts.size());
+    exec::parallel_for(0, ts.size(), kRowGrain, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            auto it = ts[i].indicators.find(name);
+            out[i] = it != ts[i].indicators.end() ? it->second : NAN;
+        }
+    });
+    return out;
+}
+
+ColumnBuffer gather_column(const TimeSeries& ts, const std::string& col) {
+    ColumnBuffer out(ts.size());
+    exec::parallel_for(0, ts.size(), kRowGrain, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) out[i] = indicators::get_column_value(ts[i], col);
+    });
+    return out;
+}
+
+// Write positions to out_col and Record::signal
+void scatter(TimeSeries& ts, const std::vector<int>& positions, const std::string& out_col) {
+    exec::parallel_for(0, ts.size(), kRowGrain, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            ts[i].indicators[out_col] = static_cast<double>(positions[i]);
+            ts[i].signal = positions[i];
+        }
+    });
+}
+
+} // namespace
+
 void sma_crossover(TimeSeries& ts, size_t fast_window, size_t slow_window,
                    const std::string& out_col) {
+    profiling::Scope scope("sma_crossover", slow_window, ts.size());
     if (ts.size() == 0 || fast_window >= slow_window) return;
     
     std::string fast_sma = "SMA_" + std::to_string(fast_window);
@@ -21,62 +66,43 @@ void sma_crossover(TimeSeries& ts, size_t fast_window, size_t slow_window,
         indicators::add_sma(ts, slow_window, "close");
     }
     
+    ColumnBuffer fast = gather(ts, fast_sma);
+    ColumnBuffer slow = gather(ts, slow_sma);
+    std::vector<int> positions(ts.size(), 0);
     int prev_signal = 0;
     
     for (size_t i = 0; i < ts.size(); ++i) {
-        auto& indicators = ts[i].indicators;
+        // Rows without both SMAs (missing or NaN) are flat and keep the held signal
+        if (std::isnan(fast[i]) || std::isnan(slow[i])) continue;
         
-        if (indicators.find(fast_sma) != indicators.end() &&
-            indicators.find(slow_sma) != indicators.end()) {
-            
-            double fast = indicators[fast_sma];
-            double slow = indicators[slow_sma];
-            
-            if (!std::isnan(fast) && !std::isnan(slow)) {
-                int signal = 0;
-                
-                // Check for crossover
-                if (i > 0) {
-                    auto& prev_ind = ts[i-1].indicators;
-                    if (prev_ind.find(fast_sma) != prev_ind.end() &&
-                        prev_ind.find(slow_sma) != prev_ind.end()) {
-                        
-                        double prev_fast = prev_ind[fast_sma];
-                        double prev_slow = prev_ind[slow_sma];
-                        
-                        if (!std::isnan(prev_fast) && !std::isnan(prev_slow)) {
-                            // Golden cross: fast crosses above slow
-                            if (prev_fast <= prev_slow && fast > slow) {
-                                signal = 1;
-                            }
-                            // Death cross: fast crosses below slow
-                            else if (prev_fast >= prev_slow && fast < slow) {
-                                signal = -1;
-                            }
-                            // Hold previous signal if no crossover
-                            else {
-                                signal = prev_signal;
-                            }
-                        }
-                    }
-                }
-                
-                indicators[out_col] = static_cast<double>(signal);
-                ts[i].signal = signal;
-                prev_signal = signal;
-            } else {
-                indicators[out_col] = 0.0;
-                ts[i].signal = 0;
+        int signal = 0;
+        
+        // Check for crossover
+        if (i > 0 && !std::isnan(fast[i - 1]) && !std::isnan(slow[i - 1])) {
+            // Golden cross: fast crosses above slow
+            if (fast[i - 1] <= slow[i - 1] && fast[i] > slow[i]) {
+                signal = 1;
+            }
+            // Death cross: fast crosses below slow
+            else if (fast[i - 1] >= slow[i - 1] && fast[i] < slow[i]) {
+                signal = -1;
+            }
+            // Hold previous signal if no crossover
+            else {
+                signal = prev_signal;
             }
-        } else {
-            indicators[out_col] = 0.0;
-            ts[i].signal = 0;
         }
+        
+        positions[i] = signal;
+        prev_signal = signal;
     }
+    
+    scatter(ts, positions, out_col);
 }
 
 void zscore_mean_reversion(TimeSeries& ts, size_t window, double entry_z, double exit_z,
                           const std::string& out_col) {
+    profiling::Scope scope("zscore_signal", window, ts.size());
     if (ts.size() == 0) return;
     
     std::string zscore_name = "Z_" + std::to_string(window);
@@ -86,78 +112,66 @@ void zscore_mean_reversion(TimeSeries& ts, size_t window, double entry_z, double
         indicators::add_zscore(ts, window, "close");
     }
     
+    ColumnBuffer zscores = gather(ts, zscore_name);
+    std::vector<int> positions(ts.size(), 0);
     int current_position = 0;
     
     for (size_t i = 0; i < ts.size(); ++i) {
-        auto& indicators = ts[i].indicators;
+        double z = zscores[i];
+        if (std::isnan(z)) continue;  // missing or NaN z-score: flat
         
-        if (indicators.find(zscore_name) != indicators.end()) {
-            double z = indicators[zscore_name];
-            
-            if (!std::isnan(z)) {
-                // Entry logic
-                if (z < -entry_z) {
-                    // Oversold - go long
-                    current_position = 1;
-                } else if (z > entry_z) {
-                    // Overbought - go short
-                    current_position = -1;
-                }
-                // Exit logic
-                else if (std::abs(z) < exit_z && current_position != 0) {
-                    // Return to mean - exit position
-                    current_position = 0;
-                }
-                
-                indicators[out_col] = static_cast<double>(current_position);
-                ts[i].signal = current_position;
-            } else {
-                indicators[out_col] = 0.0;
-                ts[i].signal = 0;
-            }
-        } else {
-            indicators[out_col] = 0.0;
-            ts[i].signal = 0;
+        // Entry logic
+        if (z < -entry_z) {
+            // Oversold - go long
+            current_position = 1;
+        } else if (z > entry_z) {
+            // Overbought - go short
+            current_position = -1;
+        }
+        // Exit logic
+        else if (std::abs(z) < exit_z && current_position != 0) {
+            // Return to mean - exit position
+            current_position = 0;
         }
+        
+        positions[i] = current_position;
     }
+    
+    scatter(ts, positions, out_col);
 }
 
 void momentum_strategy(TimeSeries& ts, size_t window, double upper_threshold,
                       double lower_threshold, const std::string& col,
                       const std::string& out_col) {
+    profiling::Scope scope("momentum", window, ts.size());
     if (ts.size() <= window) return;
     
-    for (size_t i = 0; i < ts.size(); ++i) {
-        if (i < window) {
-            ts[i].indicators[out_col] = 0.0;
-            ts[i].signal = 0;
-            continue;
-        }
-        
-        double current_price = indicators::get_column_value(ts[i], col);
-        double past_price = indicators::get_column_value(ts[i - window], col);
-        
-        if (past_price > 1e-10) {  // Avoid division by zero
-            double momentum = (current_price - past_price) / past_price;
+    // Stateless per row, so the whole pass runs in parallel
+    ColumnBuffer prices = gather_column(ts, col);
+    std::vector<int> positions(ts.size(), 0);
+    exec::parallel_for(window, ts.size(), kRowGrain, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            double current_price = prices[i];
+            double past_price = prices[i - window];
             
-            int signal = 0;
-            if (momentum > upper_threshold) {
-                signal = 1;  // Long
-            } else if (momentum < lower_threshold) {
-                signal = -1;  // Short
+            if (past_price > 1e-10) {  // Avoid division by zero
+                double momentum = (current_price - past_price) / past_price;
+                
+                if (momentum > upper_threshold) {
+                    positions[i] = 1;  // Long
+                } else if (momentum < lower_threshold) {
+                    positions[i] = -1;  // Short
+                }
             }
-            
-            ts[i].indicators[out_col] = static_cast<double>(signal);
-            ts[i].signal = signal;
-        } else {
-            ts[i].indicators[out_col] = 0.0;
-            ts[i].signal = 0;
         }
-    }
+    });
+    
+    scatter(ts, positions, out_col);
 }
 
 void bollinger_breakout(TimeSeries& ts, size_t window, double num_std,
                        const std::string& col, const std::string& out_col) {
+    profiling::Scope scope("bollinger", window, ts.size());
     if (ts.size() == 0) return;
     
     std::string mean_name = "ROLL_MEAN_" + std::to_string(window);
@@ -168,44 +182,38 @@ void bollinger_breakout(TimeSeries& ts, size_t window, double num_std,
         indicators::add_roll_mean_std(ts, window, col);
     }
     
+    ColumnBuffer means = gather(ts, mean_name);
+    ColumnBuffer sds = gather(ts, std_name);
+    ColumnBuffer prices = gather_column(ts, col);
+    std::vector<int> positions(ts.size(), 0);
     int current_position = 0;
     
     for (size_t i = 0; i < ts.size(); ++i) {
-        auto& inds = ts[i].indicators;
+        double mean = means[i];
+        double sd = sds[i];
+        double price = prices[i];
+        if (std::isnan(mean) || std::isnan(sd)) continue;  // flat until the bands exist
         
-        if (inds.find(mean_name) != inds.end() && inds.find(std_name) != inds.end()) {
-            double mean = inds[mean_name];
-            double sd = inds[std_name];
-            double price = indicators::get_column_value(ts[i], col);
-            
-            if (!std::isnan(mean) && !std::isnan(sd)) {
-                double upper_band = mean + num_std * sd;
-                double lower_band = mean - num_std * sd;
-                
-                // Breakout above upper band - go long
-                if (price > upper_band) {
-                    current_position = 1;
-                }
-                // Breakout below lower band - go short
-                else if (price < lower_band) {
-                    current_position = -1;
-                }
-                // Return to within bands - exit
-                else if (price >= lower_band && price <= upper_band && current_position != 0) {
-                    current_position = 0;
-                }
-                
-                inds[out_col] = static_cast<double>(current_position);
-                ts[i].signal = current_position;
-            } else {
-                inds[out_col] = 0.0;
-                ts[i].signal = 0;
-            }
-        } else {
-            inds[out_col] = 0.0;
-            ts[i].signal = 0;
+        double upper_band = mean + num_std * sd;
+        double lower_band = mean - num_std * sd;
+        
+        // Breakout above upper band - go long
+        if (price > upper_band) {
+            current_position = 1;
+        }
+        // Breakout below lower band - go short
+        else if (price < lower_band) {
+            current_position = -1;
         }
+        // Return to within bands - exit
+        else if (price >= lower_band && price <= upper_band && current_position != 0) {
+            current_position = 0;
+        }
+        
+        positions[i] = current_position;
     }
+    
+    scatter(ts, positions, out_col);
 }
 
 } // namespace signals
@@ -0,0 +1,206 @@
+#include "streaming.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace tsproc {
+namespace streaming {
+
+// ============================================================================
+// RollingWindow Implementation
+// ============================================================================
+
+RollingWindow::RollingWindow(size_t window) : buf_(window, 0.0) {}
+
+void RollingWindow::push(double v) {
+    if (buf_.empty()) return;
+
+    // Same add-then-evict order as the batch kernels so results match bit-for-bit
+    sum_ += v;
+    sumsq_ += v * v;
+
+    if (count_ == buf_.size()) {
+        double old = buf_[head_];
+        sum_ -= old;
+        sumsq_ -= old * old;
+    } else {
+        ++count_;
+    }
+
+    buf_[head_] = v;
+    head_ = (head_ + 1 == buf_.size()) ? 0 : head_ + 1;
+}
+
+double RollingWindow::mean() const {
+    if (!full() || buf_.empty()) return NAN;
+    return sum_ / static_cast<double>(buf_.size());
+}
+
+double RollingWindow::stddev() const {
+    if (!full() || buf_.empty()) return NAN;
+    double n = static_cast<double>(buf_.size());
+    double mean = sum_ / n;
+    double variance = (sumsq_ / n) - (mean * mean);
+    return (variance > 0) ? std::sqrt(variance) : 0.0;
+}
+
+// ============================================================================
+// StreamPipeline Implementation
+// ============================================================================
+
+StreamPipeline::StreamPipeline(const StreamConfig& config)
+    : config_(config),
+      zwin_(config.zscore_window),
+      prev_fast_(NAN),
+      prev_slow_(NAN) {
+    if (config_.fast_sma == 0 || config_.slow_sma == 0 || config_.fast_sma >= config_.slow_sma) {
+        config_.sma_crossover = false;
+    }
+    if (config_.zscore_window == 0) {
+        config_.zscore_signal = false;
+    }
+
+    // Crossover SMAs are reported like the batch path, which adds them if missing
+    if (config_.sma_crossover) {
+        for (size_t w : {config_.fast_sma, config_.slow_sma}) {
+            if (std::find(config_.sma_windows.begin(), config_.sma_windows.end(), w) ==
+                config_.sma_windows.end()) {
+                config_.sma_windows.push_back(w);
+            }
+        }
+    }
+
+    for (size_t w : config_.sma_windows) {
+        if (w == config_.fast_sma) fast_slot_ = sma_.size();
+        if (w == config_.slow_sma) slow_slot_ = sma_.size();
+        sma_.emplace_back(w);
+        values_.emplace_back("SMA_" + std::to_string(w), NAN);
+    }
+
+    if (config_.sma_crossover) {
+        sma_signal_slot_ = values_.size();
+        values_.emplace_back("signal_sma", 0.0);
+    }
+
+    if (config_.zscore_window > 0) {
+        std::string w = std::to_string(config_.zscore_window);
+        zscore_slot_ = values_.size();
+        values_.emplace_back("ROLL_MEAN_" + w, NAN);
+        values_.emplace_back("ROLL_STD_" + w, NAN);
+        values_.emplace_back("Z_" + w, NAN);
+        if (config_.zscore_signal) {
+            z_signal_slot_ = values_.size();
+            values_.emplace_back("signal_z", 0.0);
+        }
+    }
+}
+
+namespace {
+
+template <typename Fn>
+inline void timed(LatencyHistogram& histogram, Fn&& fn) {
+    using clock = std::chrono::steady_clock;
+    auto t0 = clock::now();
+    fn();
+    histogram.record(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - t0).count());
+}
+
+} // namespace
+
+int StreamPipeline::update_price(double price) {
+    if (!latency_) {
+        update_sma(price);
+        if (config_.sma_crossover) update_crossover();
+        if (config_.zscore_window > 0) update_zscore(price);
+        return signal_;
+    }
+
+    if (!sma_.empty()) timed(latency_->sma, [&] { update_sma(price); });
+    if (config_.sma_crossover) timed(latency_->crossover, [&] { update_crossover(); });
+    if (config_.zscore_window > 0) timed(latency_->zscore, [&] { update_zscore(price); });
+    return signal_;
+}
+
+void StreamPipeline::update_sma(double price) {
+    for (size_t i = 0; i < sma_.size(); ++i) {
+        sma_[i].push(price);
+        values_[i].second = sma_[i].mean();
+    }
+}
+
+void StreamPipeline::update_crossover() {
+    double fast = values_[fast_slot_].second;
+    double slow = values_[slow_slot_].second;
+
+    if (!std::isnan(fast) && !std::isnan(slow)) {
+        int signal = 0;
+        if (!std::isnan(prev_fast_) && !std::isnan(prev_slow_)) {
+            if (prev_fast_ <= prev_slow_ && fast > slow) {
+                signal = 1;
+            } else if (prev_fast_ >= prev_slow_ && fast < slow) {
+                signal = -1;
+            } else {
+                signal = sma_position_;
+            }
+        }
+        sma_position_ = signal;
+        signal_ = signal;
+    } else {
+        signal_ = 0;
+    }
+    values_[sma_signal_slot_].second = static_cast<double>(signal_);
+    prev_fast_ = fast;
+    prev_slow_ = slow;
+}
+
+void StreamPipeline::update_zscore(double price) {
+    zwin_.push(price);
+    double mean = zwin_.mean();
+    double sd = zwin_.stddev();
+    double z = NAN;
+    if (!std::isnan(mean) && !std::isnan(sd) && sd > 1e-10) {
+        z = (price - mean) / sd;
+    }
+    values_[zscore_slot_].second = mean;
+    values_[zscore_slot_ + 1].second = sd;
+    values_[zscore_slot_ + 2].second = z;
+
+    if (config_.zscore_signal) {
+        if (!std::isnan(z)) {
+            if (z < -config_.zscore_entry) {
+                z_position_ = 1;
+            } else if (z > config_.zscore_entry) {
+                z_position_ = -1;
+            } else if (std::abs(z) < config_.zscore_exit && z_position_ != 0) {
+                z_position_ = 0;
+            }
+            signal_ = z_position_;
+        } else {
+            signal_ = 0;
+        }
+        values_[z_signal_slot_].second = static_cast<double>(signal_);
+    }
+}
+
+void StreamPipeline::enable_stage_latency() {
+    if (!latency_) latency_ = std::make_unique<StageLatency>();
+}
+
+std::vector<std::pair<std::string, LatencyStats>> StreamPipeline::stage_latency() const {
+    std::vector<std::pair<std::string, LatencyStats>> out;
+    if (!latency_) return out;
+    if (!sma_.empty()) out.emplace_back("sma", latency_->sma.stats());
+    if (config_.sma_crossover) out.emplace_back("sma_crossover", latency_->crossover.stats());
+    if (config_.zscore_window > 0) out.emplace_back("zscore", latency_->zscore.stats());
+    return out;
+}
+
+void StreamPipeline::annotate(Record& r) const {
+    for (const auto& kv : values_) {
+        r.indicators[kv.first] = kv.second;
+    }
+    r.signal = signal_;
+}
+
+} // namespace streaming
+} // namespace tsproc
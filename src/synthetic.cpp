@@ -0,0 +1,487 @@
+#include "synthetic.hpp"
+#include "datetime.hpp"
+#include "gaps.hpp"
+#include "scheduler.hpp"
+#include "trace.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+#ifdef TSPROC_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace tsproc {
+namespace synthetic {
+
+namespace {
+
+constexpr size_t kBlockRows = 1 << 16;
+constexpr double kTwoPi = 6.283185307179586;
+
+// Draw identifiers: each random quantity of a row has its own stream
+enum Draw : uint64_t {
+    kReturn = 0,      // 0, 1 (normal pair)
+    kOpenGap = 2,     // 2, 3
+    kRange = 4,       // 4, 5
+    kVolume = 6,      // 6, 7
+    kIsGap = 8,
+    kIsNaN = 9,
+    kIsDuplicate = 10,
+    kCorrection = 11, // 11, 12
+    kVolKnot = 16     // 16, 17; row = knot index
+};
+
+uint64_t mix(uint64_t x) {
+    // SplitMix64 finaliser
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// Counter-based draw: a pure function of (seed, symbol, row, draw)
+uint64_t draw_bits(uint64_t seed, size_t symbol, size_t row, uint64_t draw) {
+    return mix(mix(mix(seed ^ (static_cast<uint64_t>(symbol) << 32)) ^ row) ^ draw);
+}
+
+double uniform(uint64_t seed, size_t symbol, size_t row, uint64_t draw) {
+    return static_cast<double>(draw_bits(seed, symbol, row, draw) >> 11) * 0x1.0p-53;
+}
+
+double normal(uint64_t seed, size_t symbol, size_t row, uint64_t draw) {
+    double u1 = 1.0 - uniform(seed, symbol, row, draw);  // (0, 1]
+    double u2 = uniform(seed, symbol, row, draw + 1);
+    return std::sqrt(-2.0 * std::log(u1)) * std::cos(kTwoPi * u2);
+}
+
+// 0 = Monday ... 6 = Sunday (1970-01-01 was a Thursday)
+int64_t weekday(int64_t day) {
+    return ((day + 3) % 7 + 7) % 7;
+}
+
+size_t resolve_threads(size_t threads) {
+    return threads == 0 ? exec::Scheduler::global().concurrency() : threads;
+}
+
+// Run fn(task) for task in [0, count) on the scheduler, at most `threads` at a time
+template <typename Fn>
+void run_parallel(size_t count, size_t threads, Fn fn) {
+    if (threads <= 1 || count <= 1) {
+        for (size_t t = 0; t < count; ++t) fn(t);
+        return;
+    }
+    exec::TaskGroup group;
+    const size_t nodes = group.scheduler().node_count();
+    size_t stride = std::min(threads, count);
+    for (size_t w = 1; w < stride; ++w) {
+        group.spawn([&fn, w, stride, count] {
+            for (size_t t = w; t < count; t += stride) fn(t);
+        }, static_cast<long>(numa::node_for(w, stride, nodes)));
+    }
+    for (size_t t = 0; t < count; t += stride) fn(t);
+    tracing::Span wait("synthetic", "join_wait");
+    group.wait();
+}
+
+void append_number(std::string& out, double v, const char* fmt) {
+    if (std::isnan(v)) return;  // missing value -> empty field
+    char buf[32];
+    int n = std::snprintf(buf, sizeof(buf), fmt, v);
+    if (n < 0 || n >= static_cast<int>(sizeof(buf))) {
+        n = std::snprintf(buf, sizeof(buf), "%.6e", v);  // runaway paths
+    }
+    out.append(buf, static_cast<size_t>(n));
+}
+
+void encode_csv(const std::vector<Bar>& bars, const std::vector<uint32_t>* symbols,
+                std::string& out) {
+    out.reserve(out.size() + bars.size() * 80);
+    for (size_t i = 0; i < bars.size(); ++i) {
+        const Bar& b = bars[i];
+        out += format_datetime(b.ts);
+        if (symbols) {
+            out += ',';
+            out += Generator::symbol_name((*symbols)[i]);
+        }
+        out += ',';
+        append_number(out, b.open, "%.4f");
+        out += ',';
+        append_number(out, b.high, "%.4f");
+        out += ',';
+        append_number(out, b.low, "%.4f");
+        out += ',';
+        append_number(out, b.close, "%.4f");
+        out += ',';
+        append_number(out, b.adj_close, "%.4f");
+        out += ',';
+        append_number(out, b.volume, "%.0f");
+        out += '\n';
+    }
+}
+
+// Same row layout as BinaryWriter: int64 timestamp, six doubles, signal
+void encode_binary(const std::vector<Bar>& bars, std::string& out) {
+    size_t offset = out.size();
+    out.resize(offset + bars.size() * 8 * sizeof(double));
+    char* p = &out[offset];
+    const double signal = 0.0;
+    for (const Bar& b : bars) {
+        std::memcpy(p, &b, sizeof(Bar));  // Bar is the row minus the signal column
+        std::memcpy(p + sizeof(Bar), &signal, sizeof(signal));
+        p += 8 * sizeof(double);
+    }
+}
+
+// Sequential sink for encoded blocks
+class Sink {
+public:
+    Sink(const std::string& path, OutputFormat format) : format_(format) {
+        if (format_ == OutputFormat::CompressedCSV) {
+#ifdef TSPROC_HAVE_ZLIB
+            gz_ = gzopen(path.c_str(), "wb1");
+#endif
+            ok_ = gz_ != nullptr;
+        } else {
+            file_.open(path, std::ios::binary);
+            ok_ = file_.is_open();
+        }
+        if (!ok_) {
+            std::cerr << "Error: Could not open output file: " << path << std::endl;
+        }
+    }
+
+    ~Sink() { close(); }
+
+    bool ok() const { return ok_; }
+
+    void write(const std::string& data) {
+        if (!ok_ || data.empty()) return;
+        tracing::Span span("io", "flush", -1, static_cast<int64_t>(data.size()));
+        if (format_ == OutputFormat::CompressedCSV) {
+#ifdef TSPROC_HAVE_ZLIB
+            ok_ = gzwrite(static_cast<gzFile>(gz_), data.data(),
+                          static_cast<unsigned>(data.size())) > 0;
+#endif
+        } else {
+            file_.write(data.data(), static_cast<std::streamsize>(data.size()));
+            ok_ = file_.good();
+        }
+    }
+
+    // Binary files start with a row count that is only known at the end
+    void patch_row_count(uint64_t rows) {
+        if (!ok_ || format_ != OutputFormat::Binary) return;
+        file_.seekp(0);
+        file_.write(reinterpret_cast<const char*>(&rows), sizeof(rows));
+        ok_ = file_.good();
+    }
+
+    bool close() {
+        if (format_ == OutputFormat::CompressedCSV) {
+#ifdef TSPROC_HAVE_ZLIB
+            if (gz_ && gzclose(static_cast<gzFile>(gz_)) != Z_OK) ok_ = false;
+#endif
+            gz_ = nullptr;
+        } else if (file_.is_open()) {
+            file_.close();
+        }
+        return ok_;
+    }
+
+private:
+    OutputFormat format_;
+    std::ofstream file_;
+    void* gz_ = nullptr;
+    bool ok_ = false;
+};
+
+} // namespace
+
+Generator::Generator(const GeneratorConfig& config) : config_(config) {
+    if (config_.symbols == 0) {
+        throw std::invalid_argument("Generator needs at least one symbol");
+    }
+    if (config_.frequency_ns <= 0) {
+        throw std::invalid_argument("Generator frequency must be positive");
+    }
+    if (config_.session_open_ns < 0 || config_.session_close_ns > gaps::kDayNs ||
+        config_.session_open_ns >= config_.session_close_ns) {
+        throw std::invalid_argument("Session must satisfy 0 <= open < close <= 24h");
+    }
+    if (config_.start_price <= 0.0 || config_.volatility < 0.0 || config_.cluster_length == 0 ||
+        config_.half_life < 0.0) {
+        throw std::invalid_argument("Invalid price or volatility parameters");
+    }
+    for (double rate : {config_.gap_rate, config_.nan_rate, config_.duplicate_rate}) {
+        if (rate < 0.0 || rate > 1.0) {
+            throw std::invalid_argument("Rates must be in [0, 1]");
+        }
+    }
+
+    int64_t start = to_timestamp(config_.start);
+    if (start == kInvalidTimestamp) {
+        throw std::invalid_argument("Invalid start date: " + config_.start);
+    }
+    first_day_ = floor_div(start, gaps::kDayNs);
+    while (config_.weekdays_only && weekday(first_day_) >= 5) ++first_day_;
+
+    int64_t session = config_.session_close_ns - config_.session_open_ns;
+    slots_per_day_ = static_cast<size_t>((session + config_.frequency_ns - 1) / config_.frequency_ns);
+
+    // Every row's timestamp must fit in int64 nanoseconds (dates before 2262)
+    if (config_.rows > 0) {
+        const int64_t max_day = (INT64_MAX - gaps::kDayNs) / gaps::kDayNs;
+        const uint64_t last_day_n = (config_.rows - 1) / slots_per_day_;
+        if (first_day_ > max_day || last_day_n > static_cast<uint64_t>(max_day - first_day_) ||
+            trading_day(static_cast<int64_t>(last_day_n)) > max_day) {
+            throw std::invalid_argument(
+                "Generated dates would run past 2262, the int64 nanosecond limit");
+        }
+    }
+
+    log_start_ = std::log(config_.start_price);
+    phi_ = config_.half_life > 0.0 ? std::pow(0.5, 1.0 / config_.half_life) : 1.0;
+}
+
+std::string Generator::symbol_name(size_t symbol) {
+    char buf[16];
+    std::snprintf(buf, sizeof(buf), "SYM%04zu", symbol);
+    return buf;
+}
+
+int64_t Generator::trading_day(int64_t day_n) const {
+    if (!config_.weekdays_only) return first_day_ + day_n;
+    // Count trading days from the Monday of the first week
+    int64_t td = day_n + weekday(first_day_);
+    return first_day_ - weekday(first_day_) + (td / 5) * 7 + td % 5;
+}
+
+int64_t Generator::timestamp(size_t row) const {
+    int64_t day = trading_day(static_cast<int64_t>(row / slots_per_day_));
+    int64_t slot = static_cast<int64_t>(row % slots_per_day_);
+    return day * gaps::kDayNs + config_.session_open_ns + slot * config_.frequency_ns;
+}
+
+double Generator::volatility(size_t symbol, size_t row) const {
+    if (config_.vol_cluster == 0.0) return config_.volatility;
+
+    // Smoothly interpolated noise between random knots
+    size_t knot = row / config_.cluster_length;
+    double frac = static_cast<double>(row % config_.cluster_length) /
+                  static_cast<double>(config_.cluster_length);
+    double n0 = normal(config_.seed, symbol, knot, kVolKnot);
+    double n1 = normal(config_.seed, symbol, knot + 1, kVolKnot);
+    double w = frac * frac * (3.0 - 2.0 * frac);
+    return config_.volatility * std::exp(config_.vol_cluster * (n0 + (n1 - n0) * w));
+}
+
+double Generator::innovation(size_t symbol, size_t row) const {
+    return volatility(symbol, row) * normal(config_.seed, symbol, row, kReturn);
+}
+
+std::vector<double> Generator::block_start_states(size_t symbol, size_t block_rows,
+                                                  size_t threads) const {
+    // Each block maps x -> decay * x + sum, with decay = phi^rows
+    size_t blocks = (config_.rows + block_rows - 1) / block_rows;
+    std::vector<double> sums(blocks, 0.0);
+    std::vector<double> decays(blocks, 1.0);
+    run_parallel(blocks, resolve_threads(threads), [&](size_t b) {
+        size_t end = std::min(config_.rows, (b + 1) * block_rows);
+        double x = 0.0;
+        for (size_t row = b * block_rows; row < end; ++row) x = phi_ * x + innovation(symbol, row);
+        sums[b] = x;
+        decays[b] = std::pow(phi_, static_cast<double>(end - b * block_rows));
+    });
+
+    std::vector<double> starts(blocks);
+    double x = 0.0;
+    for (size_t b = 0; b < blocks; ++b) {
+        starts[b] = x;
+        x = decays[b] * x + sums[b];
+    }
+    return starts;
+}
+
+void Generator::generate(size_t symbol, size_t first, size_t count, double start_state,
+                         std::vector<Bar>& out) const {
+    const uint64_t seed = config_.seed;
+    double x = start_state;
+    double lp = log_start_ + config_.trend * static_cast<double>(first) + x;
+    size_t end = std::min(config_.rows, first + count);
+    for (size_t row = first; row < end; ++row) {
+        double vol = volatility(symbol, row);
+        double prev_close = std::exp(lp);
+        x = phi_ * x + vol * normal(seed, symbol, row, kReturn);
+        lp = log_start_ + config_.trend * static_cast<double>(row + 1) + x;
+
+        if (config_.gap_rate > 0.0 && uniform(seed, symbol, row, kIsGap) < config_.gap_rate) {
+            continue;
+        }
+
+        Bar b;
+        b.ts = timestamp(row);
+        b.close = std::exp(lp);
+        b.open = prev_close * std::exp(0.2 * vol * normal(seed, symbol, row, kOpenGap));
+        double range = std::fabs(0.5 * vol * normal(seed, symbol, row, kRange));
+        b.high = std::max(b.open, b.close) * (1.0 + range);
+        b.low = std::min(b.open, b.close) * (1.0 - range);
+        double activity = config_.volatility > 0.0 ? vol / config_.volatility : 1.0;
+        b.volume = std::round(1e6 * activity * std::exp(0.2 * normal(seed, symbol, row, kVolume)));
+
+        if (config_.nan_rate > 0.0 && uniform(seed, symbol, row, kIsNaN) < config_.nan_rate) {
+            b.close = NAN;
+        }
+        b.adj_close = b.close;
+        out.push_back(b);
+
+        if (config_.duplicate_rate > 0.0 &&
+            uniform(seed, symbol, row, kIsDuplicate) < config_.duplicate_rate) {
+            Bar fix = b;
+            fix.close = b.close * (1.0 + 0.1 * vol * normal(seed, symbol, row, kCorrection));
+            fix.adj_close = fix.close;
+            out.push_back(fix);
+        }
+    }
+}
+
+OutputFormat format_for_path(const std::string& path) {
+    auto ends_with = [&path](const std::string& suffix) {
+        return path.size() >= suffix.size() &&
+               path.compare(path.size() - suffix.size(), suffix.size(), suffix) == 0;
+    };
+    if (ends_with(".gz")) return OutputFormat::CompressedCSV;
+    if (ends_with(".bin")) return OutputFormat::Binary;
+    return OutputFormat::CSV;
+}
+
+bool compression_available() {
+#ifdef TSPROC_HAVE_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
+
+size_t write(const GeneratorConfig& config, const std::string& path, OutputFormat format,
+             size_t threads) {
+    Generator gen(config);
+    threads = resolve_threads(threads);
+    if (format == OutputFormat::CompressedCSV && !compression_available()) {
+        std::cerr << "Error: compressed output requires zlib support" << std::endl;
+        return 0;
+    }
+
+    const size_t blocks = (config.rows + kBlockRows - 1) / kBlockRows;
+    std::vector<std::vector<double>> starts(config.symbols);
+    for (size_t s = 0; s < config.symbols; ++s) {
+        starts[s] = gen.block_start_states(s, kBlockRows, threads);
+    }
+
+    // One output stream for CSV; one file per symbol for multi-symbol binary
+    const bool per_symbol = format == OutputFormat::Binary && config.symbols > 1;
+    const bool long_format = format != OutputFormat::Binary && config.symbols > 1;
+    const size_t outputs = per_symbol ? config.symbols : 1;
+
+    size_t total = 0;
+    for (size_t o = 0; o < outputs; ++o) {
+        std::string out_path = path;
+        if (per_symbol) {
+            size_t dot = path.rfind(".bin");
+            out_path = path.substr(0, dot) + "." + Generator::symbol_name(o) + ".bin";
+        }
+
+        Sink sink(out_path, format);
+        if (!sink.ok()) return 0;
+
+        if (format == OutputFormat::Binary) {
+            uint64_t header[2] = {0, 8};
+            sink.write(std::string(reinterpret_cast<const char*>(header), sizeof(header)));
+        } else {
+            sink.write(long_format ? "Date,Symbol,Open,High,Low,Close,Adj Close,Volume\n"
+                                   : "Date,Open,High,Low,Close,Adj Close,Volume\n");
+        }
+
+        // Blocks are generated and encoded in waves of `threads`, then written in order
+        uint64_t rows_written = 0;
+        std::vector<std::string> encoded(threads);
+        std::vector<size_t> counts(threads);
+        for (size_t wave = 0; wave < blocks; wave += threads) {
+            size_t in_wave = std::min(threads, blocks - wave);
+            run_parallel(in_wave, threads, [&](size_t t) {
+                size_t b = wave + t;
+                tracing::Span span("synthetic", "block", static_cast<int64_t>(b));
+                std::vector<Bar> bars;
+                std::vector<uint32_t> symbols;
+                size_t first_symbol = per_symbol ? o : 0;
+                size_t last_symbol = per_symbol ? o + 1 : config.symbols;
+                for (size_t s = first_symbol; s < last_symbol; ++s) {
+                    gen.generate(s, b * kBlockRows, kBlockRows, starts[s][b], bars);
+                    symbols.resize(bars.size(), static_cast<uint32_t>(s));
+                }
+
+                if (long_format) {
+                    // Interleave symbols by time, keeping symbol order within a timestamp
+                    std::vector<size_t> order(bars.size());
+                    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+                    std::stable_sort(order.begin(), order.end(),
+                                     [&bars](size_t a, size_t c) { return bars[a].ts < bars[c].ts; });
+                    std::vector<Bar> sorted_bars(bars.size());
+                    std::vector<uint32_t> sorted_symbols(bars.size());
+                    for (size_t i = 0; i < order.size(); ++i) {
+                        sorted_bars[i] = bars[order[i]];
+                        sorted_symbols[i] = symbols[order[i]];
+                    }
+                    bars.swap(sorted_bars);
+                    symbols.swap(sorted_symbols);
+                }
+
+                encoded[t].clear();
+                if (format == OutputFormat::Binary) {
+                    encode_binary(bars, encoded[t]);
+                } else {
+                    encode_csv(bars, long_format ? &symbols : nullptr, encoded[t]);
+                }
+                counts[t] = bars.size();
+                span.set_rows(static_cast<int64_t>(bars.size()));
+            });
+
+            for (size_t t = 0; t < in_wave; ++t) {
+                sink.write(encoded[t]);
+                rows_written += counts[t];
+            }
+        }
+
+        sink.patch_row_count(rows_written);
+        if (!sink.close()) {
+            std::cerr << "Error: Failed writing " << out_path << std::endl;
+            return 0;
+        }
+        total += static_cast<size_t>(rows_written);
+    }
+    return total;
+}
+
+TimeSeries generate_series(const GeneratorConfig& config, size_t symbol) {
+    Generator gen(config);
+    std::vector<double> starts = gen.block_start_states(symbol, kBlockRows, 1);
+
+    TimeSeries ts;
+    ts.reserve(config.rows);
+    std::vector<Bar> bars;
+    for (size_t b = 0; b < starts.size(); ++b) {
+        bars.clear();
+        gen.generate(symbol, b * kBlockRows, kBlockRows, starts[b], bars);
+        for (const Bar& bar : bars) {
+            ts.push(to_record(bar));
+        }
+    }
+    return ts;
+}
+
+} // namespace synthetic
+} // namespace tsproc
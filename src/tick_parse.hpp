@@ -0,0 +1,262 @@
+// Text scanning shared by the tick and order-event readers: in-place field
+// splitting, header lookup by name, fast number and timestamp parsing, and
+// line-aligned parallel chunking of a mapped file. Internal to src/.
+
+#pragma once
+
+#include "datetime.hpp"
+#include "numa.hpp"
+#include "pages.hpp"
+#include "scheduler.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace tsproc {
+namespace ticks {
+namespace detail {
+
+// Text smaller than this is parsed on the calling thread
+constexpr size_t kParallelBytes = 4u << 20;
+
+// Columns a row can reference; wider files are fine, later columns are ignored
+constexpr size_t kMaxFields = 64;
+
+struct Field {
+    const char* begin;
+    const char* end;
+};
+
+inline Field trim(Field f) {
+    auto is_space = [](char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; };
+    while (f.begin < f.end && is_space(*f.begin)) ++f.begin;
+    while (f.end > f.begin && is_space(f.end[-1])) --f.end;
+    return f;
+}
+
+inline bool is_blank(const char* begin, const char* end) {
+    Field f = trim({begin, end});
+    return f.begin == f.end;
+}
+
+inline size_t split(const char* begin, const char* end, char delimiter, Field* fields, size_t max_fields) {
+    size_t count = 0;
+    const char* start = begin;
+    for (const char* p = begin; count < max_fields; ++p) {
+        if (p == end || *p == delimiter) {
+            fields[count++] = {start, p};
+            if (p == end) break;
+            start = p + 1;
+        }
+    }
+    return count;
+}
+
+// Position of the first header column named any of `names`, or SIZE_MAX
+inline size_t find_column(const Field* header, size_t count, std::initializer_list<const char*> names) {
+    for (size_t i = 0; i < count; ++i) {
+        Field f = trim(header[i]);
+        const size_t len = static_cast<size_t>(f.end - f.begin);
+        for (const char* name : names) {
+            if (std::strlen(name) != len) continue;
+            bool same = true;
+            for (size_t k = 0; k < len && same; ++k) {
+                same = std::tolower(static_cast<unsigned char>(f.begin[k])) == name[k];
+            }
+            if (same) return i;
+        }
+    }
+    return SIZE_MAX;
+}
+
+// Powers of ten that are exact doubles
+constexpr double kPow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                             1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                             1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+// Same value as strtod. Plain decimals with at most 15 significant digits
+// take the fast path: the digits and the power of ten are both exact
+// doubles, so one division gives the correctly rounded result.
+inline bool parse_number(Field f, double& out) {
+    f = trim(f);
+    if (f.begin == f.end) return false;
+
+    const char* p = f.begin;
+    const bool negative = *p == '-';
+    if (*p == '-' || *p == '+') ++p;
+    uint64_t mantissa = 0;
+    size_t digits = 0;       // significant digits
+    size_t fraction = 0;     // digits after the point
+    bool any = false;
+    bool point = false;
+    bool plain = true;
+    for (; p < f.end; ++p) {
+        const char c = *p;
+        if (c >= '0' && c <= '9') {
+            any = true;
+            if (mantissa != 0 || c != '0') ++digits;
+            if (digits > 15) {
+                plain = false;
+                break;
+            }
+            mantissa = mantissa * 10 + static_cast<uint64_t>(c - '0');
+            if (point) ++fraction;
+        } else if (c == '.' && !point) {
+            point = true;
+        } else {
+            plain = false;
+            break;
+        }
+    }
+
+    if (plain && any && fraction < std::size(kPow10)) {
+        const double value = static_cast<double>(mantissa) / kPow10[fraction];
+        out = negative ? -value : value;
+        return true;
+    }
+
+    // Exponents, long mantissas and the like: strtod on a terminated copy
+    char buf[64];
+    const size_t len = static_cast<size_t>(f.end - f.begin);
+    if (len >= sizeof(buf)) return false;
+    std::memcpy(buf, f.begin, len);
+    buf[len] = '\0';
+    char* end = nullptr;
+    errno = 0;
+    const double value = std::strtod(buf, &end);
+    if (end == buf || errno == ERANGE || !std::isfinite(value)) return false;
+    out = value;
+    return true;
+}
+
+// Integer nanoseconds since the epoch, or a date for parse_datetime()
+inline bool parse_timestamp(Field f, std::string& scratch, int64_t& out) {
+    f = trim(f);
+    if (f.begin == f.end) return false;
+
+    const char* p = f.begin;
+    const bool negative = *p == '-';
+    if (negative) ++p;
+    const size_t len = static_cast<size_t>(f.end - p);
+    if (len > 0 && len <= 19 && std::all_of(p, f.end, [](char c) { return c >= '0' && c <= '9'; })) {
+        uint64_t value = 0;
+        for (; p < f.end; ++p) value = value * 10 + static_cast<uint64_t>(*p - '0');
+        if (value > static_cast<uint64_t>(INT64_MAX)) return false;
+        out = negative ? -static_cast<int64_t>(value) : static_cast<int64_t>(value);
+        return true;
+    }
+
+    scratch.assign(f.begin, f.end);
+    return parse_datetime(scratch, out);
+}
+
+/**
+ * Calls row(fields, count) for every non-blank line in [begin, end)
+ */
+template <typename RowFn>
+void for_each_row(const char* begin, const char* end, char delimiter, size_t max_fields,
+                  RowFn&& row) {
+    Field fields[kMaxFields];
+    const char* line = begin;
+    while (line < end) {
+        const char* nl = static_cast<const char*>(std::memchr(line, '\n', static_cast<size_t>(end - line)));
+        const char* line_end = nl ? nl : end;
+        if (!is_blank(line, line_end)) {
+            row(fields, split(line, line_end, delimiter, fields, max_fields));
+        }
+        line = nl ? nl + 1 : end;
+    }
+}
+
+/**
+ * Parse [begin, end) into `out`: serially for small text, otherwise in
+ * line-aligned chunks on the scheduler whose results are appended in order
+ */
+template <typename Columns, typename ParseChunk>
+void parse_chunks(const char* begin, const char* end, size_t threads, Columns& out,
+                  ParseChunk&& parse) {
+    const size_t bytes = static_cast<size_t>(end - begin);
+    if (threads == 0) threads = exec::Scheduler::global().concurrency();
+    threads = std::min(threads, bytes / kParallelBytes + 1);
+    if (threads <= 1) {
+        parse(begin, end, out);
+        return;
+    }
+
+    std::vector<const char*> cuts = {begin};
+    for (size_t t = 1; t < threads; ++t) {
+        const char* target = begin + bytes * t / threads;
+        if (target <= cuts.back()) continue;
+        const char* nl = static_cast<const char*>(
+            std::memchr(target - 1, '\n', static_cast<size_t>(end - (target - 1))));
+        if (nl == nullptr) break;
+        if (nl + 1 > cuts.back()) cuts.push_back(nl + 1);
+    }
+    cuts.push_back(end);
+
+    const size_t chunks = cuts.size() - 1;
+    std::vector<Columns> parts(chunks);
+    exec::TaskGroup group;
+    const size_t nodes = group.scheduler().node_count();
+    for (size_t c = 1; c < chunks; ++c) {
+        group.spawn([&, c] { parse(cuts[c], cuts[c + 1], parts[c]); },
+                    static_cast<long>(numa::node_for(c, chunks, nodes)));
+    }
+    parse(cuts[0], cuts[1], parts[0]);
+    group.wait();
+
+    size_t total = out.rows();
+    for (const Columns& part : parts) total += part.rows();
+    out.reserve(total);
+    for (const Columns& part : parts) out.append(part);
+}
+
+/**
+ * The header fields and the start of the data rows
+ */
+inline size_t read_header(const char* data, size_t size, char delimiter, Field* header,
+                   const char*& rows) {
+    const char* end = data + size;
+    const char* nl = static_cast<const char*>(std::memchr(data, '\n', size));
+    rows = nl ? nl + 1 : end;
+    return split(data, nl ? nl : end, delimiter, header, kMaxFields);
+}
+
+inline bool missing(size_t column, const char* name) {
+    if (column != SIZE_MAX) return false;
+    std::cerr << "Error: No " << name << " column in tick data header" << std::endl;
+    return true;
+}
+
+// Mapped when possible; otherwise the whole file is read into `buffer`
+inline bool load_file(const std::string& path, pages::MappedFile& mapped, std::string& buffer,
+               const char*& data, size_t& size) {
+    if (mapped.open(path)) {
+        data = mapped.data();
+        size = mapped.size();
+        return true;
+    }
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file: " << path << std::endl;
+        return false;
+    }
+    buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    data = buffer.data();
+    size = buffer.size();
+    return true;
+}
+
+} // namespace detail
+} // namespace ticks
+} // namespace tsproc
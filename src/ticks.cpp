@@ -0,0 +1,248 @@
+#include "ticks.hpp"
+#include "kernels.hpp"
+#include "tick_parse.hpp"
+#include "trace.hpp"
+#include <algorithm>
+#include <cctype>
+
+namespace tsproc {
+namespace ticks {
+
+using namespace detail;
+
+namespace {
+
+// Rows per quote_features() task
+constexpr size_t kFeatureGrain = 16384;
+
+struct TradeLayout {
+    size_t ts;
+    size_t price;
+    size_t size;
+    size_t side;     // SIZE_MAX when absent
+    size_t fields;   // fields a row needs to be split into
+};
+
+struct QuoteLayout {
+    size_t ts;
+    size_t bid;
+    size_t ask;
+    size_t bid_size;
+    size_t ask_size;
+    size_t fields;
+};
+
+void parse_trade_chunk(const char* begin, const char* end, char delimiter, const TradeLayout& layout,
+                       TradeColumns& out) {
+    tracing::Span span("ticks", "parse_trades");
+    std::string scratch;
+    for_each_row(begin, end, delimiter, layout.fields, [&](const Field* f, size_t count) {
+        if (count < layout.fields) return;
+        Trade t;
+        if (!parse_timestamp(f[layout.ts], scratch, t.ts) || !parse_number(f[layout.price], t.price) ||
+            !parse_number(f[layout.size], t.size)) {
+            return;
+        }
+        if (layout.side != SIZE_MAX) {
+            Field side = trim(f[layout.side]);
+            t.side = parse_side(std::string_view(side.begin, static_cast<size_t>(side.end - side.begin)));
+        }
+        out.push(t);
+    });
+    span.set_rows(static_cast<int64_t>(out.rows()));
+}
+
+void parse_quote_chunk(const char* begin, const char* end, char delimiter, const QuoteLayout& layout,
+                       QuoteColumns& out) {
+    tracing::Span span("ticks", "parse_quotes");
+    std::string scratch;
+    for_each_row(begin, end, delimiter, layout.fields, [&](const Field* f, size_t count) {
+        if (count < layout.fields) return;
+        Quote q;
+        if (!parse_timestamp(f[layout.ts], scratch, q.ts) || !parse_number(f[layout.bid], q.bid) ||
+            !parse_number(f[layout.ask], q.ask) || !parse_number(f[layout.bid_size], q.bid_size) ||
+            !parse_number(f[layout.ask_size], q.ask_size)) {
+            return;
+        }
+        out.push(q);
+    });
+    span.set_rows(static_cast<int64_t>(out.rows()));
+}
+
+} // namespace
+
+Side parse_side(std::string_view s) {
+    if (s.size() > 4) return Side::Unknown;
+    char lower[4];
+    for (size_t i = 0; i < s.size(); ++i) {
+        lower[i] = static_cast<char>(std::tolower(static_cast<unsigned char>(s[i])));
+    }
+    const std::string_view v(lower, s.size());
+    if (v == "b" || v == "buy" || v == "1") return Side::Buy;
+    if (v == "s" || v == "sell" || v == "-1") return Side::Sell;
+    return Side::Unknown;
+}
+
+const char* side_name(Side side) {
+    switch (side) {
+        case Side::Buy: return "buy";
+        case Side::Sell: return "sell";
+        default: return "unknown";
+    }
+}
+
+void TradeColumns::push(const Trade& t) {
+    ts.push_back(t.ts);
+    price.push_back(t.price);
+    size.push_back(t.size);
+    side.push_back(static_cast<int8_t>(t.side));
+}
+
+void TradeColumns::reserve(size_t rows) {
+    ts.reserve(rows);
+    price.reserve(rows);
+    size.reserve(rows);
+    side.reserve(rows);
+}
+
+void TradeColumns::append(const TradeColumns& other) {
+    ts.insert(ts.end(), other.ts.begin(), other.ts.end());
+    price.insert(price.end(), other.price.begin(), other.price.end());
+    size.insert(size.end(), other.size.begin(), other.size.end());
+    side.insert(side.end(), other.side.begin(), other.side.end());
+}
+
+Trade TradeColumns::at(size_t i) const {
+    Trade t;
+    t.ts = ts[i];
+    t.price = price[i];
+    t.size = size[i];
+    t.side = static_cast<Side>(side[i]);
+    return t;
+}
+
+void QuoteColumns::push(const Quote& q) {
+    ts.push_back(q.ts);
+    bid.push_back(q.bid);
+    ask.push_back(q.ask);
+    bid_size.push_back(q.bid_size);
+    ask_size.push_back(q.ask_size);
+}
+
+void QuoteColumns::reserve(size_t rows) {
+    ts.reserve(rows);
+    bid.reserve(rows);
+    ask.reserve(rows);
+    bid_size.reserve(rows);
+    ask_size.reserve(rows);
+}
+
+void QuoteColumns::append(const QuoteColumns& other) {
+    ts.insert(ts.end(), other.ts.begin(), other.ts.end());
+    bid.insert(bid.end(), other.bid.begin(), other.bid.end());
+    ask.insert(ask.end(), other.ask.begin(), other.ask.end());
+    bid_size.insert(bid_size.end(), other.bid_size.begin(), other.bid_size.end());
+    ask_size.insert(ask_size.end(), other.ask_size.begin(), other.ask_size.end());
+}
+
+Quote QuoteColumns::at(size_t i) const {
+    Quote q;
+    q.ts = ts[i];
+    q.bid = bid[i];
+    q.ask = ask[i];
+    q.bid_size = bid_size[i];
+    q.ask_size = ask_size[i];
+    return q;
+}
+
+bool parse_trades(const char* data, size_t size, TradeColumns& out, size_t threads, char delimiter) {
+    Field header[kMaxFields];
+    const char* rows = nullptr;
+    const size_t count = read_header(data, size, delimiter, header, rows);
+
+    TradeLayout layout;
+    layout.ts = find_column(header, count, {"ts", "timestamp", "time", "datetime", "date"});
+    layout.price = find_column(header, count, {"price", "px"});
+    layout.size = find_column(header, count, {"size", "qty", "quantity", "volume"});
+    layout.side = find_column(header, count, {"side", "aggressor"});
+    if (missing(layout.ts, "timestamp") || missing(layout.price, "price") ||
+        missing(layout.size, "size")) {
+        return false;
+    }
+    layout.fields = std::max({layout.ts, layout.price, layout.size,
+                              layout.side == SIZE_MAX ? 0 : layout.side}) + 1;
+
+    parse_chunks(rows, data + size, threads, out,
+                 [&](const char* begin, const char* end, TradeColumns& part) {
+                     parse_trade_chunk(begin, end, delimiter, layout, part);
+                 });
+    return true;
+}
+
+bool parse_quotes(const char* data, size_t size, QuoteColumns& out, size_t threads, char delimiter) {
+    Field header[kMaxFields];
+    const char* rows = nullptr;
+    const size_t count = read_header(data, size, delimiter, header, rows);
+
+    QuoteLayout layout;
+    layout.ts = find_column(header, count, {"ts", "timestamp", "time", "datetime", "date"});
+    layout.bid = find_column(header, count, {"bid", "bid_price", "bid_px"});
+    layout.ask = find_column(header, count, {"ask", "ask_price", "ask_px", "offer"});
+    layout.bid_size = find_column(header, count, {"bid_size", "bid_qty", "bidsize"});
+    layout.ask_size = find_column(header, count, {"ask_size", "ask_qty", "asksize"});
+    if (missing(layout.ts, "timestamp") || missing(layout.bid, "bid") || missing(layout.ask, "ask") ||
+        missing(layout.bid_size, "bid_size") || missing(layout.ask_size, "ask_size")) {
+        return false;
+    }
+    layout.fields = std::max({layout.ts, layout.bid, layout.ask, layout.bid_size, layout.ask_size}) + 1;
+
+    parse_chunks(rows, data + size, threads, out,
+                 [&](const char* begin, const char* end, QuoteColumns& part) {
+                     parse_quote_chunk(begin, end, delimiter, layout, part);
+                 });
+    return true;
+}
+
+bool read_trades(const std::string& path, TradeColumns& out, size_t threads, char delimiter) {
+    pages::MappedFile mapped;
+    std::string buffer;
+    const char* data = nullptr;
+    size_t size = 0;
+    return load_file(path, mapped, buffer, data, size) &&
+           parse_trades(data, size, out, threads, delimiter);
+}
+
+bool read_quotes(const std::string& path, QuoteColumns& out, size_t threads, char delimiter) {
+    pages::MappedFile mapped;
+    std::string buffer;
+    const char* data = nullptr;
+    size_t size = 0;
+    return load_file(path, mapped, buffer, data, size) &&
+           parse_quotes(data, size, out, threads, delimiter);
+}
+
+QuoteFeatures quote_features(const QuoteColumns& quotes) {
+    const size_t n = quotes.rows();
+    tracing::Span span("ticks", "quote_features", -1, static_cast<int64_t>(n));
+    // Filled by the parallel_for below, so each range is placed on its node
+    constexpr ColumnBuffer::FirstTouch kSplit = ColumnBuffer::FirstTouch::Parallel;
+    QuoteFeatures f{ColumnBuffer(n, kSplit), ColumnBuffer(n, kSplit), ColumnBuffer(n, kSplit),
+                    ColumnBuffer(n, kSplit)};
+    exec::parallel_for(0, n, kFeatureGrain, [&](size_t begin, size_t end) {
+        kernels::quote_features(quotes.bid.data() + begin, quotes.ask.data() + begin,
+                                quotes.bid_size.data() + begin, quotes.ask_size.data() + begin,
+                                end - begin, f.mid.data() + begin, f.spread.data() + begin,
+                                f.microprice.data() + begin, f.imbalance.data() + begin);
+    });
+    return f;
+}
+
+QuoteMetrics quote_metrics(const Quote& q) {
+    QuoteMetrics m;
+    kernels::quote_features(&q.bid, &q.ask, &q.bid_size, &q.ask_size, 1, &m.mid, &m.spread,
+                            &m.microprice, &m.imbalance);
+    return m;
+}
+
+} // namespace ticks
+} // namespace tsproc
@@ -0,0 +1,145 @@
+#include "trace.hpp"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+namespace tsproc {
+namespace tracing {
+
+namespace {
+
+int64_t steady_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+void write_string(std::ostream& os, const char* s) {
+    os << '"';
+    for (; *s; ++s) {
+        if (*s == '"' || *s == '\\') os << '\\';
+        os << *s;
+    }
+    os << '"';
+}
+
+// Microseconds with nanosecond precision, as trace viewers expect
+void write_us(std::ostream& os, int64_t ns) {
+    char buf[32];
+    int n = std::snprintf(buf, sizeof(buf), "%.3f", static_cast<double>(ns) / 1000.0);
+    os.write(buf, n);
+}
+
+} // namespace
+
+Tracer& Tracer::instance() {
+    static Tracer tracer;
+    return tracer;
+}
+
+void Tracer::enable() {
+    epoch_ns_ = steady_ns();
+    ThreadBuffer& buffer = local();
+    if (buffer.tid == 0) buffer.name = "main";
+    enabled_.store(true, std::memory_order_relaxed);
+}
+
+int64_t Tracer::now() const {
+    return steady_ns() - epoch_ns_;
+}
+
+Tracer::ThreadBuffer& Tracer::local() {
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (!buffer) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto owned = std::make_unique<ThreadBuffer>();
+        owned->tid = static_cast<uint32_t>(buffers_.size());
+        owned->name = "thread-" + std::to_string(owned->tid);
+        owned->events.reserve(1024);
+        buffer = owned.get();
+        buffers_.push_back(std::move(owned));
+    }
+    return *buffer;
+}
+
+void Tracer::record(const Event& event) {
+    local().events.push_back(event);
+}
+
+void Tracer::set_thread_name(const std::string& name) {
+    ThreadBuffer& buffer = local();
+    std::lock_guard<std::mutex> lock(mutex_);
+    buffer.name = name;
+}
+
+size_t Tracer::event_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t total = 0;
+    for (const auto& b : buffers_) total += b->events.size();
+    return total;
+}
+
+void Tracer::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& b : buffers_) b->events.clear();
+}
+
+void Tracer::write(std::ostream& os) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    os << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,"
+          "\"args\":{\"name\":\"tsproc\"}}";
+    for (const auto& b : buffers_) {
+        os << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << b->tid
+           << ",\"args\":{\"name\":";
+        write_string(os, b->name.c_str());
+        os << "}}";
+        for (const Event& e : b->events) {
+            os << ",\n{\"name\":";
+            write_string(os, e.name);
+            os << ",\"cat\":";
+            write_string(os, e.category);
+            os << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << b->tid << ",\"ts\":";
+            write_us(os, e.start_ns);
+            os << ",\"dur\":";
+            write_us(os, e.duration_ns);
+            if (e.param >= 0 || e.rows >= 0) {
+                os << ",\"args\":{";
+                if (e.param >= 0) os << "\"param\":" << e.param;
+                if (e.param >= 0 && e.rows >= 0) os << ",";
+                if (e.rows >= 0) os << "\"rows\":" << e.rows;
+                os << "}";
+            }
+            os << "}";
+        }
+    }
+    os << "\n]}\n";
+}
+
+bool Tracer::write(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file for writing: " << path << std::endl;
+        return false;
+    }
+    write(file);
+    return file.good();
+}
+
+Span::Span(const char* category, const char* name, int64_t param, int64_t rows)
+    : active_(Tracer::instance().enabled()) {
+    if (active_) {
+        event_ = {category, name, Tracer::instance().now(), 0, param, rows};
+    }
+}
+
+Span::~Span() {
+    if (!active_) return;
+    Tracer& tracer = Tracer::instance();
+    event_.duration_ns = tracer.now() - event_.start_ns;
+    tracer.record(event_);
+}
+
+} // namespace tracing
+} // namespace tsproc
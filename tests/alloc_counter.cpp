@@ -0,0 +1,131 @@
+#include "alloc_counter.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+// Constant-initialized, so touching them from inside malloc never allocates
+thread_local uint64_t tls_count = 0;
+thread_local uint64_t tls_bytes = 0;
+std::atomic<uint64_t> process_count{0};
+std::atomic<uint64_t> process_bytes{0};
+
+inline void note(size_t size) {
+    ++tls_count;
+    tls_bytes += size;
+    process_count.fetch_add(1, std::memory_order_relaxed);
+    process_bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+} // namespace
+
+// Sanitizer runtimes own malloc and free. Replacing malloc alone would hand
+// their free() blocks they never allocated, so under ASan/TSan only the
+// operator new family is counted.
+#if defined(__SANITIZE_ADDRESS__) || defined(__SANITIZE_THREAD__)
+#define TSPROC_ALLOC_SANITIZED 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer) || __has_feature(thread_sanitizer)
+#define TSPROC_ALLOC_SANITIZED 1
+#endif
+#endif
+
+#if defined(__GLIBC__) && !defined(TSPROC_ALLOC_SANITIZED)
+// glibc exports its allocator under these names, so malloc itself can be
+// replaced; operator new then allocates through them to avoid double counting
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t n, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+
+void* malloc(size_t size) {
+    note(size);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t n, size_t size) {
+    note(n * size);
+    return __libc_calloc(n, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    note(size);
+    return __libc_realloc(ptr, size);
+}
+}
+
+namespace {
+inline void* raw_malloc(size_t size) { return __libc_malloc(size); }
+} // namespace
+#else
+namespace {
+inline void* raw_malloc(size_t size) { return std::malloc(size); }
+} // namespace
+#endif
+
+namespace {
+
+void* counted_new(size_t size) {
+    note(size);
+    void* p = raw_malloc(size == 0 ? 1 : size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* counted_new(size_t size, std::align_val_t align) {
+    note(size);
+    size_t alignment = static_cast<size_t>(align);
+    size_t rounded = (size + alignment - 1) / alignment * alignment;
+    void* p = std::aligned_alloc(alignment, rounded == 0 ? alignment : rounded);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+} // namespace
+
+void* operator new(size_t size) { return counted_new(size); }
+void* operator new[](size_t size) { return counted_new(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    try { return counted_new(size); } catch (...) { return nullptr; }
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    try { return counted_new(size); } catch (...) { return nullptr; }
+}
+void* operator new(size_t size, std::align_val_t align) { return counted_new(size, align); }
+void* operator new[](size_t size, std::align_val_t align) { return counted_new(size, align); }
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+
+namespace tsproc {
+namespace testing {
+
+AllocationCounter::AllocationCounter() : start_count_(tls_count), start_bytes_(tls_bytes) {}
+
+uint64_t AllocationCounter::count() const {
+    return tls_count - start_count_;
+}
+
+uint64_t AllocationCounter::bytes() const {
+    return tls_bytes - start_bytes_;
+}
+
+uint64_t process_allocations() {
+    return process_count.load(std::memory_order_relaxed);
+}
+
+uint64_t process_allocated_bytes() {
+    return process_bytes.load(std::memory_order_relaxed);
+}
+
+} // namespace testing
+} // namespace tsproc
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace tsproc {
+namespace testing {
+
+/**
+ * @brief Heap allocations made while an AllocationCounter is alive
+ *
+ * Linking alloc_counter.cpp replaces the global operator new family (and,
+ * on glibc without ASan/TSan, malloc/calloc/realloc) with versions that
+ * count every call.
+ * Counting is per thread, so a counter only sees allocations made by the
+ * thread that created it.
+ *
+ * @code
+ * AllocationCounter allocs;
+ * for (...) pipeline.update(r);
+ * EXPECT_EQ(allocs.count(), 0u);
+ * @endcode
+ */
+class AllocationCounter {
+public:
+    AllocationCounter();
+
+    /// Allocations on this thread since construction
+    uint64_t count() const;
+
+    /// Bytes requested on this thread since construction
+    uint64_t bytes() const;
+
+private:
+    uint64_t start_count_;
+    uint64_t start_bytes_;
+};
+
+/**
+ * @brief Allocations made by all threads since process start
+ */
+uint64_t process_allocations();
+
+/**
+ * @brief Bytes requested by all threads since process start
+ */
+uint64_t process_allocated_bytes();
+
+} // namespace testing
+} // namespace tsproc
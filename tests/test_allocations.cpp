@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+#include "alloc_counter.hpp"
+#include "csv_reader.hpp"
+#include "histogram.hpp"
+#include "kernels.hpp"
+#include "streaming.hpp"
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+using tsproc::testing::AllocationCounter;
+
+namespace {
+
+void* volatile sink;
+
+std::vector<double> prices(size_t n) {
+    std::vector<double> v(n);
+    for (size_t i = 0; i < n; ++i) v[i] = 100.0 + std::sin(static_cast<double>(i) * 0.01);
+    return v;
+}
+
+std::string write_csv(const std::string& name, size_t rows, bool intraday) {
+    std::string path = (fs::temp_directory_path() / name).string();
+    std::ofstream f(path);
+    f << "Date,Open,High,Low,Close,Adj Close,Volume\n";
+    for (size_t i = 0; i < rows; ++i) {
+        f << "2024-01-" << (10 + i % 20);
+        if (intraday) f << " 14:" << (10 + i % 50) << ":00";
+        f << "," << 100 + i % 7 << ",101.5,99.25," << 100.5 + i % 3 << ",100.5,  " << 1000 + i
+          << "\n";
+    }
+    return path;
+}
+
+uint64_t stream_allocations(const std::string& path) {
+    tsproc::CSVReader reader(path);
+    size_t rows = 0;
+    AllocationCounter allocs;
+    reader.stream_to([&rows](const tsproc::Record&) { ++rows; });
+    EXPECT_GT(rows, 0u);
+    return allocs.count();
+}
+
+} // namespace
+
+TEST(AllocationCounterTest, CountsThisThread) {
+    AllocationCounter allocs;
+    sink = ::operator new(64);
+    ::operator delete(sink);
+    std::vector<double> v(1000);
+    EXPECT_EQ(allocs.count(), 2u);
+    EXPECT_GE(allocs.bytes(), 64u + 1000 * sizeof(double));
+
+    // Other threads only show up in the process-wide totals
+    AllocationCounter mine;
+    uint64_t before = tsproc::testing::process_allocations();
+    std::thread([] {
+        sink = ::operator new(16);
+        ::operator delete(sink);
+    }).join();
+    EXPECT_GE(tsproc::testing::process_allocations(), before + 1);
+    EXPECT_LE(mine.count(), 2u);  // std::thread's own bookkeeping at most
+}
+
+TEST(AllocationTest, RollingKernelsDoNotAllocate) {
+    const size_t n = 100000;
+    std::vector<double> in = prices(n);
+    std::vector<double> a(n), b(n);
+
+    AllocationCounter allocs;
+    tsproc::kernels::rolling_sum(in.data(), n, 20, a.data());
+    tsproc::kernels::rolling_mean(in.data(), n, 20, a.data());
+    tsproc::kernels::rolling_mean_std(in.data(), n, 200, a.data(), b.data());
+    tsproc::kernels::ema(in.data(), n, 20, a.data());
+    EXPECT_EQ(allocs.count(), 0u);
+}
+
+TEST(AllocationTest, StreamingUpdatesDoNotAllocate) {
+    tsproc::streaming::StreamConfig config;
+    config.sma_windows = {5, 20};
+    config.zscore_window = 20;
+    config.zscore_signal = true;
+    config.fast_sma = 5;
+    config.slow_sma = 20;
+    config.sma_crossover = true;
+    tsproc::streaming::StreamPipeline pipeline(config);
+
+    tsproc::Record r;
+    std::vector<double> in = prices(50000);
+    AllocationCounter allocs;
+    for (double p : in) {
+        r.close = p;
+        pipeline.update(r);
+    }
+    EXPECT_EQ(allocs.count(), 0u);
+}
+
+TEST(AllocationTest, LatencyRecordingDoesNotAllocate) {
+    auto histogram = std::make_unique<tsproc::LatencyHistogram>();
+    tsproc::streaming::StreamConfig config;
+    config.sma_windows = {5};
+    config.zscore_window = 20;
+    tsproc::streaming::StreamPipeline pipeline(config);
+    pipeline.enable_stage_latency();
+
+    tsproc::Record r;
+    AllocationCounter allocs;
+    for (int64_t i = 0; i < 50000; ++i) {
+        histogram->record(i * 37);
+        r.close = 100.0 + static_cast<double>(i % 13);
+        pipeline.update(r);
+    }
+    EXPECT_EQ(allocs.count(), 0u);
+}
+
+TEST(AllocationTest, CSVParsingDoesNotAllocatePerRow) {
+    for (bool intraday : {false, true}) {
+        std::string small = write_csv("tsproc_alloc_small.csv", 1000, intraday);
+        std::string large = write_csv("tsproc_alloc_large.csv", 20000, intraday);
+
+        // Opening the file and the first line cost the same regardless of length
+        EXPECT_EQ(stream_allocations(large), stream_allocations(small)) << "intraday=" << intraday;
+
+        fs::remove(small);
+        fs::remove(large);
+    }
+}
+
+TEST(AllocationTest, CSVLoadOnlyGrowsStorage) {
+    std::string small = write_csv("tsproc_alloc_small.csv", 1000, false);
+    std::string large = write_csv("tsproc_alloc_large.csv", 16000, false);
+
+    auto load_allocations = [](const std::string& path) {
+        AllocationCounter allocs;
+        tsproc::TimeSeries ts = tsproc::CSVReader(path).read_to_timeseries();
+        EXPECT_GT(ts.size(), 0u);
+        return allocs.count();
+    };
+
+    // 16x the rows: only the row vector's geometric growth (4 doublings) differs
+    EXPECT_LE(load_allocations(large), load_allocations(small) + 4);
+
+    fs::remove(small);
+    fs::remove(large);
+}
@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+#include "bar.hpp"
+#include "datetime.hpp"
+#include "io.hpp"
+#include "replay.hpp"
+#include "streaming.hpp"
+#include "synthetic.hpp"
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <type_traits>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+class BarTest : public ::testing::Test {
+protected:
+    std::string bin_path = "test_bar.bin";
+
+    void TearDown() override {
+        if (fs::exists(bin_path)) fs::remove(bin_path);
+    }
+
+    static std::vector<tsproc::Bar> make_bars(size_t rows) {
+        std::vector<tsproc::Bar> bars(rows);
+        const int64_t start = tsproc::to_timestamp("2022-06-01 14:00:00");
+        for (size_t i = 0; i < rows; ++i) {
+            tsproc::Bar& b = bars[i];
+            b.ts = start + static_cast<int64_t>(i) * 1'000'000'000LL;
+            b.close = 50.0 + 3.0 * std::sin(static_cast<double>(i) * 0.3);
+            b.open = b.close - 0.25;
+            b.high = b.close + 1.0;
+            b.low = b.close - 1.0;
+            b.adj_close = b.close * 0.5;
+            b.volume = static_cast<double>(100 + i);
+        }
+        return bars;
+    }
+};
+
+TEST_F(BarTest, IsCompactAndTriviallyCopyable) {
+    EXPECT_TRUE(std::is_trivially_copyable<tsproc::Bar>::value);
+    EXPECT_EQ(sizeof(tsproc::Bar), 56u);
+
+    std::vector<tsproc::Bar> bars = make_bars(4);
+    tsproc::Bar copies[4];
+    std::memcpy(copies, bars.data(), sizeof(copies));
+    EXPECT_EQ(copies[3].ts, bars[3].ts);
+    EXPECT_EQ(copies[3].volume, bars[3].volume);
+}
+
+TEST_F(BarTest, RecordAdaptersRoundTrip) {
+    tsproc::Record r;
+    r.date = "2022-06-01 14:00:05";
+    r.open = 1.0;
+    r.high = 2.0;
+    r.low = 0.5;
+    r.close = 1.5;
+    r.adj_close = 1.25;
+    r.volume = 10.0;
+
+    tsproc::Bar b = tsproc::to_bar(r);
+    EXPECT_EQ(b.ts, tsproc::to_timestamp(r.date));
+    EXPECT_EQ(b.adj_close, 1.25);
+
+    tsproc::Record back = tsproc::to_record(b);
+    EXPECT_EQ(back.date, r.date);
+    EXPECT_EQ(back.close, r.close);
+    EXPECT_TRUE(back.indicators.empty());
+
+    tsproc::Record undated;
+    EXPECT_EQ(tsproc::to_bar(undated).ts, tsproc::kInvalidTimestamp);
+    EXPECT_EQ(tsproc::to_record(tsproc::to_bar(undated)).date, "");
+
+    tsproc::TimeSeries ts = tsproc::to_series(make_bars(5));
+    ASSERT_EQ(ts.size(), 5u);
+    EXPECT_EQ(tsproc::to_bars(ts)[4].ts, make_bars(5)[4].ts);
+}
+
+TEST_F(BarTest, BinaryBarsRoundTripBitExact) {
+    std::vector<tsproc::Bar> bars = make_bars(1000);
+    ASSERT_TRUE(tsproc::BinaryWriter(bin_path).write(bars));
+
+    tsproc::BinaryReader reader(bin_path);
+    std::vector<tsproc::Bar> read = reader.read_bars();
+    ASSERT_EQ(read.size(), bars.size());
+    EXPECT_EQ(std::memcmp(read.data(), bars.data(), bars.size() * sizeof(tsproc::Bar)), 0);
+
+    // The Record path reads the same file, with a zero signal column
+    tsproc::TimeSeries ts = reader.read();
+    ASSERT_EQ(ts.size(), bars.size());
+    EXPECT_EQ(ts[7].date, tsproc::format_datetime(bars[7].ts));
+    EXPECT_EQ(ts[7].adj_close, bars[7].adj_close);
+    EXPECT_EQ(ts[7].signal, 0);
+
+    std::vector<tsproc::Bar> block = reader.read_bars(995, 10);
+    ASSERT_EQ(block.size(), 5u);
+    EXPECT_EQ(block[0].ts, bars[995].ts);
+
+    std::vector<tsproc::Bar> range = reader.read_bars_range(bars[10].ts, bars[20].ts);
+    ASSERT_EQ(range.size(), 10u);
+    EXPECT_EQ(range.front().ts, bars[10].ts);
+    EXPECT_TRUE(reader.read_bars_range(bars[999].ts + 1, INT64_MAX).empty());
+}
+
+TEST_F(BarTest, LegacyFilesHaveNoTimestamps) {
+    // 7-column rows: OHLC, adj_close, volume, signal
+    std::ofstream out(bin_path, std::ios::binary);
+    uint64_t header[2] = {2, 7};
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    for (int i = 0; i < 2; ++i) {
+        double row[7] = {1.0 + i, 2.0, 0.5, 1.5, 1.25, 10.0, 1.0};
+        out.write(reinterpret_cast<const char*>(row), sizeof(row));
+    }
+    out.close();
+
+    std::vector<tsproc::Bar> bars = tsproc::BinaryReader(bin_path).read_bars();
+    ASSERT_EQ(bars.size(), 2u);
+    EXPECT_EQ(bars[1].ts, tsproc::kInvalidTimestamp);
+    EXPECT_EQ(bars[1].open, 2.0);
+    EXPECT_EQ(bars[1].volume, 10.0);
+}
+
+TEST_F(BarTest, StreamPipelineMatchesRecordInput) {
+    tsproc::streaming::StreamConfig config;
+    config.sma_windows = {5, 20};
+    config.fast_sma = 5;
+    config.slow_sma = 20;
+    config.sma_crossover = true;
+    config.zscore_window = 10;
+    config.zscore_signal = true;
+
+    tsproc::streaming::StreamPipeline from_bars(config);
+    tsproc::streaming::StreamPipeline from_records(config);
+    for (const tsproc::Bar& b : make_bars(300)) {
+        ASSERT_EQ(from_bars.update(b), from_records.update(tsproc::to_record(b)));
+        for (size_t j = 0; j < from_bars.values().size(); ++j) {
+            const double x = from_bars.values()[j].second;
+            const double y = from_records.values()[j].second;
+            ASSERT_TRUE(x == y || (std::isnan(x) && std::isnan(y)));
+        }
+    }
+}
+
+TEST_F(BarTest, ReplayReadsBinaryAsBars) {
+    std::vector<tsproc::Bar> bars = make_bars(50);
+    ASSERT_TRUE(tsproc::BinaryWriter(bin_path).write(bars));
+
+    tsproc::ReplaySource source(bin_path);
+    ASSERT_EQ(source.load(), 50u);
+    EXPECT_EQ(source.bars()[49].ts, bars[49].ts);
+
+    size_t emitted = 0;
+    double last_close = 0.0;
+    source.run([&](const tsproc::Bar& b) {
+        ++emitted;
+        last_close = b.close;
+    });
+    EXPECT_EQ(emitted, 50u);
+    EXPECT_EQ(last_close, bars[49].close);
+
+    // Records are built on demand for the compatibility path
+    EXPECT_EQ(source.series()[49].date, tsproc::format_datetime(bars[49].ts));
+}
+
+TEST_F(BarTest, GeneratorFillsAdjustedClose) {
+    tsproc::synthetic::GeneratorConfig config;
+    config.rows = 100;
+    tsproc::synthetic::Generator gen(config);
+    std::vector<tsproc::Bar> bars;
+    gen.generate(0, 0, 100, 0.0, bars);
+    ASSERT_EQ(bars.size(), 100u);
+    for (const tsproc::Bar& b : bars) ASSERT_EQ(b.adj_close, b.close);
+}
@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+#include "csv_reader.hpp"
+#include "csv_index.hpp"
+#include "datetime.hpp"
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr int64_t kMinute = 60LL * 1000000000LL;
+
+} // namespace
+
+class CSVIndexTest : public ::testing::Test {
+protected:
+    std::string csv_path = "test_index.csv";
+    std::string idx_path = tsproc::CSVIndex::sidecar_path(csv_path);
+    int64_t origin = tsproc::to_timestamp("2016-03-01");
+
+    void TearDown() override {
+        if (fs::exists(csv_path)) fs::remove(csv_path);
+        if (fs::exists(idx_path)) fs::remove(idx_path);
+    }
+
+    // Minute bars with close = row number and a few blank lines
+    void create_csv(size_t rows) {
+        std::ofstream ofs(csv_path);
+        ofs << "Date,Open,High,Low,Close,Adj Close,Volume\n";
+        for (size_t i = 0; i < rows; ++i) {
+            ofs << tsproc::format_datetime(origin + static_cast<int64_t>(i) * kMinute)
+                << ",1,2,0.5," << i << "," << i << ",100\n";
+            if (i % 700 == 350) ofs << "\n";
+        }
+    }
+
+    int64_t at(size_t row) const { return origin + static_cast<int64_t>(row) * kMinute; }
+};
+
+TEST_F(CSVIndexTest, BuildSaveLoad) {
+    create_csv(5000);
+    tsproc::CSVIndex index;
+    ASSERT_TRUE(index.build(csv_path, 100));
+    EXPECT_EQ(index.row_count(), 5000u);
+    ASSERT_EQ(index.entries().size(), 50u);
+    EXPECT_EQ(index.entries()[3].timestamp, at(300));
+    ASSERT_TRUE(index.save(idx_path));
+
+    tsproc::CSVIndex loaded;
+    ASSERT_TRUE(loaded.load(idx_path, csv_path));
+    EXPECT_EQ(loaded.row_count(), 5000u);
+    EXPECT_EQ(loaded.stride(), 100u);
+    EXPECT_EQ(loaded.entries()[49].offset, index.entries()[49].offset);
+}
+
+TEST_F(CSVIndexTest, StaleIndexIsIgnored) {
+    create_csv(1000);
+    tsproc::CSVIndex index;
+    ASSERT_TRUE(index.build(csv_path, 64));
+    ASSERT_TRUE(index.save(idx_path));
+
+    create_csv(1200);
+    tsproc::CSVIndex loaded;
+    EXPECT_FALSE(loaded.load(idx_path, csv_path));
+    EXPECT_EQ(tsproc::CSVReader(csv_path).row_count(), 1200u);
+}
+
+TEST_F(CSVIndexTest, SameSizeEditIsStale) {
+    create_csv(1000);
+    tsproc::CSVIndex index;
+    ASSERT_TRUE(index.build(csv_path, 64));
+    ASSERT_TRUE(index.save(idx_path));
+    const auto stamp = fs::last_write_time(csv_path);
+
+    // Rewrite one byte in place: same size, later modification time
+    {
+        std::fstream f(csv_path, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(60);
+        f.put('7');
+    }
+    fs::last_write_time(csv_path, stamp + std::chrono::seconds(1));
+    tsproc::CSVIndex loaded;
+    EXPECT_FALSE(loaded.load(idx_path, csv_path));
+
+    fs::last_write_time(csv_path, stamp);
+    EXPECT_TRUE(loaded.load(idx_path, csv_path));
+}
+
+TEST_F(CSVIndexTest, TruncatedIndexIsRejected) {
+    create_csv(1000);
+    tsproc::CSVIndex index;
+    ASSERT_TRUE(index.build(csv_path, 64));
+    ASSERT_TRUE(index.save(idx_path));
+
+    // Drop the last entry: the stored count no longer matches the file length
+    fs::resize_file(idx_path, fs::file_size(idx_path) - 16);
+    tsproc::CSVIndex loaded;
+    EXPECT_FALSE(loaded.load(idx_path, csv_path));
+
+    // A header claiming more entries than the file holds
+    fs::resize_file(idx_path, 8 + 5 * 8);
+    std::fstream f(idx_path, std::ios::in | std::ios::out | std::ios::binary);
+    const uint64_t huge = uint64_t(1) << 60;
+    f.seekp(8 + 4 * 8);
+    f.write(reinterpret_cast<const char*>(&huge), sizeof(huge));
+    f.close();
+    EXPECT_FALSE(loaded.load(idx_path, csv_path));
+}
+
+TEST_F(CSVIndexTest, BuiltDuringFirstParse) {
+    create_csv(3000);
+    tsproc::CSVReader reader(csv_path);
+    reader.set_build_index(true, 256);
+    ASSERT_EQ(reader.read_to_timeseries().size(), 3000u);
+    ASSERT_TRUE(fs::exists(idx_path));
+
+    tsproc::CSVIndex parsed;
+    ASSERT_TRUE(parsed.load(idx_path, csv_path));
+    tsproc::CSVIndex scanned;
+    ASSERT_TRUE(scanned.build(csv_path, 256));
+    ASSERT_EQ(parsed.entries().size(), scanned.entries().size());
+    for (size_t i = 0; i < parsed.entries().size(); ++i) {
+        EXPECT_EQ(parsed.entries()[i].offset, scanned.entries()[i].offset);
+        EXPECT_EQ(parsed.entries()[i].timestamp, scanned.entries()[i].timestamp);
+    }
+    EXPECT_EQ(reader.row_count(), 3000u);
+}
+
+TEST_F(CSVIndexTest, ReadRowsSeeksToAnyRow) {
+    create_csv(4000);
+    tsproc::CSVReader reader(csv_path);
+    tsproc::TimeSeries unindexed = reader.read_rows(1234, 10);
+
+    tsproc::CSVIndex index;
+    ASSERT_TRUE(index.build(csv_path, 100));
+    ASSERT_TRUE(index.save(idx_path));
+    tsproc::TimeSeries indexed = reader.read_rows(1234, 10);
+
+    ASSERT_EQ(indexed.size(), 10u);
+    ASSERT_EQ(unindexed.size(), 10u);
+    EXPECT_DOUBLE_EQ(indexed[0].close, 1234.0);
+    EXPECT_DOUBLE_EQ(unindexed[9].close, 1243.0);
+    EXPECT_EQ(reader.read_rows(3995, 100).size(), 5u);
+}
+
+TEST_F(CSVIndexTest, ParallelReadMatchesSequential) {
+    create_csv(6000);
+    tsproc::CSVReader reader(csv_path);
+    tsproc::TimeSeries expected = reader.read_to_timeseries();
+
+    // Byte-balanced chunks without an index, row-balanced with one
+    for (bool with_index : {false, true}) {
+        if (with_index) {
+            tsproc::CSVIndex index;
+            ASSERT_TRUE(index.build(csv_path, 128));
+            ASSERT_TRUE(index.save(idx_path));
+        }
+        tsproc::TimeSeries ts = reader.read_parallel(4);
+        ASSERT_EQ(ts.size(), expected.size());
+        for (size_t i = 0; i < ts.size(); ++i) {
+            ASSERT_EQ(ts[i].date, expected[i].date);
+        }
+    }
+}
+
+TEST_F(CSVIndexTest, RangeReadUsesIndex) {
+    create_csv(20000);
+    tsproc::CSVIndex index;
+    ASSERT_TRUE(index.build(csv_path, 500));
+    ASSERT_TRUE(index.save(idx_path));
+
+    tsproc::CSVReader reader(csv_path);
+    tsproc::TimeSeries ts = reader.read_range(at(10250), at(10300));
+    ASSERT_EQ(ts.size(), 50u);
+    EXPECT_DOUBLE_EQ(ts[0].close, 10250.0);
+    EXPECT_EQ(reader.read_range(INT64_MIN, at(3)).size(), 3u);
+}
@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include "downsample.hpp"
+#include "indicators.hpp"
+#include "timeseries.hpp"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+class DownsampleTest : public ::testing::Test {
+protected:
+    tsproc::TimeSeries create_series(const std::vector<double>& close_prices) {
+        tsproc::TimeSeries ts;
+        for (size_t i = 0; i < close_prices.size(); ++i) {
+            tsproc::Record r;
+            r.date = "";
+            r.open = close_prices[i];
+            r.high = close_prices[i] + 1.0;
+            r.low = close_prices[i] - 1.0;
+            r.close = close_prices[i];
+            r.adj_close = close_prices[i];
+            r.volume = 1000.0;
+            ts.push(r);
+        }
+        return ts;
+    }
+
+    std::vector<double> wave(size_t n) {
+        std::vector<double> y(n);
+        for (size_t i = 0; i < n; ++i) {
+            y[i] = std::sin(static_cast<double>(i) * 0.01) * 100.0 + static_cast<double>(i % 13);
+        }
+        return y;
+    }
+};
+
+TEST_F(DownsampleTest, LTTB_KeepsEndpointsAndCount) {
+    std::vector<double> y = wave(1000);
+    std::vector<double> x(y.size());
+    for (size_t i = 0; i < x.size(); ++i) x[i] = static_cast<double>(i);
+
+    std::vector<size_t> idx = tsproc::downsample::lttb_indices(x, y, 50, 1);
+
+    ASSERT_EQ(idx.size(), 50u);
+    EXPECT_EQ(idx.front(), 0u);
+    EXPECT_EQ(idx.back(), 999u);
+    EXPECT_TRUE(std::is_sorted(idx.begin(), idx.end()));
+}
+
+TEST_F(DownsampleTest, LTTB_PicksSpike) {
+    // A single spike must survive downsampling
+    std::vector<double> y(100, 1.0);
+    y[42] = 50.0;
+    std::vector<double> x(y.size());
+    for (size_t i = 0; i < x.size(); ++i) x[i] = static_cast<double>(i);
+
+    std::vector<size_t> idx = tsproc::downsample::lttb_indices(x, y, 10, 1);
+    EXPECT_NE(std::find(idx.begin(), idx.end(), 42u), idx.end());
+}
+
+TEST_F(DownsampleTest, LTTB_ThresholdAboveSize) {
+    std::vector<double> y = {1, 2, 3};
+    std::vector<double> x = {0, 1, 2};
+    EXPECT_EQ(tsproc::downsample::lttb_indices(x, y, 10).size(), 3u);
+}
+
+TEST_F(DownsampleTest, LTTB_ParallelIndependentOfThreads) {
+    std::vector<double> y = wave(200000);
+    std::vector<double> x(y.size());
+    for (size_t i = 0; i < x.size(); ++i) x[i] = static_cast<double>(i);
+
+    std::vector<size_t> serial = tsproc::downsample::lttb_indices(x, y, 2000, 1);
+    ASSERT_EQ(serial.size(), 2000u);
+    EXPECT_TRUE(std::is_sorted(serial.begin(), serial.end()));
+    EXPECT_EQ(tsproc::downsample::lttb_indices(x, y, 2000, 4), serial);
+    EXPECT_EQ(tsproc::downsample::lttb_indices(x, y, 2000, 7), serial);
+    EXPECT_EQ(tsproc::downsample::lttb_indices(x, y, 2000), serial);
+}
+
+TEST_F(DownsampleTest, LTTB_SkipsAllNaNBucket) {
+    // Level at 100 with a NaN gap; the gap must not pull picks towards zero
+    std::vector<double> y(100, 100.0);
+    for (size_t i = 40; i < 59; ++i) y[i] = NAN;
+    y[30] = 101.0;
+    y[31] = 99.5;
+    std::vector<double> x(y.size());
+    for (size_t i = 0; i < x.size(); ++i) x[i] = static_cast<double>(i);
+
+    // Bucket 3 is rows [30, 40) and buckets 4 and 5 are all NaN: the pick
+    // in bucket 3 aims at the level past the gap, so the spike wins
+    std::vector<size_t> idx = tsproc::downsample::lttb_indices(x, y, 12, 1);
+    ASSERT_EQ(idx.size(), 12u);
+    EXPECT_EQ(idx[4], 30u);
+}
+
+TEST_F(DownsampleTest, MinMax_KeepsExtremes) {
+    std::vector<double> y = wave(10000);
+    y[1234] = 1e6;
+    y[8765] = -1e6;
+
+    std::vector<size_t> idx = tsproc::downsample::minmax_indices(y, 100, 1);
+
+    EXPECT_LE(idx.size(), 400u);
+    EXPECT_TRUE(std::is_sorted(idx.begin(), idx.end()));
+    EXPECT_EQ(std::adjacent_find(idx.begin(), idx.end()), idx.end());
+    EXPECT_NE(std::find(idx.begin(), idx.end(), 1234u), idx.end());
+    EXPECT_NE(std::find(idx.begin(), idx.end(), 8765u), idx.end());
+    EXPECT_EQ(idx.front(), 0u);
+    EXPECT_EQ(idx.back(), 9999u);
+}
+
+TEST_F(DownsampleTest, MinMax_ParallelMatchesSerial) {
+    std::vector<double> y = wave(300000);
+    EXPECT_EQ(tsproc::downsample::minmax_indices(y, 500, 1),
+              tsproc::downsample::minmax_indices(y, 500, 4));
+}
+
+TEST_F(DownsampleTest, TimeSeries_IndicatorColumn) {
+    tsproc::TimeSeries ts = create_series(wave(500));
+    tsproc::indicators::add_sma(ts, 5, "close");
+
+    tsproc::TimeSeries out = tsproc::downsample::minmax(ts, 20, "SMA_5");
+
+    ASSERT_GT(out.size(), 0u);
+    EXPECT_LE(out.size(), 80u);
+    EXPECT_NE(out[0].indicators.find("SMA_5"), out[0].indicators.end());
+
+    tsproc::TimeSeries lt = tsproc::downsample::lttb(ts, 30, "close");
+    EXPECT_EQ(lt.size(), 30u);
+}
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include "duplicates.hpp"
+#include "csv_reader.hpp"
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+tsproc::Record bar(const std::string& date, double open, double high, double low, double close,
+                   double volume) {
+    tsproc::Record r;
+    r.date = date;
+    r.open = open;
+    r.high = high;
+    r.low = low;
+    r.close = close;
+    r.adj_close = close;
+    r.volume = volume;
+    return r;
+}
+
+tsproc::TimeSeries resolve(const std::vector<tsproc::Record>& rows, tsproc::DuplicatePolicy policy,
+                           bool* sorted = nullptr) {
+    tsproc::TimeSeries out;
+    tsproc::DuplicateResolver resolver(out, policy);
+    for (const auto& r : rows) resolver.push(r);
+    if (sorted) *sorted = resolver.sorted();
+    return out;
+}
+
+} // namespace
+
+class DuplicatesTest : public ::testing::Test {
+protected:
+    std::vector<tsproc::Record> sorted_rows = {
+        bar("2020-01-01", 10, 12, 9, 11, 100),
+        bar("2020-01-02", 11, 13, 10, 12, 100),
+        bar("2020-01-02", 11, 15, 8, 14, 50),  // correction / second print
+        bar("2020-01-03", 14, 14, 13, 13, 100),
+    };
+};
+
+TEST_F(DuplicatesTest, SortedPolicies) {
+    bool sorted = false;
+    tsproc::TimeSeries first = resolve(sorted_rows, tsproc::DuplicatePolicy::KeepFirst, &sorted);
+    EXPECT_TRUE(sorted);
+    ASSERT_EQ(first.size(), 3u);
+    EXPECT_DOUBLE_EQ(first[1].close, 12.0);
+
+    tsproc::TimeSeries last = resolve(sorted_rows, tsproc::DuplicatePolicy::KeepLast);
+    ASSERT_EQ(last.size(), 3u);
+    EXPECT_DOUBLE_EQ(last[1].close, 14.0);
+    EXPECT_DOUBLE_EQ(last[1].volume, 50.0);
+
+    tsproc::TimeSeries agg = resolve(sorted_rows, tsproc::DuplicatePolicy::Aggregate);
+    ASSERT_EQ(agg.size(), 3u);
+    EXPECT_DOUBLE_EQ(agg[1].open, 11.0);
+    EXPECT_DOUBLE_EQ(agg[1].high, 15.0);
+    EXPECT_DOUBLE_EQ(agg[1].low, 8.0);
+    EXPECT_DOUBLE_EQ(agg[1].close, 14.0);
+    EXPECT_DOUBLE_EQ(agg[1].volume, 150.0);
+
+    EXPECT_EQ(resolve(sorted_rows, tsproc::DuplicatePolicy::KeepAll).size(), 4u);
+}
+
+TEST_F(DuplicatesTest, UnsortedSwitchesToHashPath) {
+    std::vector<tsproc::Record> rows = {
+        bar("2020-01-02", 1, 1, 1, 1, 1),
+        bar("2020-01-01", 2, 2, 2, 2, 1),
+        bar("2020-01-03", 3, 3, 3, 3, 1),
+        bar("2020-01-02", 4, 4, 4, 4, 1),   // duplicate of row 0, far back
+        bar("2020-01-01", 5, 5, 5, 5, 1),
+    };
+
+    tsproc::TimeSeries out;
+    tsproc::DuplicateResolver resolver(out, tsproc::DuplicatePolicy::KeepLast);
+    for (const auto& r : rows) resolver.push(r);
+    EXPECT_FALSE(resolver.sorted());
+    EXPECT_EQ(resolver.duplicates(), 2u);
+
+    // First-seen order is kept
+    ASSERT_EQ(out.size(), 3u);
+    EXPECT_EQ(out[0].date, "2020-01-02");
+    EXPECT_DOUBLE_EQ(out[0].close, 4.0);
+    EXPECT_DOUBLE_EQ(out[1].close, 5.0);
+}
+
+TEST_F(DuplicatesTest, ReaderResolvesOnTheFly) {
+    const std::string path = "test_duplicates.csv";
+    {
+        std::ofstream ofs(path);
+        ofs << "Date,Open,High,Low,Close,Adj Close,Volume\n";
+        for (const auto& r : sorted_rows) {
+            ofs << r.date << "," << r.open << "," << r.high << "," << r.low << "," << r.close
+                << "," << r.adj_close << "," << r.volume << "\n";
+        }
+    }
+
+    tsproc::CSVReader reader(path);
+    reader.set_duplicate_policy(tsproc::DuplicatePolicy::Aggregate);
+    tsproc::TimeSeries ts = reader.read_to_timeseries();
+    EXPECT_EQ(ts.size(), 3u);
+    EXPECT_EQ(reader.duplicates_resolved(), 1u);
+    EXPECT_DOUBLE_EQ(ts[1].volume, 150.0);
+
+    EXPECT_EQ(reader.read_parallel(2).size(), 3u);
+    fs::remove(path);
+}
+
+TEST(DuplicatePolicyTest, Parse) {
+    EXPECT_EQ(tsproc::parse_duplicate_policy("last"), tsproc::DuplicatePolicy::KeepLast);
+    EXPECT_EQ(tsproc::parse_duplicate_policy("aggregate"), tsproc::DuplicatePolicy::Aggregate);
+    EXPECT_THROW(tsproc::parse_duplicate_policy("median"), std::invalid_argument);
+}
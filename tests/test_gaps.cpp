@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include "gaps.hpp"
+#include "datetime.hpp"
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+constexpr int64_t kMinute = 60LL * 1000000000LL;
+constexpr int64_t kHour = 60 * kMinute;
+
+tsproc::Record bar(int64_t ns, double close) {
+    tsproc::Record r;
+    r.date = tsproc::format_datetime(ns);
+    r.open = r.high = r.low = r.close = r.adj_close = close;
+    r.volume = 100.0;
+    return r;
+}
+
+} // namespace
+
+class GapsTest : public ::testing::Test {
+protected:
+    int64_t origin = tsproc::to_timestamp("2021-03-01");  // a Monday
+
+    // Minute bars at the given minute offsets, close = offset
+    tsproc::TimeSeries minutes(std::initializer_list<int> offsets) {
+        tsproc::TimeSeries ts;
+        for (int m : offsets) ts.push(bar(origin + m * kMinute, m));
+        return ts;
+    }
+
+    tsproc::gaps::Calendar every(int64_t freq) {
+        tsproc::gaps::Calendar calendar;
+        calendar.frequency_ns = freq;
+        return calendar;
+    }
+};
+
+TEST_F(GapsTest, DetectsMissingBars) {
+    tsproc::TimeSeries ts = minutes({0, 1, 2, 5, 6, 10});
+    std::vector<tsproc::gaps::Gap> gaps = tsproc::gaps::detect(ts, every(kMinute));
+
+    ASSERT_EQ(gaps.size(), 2u);
+    EXPECT_EQ(gaps[0].row, 3u);
+    EXPECT_EQ(gaps[0].missing, 2u);
+    EXPECT_EQ(gaps[0].start_ns, origin + 3 * kMinute);
+    EXPECT_EQ(gaps[1].missing, 3u);
+    EXPECT_EQ(tsproc::gaps::total_missing(gaps), 5u);
+}
+
+TEST_F(GapsTest, InvalidAndDuplicateRowsIgnored) {
+    tsproc::TimeSeries ts = minutes({0, 1, 1, 2});
+    tsproc::Record junk;
+    junk.date = "not a date";
+    ts.push(junk);
+    ts.push(bar(origin + 4 * kMinute, 4));
+
+    std::vector<tsproc::gaps::Gap> gaps = tsproc::gaps::detect(ts, every(kMinute));
+    ASSERT_EQ(gaps.size(), 1u);
+    EXPECT_EQ(gaps[0].prev_row, 3u);
+    EXPECT_EQ(gaps[0].row, 5u);
+    EXPECT_EQ(gaps[0].missing, 1u);
+}
+
+TEST_F(GapsTest, WeekdaySessionCalendar) {
+    tsproc::gaps::Calendar calendar = every(kHour);
+    calendar.weekdays_only = true;
+    calendar.session_open_ns = 9 * kHour;
+    calendar.session_close_ns = 17 * kHour;  // slots 09:00 .. 16:00
+    calendar.holidays.push_back(tsproc::to_timestamp("2021-03-08"));
+
+    int64_t fri_last = tsproc::to_timestamp("2021-03-05 16:00:00");
+    int64_t tue_first = tsproc::to_timestamp("2021-03-09 09:00:00");
+    int64_t tue_noon = tsproc::to_timestamp("2021-03-09 12:00:00");
+
+    tsproc::TimeSeries ts;
+    ts.push(bar(fri_last, 1));
+    ts.push(bar(tue_first, 2));  // weekend and Monday holiday: no gap
+    ts.push(bar(tue_noon, 3));   // 10:00 and 11:00 missing
+
+    std::vector<tsproc::gaps::Gap> gaps = tsproc::gaps::detect(ts, calendar);
+    ASSERT_EQ(gaps.size(), 1u);
+    EXPECT_EQ(gaps[0].missing, 2u);
+
+    // Across a full missing day: rest of Tuesday, all of Wednesday, Thursday morning
+    ts.push(bar(tsproc::to_timestamp("2021-03-11 10:00:00"), 4));
+    gaps = tsproc::gaps::detect(ts, calendar);
+    ASSERT_EQ(gaps.size(), 2u);
+    EXPECT_EQ(gaps[1].missing, 4u + 8u + 1u);
+}
+
+TEST_F(GapsTest, FillMethods) {
+    tsproc::TimeSeries ts = minutes({0, 4});
+    tsproc::gaps::Calendar calendar = every(kMinute);
+    std::vector<tsproc::gaps::Gap> gaps = tsproc::gaps::detect(ts, calendar);
+
+    tsproc::TimeSeries ffill = tsproc::gaps::fill(ts, gaps, calendar, tsproc::gaps::FillMethod::ForwardFill);
+    ASSERT_EQ(ffill.size(), 5u);
+    EXPECT_EQ(ffill[1].date, tsproc::format_datetime(origin + kMinute));
+    EXPECT_DOUBLE_EQ(ffill[3].close, 0.0);
+    EXPECT_DOUBLE_EQ(ffill[3].volume, 0.0);
+    EXPECT_DOUBLE_EQ(ffill[4].close, 4.0);
+
+    tsproc::TimeSeries linear = tsproc::gaps::fill(ts, gaps, calendar, tsproc::gaps::FillMethod::Linear);
+    EXPECT_DOUBLE_EQ(linear[1].close, 1.0);
+    EXPECT_DOUBLE_EQ(linear[3].close, 3.0);
+
+    tsproc::TimeSeries nan = tsproc::gaps::fill(ts, gaps, calendar, tsproc::gaps::FillMethod::NaN);
+    EXPECT_TRUE(std::isnan(nan[2].close));
+
+    // Filling closes every gap
+    EXPECT_TRUE(tsproc::gaps::detect(ffill, calendar).empty());
+}
+
+TEST_F(GapsTest, InferFrequencyAndValidation) {
+    std::vector<int64_t> stamps = tsproc::gaps::timestamps(minutes({0, 5, 10, 15, 30, 35}));
+    EXPECT_EQ(tsproc::gaps::infer_frequency(stamps), 5 * kMinute);
+
+    EXPECT_THROW(tsproc::gaps::detect(stamps, every(0)), std::invalid_argument);
+    EXPECT_THROW(tsproc::gaps::parse_fill_method("zero"), std::invalid_argument);
+}
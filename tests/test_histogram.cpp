@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include "histogram.hpp"
+#include "streaming.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using tsproc::LatencyHistogram;
+
+namespace {
+
+// Nearest-rank percentile on the raw values, the definition the histogram approximates
+double exact_percentile(std::vector<int64_t> values, double q) {
+    std::sort(values.begin(), values.end());
+    size_t rank = static_cast<size_t>(std::ceil(q * static_cast<double>(values.size())));
+    return static_cast<double>(values[std::max<size_t>(rank, 1) - 1]);
+}
+
+} // namespace
+
+TEST(HistogramTest, BucketsCoverTheRangeInOrder) {
+    EXPECT_EQ(LatencyHistogram::bucket_index(0), 0u);
+    EXPECT_EQ(LatencyHistogram::bucket_index(255), 255u);
+    EXPECT_EQ(LatencyHistogram::bucket_index(256), 256u);
+    EXPECT_EQ(LatencyHistogram::bucket_index(UINT64_MAX), LatencyHistogram::kBucketCount - 1);
+    EXPECT_EQ(LatencyHistogram::bucket_upper(LatencyHistogram::kBucketCount - 1), UINT64_MAX);
+
+    // Each bucket's upper bound maps back to it, and the next value starts the next bucket
+    for (size_t i = 0; i + 1 < LatencyHistogram::kBucketCount; ++i) {
+        uint64_t upper = LatencyHistogram::bucket_upper(i);
+        ASSERT_EQ(LatencyHistogram::bucket_index(upper), i);
+        ASSERT_EQ(LatencyHistogram::bucket_index(upper + 1), i + 1);
+    }
+}
+
+TEST(HistogramTest, SmallValuesAreExact) {
+    auto h = std::make_unique<LatencyHistogram>();
+    for (int64_t v = 1; v <= 100; ++v) h->record(v);
+
+    tsproc::LatencyStats s = h->stats();
+    EXPECT_EQ(s.count, 100u);
+    EXPECT_DOUBLE_EQ(s.min_ns, 1.0);
+    EXPECT_DOUBLE_EQ(s.max_ns, 100.0);
+    EXPECT_DOUBLE_EQ(s.mean_ns, 50.5);
+    EXPECT_DOUBLE_EQ(s.p50_ns, 50.0);
+    EXPECT_DOUBLE_EQ(s.p90_ns, 90.0);
+    EXPECT_DOUBLE_EQ(s.p99_ns, 99.0);
+    EXPECT_DOUBLE_EQ(s.p999_ns, 100.0);
+}
+
+TEST(HistogramTest, PercentilesWithinRelativeError) {
+    auto h = std::make_unique<LatencyHistogram>();
+    std::mt19937_64 rng(42);
+    std::lognormal_distribution<double> dist(8.0, 1.5);  // ~3us median, long tail
+    std::vector<int64_t> values(200000);
+    for (auto& v : values) {
+        v = static_cast<int64_t>(dist(rng));
+        h->record(v);
+    }
+
+    for (double q : {0.5, 0.9, 0.99, 0.999, 0.9999}) {
+        double exact = exact_percentile(values, q);
+        double approx = h->percentile(q);
+        EXPECT_GE(approx, exact) << "q=" << q;
+        EXPECT_LE(approx, exact * (1.0 + 1.0 / 128.0)) << "q=" << q;
+    }
+    EXPECT_DOUBLE_EQ(h->percentile(1.0), static_cast<double>(*std::max_element(values.begin(), values.end())));
+}
+
+TEST(HistogramTest, ConcurrentRecordingKeepsEveryEvent) {
+    auto h = std::make_unique<LatencyHistogram>();
+    const int kThreads = 4;
+    const int kPerThread = 50000;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&h, t] {
+            for (int i = 0; i < kPerThread; ++i) h->record(1000 * (t + 1) + i % 7);
+        });
+    }
+    for (auto& t : threads) t.join();
+
+    tsproc::LatencyStats s = h->stats();
+    EXPECT_EQ(s.count, static_cast<size_t>(kThreads * kPerThread));
+    EXPECT_DOUBLE_EQ(s.min_ns, 1000.0);
+    EXPECT_DOUBLE_EQ(s.max_ns, 4006.0);
+}
+
+TEST(HistogramTest, MergeAndReset) {
+    auto a = std::make_unique<LatencyHistogram>();
+    auto b = std::make_unique<LatencyHistogram>();
+    a->record(10);
+    b->record(5);
+    b->record(-3);  // clock skew clamps to zero
+    a->merge(*b);
+
+    tsproc::LatencyStats s = a->stats();
+    EXPECT_EQ(s.count, 3u);
+    EXPECT_DOUBLE_EQ(s.min_ns, 0.0);
+    EXPECT_DOUBLE_EQ(s.max_ns, 10.0);
+
+    a->reset();
+    EXPECT_EQ(a->count(), 0u);
+    EXPECT_DOUBLE_EQ(a->percentile(0.99), 0.0);
+    EXPECT_EQ(a->stats().count, 0u);
+}
+
+TEST(HistogramTest, StreamPipelineStageLatency) {
+    tsproc::streaming::StreamConfig config;
+    config.sma_windows = {5};
+    config.zscore_window = 10;
+    tsproc::streaming::StreamPipeline pipeline(config);
+    EXPECT_TRUE(pipeline.stage_latency().empty());
+
+    pipeline.enable_stage_latency();
+    tsproc::Record r;
+    for (int i = 0; i < 100; ++i) {
+        r.close = 100.0 + i;
+        pipeline.update(r);
+    }
+
+    auto stages = pipeline.stage_latency();
+    ASSERT_EQ(stages.size(), 2u);  // crossover is not configured
+    EXPECT_EQ(stages[0].first, "sma");
+    EXPECT_EQ(stages[1].first, "zscore");
+    for (const auto& stage : stages) EXPECT_EQ(stage.second.count, 100u);
+}
+
+TEST(HistogramTest, JsonExport) {
+    tsproc::LatencyStats s;
+    s.count = 3;
+    s.p99_ns = 120;
+    std::ostringstream os;
+    tsproc::write_latency_json(os, {{"ingest_to_signal", s}, {"sma", tsproc::LatencyStats()}});
+
+    std::string json = os.str();
+    EXPECT_NE(json.find("\"ingest_to_signal\": {\"count\": 3"), std::string::npos);
+    EXPECT_NE(json.find("\"p99_ns\": 120"), std::string::npos);
+    EXPECT_NE(json.find("\"sma\": {\"count\": 0"), std::string::npos);
+    EXPECT_EQ(json.front(), '{');
+}
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include "indicators.hpp"
 #include "timeseries.hpp"
+#include <algorithm>
 #include <cmath>
 #include <vector>
 
@@ -151,3 +152,91 @@ TEST_F(IndicatorsTest, MultipleIndicators) {
     EXPECT_TRUE(ts[5].indicators.find("SMA_5") != ts[5].indicators.end());
     EXPECT_TRUE(ts[5].indicators.find("ZSCORE_3") != ts[5].indicators.end());
 }
+
+TEST_F(IndicatorsTest, RangeVolatility_KnownBars) {
+    // Identical bars: no close-to-open or overnight variation, so Yang-Zhang
+    // reduces to the Rogers-Satchell part
+    tsproc::TimeSeries ts;
+    for (int i = 0; i < 6; ++i) {
+        tsproc::Record r;
+        r.date = "2020-01-0" + std::to_string(i + 1);
+        r.open = 100.0;
+        r.high = 102.0;
+        r.low = 98.0;
+        r.close = 100.0;
+        r.adj_close = r.close;
+        r.volume = 1000.0;
+        ts.push(r);
+    }
+    tsproc::indicators::add_range_volatility(ts, 3, 1.0);
+
+    const double hl = std::log(102.0 / 98.0);
+    const double u = std::log(1.02);
+    const double d = std::log(0.98);
+    EXPECT_TRUE(std::isnan(ts[1].indicators["VOL_PARK_3"]));
+    EXPECT_NEAR(ts[2].indicators["VOL_PARK_3"], hl / std::sqrt(4.0 * std::log(2.0)), 1e-12);
+    EXPECT_NEAR(ts[2].indicators["VOL_GK_3"], std::sqrt(0.5) * hl, 1e-12);
+    EXPECT_NEAR(ts[2].indicators["VOL_RS_3"], std::sqrt(u * u + d * d), 1e-12);
+    EXPECT_TRUE(std::isnan(ts[2].indicators["VOL_YZ_3"]));
+    const double k = 0.34 / (1.34 + 4.0 / 2.0);
+    EXPECT_NEAR(ts[5].indicators["VOL_YZ_3"], std::sqrt((1.0 - k) * (u * u + d * d)), 1e-12);
+}
+
+TEST_F(IndicatorsTest, RangeVolatility_RecoversSimulatedSigma) {
+    // Bars built from a driftless random walk of 100 steps each
+    const double sigma = 0.01;
+    const int steps = 100;
+    uint64_t state = 12345;
+    auto normal = [&state]() {
+        double u[2];
+        for (double& x : u) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            x = (static_cast<double>(state >> 11) + 0.5) / 9007199254740992.0;
+        }
+        return std::sqrt(-2.0 * std::log(u[0])) * std::cos(6.283185307179586 * u[1]);
+    };
+
+    tsproc::TimeSeries ts;
+    double log_price = std::log(100.0);
+    for (int bar = 0; bar < 4000; ++bar) {
+        tsproc::Record r;
+        r.date = std::to_string(bar);
+        r.open = std::exp(log_price);
+        double hi = log_price, lo = log_price;
+        for (int s = 0; s < steps; ++s) {
+            log_price += sigma / std::sqrt(static_cast<double>(steps)) * normal();
+            hi = std::max(hi, log_price);
+            lo = std::min(lo, log_price);
+        }
+        r.high = std::exp(hi);
+        r.low = std::exp(lo);
+        r.close = r.adj_close = std::exp(log_price);
+        r.volume = 1.0;
+        ts.push(r);
+    }
+    tsproc::indicators::add_range_volatility(ts, 4000, 1.0);
+
+    // A discretely sampled path understates the true range a little
+    const auto& last = ts[ts.size() - 1].indicators;
+    for (const char* name : {"VOL_PARK_4000", "VOL_GK_4000", "VOL_RS_4000"}) {
+        EXPECT_NEAR(last.at(name), sigma, 0.1 * sigma) << name;
+    }
+    EXPECT_TRUE(std::isnan(last.at("VOL_YZ_4000")));  // needs window + 1 bars
+}
+
+TEST_F(IndicatorsTest, RollingMoments_FusedWithMeanStd) {
+    std::vector<double> prices = {1, 2, 3, 4, 10, 6, 7, 8, 9, 10};
+    tsproc::TimeSeries ts = create_simple_series(prices);
+    tsproc::indicators::add_roll_moments(ts, 5, "close");
+
+    EXPECT_TRUE(std::isnan(ts[3].indicators["ROLL_SKEW_5"]));
+    // Window {1, 2, 3, 4, 10}: mean 4, deviations -3 -2 -1 0 6
+    EXPECT_DOUBLE_EQ(ts[4].indicators["ROLL_MEAN_5"], 4.0);
+    EXPECT_NEAR(ts[4].indicators["ROLL_STD_5"], std::sqrt(10.0), 1e-12);
+    EXPECT_NEAR(ts[4].indicators["ROLL_SKEW_5"], 36.0 / std::pow(10.0, 1.5), 1e-12);
+    EXPECT_NEAR(ts[4].indicators["ROLL_KURT_5"], 278.8 / 100.0 - 3.0, 1e-12);
+
+    // Symmetric window {6, 7, 8, 9, 10}
+    EXPECT_NEAR(ts[9].indicators["ROLL_SKEW_5"], 0.0, 1e-12);
+    EXPECT_NEAR(ts[9].indicators["ROLL_KURT_5"], 6.8 / 4.0 - 3.0, 1e-12);
+}
@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+#include "kernels.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using tsproc::kernels::Isa;
+
+namespace {
+
+std::vector<double> prices(size_t n) {
+    std::vector<double> v(n);
+    for (size_t i = 0; i < n; ++i) {
+        v[i] = 100.0 + 5.0 * std::sin(static_cast<double>(i) * 0.013) + 0.001 * static_cast<double>(i % 17);
+    }
+    return v;
+}
+
+bool same_bits(const std::vector<double>& a, const std::vector<double>& b) {
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(double)) == 0;
+}
+
+struct Outputs {
+    std::vector<double> sum, mean, roll_mean, roll_sd, ema;
+    std::vector<double> park, gk, rs, yz;
+    std::vector<double> mom_mean, mom_sd, skew, kurt;
+};
+
+Outputs run_all(const std::vector<double>& in, size_t window) {
+    const size_t n = in.size();
+    Outputs o{std::vector<double>(n), std::vector<double>(n), std::vector<double>(n),
+              std::vector<double>(n), std::vector<double>(n), std::vector<double>(n),
+              std::vector<double>(n), std::vector<double>(n), std::vector<double>(n),
+              std::vector<double>(n), std::vector<double>(n), std::vector<double>(n),
+              std::vector<double>(n)};
+    tsproc::kernels::rolling_sum(in.data(), n, window, o.sum.data());
+    tsproc::kernels::rolling_mean(in.data(), n, window, o.mean.data());
+    tsproc::kernels::rolling_mean_std(in.data(), n, window, o.roll_mean.data(), o.roll_sd.data());
+    tsproc::kernels::ema(in.data(), n, window, o.ema.data());
+    tsproc::kernels::rolling_moments(in.data(), n, window, o.mom_mean.data(), o.mom_sd.data(),
+                                     o.skew.data(), o.kurt.data());
+
+    // OHLC around the series: open is the previous value, high/low bracket both
+    std::vector<double> open(n), high(n), low(n);
+    for (size_t i = 0; i < n; ++i) {
+        open[i] = i > 0 ? in[i - 1] : in[i];
+        high[i] = std::max(open[i], in[i]) + 0.1 + 0.01 * static_cast<double>(i % 5);
+        low[i] = std::min(open[i], in[i]) - 0.1;
+    }
+    tsproc::kernels::range_volatility(open.data(), high.data(), low.data(), in.data(), n, window,
+                                      o.park.data(), o.gk.data(), o.rs.data(), o.yz.data());
+    return o;
+}
+
+// Restores the startup variant so other tests are unaffected
+class KernelsTest : public ::testing::Test {
+protected:
+    void SetUp() override { saved_ = tsproc::kernels::active_isa(); }
+    void TearDown() override { tsproc::kernels::set_isa(saved_); }
+    Isa saved_ = Isa::Generic;
+};
+
+} // namespace
+
+TEST_F(KernelsTest, KnownVectors) {
+    std::vector<double> in = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    Outputs o = run_all(in, 3);
+
+    EXPECT_TRUE(std::isnan(o.mean[0]));
+    EXPECT_TRUE(std::isnan(o.mean[1]));
+    for (size_t i = 2; i < in.size(); ++i) {
+        EXPECT_DOUBLE_EQ(o.sum[i], 3.0 * static_cast<double>(i));
+        EXPECT_DOUBLE_EQ(o.mean[i], static_cast<double>(i));
+        EXPECT_DOUBLE_EQ(o.roll_mean[i], static_cast<double>(i));
+        EXPECT_NEAR(o.roll_sd[i], std::sqrt(2.0 / 3.0), 1e-9);
+    }
+    EXPECT_DOUBLE_EQ(o.ema[0], 1.0);
+    EXPECT_DOUBLE_EQ(o.ema[1], 0.5 * 2.0 + 0.5 * 1.0);
+}
+
+TEST_F(KernelsTest, RollingMomentsMatchDirectComputation) {
+    // Prices that drift far from the first value, where raw power sums lose
+    // every digit of the third and fourth moments
+    std::vector<double> in(5000);
+    for (size_t i = 0; i < in.size(); ++i) {
+        in[i] = 100.0 + 0.2 * static_cast<double>(i) +
+                std::sin(static_cast<double>(i) * 0.7) * (1.0 + 0.5 * std::sin(static_cast<double>(i) * 0.031));
+    }
+    const size_t window = 30;
+    Outputs o = run_all(in, window);
+
+    EXPECT_TRUE(std::isnan(o.skew[window - 2]));
+    EXPECT_TRUE(same_bits(o.mom_mean, o.roll_mean));
+    EXPECT_TRUE(same_bits(o.mom_sd, o.roll_sd));
+    for (size_t i = window - 1; i < in.size(); i += 7) {
+        double m = 0.0;
+        for (size_t j = i + 1 - window; j <= i; ++j) m += in[j];
+        m /= static_cast<double>(window);
+        double m2 = 0.0, m3 = 0.0, m4 = 0.0;
+        for (size_t j = i + 1 - window; j <= i; ++j) {
+            const double d = in[j] - m;
+            m2 += d * d;
+            m3 += d * d * d;
+            m4 += d * d * d * d;
+        }
+        m2 /= static_cast<double>(window);
+        m3 /= static_cast<double>(window);
+        m4 /= static_cast<double>(window);
+        ASSERT_NEAR(o.skew[i], m3 / std::pow(m2, 1.5), 1e-6) << i;
+        ASSERT_NEAR(o.kurt[i], m4 / (m2 * m2) - 3.0, 1e-6) << i;
+    }
+
+    // A flat window has no skew or kurtosis
+    std::vector<double> flat(50, 42.0);
+    Outputs f = run_all(flat, 10);
+    EXPECT_TRUE(std::isnan(f.skew[20]));
+    EXPECT_TRUE(std::isnan(f.kurt[20]));
+    EXPECT_EQ(f.mom_sd[20], 0.0);
+}
+
+TEST_F(KernelsTest, GenericAlwaysSupported) {
+    std::vector<Isa> isas = tsproc::kernels::supported_isas();
+    ASSERT_FALSE(isas.empty());
+    EXPECT_EQ(isas.front(), Isa::Generic);
+
+    // The startup choice is one of the supported variants
+    Isa active = tsproc::kernels::active_isa();
+    bool found = false;
+    for (Isa isa : isas) found = found || isa == active;
+    EXPECT_TRUE(found) << tsproc::kernels::isa_name(active);
+}
+
+TEST_F(KernelsTest, EveryVariantMatchesGenericBitForBit) {
+    std::vector<double> in = prices(10000);
+
+    ASSERT_TRUE(tsproc::kernels::set_isa(Isa::Generic));
+    Outputs expected = run_all(in, 20);
+
+    for (Isa isa : tsproc::kernels::supported_isas()) {
+        ASSERT_TRUE(tsproc::kernels::set_isa(isa));
+        EXPECT_EQ(tsproc::kernels::active_isa(), isa);
+        Outputs got = run_all(in, 20);
+        const char* name = tsproc::kernels::isa_name(isa);
+        EXPECT_TRUE(same_bits(got.sum, expected.sum)) << name;
+        EXPECT_TRUE(same_bits(got.mean, expected.mean)) << name;
+        EXPECT_TRUE(same_bits(got.roll_mean, expected.roll_mean)) << name;
+        EXPECT_TRUE(same_bits(got.roll_sd, expected.roll_sd)) << name;
+        EXPECT_TRUE(same_bits(got.ema, expected.ema)) << name;
+        EXPECT_TRUE(same_bits(got.park, expected.park)) << name;
+        EXPECT_TRUE(same_bits(got.gk, expected.gk)) << name;
+        EXPECT_TRUE(same_bits(got.rs, expected.rs)) << name;
+        EXPECT_TRUE(same_bits(got.yz, expected.yz)) << name;
+        EXPECT_TRUE(same_bits(got.skew, expected.skew)) << name;
+        EXPECT_TRUE(same_bits(got.kurt, expected.kurt)) << name;
+    }
+}
+
+TEST_F(KernelsTest, IsaNames) {
+    Isa isa = Isa::Generic;
+    EXPECT_TRUE(tsproc::kernels::parse_isa("avx2", isa));
+    EXPECT_EQ(isa, Isa::AVX2);
+    EXPECT_TRUE(tsproc::kernels::parse_isa("sse42", isa));
+    EXPECT_EQ(isa, Isa::SSE42);
+    EXPECT_TRUE(tsproc::kernels::parse_isa("avx512", isa));
+    EXPECT_EQ(isa, Isa::AVX512);
+    EXPECT_FALSE(tsproc::kernels::parse_isa("neon", isa));
+    EXPECT_STREQ(tsproc::kernels::isa_name(Isa::SSE42), "sse4.2");
+}
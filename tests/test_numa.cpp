@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include "numa.hpp"
+#include "column_buffer.hpp"
+#include "scheduler.hpp"
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using tsproc::ColumnBuffer;
+using tsproc::exec::Scheduler;
+using tsproc::exec::SchedulerOptions;
+using tsproc::exec::TaskGroup;
+using tsproc::numa::Topology;
+
+namespace {
+
+// Two nodes of two CPUs each; binding to CPUs the machine lacks just fails
+Topology two_nodes() {
+    return Topology({{0, 1}, {2, 3}});
+}
+
+SchedulerOptions on_topology(const Topology& topology, size_t threads) {
+    SchedulerOptions options;
+    options.threads = threads;
+    options.topology = &topology;
+    return options;
+}
+
+} // namespace
+
+TEST(NumaTest, ParseCpulist) {
+    EXPECT_EQ(tsproc::numa::parse_cpulist("0"), std::vector<int>({0}));
+    EXPECT_EQ(tsproc::numa::parse_cpulist("0-3,8,10-11\n"), std::vector<int>({0, 1, 2, 3, 8, 10, 11}));
+    EXPECT_EQ(tsproc::numa::parse_cpulist("4,2-3,2"), std::vector<int>({2, 3, 4}));
+    EXPECT_TRUE(tsproc::numa::parse_cpulist("").empty());
+
+    EXPECT_THROW(tsproc::numa::parse_cpulist("3-1"), std::invalid_argument);
+    EXPECT_THROW(tsproc::numa::parse_cpulist("a-b"), std::invalid_argument);
+    EXPECT_THROW(tsproc::numa::parse_cpulist("1-"), std::invalid_argument);
+}
+
+TEST(NumaTest, TopologyFromLists) {
+    Topology topology({{0, 1}, {}, {4, 5, 6}});
+    EXPECT_EQ(topology.node_count(), 2u);  // empty node dropped
+    EXPECT_EQ(topology.cpu_count(), 5u);
+    EXPECT_EQ(topology.node_of_cpu(1), 0);
+    EXPECT_EQ(topology.node_of_cpu(5), 1);
+    EXPECT_EQ(topology.node_of_cpu(3), -1);
+    EXPECT_EQ(topology.node_of_cpu(99), -1);
+
+    EXPECT_THROW(Topology({{}, {}}), std::invalid_argument);
+    EXPECT_THROW(Topology(std::vector<std::vector<int>>{{-1}}), std::invalid_argument);
+}
+
+TEST(NumaTest, SystemTopologyCoversAllowedCpus) {
+    const Topology& topology = Topology::system();
+    ASSERT_GE(topology.node_count(), 1u);
+    EXPECT_GE(topology.cpu_count(), 1u);
+    EXPECT_LT(topology.current_node(), topology.node_count());
+}
+
+TEST(NumaTest, NodeForSplitsEvenly) {
+    EXPECT_EQ(tsproc::numa::node_for(5, 10, 1), 0u);
+    EXPECT_EQ(tsproc::numa::node_for(0, 10, 2), 0u);
+    EXPECT_EQ(tsproc::numa::node_for(4, 10, 2), 0u);
+    EXPECT_EQ(tsproc::numa::node_for(5, 10, 2), 1u);
+    EXPECT_EQ(tsproc::numa::node_for(9, 10, 2), 1u);
+    EXPECT_EQ(tsproc::numa::node_for(10, 11, 4), 3u);
+    EXPECT_EQ(tsproc::numa::node_for(0, 0, 4), 0u);
+}
+
+TEST(NumaTest, WorkersSpreadOverNodes) {
+    Topology topology = two_nodes();
+    Scheduler scheduler(on_topology(topology, 4));
+    ASSERT_EQ(scheduler.node_count(), 2u);
+    // Workers take CPUs 1, 2, 3 after the caller's CPU 0
+    EXPECT_EQ(scheduler.worker_node(0), 0u);
+    EXPECT_EQ(scheduler.worker_node(1), 1u);
+    EXPECT_EQ(scheduler.worker_node(2), 1u);
+
+    SchedulerOptions flat = on_topology(topology, 4);
+    flat.numa_aware = false;
+    Scheduler unaware(flat);
+    EXPECT_EQ(unaware.node_count(), 1u);
+}
+
+TEST(NumaTest, NodeTasksAllRun) {
+    Topology topology = two_nodes();
+    Scheduler scheduler(on_topology(topology, 4));
+
+    // Idle workers may take another node's tasks, so only completion and
+    // the reported node are checked, not placement
+    std::atomic<int> ran{0};
+    std::atomic<int> bad_node{0};
+    TaskGroup group(scheduler);
+    for (int i = 0; i < 64; ++i) {
+        group.spawn([&] {
+            if (scheduler.current_node() >= scheduler.node_count()) bad_node.fetch_add(1);
+            ran.fetch_add(1);
+        }, i % 3 - 1);  // nodes -1 (none), 0 and 1
+    }
+    group.wait();
+    EXPECT_EQ(ran.load(), 64);
+    EXPECT_EQ(bad_node.load(), 0);
+}
+
+TEST(NumaTest, ParallelForCoversRangeOnTwoNodes) {
+    Topology topology = two_nodes();
+    Scheduler scheduler(on_topology(topology, 3));
+
+    std::vector<std::atomic<int>> hits(20011);
+    tsproc::exec::parallel_for(0, hits.size(), 100, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) hits[i].fetch_add(1);
+    }, scheduler);
+    for (size_t i = 0; i < hits.size(); ++i) ASSERT_EQ(hits[i].load(), 1) << i;
+}
+
+TEST(NumaTest, ColumnBufferIsZeroedAndAligned) {
+    Topology topology = two_nodes();
+    Scheduler scheduler(on_topology(topology, 3));
+
+    ColumnBuffer column(100003, ColumnBuffer::FirstTouch::Parallel, scheduler);
+    ASSERT_EQ(column.size(), 100003u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(column.data()) % ColumnBuffer::kAlignment, 0u);
+    for (double v : column) ASSERT_EQ(v, 0.0);
+
+    ColumnBuffer local(100003);   // first touched on this thread
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(local.data()) % ColumnBuffer::kAlignment, 0u);
+    for (double v : local) ASSERT_EQ(v, 0.0);
+
+    column[42] = 1.5;
+    ColumnBuffer moved = std::move(column);
+    EXPECT_EQ(moved[42], 1.5);
+    EXPECT_TRUE(column.empty());
+
+    ColumnBuffer none(0, ColumnBuffer::FirstTouch::Parallel, scheduler);
+    EXPECT_TRUE(none.empty());
+    EXPECT_EQ(none.begin(), none.end());
+}
@@ -0,0 +1,209 @@
+#include <gtest/gtest.h>
+#include "order_book.hpp"
+#include "indicators.hpp"
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <random>
+#include <string>
+
+namespace fs = std::filesystem;
+using tsproc::book::EventType;
+using tsproc::book::OrderBook;
+using tsproc::book::OrderEvent;
+using tsproc::book::Side;
+
+namespace {
+
+OrderEvent event(int64_t ts, EventType type, Side side, double price, double size, uint64_t id = 0) {
+    OrderEvent e;
+    e.ts = ts;
+    e.type = type;
+    e.side = side;
+    e.price = price;
+    e.size = size;
+    e.order_id = id;
+    return e;
+}
+
+} // namespace
+
+TEST(OrderBookTest, ParsesEventTypes) {
+    EventType type;
+    ASSERT_TRUE(tsproc::book::parse_event_type("A", type));
+    EXPECT_EQ(type, EventType::Add);
+    ASSERT_TRUE(tsproc::book::parse_event_type("replace", type));
+    EXPECT_EQ(type, EventType::Modify);
+    ASSERT_TRUE(tsproc::book::parse_event_type("DELETE", type));
+    EXPECT_EQ(type, EventType::Cancel);
+    ASSERT_TRUE(tsproc::book::parse_event_type("fill", type));
+    EXPECT_EQ(type, EventType::Execute);
+    ASSERT_TRUE(tsproc::book::parse_event_type("R", type));
+    EXPECT_EQ(type, EventType::Clear);
+    EXPECT_FALSE(tsproc::book::parse_event_type("bogus", type));
+}
+
+TEST(OrderBookTest, OrderLifecycle) {
+    OrderBook book(0.01);
+    EXPECT_TRUE(std::isnan(book.best_bid()));
+
+    ASSERT_TRUE(book.apply(event(1, EventType::Add, Side::Buy, 100.00, 300, 1)));
+    ASSERT_TRUE(book.apply(event(1, EventType::Add, Side::Buy, 100.00, 200, 2)));
+    ASSERT_TRUE(book.apply(event(1, EventType::Add, Side::Buy, 99.98, 400, 3)));
+    ASSERT_TRUE(book.apply(event(1, EventType::Add, Side::Sell, 100.02, 100, 4)));
+    EXPECT_FALSE(book.apply(event(1, EventType::Add, Side::Sell, 100.03, 100, 4)));  // duplicate id
+
+    EXPECT_DOUBLE_EQ(book.best_bid(), 100.00);
+    EXPECT_DOUBLE_EQ(book.best_ask(), 100.02);
+    EXPECT_EQ(book.best_size(Side::Buy), 500.0);
+    EXPECT_EQ(book.best_orders(Side::Buy), 2u);
+    EXPECT_EQ(book.depth(Side::Buy, 5), 900.0);
+    EXPECT_EQ(book.order_count(), 4u);
+
+    // Partial fill, then the rest of the touch leaves
+    ASSERT_TRUE(book.apply(event(2, EventType::Execute, Side::Buy, 0, 100, 1)));
+    EXPECT_EQ(book.best_size(Side::Buy), 400.0);
+    EXPECT_EQ(book.traded_volume(), 100.0);
+    ASSERT_TRUE(book.apply(event(2, EventType::Cancel, Side::Buy, 0, 0, 1)));
+    ASSERT_TRUE(book.apply(event(2, EventType::Execute, Side::Buy, 0, 200, 2)));
+    EXPECT_DOUBLE_EQ(book.best_bid(), 99.98);
+    EXPECT_EQ(book.best_orders(Side::Buy), 1u);
+    EXPECT_EQ(book.order_count(), 2u);
+
+    // Modify moves an order to a new price
+    ASSERT_TRUE(book.apply(event(3, EventType::Modify, Side::Buy, 100.01, 50, 3)));
+    EXPECT_DOUBLE_EQ(book.best_bid(), 100.01);
+    EXPECT_EQ(book.best_size(Side::Buy), 50.0);
+    EXPECT_EQ(book.depth(Side::Buy, 5), 50.0);
+
+    EXPECT_FALSE(book.apply(event(4, EventType::Cancel, Side::Buy, 0, 0, 99)));  // unknown id
+    EXPECT_FALSE(book.apply(event(4, EventType::Add, Side::Unknown, 100.0, 1, 5)));
+    EXPECT_EQ(book.rejected(), 3u);
+
+    ASSERT_TRUE(book.apply(event(5, EventType::Clear, Side::Unknown, 0, 0)));
+    EXPECT_TRUE(std::isnan(book.best_ask()));
+    EXPECT_EQ(book.order_count(), 0u);
+}
+
+TEST(OrderBookTest, LevelEvents) {
+    OrderBook book(0.5);
+    book.apply(event(1, EventType::Add, Side::Sell, 10.5, 10));
+    book.apply(event(1, EventType::Add, Side::Sell, 11.0, 20));
+    book.apply(event(1, EventType::Add, Side::Sell, 12.0, 30));
+    book.apply(event(1, EventType::Modify, Side::Sell, 11.0, 5));   // absolute size
+    book.apply(event(1, EventType::Execute, Side::Sell, 10.5, 10)); // clears the touch
+
+    std::vector<tsproc::book::PriceLevel> levels;
+    ASSERT_EQ(book.levels(Side::Sell, 5, levels), 2u);
+    EXPECT_EQ(levels[0].price, 11.0);
+    EXPECT_EQ(levels[0].size, 5.0);
+    EXPECT_EQ(levels[1].price, 12.0);
+    EXPECT_EQ(book.traded_volume(), 10.0);
+    EXPECT_EQ(book.depth(Side::Sell, 1), 5.0);
+}
+
+TEST(OrderBookTest, GrowsAroundDistantPrices) {
+    OrderBook book(0.01, 100000);
+    ASSERT_TRUE(book.apply(event(1, EventType::Add, Side::Buy, 100.0, 1, 1)));
+    ASSERT_TRUE(book.apply(event(1, EventType::Add, Side::Buy, 50.0, 2, 2)));    // 5000 ticks below
+    ASSERT_TRUE(book.apply(event(1, EventType::Add, Side::Buy, 150.0, 3, 3)));   // and above
+    EXPECT_DOUBLE_EQ(book.best_bid(), 150.0);
+    EXPECT_EQ(book.depth(Side::Buy, 10), 6.0);
+    EXPECT_FALSE(book.apply(event(1, EventType::Add, Side::Buy, 5000.0, 1, 4)));  // past max_levels
+
+    book.apply(event(2, EventType::Cancel, Side::Buy, 0, 0, 3));
+    book.apply(event(2, EventType::Cancel, Side::Buy, 0, 0, 1));
+    EXPECT_DOUBLE_EQ(book.best_bid(), 50.0);
+}
+
+TEST(OrderBookTest, MatchesMapReference) {
+    // Random L3 flow against a std::map book
+    std::mt19937_64 rng(7);
+    OrderBook book(0.01);
+    std::map<int64_t, double> bids;
+    std::map<uint64_t, std::pair<int64_t, double>> live;
+    uint64_t next_id = 1;
+    for (int i = 0; i < 200000; ++i) {
+        const int action = static_cast<int>(rng() % 3);
+        if (action == 0 || live.empty()) {
+            const int64_t tick = 10000 + static_cast<int64_t>(rng() % 200);
+            const double size = static_cast<double>(1 + rng() % 100);
+            ASSERT_TRUE(book.apply(event(i, EventType::Add, Side::Buy, tick * 0.01, size, next_id)));
+            live[next_id++] = {tick, size};
+            bids[tick] += size;
+        } else {
+            auto it = live.lower_bound(1 + rng() % next_id);
+            if (it == live.end()) it = live.begin();
+            const double size = action == 1 ? it->second.second : 1.0;
+            ASSERT_TRUE(book.apply(event(i, EventType::Execute, Side::Buy, 0, size, it->first)));
+            bids[it->second.first] -= size;
+            if (bids[it->second.first] == 0.0) bids.erase(it->second.first);
+            it->second.second -= size;
+            if (it->second.second == 0.0) live.erase(it);
+        }
+        if (bids.empty()) {
+            ASSERT_TRUE(std::isnan(book.best_bid()));
+        } else {
+            ASSERT_EQ(book.best_size(Side::Buy), bids.rbegin()->second);
+            ASSERT_DOUBLE_EQ(book.best_bid(), bids.rbegin()->first * 0.01);
+        }
+    }
+    EXPECT_EQ(book.order_count(), live.size());
+}
+
+TEST(OrderBookTest, ReplaySamplesPerInterval) {
+    std::vector<OrderEvent> events = {
+        event(0, EventType::Add, Side::Buy, 100.0, 10, 1),
+        event(0, EventType::Add, Side::Sell, 100.1, 30, 2),
+        event(400, EventType::Add, Side::Buy, 100.05, 10, 3),
+        event(1500, EventType::Execute, Side::Sell, 0, 5, 2),
+        event(1500, EventType::Cancel, Side::Buy, 0, 0, 3),
+    };
+
+    std::vector<int64_t> stamps;
+    OrderBook book(0.01);
+    tsproc::book::replay(events, book, 1000,
+                         [&](int64_t ts, const OrderBook&) { stamps.push_back(ts); });
+    EXPECT_EQ(stamps, (std::vector<int64_t>{0, 1000}));
+
+    tsproc::book::FeatureOptions options;
+    options.interval_ns = 1000;
+    OrderBook fresh(0.01);
+    tsproc::TimeSeries ts = tsproc::book::book_features(events, fresh, options);
+    ASSERT_EQ(ts.size(), 2u);
+    EXPECT_DOUBLE_EQ(ts[0].close, 100.075);
+    EXPECT_DOUBLE_EQ(ts[0].low, 100.05);
+    EXPECT_DOUBLE_EQ(ts[0].high, 100.075);
+    EXPECT_EQ(ts[1].volume, 5.0);
+    EXPECT_NEAR(ts[1].indicators.at("spread"), 0.1, 1e-9);
+    EXPECT_DOUBLE_EQ(ts[1].indicators.at("depth_imbalance"), (10.0 - 25.0) / 35.0);
+
+    // Feature columns feed the indicator functions by name
+    tsproc::indicators::add_sma(ts, 2, "depth_imbalance");
+    EXPECT_EQ(ts[1].indicators.count("SMA_2"), 1u);
+}
+
+TEST(OrderBookTest, ParsesEventFiles) {
+    const std::string path = (fs::temp_directory_path() / "tsproc_book_events.csv").string();
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "ts,order_id,type,side,price,size\n"
+               "1000,1,A,B,99.5,100\n"
+               "1000,2,add,S,100.5,200\n"
+               "2000,1,X,B,,40\n"      // no price on an execute: row skipped
+               "2000,1,X,B,0,40\n"
+               "3000,,R,,,\n";         // clear needs no side/price/size
+    }
+    std::vector<OrderEvent> events;
+    ASSERT_TRUE(tsproc::book::read_order_events(path, events));
+    ASSERT_EQ(events.size(), 4u);
+    EXPECT_EQ(events[1].order_id, 2u);
+    EXPECT_EQ(events[1].side, Side::Sell);
+    EXPECT_EQ(events[2].type, EventType::Execute);
+    EXPECT_EQ(events[3].type, EventType::Clear);
+    fs::remove(path);
+
+    const std::string bad = "ts,type,price\n1,A,2\n";
+    EXPECT_FALSE(tsproc::book::parse_order_events(bad.data(), bad.size(), events));
+}
@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+#include "pages.hpp"
+#include "column_buffer.hpp"
+#include "datetime.hpp"
+#include "io.hpp"
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+using tsproc::pages::Backing;
+using tsproc::pages::HugePages;
+
+namespace {
+
+// Restores the process-wide mode after each test
+class PagesTest : public ::testing::Test {
+protected:
+    void SetUp() override { saved_ = tsproc::pages::huge_pages(); }
+    void TearDown() override { tsproc::pages::set_huge_pages(saved_); }
+
+private:
+    HugePages saved_ = HugePages::Transparent;
+};
+
+tsproc::TimeSeries minute_bars(size_t rows) {
+    tsproc::TimeSeries ts;
+    ts.reserve(rows);
+    const int64_t start = tsproc::to_timestamp("2024-03-01 09:30:00");
+    for (size_t i = 0; i < rows; ++i) {
+        tsproc::Record r;
+        r.date = tsproc::format_datetime(start + static_cast<int64_t>(i) * 60'000'000'000LL);
+        r.open = r.high = r.low = r.close = r.adj_close = 100.0 + static_cast<double>(i);
+        r.volume = static_cast<double>(i);
+        r.signal = static_cast<int>(i % 3) - 1;
+        ts.push(r);
+    }
+    return ts;
+}
+
+} // namespace
+
+TEST_F(PagesTest, ParsesModes) {
+    EXPECT_EQ(tsproc::pages::parse_huge_pages("off"), HugePages::Off);
+    EXPECT_EQ(tsproc::pages::parse_huge_pages("thp"), HugePages::Transparent);
+    EXPECT_EQ(tsproc::pages::parse_huge_pages("hugetlb"), HugePages::Explicit);
+    EXPECT_THROW(tsproc::pages::parse_huge_pages("2m"), std::invalid_argument);
+    for (HugePages mode : {HugePages::Off, HugePages::Transparent, HugePages::Explicit}) {
+        EXPECT_EQ(tsproc::pages::parse_huge_pages(tsproc::pages::huge_pages_name(mode)), mode);
+    }
+}
+
+TEST_F(PagesTest, SmallAndDisabledBlocksUseTheHeap) {
+    tsproc::pages::set_huge_pages(HugePages::Transparent);
+    tsproc::pages::Block small = tsproc::pages::allocate(1000);
+    EXPECT_EQ(small.backing, Backing::Heap);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(small.data) % tsproc::pages::kPageSize, 0u);
+    tsproc::pages::release(small);
+    EXPECT_EQ(small.data, nullptr);
+
+    tsproc::pages::set_huge_pages(HugePages::Off);
+    tsproc::pages::Block large = tsproc::pages::allocate(tsproc::pages::kHugeThreshold);
+    EXPECT_EQ(large.backing, Backing::Heap);
+    tsproc::pages::release(large);
+
+    tsproc::pages::Block none = tsproc::pages::allocate(0);
+    EXPECT_EQ(none.data, nullptr);
+    tsproc::pages::release(none);
+}
+
+#if defined(__linux__)
+TEST_F(PagesTest, LargeBlocksAreHugePageAligned) {
+    tsproc::pages::set_huge_pages(HugePages::Transparent);
+    const size_t bytes = tsproc::pages::kHugeThreshold + 12345;
+    tsproc::pages::Block block = tsproc::pages::allocate(bytes);
+    EXPECT_EQ(block.backing, Backing::Transparent);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(block.data) % tsproc::pages::kHugePageSize, 0u);
+    EXPECT_EQ(block.mapped % tsproc::pages::kHugePageSize, 0u);
+    EXPECT_GE(block.mapped, bytes);
+    std::memset(block.data, 0x5a, bytes);  // whole range writable
+    tsproc::pages::release(block);
+}
+
+TEST_F(PagesTest, HugetlbFallsBackWhenThePoolIsEmpty) {
+    tsproc::pages::set_huge_pages(HugePages::Explicit);
+    const tsproc::pages::PageStats before = tsproc::pages::stats();
+    tsproc::pages::Block block = tsproc::pages::allocate(tsproc::pages::kHugeThreshold);
+    const tsproc::pages::PageStats after = tsproc::pages::stats();
+
+    // Either the reserved pool served it or the fallback was counted
+    if (block.backing == Backing::Explicit) {
+        EXPECT_EQ(after.explicit_blocks, before.explicit_blocks + 1);
+    } else {
+        EXPECT_EQ(block.backing, Backing::Transparent);
+        EXPECT_EQ(after.explicit_fallbacks, before.explicit_fallbacks + 1);
+    }
+    static_cast<char*>(block.data)[0] = 1;
+    tsproc::pages::release(block);
+}
+
+TEST_F(PagesTest, LargeColumnsUseHugePages) {
+    tsproc::pages::set_huge_pages(HugePages::Transparent);
+    tsproc::ColumnBuffer column(1 << 20);  // 8 MiB
+    EXPECT_EQ(column.backing(), Backing::Transparent);
+    EXPECT_EQ(column[0], 0.0);
+    EXPECT_EQ(column[column.size() - 1], 0.0);
+
+    tsproc::ColumnBuffer small(100);
+    EXPECT_EQ(small.backing(), Backing::Heap);
+}
+#endif
+
+TEST_F(PagesTest, MappedBinaryReadsMatchTheWrittenRows) {
+    const std::string path = (fs::temp_directory_path() / "tsproc_pages.bin").string();
+    tsproc::TimeSeries written = minute_bars(500);
+    ASSERT_TRUE(tsproc::BinaryWriter(path).write(written));
+
+    const uint64_t mapped_before = tsproc::pages::stats().mapped_files;
+    tsproc::BinaryReader reader(path);
+    tsproc::TimeSeries all = reader.read();
+    ASSERT_EQ(all.size(), written.size());
+    for (size_t i = 0; i < all.size(); ++i) {
+        ASSERT_EQ(all[i].date, written[i].date) << i;
+        ASSERT_EQ(all[i].close, written[i].close) << i;
+        ASSERT_EQ(all[i].signal, written[i].signal) << i;
+    }
+#if defined(__linux__)
+    EXPECT_GT(tsproc::pages::stats().mapped_files, mapped_before);
+#else
+    (void)mapped_before;
+#endif
+
+    tsproc::TimeSeries block = reader.read_rows(490, 100);
+    ASSERT_EQ(block.size(), 10u);
+    EXPECT_EQ(block[0].date, written[490].date);
+
+    tsproc::TimeSeries range = reader.read_range(tsproc::to_timestamp(written[100].date),
+                                                 tsproc::to_timestamp(written[110].date));
+    ASSERT_EQ(range.size(), 10u);
+    EXPECT_EQ(range[0].date, written[100].date);
+
+    // A truncated file reads the complete rows it still holds
+    fs::resize_file(path, 16 + 8 * sizeof(double) * 50 + 20);
+    EXPECT_EQ(reader.read().size(), 50u);
+
+    fs::remove(path);
+}
+
+TEST_F(PagesTest, MappedFileRejectsEmptyAndMissingFiles) {
+    const std::string path = (fs::temp_directory_path() / "tsproc_pages_empty.bin").string();
+    { std::ofstream empty(path); }
+    tsproc::pages::MappedFile file;
+    EXPECT_FALSE(file.open(path));
+    EXPECT_FALSE(file.open(path + ".missing"));
+    EXPECT_EQ(file.data(), nullptr);
+    EXPECT_TRUE(tsproc::BinaryReader(path).read().empty());
+    fs::remove(path);
+}
@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+#include "panel.hpp"
+#include "csv_reader.hpp"
+#include "datetime.hpp"
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+class PanelTest : public ::testing::Test {
+protected:
+    std::string csv_path = (fs::temp_directory_path() / "tsproc_panel.csv").string();
+
+    void TearDown() override {
+        if (fs::exists(csv_path)) fs::remove(csv_path);
+    }
+
+    // Symbol-first long format with three tickers interleaved; close = day + k
+    void write_long(size_t days, bool symbol_first = true) {
+        const char* symbols[] = {"AAPL", "MSFT", "GOOG"};
+        std::ofstream out(csv_path);
+        out << (symbol_first ? "Symbol,Date," : "Date,symbol,")
+            << "Open,High,Low,Close,Adj Close,Volume\n";
+        const int64_t day = 86'400'000'000'000LL;
+        const int64_t start = tsproc::to_timestamp("2021-01-04");
+        for (size_t d = 0; d < days; ++d) {
+            for (int k = 0; k < 3; ++k) {
+                const std::string date = tsproc::format_datetime(start + static_cast<int64_t>(d) * day);
+                const double close = static_cast<double>(d) + k;
+                if (symbol_first) {
+                    out << symbols[k] << ',' << date;
+                } else {
+                    out << date << ',' << symbols[k];
+                }
+                out << ',' << close << ',' << close + 1 << ',' << close - 1 << ',' << close << ','
+                    << close << ',' << 100 * (k + 1) << '\n';
+            }
+        }
+    }
+};
+
+TEST_F(PanelTest, SymbolTableEncodesInFirstSeenOrder) {
+    tsproc::SymbolTable table;
+    EXPECT_EQ(table.intern("MSFT"), 0u);
+    EXPECT_EQ(table.intern("AAPL"), 1u);
+    EXPECT_EQ(table.intern(std::string("MSFT")), 0u);
+    EXPECT_EQ(table.size(), 2u);
+    EXPECT_EQ(table.name(1), "AAPL");
+
+    uint32_t id = 99;
+    EXPECT_TRUE(table.find("AAPL", id));
+    EXPECT_EQ(id, 1u);
+    EXPECT_FALSE(table.find("GOOG", id));
+
+    // Moving keeps the lookup keys valid
+    tsproc::SymbolTable moved = std::move(table);
+    EXPECT_TRUE(moved.find("MSFT", id));
+    EXPECT_EQ(id, 0u);
+}
+
+TEST_F(PanelTest, MergeRemapsPartsAndKeepsOrder) {
+    std::vector<tsproc::Panel> parts(2);
+    tsproc::Bar b;
+    b.ts = 1;
+    b.close = 10.0;
+    parts[0].push(parts[0].add_symbol("A"), b);
+    b.ts = 2;
+    parts[1].push(parts[1].add_symbol("B"), b);
+    b.ts = 3;
+    parts[1].push(parts[1].add_symbol("A"), b);
+
+    tsproc::Panel panel = tsproc::Panel::merge(parts);
+    ASSERT_EQ(panel.symbol_count(), 2u);
+    EXPECT_EQ(panel.symbols().name(0), "A");
+    EXPECT_EQ(panel.symbols().name(1), "B");
+    ASSERT_EQ(panel.columns(0).size(), 2u);
+    EXPECT_EQ(panel.columns(0).ts[0], 1);
+    EXPECT_EQ(panel.columns(0).ts[1], 3);
+    EXPECT_EQ(panel.row_count(), 3u);
+    EXPECT_EQ(panel.find("C"), nullptr);
+}
+
+TEST_F(PanelTest, ReadsLongFormatPerSymbol) {
+    write_long(50);
+    tsproc::Panel panel = tsproc::CSVReader(csv_path).read_panel("Symbol", 1);
+    ASSERT_EQ(panel.symbol_count(), 3u);
+    EXPECT_EQ(panel.symbols().name(0), "AAPL");
+    EXPECT_EQ(panel.row_count(), 150u);
+
+    const tsproc::SymbolColumns* msft = panel.find("MSFT");
+    ASSERT_NE(msft, nullptr);
+    ASSERT_EQ(msft->size(), 50u);
+    EXPECT_EQ(msft->close[7], 8.0);
+    EXPECT_EQ(msft->volume[7], 200.0);
+    EXPECT_EQ(msft->ts[1] - msft->ts[0], 86'400'000'000'000LL);
+
+    tsproc::TimeSeries ts = panel.series(2);
+    ASSERT_EQ(ts.size(), 50u);
+    EXPECT_EQ(ts[0].date, "2021-01-04");
+    EXPECT_EQ(ts[49].close, 51.0);
+}
+
+TEST_F(PanelTest, ParallelChunksMatchSerialParse) {
+    write_long(400, false);  // Date,symbol,... with a lower-case header
+    tsproc::Panel serial = tsproc::CSVReader(csv_path).read_panel("SYMBOL", 1);
+    tsproc::Panel parallel = tsproc::CSVReader(csv_path).read_panel("SYMBOL", 7);
+
+    ASSERT_EQ(serial.symbol_count(), 3u);
+    ASSERT_EQ(parallel.symbol_count(), serial.symbol_count());
+    for (uint32_t id = 0; id < serial.symbol_count(); ++id) {
+        EXPECT_EQ(parallel.symbols().name(id), serial.symbols().name(id));
+        EXPECT_EQ(parallel.columns(id).ts, serial.columns(id).ts);
+        EXPECT_EQ(parallel.columns(id).close, serial.columns(id).close);
+    }
+}
+
+TEST_F(PanelTest, InvalidRowsFollowDropNa) {
+    std::ofstream out(csv_path);
+    out << "Symbol,Date,Open,High,Low,Close,Adj Close,Volume\n"
+        << "X,2021-01-04,1,2,0.5,1.5,1.5,10\n"
+        << "X,2021-01-05,1,2,0.5,,1.5,10\n"      // missing close
+        << ",2021-01-06,1,2,0.5,1.5,1.5,10\n"    // no symbol: never routed
+        << "Y,2021-01-07,1\n"                    // short row
+        << "\n";
+    out.close();
+
+    tsproc::Panel dropped = tsproc::CSVReader(csv_path).read_panel();
+    EXPECT_EQ(dropped.row_count(), 1u);
+    EXPECT_EQ(dropped.symbol_count(), 1u);
+
+    tsproc::Panel kept = tsproc::CSVReader(csv_path).read_panel("Symbol", 1, false);
+    EXPECT_EQ(kept.row_count(), 3u);
+    const tsproc::SymbolColumns* x = kept.find("X");
+    ASSERT_NE(x, nullptr);
+    EXPECT_TRUE(std::isnan(x->close[1]));
+    const tsproc::SymbolColumns* y = kept.find("Y");
+    ASSERT_NE(y, nullptr);
+    EXPECT_EQ(y->ts[0], tsproc::to_timestamp("2021-01-07"));
+    EXPECT_EQ(y->open[0], 0.0);
+}
+
+TEST_F(PanelTest, MissingSymbolColumnGivesEmptyPanel) {
+    write_long(3);
+    EXPECT_EQ(tsproc::CSVReader(csv_path).read_panel("Ticker").symbol_count(), 0u);
+    EXPECT_EQ(tsproc::CSVReader(csv_path + ".missing").read_panel().symbol_count(), 0u);
+}
+
+TEST_F(PanelTest, SeriesResolvesDuplicatesPerSymbol) {
+    std::ofstream out(csv_path);
+    out << "Symbol,Date,Open,High,Low,Close,Adj Close,Volume\n"
+        << "A,2021-01-04,1,1,1,1,1,1\n"
+        << "B,2021-01-04,5,5,5,5,5,5\n"
+        << "A,2021-01-04,2,2,2,2,2,2\n";
+    out.close();
+
+    tsproc::Panel panel = tsproc::CSVReader(csv_path).read_panel();
+    size_t resolved = 0;
+    tsproc::TimeSeries a = panel.series(0, tsproc::DuplicatePolicy::KeepLast, &resolved);
+    ASSERT_EQ(a.size(), 1u);
+    EXPECT_EQ(a[0].close, 2.0);
+    EXPECT_EQ(resolved, 1u);
+    EXPECT_EQ(panel.series(1).size(), 1u);
+}
@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+#include "profiler.hpp"
+#include "indicators.hpp"
+#include <sstream>
+#include <thread>
+
+using namespace tsproc::profiling;
+
+namespace {
+
+tsproc::TimeSeries ramp(size_t n) {
+    tsproc::TimeSeries ts;
+    for (size_t i = 0; i < n; ++i) {
+        tsproc::Record r;
+        r.date = "2024-01-01";
+        r.open = r.high = r.low = r.close = r.adj_close = static_cast<double>(i);
+        r.volume = 1.0;
+        ts.push(r);
+    }
+    return ts;
+}
+
+// Leaves the process-wide profiler disabled and empty for other tests
+class ProfilerTest : public ::testing::Test {
+protected:
+    void SetUp() override { Profiler::instance().reset(); }
+    void TearDown() override {
+        Profiler::instance().disable();
+        Profiler::instance().reset();
+    }
+};
+
+} // namespace
+
+TEST(PerfCountersTest, DegradesGracefully) {
+    PerfCounters counters;
+    if (!counters.available()) {
+        EXPECT_FALSE(counters.status().empty());
+        EXPECT_FALSE(counters.read().any_valid());
+        return;
+    }
+
+    CounterSample before = counters.read();
+    volatile double sink = 0.0;
+    for (int i = 0; i < 100000; ++i) sink = sink + i;
+    CounterSample delta = counters.read().since(before);
+    EXPECT_TRUE(delta.any_valid());
+    if (delta.valid[kInstructions]) {
+        EXPECT_GT(delta.values[kInstructions], 100000u);
+    }
+}
+
+TEST(PerfCountersTest, SampleArithmetic) {
+    CounterSample a, b;
+    a.values[kCycles] = 100;
+    a.valid[kCycles] = true;
+    b.values[kCycles] = 250;
+    b.valid[kCycles] = true;
+    b.values[kInstructions] = 7;
+    b.valid[kInstructions] = true;
+
+    CounterSample d = b.since(a);
+    EXPECT_TRUE(d.valid[kCycles]);
+    EXPECT_EQ(d.values[kCycles], 150u);
+    EXPECT_FALSE(d.valid[kInstructions]);  // not counted at the start
+
+    d += d;
+    EXPECT_EQ(d.values[kCycles], 300u);
+    EXPECT_STREQ(event_name(kBranchMisses), "branch-misses");
+}
+
+TEST_F(ProfilerTest, DisabledRecordsNothing) {
+    {
+        Scope scope("load", 10);
+    }
+    EXPECT_TRUE(Profiler::instance().stages().empty());
+}
+
+TEST_F(ProfilerTest, NestedScopesFormPaths) {
+    Profiler::instance().enable(false);
+    tsproc::TimeSeries ts = ramp(100);
+    {
+        Scope scope("indicators", ts.size());
+        tsproc::indicators::add_sma(ts, 5);
+        tsproc::indicators::add_sma(ts, 5);
+        tsproc::indicators::add_ema(ts, 10);
+    }
+
+    std::vector<StageStats> stages = Profiler::instance().stages();
+    ASSERT_EQ(stages.size(), 3u);
+    EXPECT_EQ(stages[0].path, "indicators");
+    EXPECT_EQ(stages[0].depth, 0u);
+    EXPECT_EQ(stages[1].path, "indicators/sma(5)");
+    EXPECT_EQ(stages[1].depth, 1u);
+    EXPECT_EQ(stages[1].calls, 2u);
+    EXPECT_EQ(stages[1].rows, 200u);
+    EXPECT_EQ(stages[2].path, "indicators/ema(10)");
+    EXPECT_GE(stages[0].seconds, stages[1].seconds);
+    EXPECT_FALSE(stages[1].counters.any_valid());
+
+    std::ostringstream os;
+    Profiler::instance().report(os);
+    EXPECT_NE(os.str().find("  sma(5)"), std::string::npos);
+    EXPECT_NE(os.str().find("hardware counters unavailable"), std::string::npos);
+}
+
+TEST_F(ProfilerTest, RowsCanBeSetLater) {
+    Profiler::instance().enable(false);
+    {
+        Scope scope("load");
+        scope.set_rows(42);
+    }
+    std::vector<StageStats> stages = Profiler::instance().stages();
+    ASSERT_EQ(stages.size(), 1u);
+    EXPECT_EQ(stages[0].rows, 42u);
+}
+
+TEST_F(ProfilerTest, CountersReportedWhenAvailable) {
+    Profiler::instance().enable(true);
+    if (!Profiler::instance().counters_enabled()) {
+        EXPECT_FALSE(Profiler::instance().counter_status().empty());
+        GTEST_SKIP() << Profiler::instance().counter_status();
+    }
+    tsproc::TimeSeries ts = ramp(10000);
+    tsproc::indicators::add_roll_mean_std(ts, 20);
+
+    std::vector<StageStats> stages = Profiler::instance().stages();
+    ASSERT_EQ(stages.size(), 1u);
+    EXPECT_TRUE(stages[0].counters.any_valid());
+
+    std::ostringstream os;
+    Profiler::instance().report(os);
+    EXPECT_NE(os.str().find("cycles/row"), std::string::npos);
+}
+
+TEST_F(ProfilerTest, TaskCountersChargeSpawningStage) {
+    Profiler::instance().enable(true);
+    if (!Profiler::instance().counters_enabled()) {
+        GTEST_SKIP() << Profiler::instance().counter_status();
+    }
+
+    const uint64_t iterations = 2000000;
+    {
+        Scope outer("stage");
+        Scope scope("parallel", 1);
+        const size_t stage = current_stage();
+        const std::thread::id spawner = std::this_thread::get_id();
+        // Stands in for a pool worker: the spawning thread only waits
+        std::thread worker([stage, spawner, iterations] {
+            TaskScope task(stage, spawner);
+            EXPECT_EQ(current_stage(), stage);
+            volatile uint64_t sink = 0;
+            for (uint64_t i = 0; i < iterations; ++i) sink = sink + i;
+        });
+        worker.join();
+    }
+    EXPECT_EQ(current_stage(), kNoStage);
+
+    // Charged to the spawning stage and the stage enclosing it
+    std::vector<StageStats> stages = Profiler::instance().stages();
+    ASSERT_EQ(stages.size(), 2u);
+    EXPECT_EQ(stages[1].path, "stage/parallel");
+    EXPECT_EQ(stages[1].calls, 1u);
+    if (!stages[1].counters.valid[kInstructions]) GTEST_SKIP() << "instructions not counted";
+    EXPECT_GT(stages[1].counters.values[kInstructions], iterations);
+    EXPECT_GE(stages[0].counters.values[kInstructions], stages[1].counters.values[kInstructions]);
+}
@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+#include "pyramid.hpp"
+#include "datetime.hpp"
+#include "io.hpp"
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr int64_t kMinute = 60LL * 1000000000LL;
+
+} // namespace
+
+class PyramidTest : public ::testing::Test {
+protected:
+    std::string base_path = "test_pyramid.bin";
+
+    void TearDown() override {
+        for (const char* suffix : {"", ".pyr", ".pyr-5m", ".pyr-1h", ".pyr-1d"}) {
+            std::string p = base_path + suffix;
+            if (fs::exists(p)) fs::remove(p);
+        }
+    }
+
+    // Minute bars starting at 2021-01-04 00:00 with close = row number
+    tsproc::TimeSeries minute_bars(size_t first, size_t count) {
+        int64_t origin = tsproc::to_timestamp("2021-01-04");
+        tsproc::TimeSeries ts;
+        for (size_t i = first; i < first + count; ++i) {
+            tsproc::Record r;
+            r.date = tsproc::format_datetime(origin + static_cast<int64_t>(i) * kMinute);
+            r.open = static_cast<double>(i);
+            r.high = static_cast<double>(i) + 0.5;
+            r.low = static_cast<double>(i) - 0.5;
+            r.close = static_cast<double>(i) + 0.25;
+            r.adj_close = r.close;
+            r.volume = 10.0;
+            ts.push(r);
+        }
+        return ts;
+    }
+
+    void expect_same(const tsproc::TimeSeries& a, const tsproc::TimeSeries& b) {
+        ASSERT_EQ(a.size(), b.size());
+        for (size_t i = 0; i < a.size(); ++i) {
+            EXPECT_EQ(a[i].date, b[i].date);
+            EXPECT_DOUBLE_EQ(a[i].open, b[i].open);
+            EXPECT_DOUBLE_EQ(a[i].high, b[i].high);
+            EXPECT_DOUBLE_EQ(a[i].low, b[i].low);
+            EXPECT_DOUBLE_EQ(a[i].close, b[i].close);
+            EXPECT_DOUBLE_EQ(a[i].volume, b[i].volume);
+        }
+    }
+};
+
+TEST(DurationTest, ParseAndFormat) {
+    int64_t ns = 0;
+    ASSERT_TRUE(tsproc::parse_duration("5m", ns));
+    EXPECT_EQ(ns, 5 * kMinute);
+    ASSERT_TRUE(tsproc::parse_duration("1d", ns));
+    EXPECT_EQ(tsproc::format_duration(ns), "1d");
+    EXPECT_EQ(tsproc::format_duration(90 * kMinute), "90m");
+    EXPECT_FALSE(tsproc::parse_duration("5x", ns));
+    EXPECT_FALSE(tsproc::parse_duration("0m", ns));
+    EXPECT_FALSE(tsproc::parse_duration("20000w", ns));   // past INT64_MAX ns
+    ASSERT_TRUE(tsproc::parse_duration("15250w", ns));
+    EXPECT_EQ(ns, 15250 * 7 * 24 * 60 * kMinute);
+}
+
+TEST_F(PyramidTest, ResampleAggregatesOHLCV) {
+    tsproc::TimeSeries bars = minute_bars(0, 12);
+    tsproc::TimeSeries five = tsproc::resample(bars, 5 * kMinute);
+
+    ASSERT_EQ(five.size(), 3u);
+    EXPECT_EQ(five[0].date, "2021-01-04");
+    EXPECT_EQ(five[1].date, "2021-01-04 00:05:00");
+    EXPECT_DOUBLE_EQ(five[0].open, 0.0);
+    EXPECT_DOUBLE_EQ(five[0].high, 4.5);
+    EXPECT_DOUBLE_EQ(five[0].low, -0.5);
+    EXPECT_DOUBLE_EQ(five[0].close, 4.25);
+    EXPECT_DOUBLE_EQ(five[0].volume, 50.0);
+    // Partial last bucket holds minutes 10 and 11
+    EXPECT_DOUBLE_EQ(five[2].volume, 20.0);
+}
+
+TEST_F(PyramidTest, QueryUsesCoarsestLevel) {
+    tsproc::TimeSeries bars = minute_bars(0, 3 * 24 * 60);
+    tsproc::Pyramid pyramid(base_path);
+    ASSERT_TRUE(pyramid.build(bars, {60 * kMinute, 5 * kMinute, 24 * 60 * kMinute}));
+
+    EXPECT_EQ(pyramid.select_level(5 * kMinute), 5 * kMinute);
+    EXPECT_EQ(pyramid.select_level(15 * kMinute), 5 * kMinute);
+    EXPECT_EQ(pyramid.select_level(4 * 60 * kMinute), 60 * kMinute);
+    EXPECT_EQ(pyramid.select_level(7 * kMinute), 0);
+
+    // Reopening picks the levels up from the manifest
+    tsproc::Pyramid reopened(base_path);
+    ASSERT_EQ(reopened.levels().size(), 3u);
+
+    expect_same(reopened.query(4 * 60 * kMinute), tsproc::resample(bars, 4 * 60 * kMinute));
+    expect_same(reopened.query(7 * kMinute), tsproc::resample(bars, 7 * kMinute));
+    EXPECT_EQ(reopened.query(24 * 60 * kMinute).size(), 3u);
+}
+
+TEST_F(PyramidTest, IncrementalAppendMatchesRebuild) {
+    tsproc::TimeSeries all = minute_bars(0, 200);
+
+    tsproc::Pyramid pyramid(base_path);
+    ASSERT_TRUE(pyramid.build(minute_bars(0, 63), {5 * kMinute, 60 * kMinute}));
+    ASSERT_TRUE(pyramid.append(minute_bars(63, 70)));
+    ASSERT_TRUE(pyramid.append(minute_bars(133, 67)));
+
+    tsproc::BinaryReader base(base_path);
+    EXPECT_EQ(base.row_count(), 200u);
+
+    tsproc::BinaryReader five(pyramid.level_path(5 * kMinute));
+    expect_same(five.read(), tsproc::resample(all, 5 * kMinute));
+    tsproc::BinaryReader hour(pyramid.level_path(60 * kMinute));
+    expect_same(hour.read(), tsproc::resample(all, 60 * kMinute));
+}
+
+TEST_F(PyramidTest, AppendRejectsOlderRows) {
+    tsproc::Pyramid pyramid(base_path);
+    ASSERT_TRUE(pyramid.build(minute_bars(10, 10), {5 * kMinute}));
+    EXPECT_FALSE(pyramid.append(minute_bars(0, 5)));
+}
+
+TEST_F(PyramidTest, QueryWidensRangeToWholeBuckets) {
+    tsproc::TimeSeries bars = minute_bars(0, 6 * 60);
+    tsproc::Pyramid pyramid(base_path);
+    ASSERT_TRUE(pyramid.build(bars, {5 * kMinute, 60 * kMinute}));
+    tsproc::Pyramid base_only(base_path + ".flat");
+    ASSERT_TRUE(tsproc::BinaryWriter(base_path + ".flat").write(bars));
+
+    // 00:10 .. 02:50 is not aligned to 1h: both edge hours come back whole
+    const int64_t origin = tsproc::to_timestamp("2021-01-04");
+    const int64_t from = origin + 10 * kMinute;
+    const int64_t to = origin + 170 * kMinute;
+    tsproc::TimeSeries all_hours = tsproc::resample(bars, 60 * kMinute);
+    tsproc::TimeSeries expected;
+    for (size_t i = 0; i < 3; ++i) expected.push(all_hours[i]);
+    expect_same(pyramid.query(60 * kMinute, from, to), expected);
+
+    // The stored levels do not change the answer
+    expect_same(base_only.query(60 * kMinute, from, to), expected);
+    expect_same(pyramid.query(2 * 60 * kMinute, from, to),
+                base_only.query(2 * 60 * kMinute, from, to));
+    EXPECT_EQ(pyramid.query(2 * 60 * kMinute, from, to).size(), 2u);
+    fs::remove(base_path + ".flat");
+}
+
+TEST_F(PyramidTest, AddLevelsBuildsMissingOnly) {
+    tsproc::TimeSeries all = minute_bars(0, 120);
+    tsproc::Pyramid pyramid(base_path);
+    ASSERT_TRUE(pyramid.build(minute_bars(0, 60), {5 * kMinute}));
+    ASSERT_TRUE(pyramid.append(minute_bars(60, 60)));
+    ASSERT_TRUE(pyramid.add_levels({5 * kMinute, 60 * kMinute}));
+
+    ASSERT_EQ(pyramid.levels(), (std::vector<int64_t>{5 * kMinute, 60 * kMinute}));
+    tsproc::BinaryReader hour(pyramid.level_path(60 * kMinute));
+    expect_same(hour.read(), tsproc::resample(all, 60 * kMinute));
+    EXPECT_EQ(tsproc::Pyramid(base_path).levels().size(), 2u);
+}
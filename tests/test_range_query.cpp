@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include "csv_reader.hpp"
+#include "datetime.hpp"
+#include "io.hpp"
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr int64_t kMinute = 60LL * 1000000000LL;
+
+} // namespace
+
+class RangeQueryTest : public ::testing::Test {
+protected:
+    std::string csv_path = "test_range.csv";
+    std::string bin_path = "test_range.bin";
+    int64_t origin = tsproc::to_timestamp("2015-01-01");
+
+    void TearDown() override {
+        if (fs::exists(csv_path)) fs::remove(csv_path);
+        if (fs::exists(bin_path)) fs::remove(bin_path);
+    }
+
+    // Minute bars with close = row number; large enough to exercise bisection
+    void create_csv(size_t rows) {
+        std::ofstream ofs(csv_path);
+        ofs << "Date,Open,High,Low,Close,Adj Close,Volume\n";
+        for (size_t i = 0; i < rows; ++i) {
+            ofs << tsproc::format_datetime(origin + static_cast<int64_t>(i) * kMinute)
+                << ",1,2,0.5," << i << "," << i << ",100\n";
+            if (i % 1000 == 500) ofs << "\n";  // stray blank lines must be tolerated
+        }
+    }
+
+    int64_t at(size_t row) const { return origin + static_cast<int64_t>(row) * kMinute; }
+};
+
+TEST_F(RangeQueryTest, CSV_SelectsHalfOpenRange) {
+    create_csv(50000);
+    tsproc::CSVReader reader(csv_path);
+
+    tsproc::TimeSeries ts = reader.read_range(at(31234), at(31334));
+
+    ASSERT_EQ(ts.size(), 100u);
+    EXPECT_DOUBLE_EQ(ts[0].close, 31234.0);
+    EXPECT_DOUBLE_EQ(ts[99].close, 31333.0);
+}
+
+TEST_F(RangeQueryTest, CSV_BoundsOutsideData) {
+    create_csv(2000);
+    tsproc::CSVReader reader(csv_path);
+
+    EXPECT_EQ(reader.read_range(INT64_MIN, at(10)).size(), 10u);
+    EXPECT_EQ(reader.read_range(at(1990), INT64_MAX).size(), 10u);
+    EXPECT_EQ(reader.read_range(at(5000), at(6000)).size(), 0u);
+    EXPECT_EQ(reader.read_range(INT64_MIN, INT64_MAX).size(), 2000u);
+}
+
+TEST_F(RangeQueryTest, CSV_FirstAndLastRows) {
+    create_csv(30000);
+    tsproc::CSVReader reader(csv_path);
+
+    tsproc::TimeSeries head = reader.read_range(at(0), at(1));
+    ASSERT_EQ(head.size(), 1u);
+    EXPECT_DOUBLE_EQ(head[0].close, 0.0);
+
+    tsproc::TimeSeries tail = reader.read_range(at(29999), at(30000));
+    ASSERT_EQ(tail.size(), 1u);
+    EXPECT_DOUBLE_EQ(tail[0].close, 29999.0);
+}
+
+TEST_F(RangeQueryTest, Binary_BinarySearchRange) {
+    create_csv(5000);
+    tsproc::CSVReader reader(csv_path);
+    tsproc::BinaryWriter writer(bin_path);
+    ASSERT_TRUE(writer.write(reader.read_to_timeseries()));
+
+    tsproc::BinaryReader bin(bin_path);
+    tsproc::TimeSeries ts = bin.read_range(at(1000), at(1500));
+
+    ASSERT_EQ(ts.size(), 500u);
+    EXPECT_DOUBLE_EQ(ts[0].close, 1000.0);
+    EXPECT_DOUBLE_EQ(ts[499].close, 1499.0);
+    EXPECT_EQ(ts[0].date, tsproc::format_datetime(at(1000)));
+
+    EXPECT_EQ(bin.read_range(at(9000), at(9100)).size(), 0u);
+    EXPECT_EQ(bin.read_range(INT64_MIN, INT64_MAX).size(), 5000u);
+}
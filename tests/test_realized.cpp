@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+#include "realized.hpp"
+#include "datetime.hpp"
+#include "scheduler.hpp"
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr int64_t kMinute = 60LL * 1000000000;
+
+tsproc::Record bar(int64_t ns, double close, double volume) {
+    tsproc::Record r;
+    r.date = tsproc::format_datetime(ns);
+    r.open = r.high = r.low = r.close = r.adj_close = close;
+    r.volume = volume;
+    return r;
+}
+
+// Minute bars from 14:30 to 20:59 UTC on `days` consecutive days, with
+// returns that alternate +/- and grow towards the close
+tsproc::TimeSeries session_bars(int days) {
+    tsproc::TimeSeries ts;
+    const int64_t first_day = tsproc::to_timestamp("2024-03-04");
+    for (int d = 0; d < days; ++d) {
+        double price = 100.0;
+        const int64_t open = first_day + d * 24 * 60 * kMinute + (14 * 60 + 30) * kMinute;
+        for (int m = 0; m < 390; ++m) {
+            const double size = 0.0001 * (1.0 + m / 130);   // three volatility regimes
+            if (m > 0) price *= std::exp(m % 2 == 0 ? size : -size);
+            ts.push(bar(open + m * kMinute, price, m < 30 ? 3000.0 : 1000.0));
+        }
+    }
+    return ts;
+}
+
+} // namespace
+
+TEST(RealizedTest, VarianceAndBipowerOfKnownReturns) {
+    // Returns 0.01, -0.02, 0.01 on one day
+    const int64_t t0 = tsproc::to_timestamp("2024-03-04 15:00");
+    tsproc::TimeSeries ts;
+    double price = 50.0;
+    ts.push(bar(t0, price, 10));
+    const double returns[] = {0.01, -0.02, 0.01};
+    for (int i = 0; i < 3; ++i) {
+        price *= std::exp(returns[i]);
+        ts.push(bar(t0 + (i + 1) * kMinute, price, 10));
+    }
+
+    tsproc::realized::Result r = tsproc::realized::compute(ts);
+    ASSERT_EQ(r.daily.size(), 1u);
+    const auto& day = r.daily[0].indicators;
+    EXPECT_EQ(r.daily[0].date, "2024-03-04");
+    EXPECT_NEAR(day.at("RV"), 0.0006, 1e-12);
+    EXPECT_NEAR(day.at("BV"), M_PI / 2.0 * (0.0002 + 0.0002), 1e-12);
+    EXPECT_EQ(day.at("JUMP"), 0.0);   // BV > RV: no jump component
+    EXPECT_NEAR(day.at("RVOL"), std::sqrt(0.0006), 1e-12);
+    EXPECT_EQ(day.at("RETURNS"), 3.0);
+    EXPECT_EQ(r.daily[0].volume, 40.0);
+}
+
+TEST(RealizedTest, OvernightReturnsAreExcluded) {
+    tsproc::TimeSeries ts;
+    const int64_t t0 = tsproc::to_timestamp("2024-03-04 20:58");
+    ts.push(bar(t0, 100.0, 1));
+    ts.push(bar(t0 + kMinute, 100.0, 1));
+    ts.push(bar(t0 + 18 * 60 * kMinute, 120.0, 1));   // next day, 20% gap
+    ts.push(bar(t0 + 18 * 60 * kMinute + kMinute, 120.0, 1));
+
+    tsproc::realized::Result r = tsproc::realized::compute(ts);
+    ASSERT_EQ(r.daily.size(), 2u);
+    EXPECT_EQ(r.daily[0].indicators.at("RV"), 0.0);
+    EXPECT_EQ(r.daily[1].indicators.at("RV"), 0.0);
+    EXPECT_EQ(r.daily[1].open, 120.0);
+
+    // Trading days that start at 22:00 UTC are dated at their start
+    tsproc::realized::Options options;
+    options.day_offset_ns = -2 * 60 * kMinute;
+    tsproc::realized::Result shifted = tsproc::realized::compute(ts, options);
+    EXPECT_EQ(shifted.daily.size(), 2u);
+    EXPECT_EQ(shifted.daily[0].date, "2024-03-03 22:00:00");
+}
+
+TEST(RealizedTest, SeasonalProfile) {
+    tsproc::TimeSeries ts = session_bars(20);
+    tsproc::realized::Options options;
+    options.bucket_ns = 130 * kMinute;   // one bucket per volatility regime
+    options.day_offset_ns = 14 * 60 * kMinute + 30 * kMinute;
+
+    tsproc::realized::Result r = tsproc::realized::compute(ts, options);
+    ASSERT_EQ(r.daily.size(), 20u);
+    ASSERT_EQ(r.profile.size(), 3u);
+    EXPECT_EQ(r.profile[1].offset_ns, 130 * kMinute);
+    EXPECT_EQ(r.profile[0].bars, 20u * 130u);
+    EXPECT_EQ(r.profile[0].returns, 20u * 129u);   // no return into the first bar
+    EXPECT_DOUBLE_EQ(r.profile[0].mean_volume, (30 * 3000.0 + 100 * 1000.0) / 130.0);
+
+    // Return sizes are 1:2:3 across the regimes
+    const double scale = std::sqrt(3.0 / (1.0 + 4.0 + 9.0));
+    EXPECT_NEAR(r.profile[0].volatility_factor, 1.0 * scale, 1e-9);
+    EXPECT_NEAR(r.profile[2].volatility_factor, 3.0 * scale, 1e-9);
+    EXPECT_NEAR(r.profile[0].volume_factor + r.profile[1].volume_factor + r.profile[2].volume_factor,
+                3.0, 1e-12);
+}
+
+TEST(RealizedTest, ParallelMatchesSerial) {
+    tsproc::TimeSeries ts = session_bars(64);
+    tsproc::exec::SchedulerOptions options;
+    options.threads = 1;
+    tsproc::exec::Scheduler::configure_global(options);
+    tsproc::realized::Result expected = tsproc::realized::compute(ts);
+    options.threads = 4;
+    tsproc::exec::Scheduler::configure_global(options);
+    tsproc::realized::Result got = tsproc::realized::compute(ts);
+    tsproc::exec::Scheduler::configure_global(tsproc::exec::SchedulerOptions());
+
+    ASSERT_EQ(got.daily.size(), expected.daily.size());
+    for (size_t i = 0; i < got.daily.size(); ++i) {
+        EXPECT_EQ(got.daily[i].indicators.at("BV"), expected.daily[i].indicators.at("BV"));
+    }
+    ASSERT_EQ(got.profile.size(), expected.profile.size());
+    for (size_t b = 0; b < got.profile.size(); ++b) {
+        EXPECT_EQ(got.profile[b].mean_sq_return, expected.profile[b].mean_sq_return);
+    }
+}
+
+TEST(RealizedTest, WritesProfileAndValidates) {
+    tsproc::realized::Result r = tsproc::realized::compute(session_bars(2));
+    const std::string path = (fs::temp_directory_path() / "tsproc_seasonality.csv").string();
+    ASSERT_TRUE(tsproc::realized::write_profile(path, r.profile));
+    std::ifstream in(path);
+    std::string header, first;
+    std::getline(in, header);
+    std::getline(in, first);
+    EXPECT_EQ(header.substr(0, 20), "offset,bars,returns,");
+    EXPECT_EQ(first.substr(0, 9), "14:30:00,");
+    fs::remove(path);
+
+    tsproc::realized::Options bad;
+    bad.bucket_ns = 0;
+    EXPECT_THROW(tsproc::realized::compute(session_bars(1), bad), std::invalid_argument);
+    bad = tsproc::realized::Options();
+    bad.col = "nope";
+    EXPECT_THROW(tsproc::realized::compute(session_bars(1), bad), std::invalid_argument);
+}
@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+#include "replay.hpp"
+#include "streaming.hpp"
+#include "datetime.hpp"
+#include "indicators.hpp"
+#include "signals.hpp"
+#include "io.hpp"
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+class ReplayTest : public ::testing::Test {
+protected:
+    std::string csv_path = "test_replay.csv";
+    std::string bin_path = "test_replay.bin";
+
+    void TearDown() override {
+        if (fs::exists(csv_path)) fs::remove(csv_path);
+        if (fs::exists(bin_path)) fs::remove(bin_path);
+    }
+
+    // Intraday bars one second apart with an oscillating close
+    void create_csv(size_t rows) {
+        std::ofstream ofs(csv_path);
+        ofs << "Date,Open,High,Low,Close,Adj Close,Volume\n";
+        for (size_t i = 0; i < rows; ++i) {
+            double close = 100.0 + 5.0 * std::sin(static_cast<double>(i) * 0.7) + (i % 7);
+            ofs << tsproc::format_datetime(tsproc::to_timestamp("2021-03-01 09:30:00") +
+                                           static_cast<int64_t>(i) * 1000000000LL)
+                << "," << close << "," << close + 1 << "," << close - 1 << ","
+                << close << "," << close << ",1000\n";
+        }
+    }
+};
+
+TEST(DateTimeTest, ParseAndFormat) {
+    int64_t ns = 0;
+    ASSERT_TRUE(tsproc::parse_datetime("1970-01-02", ns));
+    EXPECT_EQ(ns, 86400LL * 1000000000LL);
+
+    ASSERT_TRUE(tsproc::parse_datetime("2020-02-29 12:34:56.5", ns));
+    EXPECT_EQ(tsproc::format_datetime(ns), "2020-02-29 12:34:56.5");
+
+    ASSERT_TRUE(tsproc::parse_datetime("2020-01-01T00:00:00Z", ns));
+    EXPECT_EQ(tsproc::format_datetime(ns), "2020-01-01");
+
+    EXPECT_FALSE(tsproc::parse_datetime("not a date", ns));
+    EXPECT_FALSE(tsproc::parse_datetime("2020-13-01", ns));
+    EXPECT_FALSE(tsproc::parse_datetime("2023-02-30", ns));
+    EXPECT_FALSE(tsproc::parse_datetime("2023-04-31", ns));
+    EXPECT_FALSE(tsproc::parse_datetime("2100-02-29", ns));
+    EXPECT_TRUE(tsproc::parse_datetime("2000-02-29", ns));
+    EXPECT_EQ(tsproc::to_timestamp(""), tsproc::kInvalidTimestamp);
+}
+
+TEST(DateTimeTest, RejectsDatesOutsideInt64Range) {
+    int64_t ns = 0;
+    ASSERT_TRUE(tsproc::parse_datetime("2262-04-11 23:47:16.854775807", ns));
+    EXPECT_EQ(ns, INT64_MAX);
+    EXPECT_FALSE(tsproc::parse_datetime("2262-04-11 23:47:17", ns));
+    EXPECT_FALSE(tsproc::parse_datetime("9999-12-31", ns));
+
+    ASSERT_TRUE(tsproc::parse_datetime("1677-09-21 00:12:44", ns));
+    EXPECT_EQ(tsproc::format_datetime(ns), "1677-09-21 00:12:44");
+    EXPECT_FALSE(tsproc::parse_datetime("1677-09-21 00:12:43", ns));
+    EXPECT_FALSE(tsproc::parse_datetime("1600-01-01", ns));
+}
+
+TEST(ReplaySpeedTest, ParseSpeed) {
+    tsproc::ReplayOptions opts;
+    ASSERT_TRUE(tsproc::parse_replay_speed("realtime", opts));
+    EXPECT_EQ(opts.speed, tsproc::ReplaySpeed::RealTime);
+    ASSERT_TRUE(tsproc::parse_replay_speed("60x", opts));
+    EXPECT_EQ(opts.speed, tsproc::ReplaySpeed::Scaled);
+    EXPECT_DOUBLE_EQ(opts.factor, 60.0);
+    ASSERT_TRUE(tsproc::parse_replay_speed("fast", opts));
+    EXPECT_EQ(opts.speed, tsproc::ReplaySpeed::AsFastAsPossible);
+    EXPECT_FALSE(tsproc::parse_replay_speed("-2", opts));
+    EXPECT_FALSE(tsproc::parse_replay_speed("soon", opts));
+}
+
+TEST_F(ReplayTest, StreamingMatchesBatch) {
+    create_csv(60);
+
+    tsproc::streaming::StreamConfig config;
+    config.sma_windows = {5};
+    config.zscore_window = 10;
+    config.zscore_signal = true;
+    config.zscore_entry = 1.0;
+    config.zscore_exit = 0.2;
+
+    tsproc::streaming::StreamPipeline pipeline(config);
+    tsproc::ReplaySource source(csv_path);
+    std::vector<std::vector<double>> streamed;
+    source.run([&](const tsproc::Record& r) {
+        pipeline.update(r);
+        std::vector<double> row;
+        for (const auto& kv : pipeline.values()) row.push_back(kv.second);
+        streamed.push_back(row);
+    });
+
+    tsproc::TimeSeries ts = source.series();
+    tsproc::indicators::add_sma(ts, 5, "close");
+    tsproc::indicators::add_zscore(ts, 10, "close");
+    tsproc::signals::zscore_mean_reversion(ts, 10, 1.0, 0.2, "signal_z");
+
+    ASSERT_EQ(streamed.size(), ts.size());
+    const auto& names = pipeline.values();
+    for (size_t i = 0; i < ts.size(); ++i) {
+        for (size_t j = 0; j < names.size(); ++j) {
+            double batch = ts[i].indicators[names[j].first];
+            if (std::isnan(batch)) {
+                EXPECT_TRUE(std::isnan(streamed[i][j])) << names[j].first << " row " << i;
+            } else {
+                EXPECT_DOUBLE_EQ(streamed[i][j], batch) << names[j].first << " row " << i;
+            }
+        }
+    }
+}
+
+TEST_F(ReplayTest, AsFastAsPossibleRecordsLatency) {
+    create_csv(100);
+
+    tsproc::ReplaySource source(csv_path);
+    size_t calls = 0;
+    size_t emitted = source.run([&](const tsproc::Record&) { ++calls; });
+
+    EXPECT_EQ(emitted, 100u);
+    EXPECT_EQ(calls, 100u);
+    ASSERT_EQ(source.latency().count(), 100u);
+
+    tsproc::LatencyStats stats = source.latency_stats();
+    EXPECT_EQ(stats.count, 100u);
+    EXPECT_LE(stats.min_ns, stats.p50_ns);
+    EXPECT_LE(stats.p50_ns, stats.p99_ns);
+    EXPECT_LE(stats.p99_ns, stats.max_ns);
+}
+
+TEST_F(ReplayTest, ScaledPacingFollowsTimestamps) {
+    // 5 bars one second apart, replayed 20x faster -> ~200ms
+    create_csv(5);
+
+    tsproc::ReplayOptions opts;
+    opts.speed = tsproc::ReplaySpeed::Scaled;
+    opts.factor = 20.0;
+    tsproc::ReplaySource source(csv_path, opts);
+    source.load();
+
+    auto t0 = std::chrono::steady_clock::now();
+    source.run([](const tsproc::Record&) {});
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    EXPECT_GE(elapsed, 0.19);
+    EXPECT_LT(elapsed, 2.0);
+}
+
+TEST_F(ReplayTest, BinaryInputKeepsTimestamps) {
+    create_csv(10);
+    tsproc::ReplaySource csv_source(csv_path);
+    csv_source.load();
+
+    tsproc::BinaryWriter writer(bin_path);
+    ASSERT_TRUE(writer.write(csv_source.series()));
+
+    tsproc::ReplaySource bin_source(bin_path);
+    ASSERT_EQ(bin_source.load(), 10u);
+    for (size_t i = 0; i < 10; ++i) {
+        EXPECT_EQ(bin_source.series()[i].date, csv_source.series()[i].date);
+        EXPECT_DOUBLE_EQ(bin_source.series()[i].close, csv_source.series()[i].close);
+    }
+}
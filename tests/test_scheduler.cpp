@@ -0,0 +1,225 @@
+#include <gtest/gtest.h>
+#include "scheduler.hpp"
+#include "indicators.hpp"
+#include "signals.hpp"
+#include "io.hpp"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using tsproc::exec::Scheduler;
+using tsproc::exec::SchedulerOptions;
+using tsproc::exec::TaskGraph;
+using tsproc::exec::TaskGroup;
+
+namespace {
+
+SchedulerOptions with_threads(size_t threads) {
+    SchedulerOptions options;
+    options.threads = threads;
+    return options;
+}
+
+tsproc::TimeSeries make_series(size_t rows) {
+    tsproc::TimeSeries ts;
+    ts.reserve(rows);
+    for (size_t i = 0; i < rows; ++i) {
+        tsproc::Record r;
+        r.date = std::to_string(i);
+        r.close = 100.0 + 10.0 * std::sin(static_cast<double>(i) * 0.01);
+        r.open = r.high = r.low = r.adj_close = r.close;
+        r.volume = 1000.0;
+        ts.push(r);
+    }
+    return ts;
+}
+
+void run_pipeline(tsproc::TimeSeries& ts) {
+    tsproc::indicators::add_sma(ts, 20, "close");
+    tsproc::indicators::add_zscore(ts, 50, "close");
+    tsproc::indicators::add_volatility(ts, 50, "close", 252.0);
+    tsproc::signals::sma_crossover(ts, 10, 40, "signal_sma");
+    tsproc::signals::zscore_mean_reversion(ts, 50, 1.5, 0.5, "signal_z");
+    tsproc::signals::momentum_strategy(ts, 10, 0.01, -0.01, "close", "signal_mom");
+    tsproc::signals::bollinger_breakout(ts, 50, 2.0, "close", "signal_bb");
+}
+
+std::string csv_text(const tsproc::TimeSeries& ts) {
+    std::string path = (std::filesystem::temp_directory_path() / "tsproc_sched.csv").string();
+    tsproc::CSVWriter(path).write(ts);
+    std::ifstream f(path);
+    std::stringstream ss;
+    ss << f.rdbuf();
+    std::filesystem::remove(path);
+    return ss.str();
+}
+
+} // namespace
+
+TEST(SchedulerTest, ParallelForCoversRangeOnce) {
+    Scheduler scheduler(with_threads(4));
+    EXPECT_EQ(scheduler.concurrency(), 4u);
+
+    std::vector<std::atomic<int>> hits(10007);
+    tsproc::exec::parallel_for(0, hits.size(), 64, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) hits[i].fetch_add(1);
+    }, scheduler);
+
+    for (size_t i = 0; i < hits.size(); ++i) ASSERT_EQ(hits[i].load(), 1) << i;
+}
+
+TEST(SchedulerTest, SingleThreadRunsInline) {
+    Scheduler scheduler(with_threads(1));
+    EXPECT_EQ(scheduler.concurrency(), 1u);
+
+    const std::thread::id caller = std::this_thread::get_id();
+    bool same_thread = true;
+    TaskGroup group(scheduler);
+    for (int i = 0; i < 8; ++i) {
+        group.spawn([&] { same_thread = same_thread && std::this_thread::get_id() == caller; });
+    }
+    group.wait();
+    EXPECT_TRUE(same_thread);
+}
+
+TEST(SchedulerTest, NestedParallelismStaysWithinPool) {
+    Scheduler scheduler(with_threads(3));
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    std::atomic<long> total{0};
+
+    tsproc::exec::parallel_for(0, 16, 1, [&](size_t begin, size_t end) {
+        for (size_t outer = begin; outer < end; ++outer) {
+            tsproc::exec::parallel_for(0, 1000, 10, [&](size_t b, size_t e) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    threads.insert(std::this_thread::get_id());
+                }
+                total.fetch_add(static_cast<long>(e - b));
+            }, scheduler);
+        }
+    }, scheduler);
+
+    EXPECT_EQ(total.load(), 16 * 1000);
+    EXPECT_LE(threads.size(), scheduler.concurrency());  // no extra threads for inner loops
+}
+
+TEST(SchedulerTest, ExceptionsReachTheWaiter) {
+    Scheduler scheduler(with_threads(2));
+    std::atomic<int> ran{0};
+    TaskGroup group(scheduler);
+    for (int i = 0; i < 10; ++i) {
+        group.spawn([&, i] {
+            ran.fetch_add(1);
+            if (i == 3) throw std::runtime_error("task failed");
+        });
+    }
+    EXPECT_THROW(group.wait(), std::runtime_error);
+    EXPECT_EQ(ran.load(), 10);  // the other tasks still ran
+
+    EXPECT_THROW(tsproc::exec::parallel_for(0, 100, 1, [](size_t b, size_t) {
+        if (b > 50) throw std::out_of_range("chunk");
+    }, scheduler), std::out_of_range);
+}
+
+TEST(SchedulerTest, IdleWaiterSleeps) {
+    Scheduler scheduler(with_threads(2));
+    std::atomic<bool> started{false};
+    TaskGroup group(scheduler);
+    group.spawn([&] {
+        started.store(true);
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    });
+    while (!started.load()) std::this_thread::yield();
+
+    // The only task is running on the worker: the waiter must block, not spin
+    timespec before, after;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &before);
+    group.wait();
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &after);
+    const double cpu_ms = (after.tv_sec - before.tv_sec) * 1e3 + (after.tv_nsec - before.tv_nsec) / 1e6;
+    EXPECT_LT(cpu_ms, 100.0);
+}
+
+TEST(SchedulerTest, TaskGraphRespectsDependencies) {
+    Scheduler scheduler(with_threads(4));
+    std::atomic<int> clock{0};
+    int a = -1, b = -1, c = -1, d = -1;
+
+    // Diamond: a -> {b, c} -> d
+    TaskGraph graph;
+    auto na = graph.add([&] { a = clock.fetch_add(1); });
+    auto nb = graph.add([&] { b = clock.fetch_add(1); }, {na});
+    auto nc = graph.add([&] { c = clock.fetch_add(1); }, {na});
+    graph.add([&] { d = clock.fetch_add(1); }, {nb, nc});
+    EXPECT_EQ(graph.size(), 4u);
+    graph.run(scheduler);
+
+    EXPECT_EQ(a, 0);
+    EXPECT_LT(a, b);
+    EXPECT_LT(a, c);
+    EXPECT_EQ(d, 3);
+
+    // Graphs can be run again
+    graph.run(scheduler);
+    EXPECT_EQ(clock.load(), 8);
+
+    EXPECT_THROW(graph.add([] {}, {10}), std::invalid_argument);
+}
+
+TEST(SchedulerTest, TaskGraphSkipsDependentsOfFailedNodes) {
+    for (size_t threads : {1u, 3u}) {
+        Scheduler scheduler(with_threads(threads));
+        std::atomic<int> ran{0};
+        TaskGraph graph;
+        auto bad = graph.add([] { throw std::runtime_error("load failed"); });
+        graph.add([&] { ran.fetch_add(1); }, {bad});
+        graph.add([&] { ran.fetch_add(10); });
+        EXPECT_THROW(graph.run(scheduler), std::runtime_error);
+        EXPECT_EQ(ran.load(), 10) << threads;
+    }
+}
+
+TEST(SchedulerTest, PinnedWorkersRun) {
+    SchedulerOptions options = with_threads(3);
+    options.pin_threads = true;
+    Scheduler scheduler(options);
+
+    std::atomic<int> sum{0};
+    tsproc::exec::parallel_for(0, 300, 1, [&](size_t b, size_t e) {
+        sum.fetch_add(static_cast<int>(e - b));
+    }, scheduler);
+    EXPECT_EQ(sum.load(), 300);
+}
+
+TEST(SchedulerTest, LibraryResultsIndependentOfThreadCount) {
+    // Large enough that indicators, signals and the CSV writer all split work
+    const size_t rows = 120000;
+
+    Scheduler::configure_global(with_threads(1));
+    tsproc::TimeSeries serial = make_series(rows);
+    run_pipeline(serial);
+    std::string serial_csv = csv_text(serial);
+
+    Scheduler::configure_global(with_threads(4));
+    tsproc::TimeSeries parallel = make_series(rows);
+    run_pipeline(parallel);
+    std::string parallel_csv = csv_text(parallel);
+
+    Scheduler::configure_global(SchedulerOptions());
+
+    EXPECT_EQ(serial_csv.size(), parallel_csv.size());
+    EXPECT_TRUE(serial_csv == parallel_csv);
+    for (size_t i = 0; i < rows; ++i) {
+        ASSERT_EQ(serial[i].signal, parallel[i].signal) << i;
+    }
+}
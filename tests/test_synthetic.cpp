@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include "synthetic.hpp"
+#include "csv_reader.hpp"
+#include "datetime.hpp"
+#include "io.hpp"
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr int64_t kMinute = 60LL * 1000000000LL;
+
+} // namespace
+
+class SyntheticTest : public ::testing::Test {
+protected:
+    std::string csv_path = "test_synthetic.csv";
+    std::string bin_path = "test_synthetic.bin";
+
+    void TearDown() override {
+        for (const auto& p : {csv_path, bin_path}) {
+            if (fs::exists(p)) fs::remove(p);
+        }
+    }
+};
+
+TEST_F(SyntheticTest, DeterministicAcrossThreadCounts) {
+    tsproc::synthetic::GeneratorConfig config;
+    config.rows = 200000;  // several blocks
+    config.frequency_ns = kMinute;
+    config.vol_cluster = 0.5;
+
+    ASSERT_EQ(tsproc::synthetic::write(config, bin_path, tsproc::synthetic::OutputFormat::Binary, 1),
+              200000u);
+    tsproc::TimeSeries one = tsproc::BinaryReader(bin_path).read();
+    ASSERT_EQ(tsproc::synthetic::write(config, bin_path, tsproc::synthetic::OutputFormat::Binary, 4),
+              200000u);
+    tsproc::TimeSeries four = tsproc::BinaryReader(bin_path).read();
+
+    ASSERT_EQ(one.size(), four.size());
+    for (size_t i = 0; i < one.size(); i += 997) {
+        EXPECT_EQ(one[i].date, four[i].date);
+        EXPECT_DOUBLE_EQ(one[i].close, four[i].close);
+    }
+
+    tsproc::TimeSeries series = tsproc::synthetic::generate_series(config);
+    EXPECT_DOUBLE_EQ(series[150000].close, one[150000].close);
+}
+
+TEST_F(SyntheticTest, BarsAreConsistent) {
+    tsproc::synthetic::GeneratorConfig config;
+    config.rows = 5000;
+    tsproc::TimeSeries ts = tsproc::synthetic::generate_series(config);
+
+    ASSERT_EQ(ts.size(), 5000u);
+    EXPECT_EQ(ts[0].date, "2020-01-01");
+    for (const auto& r : ts) {
+        EXPECT_GE(r.high, std::max(r.open, r.close));
+        EXPECT_LE(r.low, std::min(r.open, r.close));
+        EXPECT_GT(r.low, 0.0);
+        EXPECT_GT(r.volume, 0.0);
+    }
+}
+
+TEST_F(SyntheticTest, IntradayWeekdaySchedule) {
+    tsproc::synthetic::GeneratorConfig config;
+    config.start = "2021-03-05";  // Friday
+    config.frequency_ns = 30 * kMinute;
+    config.weekdays_only = true;
+    ASSERT_TRUE(tsproc::parse_session("09:00-11:00", config.session_open_ns, config.session_close_ns));
+
+    tsproc::synthetic::Generator gen(config);
+    EXPECT_EQ(tsproc::format_datetime(gen.timestamp(0)), "2021-03-05 09:00:00");
+    EXPECT_EQ(tsproc::format_datetime(gen.timestamp(3)), "2021-03-05 10:30:00");
+    EXPECT_EQ(tsproc::format_datetime(gen.timestamp(4)), "2021-03-08 09:00:00");  // Monday
+    EXPECT_EQ(tsproc::format_datetime(gen.timestamp(4 * 5)), "2021-03-12 09:00:00");
+}
+
+TEST_F(SyntheticTest, InjectsGapsNaNsAndDuplicates) {
+    tsproc::synthetic::GeneratorConfig config;
+    config.rows = 20000;
+    config.gap_rate = 0.05;
+    config.nan_rate = 0.02;
+    config.duplicate_rate = 0.03;
+    tsproc::TimeSeries ts = tsproc::synthetic::generate_series(config);
+
+    size_t nans = 0, dups = 0;
+    for (size_t i = 0; i < ts.size(); ++i) {
+        if (std::isnan(ts[i].close)) ++nans;
+        if (i > 0 && ts[i].date == ts[i - 1].date) ++dups;
+    }
+    EXPECT_NEAR(static_cast<double>(nans) / 20000.0, 0.02 * 0.95, 0.006);
+    EXPECT_NEAR(static_cast<double>(dups) / 20000.0, 0.03 * 0.95, 0.006);
+    EXPECT_NEAR(static_cast<double>(ts.size()), 20000.0 * (1 - 0.05) * (1 + 0.03), 300.0);
+}
+
+TEST_F(SyntheticTest, CSVOutputIsReadable) {
+    tsproc::synthetic::GeneratorConfig config;
+    config.rows = 1000;
+    config.nan_rate = 0.1;
+    ASSERT_EQ(tsproc::synthetic::write(config, csv_path, tsproc::synthetic::OutputFormat::CSV, 2),
+              1000u);
+
+    tsproc::CSVReader reader(csv_path);
+    EXPECT_EQ(reader.read_to_timeseries(false).size(), 1000u);
+    EXPECT_LT(reader.read_to_timeseries(true).size(), 1000u);
+}
+
+TEST_F(SyntheticTest, MultiSymbolLongFormat) {
+    tsproc::synthetic::GeneratorConfig config;
+    config.rows = 10;
+    config.symbols = 3;
+    ASSERT_EQ(tsproc::synthetic::write(config, csv_path, tsproc::synthetic::OutputFormat::CSV),
+              30u);
+
+    std::ifstream file(csv_path);
+    std::string header, first, second;
+    std::getline(file, header);
+    std::getline(file, first);
+    std::getline(file, second);
+    EXPECT_EQ(header, "Date,Symbol,Open,High,Low,Close,Adj Close,Volume");
+    EXPECT_EQ(first.substr(0, 19), "2020-01-01,SYM0000,");
+    EXPECT_EQ(second.substr(0, 19), "2020-01-01,SYM0001,");
+}
+
+TEST_F(SyntheticTest, HalfLifeBoundsLongPaths) {
+    tsproc::synthetic::GeneratorConfig config;
+    config.rows = 300000;
+    config.frequency_ns = kMinute;
+    config.trend = 0.0;
+    config.half_life = 50.0;
+    tsproc::TimeSeries ts = tsproc::synthetic::generate_series(config);
+
+    // Stationary deviation sd is about 0.02 / sqrt(1 - phi^2) ~ 0.12 in log terms
+    for (size_t i = 0; i < ts.size(); i += 101) {
+        ASSERT_GT(ts[i].close, 40.0);
+        ASSERT_LT(ts[i].close, 250.0);
+    }
+}
+
+TEST_F(SyntheticTest, RejectsInvalidConfig) {
+    tsproc::synthetic::GeneratorConfig config;
+    config.gap_rate = 1.5;
+    EXPECT_THROW(tsproc::synthetic::Generator{config}, std::invalid_argument);
+
+    // Daily rows from 2020 pass the int64 nanosecond range in 2262
+    config = tsproc::synthetic::GeneratorConfig();
+    config.rows = 100000;
+    EXPECT_THROW(tsproc::synthetic::Generator{config}, std::invalid_argument);
+    config.rows = 80000;
+    EXPECT_NO_THROW(tsproc::synthetic::Generator{config});
+    config.weekdays_only = true;   // 80000 trading days span about 112000 calendar days
+    EXPECT_THROW(tsproc::synthetic::Generator{config}, std::invalid_argument);
+}
@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include "ticks.hpp"
+#include "datetime.hpp"
+#include "kernels.hpp"
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace fs = std::filesystem;
+using tsproc::ticks::Side;
+
+namespace {
+
+std::string quote_text(size_t rows) {
+    std::string text = "ts,symbol,bid,ask,bid_size,ask_size\n";
+    const int64_t start = 1'700'000'000'000'000'000LL;
+    for (size_t i = 0; i < rows; ++i) {
+        const double bid = 100.0 + 0.01 * static_cast<double>(i % 200);
+        text += std::to_string(start + static_cast<int64_t>(i) * 1000) + ",X," +
+                std::to_string(bid) + "," + std::to_string(bid + 0.02) + "," +
+                std::to_string(100 + i % 7) + "," + std::to_string(300 - i % 11) + "\n";
+    }
+    return text;
+}
+
+} // namespace
+
+TEST(TicksTest, ParsesSides) {
+    EXPECT_EQ(tsproc::ticks::parse_side("B"), Side::Buy);
+    EXPECT_EQ(tsproc::ticks::parse_side("buy"), Side::Buy);
+    EXPECT_EQ(tsproc::ticks::parse_side("SELL"), Side::Sell);
+    EXPECT_EQ(tsproc::ticks::parse_side("-1"), Side::Sell);
+    EXPECT_EQ(tsproc::ticks::parse_side(""), Side::Unknown);
+    EXPECT_EQ(tsproc::ticks::parse_side("market"), Side::Unknown);
+    EXPECT_STREQ(tsproc::ticks::side_name(Side::Sell), "sell");
+}
+
+TEST(TicksTest, ParsesTradesWithNanosecondTimestamps) {
+    const std::string text =
+        "Price,Size,Side,Timestamp\n"
+        "101.25,300,B,2024-03-01 14:30:00.000000001\n"
+        "101.5,100,s,1709303400000000002\n"
+        "\n"
+        "bad,100,B,2024-03-01 14:30:01\n"       // bad price: skipped
+        "101.75,1e3,,2024-03-01T14:30:02Z\n";   // exponent, no side
+    tsproc::ticks::TradeColumns trades;
+    ASSERT_TRUE(tsproc::ticks::parse_trades(text.data(), text.size(), trades));
+    ASSERT_EQ(trades.rows(), 3u);
+
+    const int64_t base = tsproc::to_timestamp("2024-03-01 14:30:00");
+    EXPECT_EQ(trades.ts[0], base + 1);
+    EXPECT_EQ(trades.ts[1], base + 2);
+    EXPECT_EQ(trades.at(0).side, Side::Buy);
+    EXPECT_EQ(trades.at(1).side, Side::Sell);
+    EXPECT_EQ(trades.at(2).side, Side::Unknown);
+    EXPECT_EQ(trades.price[1], 101.5);
+    EXPECT_EQ(trades.size[2], 1000.0);
+}
+
+TEST(TicksTest, DecimalsMatchStrtod) {
+    const char* values[] = {"0.1", "101.25", "-3.14159", "123456789.012345", "0.000000000000000001",
+                            "1234567890123456789.5", "7", "+2.5", "00012.5000"};
+    std::string text = "ts,price,size\n";
+    for (const char* v : values) text += std::string("1,") + v + ",1\n";
+    tsproc::ticks::TradeColumns trades;
+    ASSERT_TRUE(tsproc::ticks::parse_trades(text.data(), text.size(), trades));
+    ASSERT_EQ(trades.rows(), std::size(values));
+    for (size_t i = 0; i < trades.rows(); ++i) {
+        EXPECT_EQ(trades.price[i], std::strtod(values[i], nullptr)) << values[i];
+    }
+}
+
+TEST(TicksTest, MissingColumnsAreReported) {
+    const std::string text = "ts,price\n1,2\n";
+    tsproc::ticks::TradeColumns trades;
+    EXPECT_FALSE(tsproc::ticks::parse_trades(text.data(), text.size(), trades));
+    tsproc::ticks::QuoteColumns quotes;
+    EXPECT_FALSE(tsproc::ticks::parse_quotes(text.data(), text.size(), quotes));
+}
+
+TEST(TicksTest, ParallelQuoteParseMatchesSerial) {
+    const std::string text = quote_text(200000);  // ~10 MiB, several chunks
+    tsproc::ticks::QuoteColumns serial;
+    tsproc::ticks::QuoteColumns parallel;
+    ASSERT_TRUE(tsproc::ticks::parse_quotes(text.data(), text.size(), serial, 1));
+    ASSERT_TRUE(tsproc::ticks::parse_quotes(text.data(), text.size(), parallel, 4));
+    ASSERT_EQ(serial.rows(), 200000u);
+    EXPECT_EQ(parallel.ts, serial.ts);
+    EXPECT_EQ(parallel.bid, serial.bid);
+    EXPECT_EQ(parallel.ask_size, serial.ask_size);
+}
+
+TEST(TicksTest, QuoteFeatures) {
+    tsproc::ticks::QuoteColumns quotes;
+    quotes.push({1, 99.0, 101.0, 300.0, 100.0});
+    quotes.push({2, 10.0, 10.5, 0.0, 0.0});
+
+    tsproc::ticks::QuoteFeatures f = tsproc::ticks::quote_features(quotes);
+    EXPECT_EQ(f.mid[0], 100.0);
+    EXPECT_EQ(f.spread[0], 2.0);
+    EXPECT_EQ(f.microprice[0], (99.0 * 100.0 + 101.0 * 300.0) / 400.0);  // leans to the ask
+    EXPECT_EQ(f.imbalance[0], 0.5);
+    EXPECT_EQ(f.microprice[1], 10.25);  // empty book: the mid
+    EXPECT_EQ(f.imbalance[1], 0.0);
+}
+
+TEST(TicksTest, StreamingMetricsMatchBatchOnEveryIsa) {
+    const std::string text = quote_text(5000);
+    tsproc::ticks::QuoteColumns quotes;
+    ASSERT_TRUE(tsproc::ticks::parse_quotes(text.data(), text.size(), quotes, 1));
+
+    const tsproc::kernels::Isa saved = tsproc::kernels::active_isa();
+    tsproc::ticks::QuoteFeatures reference = tsproc::ticks::quote_features(quotes);
+    for (tsproc::kernels::Isa isa : tsproc::kernels::supported_isas()) {
+        ASSERT_TRUE(tsproc::kernels::set_isa(isa));
+        tsproc::ticks::QuoteFeatures f = tsproc::ticks::quote_features(quotes);
+        EXPECT_EQ(std::memcmp(f.microprice.data(), reference.microprice.data(),
+                              quotes.rows() * sizeof(double)), 0)
+            << tsproc::kernels::isa_name(isa);
+        for (size_t i = 0; i < quotes.rows(); i += 97) {
+            tsproc::ticks::QuoteMetrics m = tsproc::ticks::quote_metrics(quotes.at(i));
+            ASSERT_EQ(m.mid, f.mid[i]);
+            ASSERT_EQ(m.spread, f.spread[i]);
+            ASSERT_EQ(m.microprice, f.microprice[i]);
+            ASSERT_EQ(m.imbalance, f.imbalance[i]);
+        }
+    }
+    tsproc::kernels::set_isa(saved);
+}
+
+TEST(TicksTest, ReadsFiles) {
+    const std::string path = (fs::temp_directory_path() / "tsproc_quotes.csv").string();
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << quote_text(100);
+    }
+    tsproc::ticks::QuoteColumns quotes;
+    ASSERT_TRUE(tsproc::ticks::read_quotes(path, quotes));
+    EXPECT_EQ(quotes.rows(), 100u);
+    EXPECT_EQ(quotes.ts[1] - quotes.ts[0], 1000);
+    fs::remove(path);
+
+    tsproc::ticks::TradeColumns trades;
+    EXPECT_FALSE(tsproc::ticks::read_trades(path + ".missing", trades));
+}
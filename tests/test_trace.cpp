@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+#include "trace.hpp"
+#include "profiler.hpp"
+#include <sstream>
+#include <thread>
+
+using namespace tsproc::tracing;
+
+namespace {
+
+// Leaves the process-wide tracer disabled and empty for other tests
+class TraceTest : public ::testing::Test {
+protected:
+    void SetUp() override { Tracer::instance().clear(); }
+    void TearDown() override {
+        Tracer::instance().disable();
+        Tracer::instance().clear();
+    }
+};
+
+size_t count(const std::string& text, const std::string& needle) {
+    size_t n = 0;
+    for (size_t pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + 1)) {
+        ++n;
+    }
+    return n;
+}
+
+} // namespace
+
+TEST_F(TraceTest, DisabledRecordsNothing) {
+    {
+        Span span("test", "idle");
+    }
+    EXPECT_EQ(Tracer::instance().event_count(), 0u);
+}
+
+TEST_F(TraceTest, SpansFromWorkerThreadsAreExported) {
+    Tracer::instance().enable();
+    {
+        Span outer("test", "outer", 7, 100);
+        std::thread worker([] {
+            Tracer::instance().set_thread_name("worker");
+            Span inner("test", "inner");
+        });
+        worker.join();  // the worker's buffer outlives the thread
+    }
+    EXPECT_EQ(Tracer::instance().event_count(), 2u);
+
+    std::ostringstream os;
+    Tracer::instance().write(os);
+    const std::string json = os.str();
+    EXPECT_EQ(json.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["), 0u);
+    EXPECT_EQ(count(json, "\"ph\":\"X\""), 2u);
+    EXPECT_NE(json.find("\"name\":\"outer\",\"cat\":\"test\""), std::string::npos);
+    EXPECT_NE(json.find("\"args\":{\"param\":7,\"rows\":100}"), std::string::npos);
+    EXPECT_NE(json.find("\"args\":{\"name\":\"worker\"}"), std::string::npos);
+    EXPECT_NE(json.find("\"args\":{\"name\":\"main\"}"), std::string::npos);
+}
+
+TEST_F(TraceTest, ProfilerScopesEmitSpans) {
+    Tracer::instance().enable();
+    {
+        tsproc::profiling::Scope stage("load");
+        stage.set_rows(5);
+        tsproc::profiling::Scope kernel("sma", 20, 5);
+    }
+
+    std::ostringstream os;
+    Tracer::instance().write(os);
+    const std::string json = os.str();
+    EXPECT_NE(json.find("\"name\":\"load\",\"cat\":\"stage\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"sma\",\"cat\":\"kernel\""), std::string::npos);
+    EXPECT_NE(json.find("\"args\":{\"param\":20,\"rows\":5}"), std::string::npos);
+    EXPECT_NE(json.find("\"args\":{\"rows\":5}"), std::string::npos);
+}
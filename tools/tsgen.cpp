@@ -0,0 +1,186 @@
+#include "synthetic.hpp"
+#include "datetime.hpp"
+#include "scheduler.hpp"
+#include "trace.hpp"
+#include <chrono>
+#include <iostream>
+#include <string>
+
+namespace tsproc {
+
+void print_tsgen_usage(const char* program_name) {
+    std::cout << "Usage: " << program_name << " [OPTIONS]\n\n"
+              << "Synthetic OHLCV data generator\n\n"
+              << "Options:\n"
+              << "  -n, --rows N          Bars per symbol (default: 10000)\n"
+              << "  -o, --output FILE     Output file; .csv, .csv.gz or .bin (required)\n"
+              << "  --format FMT          Override the format: csv, gz or bin\n"
+              << "  --seed S              Random seed (default: 42)\n"
+              << "  --symbols N           Number of symbols (default: 1; CSV gains a Symbol column)\n"
+              << "  --start DATE          First trading day (default: 2020-01-01)\n"
+              << "  --freq PERIOD         Bar spacing, e.g. 1d, 1h, 1m, 500ms (default: 1d)\n"
+              << "  --weekdays            Generate Monday-Friday only\n"
+              << "  --session HH:MM-HH:MM Intraday session (UTC) for sub-daily bars\n"
+              << "  --start-price P       Starting price (default: 100)\n"
+              << "  --trend MU            Mean log return per bar (default: 0.0001)\n"
+              << "  --volatility SIGMA    Std. dev. of log returns per bar (default: 0.02)\n"
+              << "  --half-life N         Pull prices back to trend with this half-life in bars\n"
+              << "                        (default: 0 = random walk; use for very long corpora)\n"
+              << "  --vol-cluster X       Volatility clustering strength (default: 0)\n"
+              << "  --cluster-len N       Bars between volatility regime knots (default: 250)\n"
+              << "  --gap-rate P          Probability a bar is missing (default: 0)\n"
+              << "  --nan-rate P          Probability a bar has a missing close (default: 0)\n"
+              << "  --dup-rate P          Probability a bar is repeated with a correction (default: 0)\n"
+              << "  --threads N           Worker threads (default: all cores)\n"
+              << "  --trace FILE          Write a Chrome trace-event timeline of the run\n"
+              << "  --help                Show this help message\n\n"
+              << "Examples:\n"
+              << "  " << program_name << " -n 100000000 --freq 1m --trend 0 --volatility 0.001 \\\n"
+              << "      --half-life 100000 -o data/large.bin\n"
+              << "  " << program_name << " -n 390000 --freq 1m --weekdays --session 14:30-21:00 \\\n"
+              << "      --symbols 20 --gap-rate 0.001 --dup-rate 0.0005 -o data/intraday.csv.gz\n";
+}
+
+bool parse_tsgen_args(int argc, char* argv[], synthetic::GeneratorConfig& config,
+                      std::string& output, std::string& format, size_t& threads,
+                      std::string& trace_file) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+
+        if (arg == "--help" || arg == "-h") {
+            return false;
+        }
+        else if ((arg == "-n" || arg == "--rows") && has_value) {
+            config.rows = std::stoull(argv[++i]);
+        }
+        else if ((arg == "-o" || arg == "--output") && has_value) {
+            output = argv[++i];
+        }
+        else if (arg == "--format" && has_value) {
+            format = argv[++i];
+        }
+        else if (arg == "--seed" && has_value) {
+            config.seed = std::stoull(argv[++i]);
+        }
+        else if (arg == "--symbols" && has_value) {
+            config.symbols = std::stoul(argv[++i]);
+        }
+        else if (arg == "--start" && has_value) {
+            config.start = argv[++i];
+        }
+        else if (arg == "--freq" && has_value) {
+            if (!parse_duration(argv[++i], config.frequency_ns)) {
+                std::cerr << "Invalid frequency: " << argv[i] << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "--weekdays") {
+            config.weekdays_only = true;
+        }
+        else if (arg == "--session" && has_value) {
+            if (!parse_session(argv[++i], config.session_open_ns, config.session_close_ns)) {
+                std::cerr << "Invalid session (expected HH:MM-HH:MM): " << argv[i] << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "--start-price" && has_value) {
+            config.start_price = std::stod(argv[++i]);
+        }
+        else if (arg == "--trend" && has_value) {
+            config.trend = std::stod(argv[++i]);
+        }
+        else if (arg == "--volatility" && has_value) {
+            config.volatility = std::stod(argv[++i]);
+        }
+        else if (arg == "--half-life" && has_value) {
+            config.half_life = std::stod(argv[++i]);
+        }
+        else if (arg == "--vol-cluster" && has_value) {
+            config.vol_cluster = std::stod(argv[++i]);
+        }
+        else if (arg == "--cluster-len" && has_value) {
+            config.cluster_length = std::stoul(argv[++i]);
+        }
+        else if (arg == "--gap-rate" && has_value) {
+            config.gap_rate = std::stod(argv[++i]);
+        }
+        else if (arg == "--nan-rate" && has_value) {
+            config.nan_rate = std::stod(argv[++i]);
+        }
+        else if (arg == "--dup-rate" && has_value) {
+            config.duplicate_rate = std::stod(argv[++i]);
+        }
+        else if (arg == "--threads" && has_value) {
+            threads = std::stoul(argv[++i]);
+        }
+        else if (arg == "--trace" && has_value) {
+            trace_file = argv[++i];
+        }
+        else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return false;
+        }
+    }
+
+    if (output.empty()) {
+        std::cerr << "Error: --output is required\n";
+        return false;
+    }
+    if (!format.empty() && format != "csv" && format != "gz" && format != "bin") {
+        std::cerr << "Error: --format must be csv, gz or bin\n";
+        return false;
+    }
+    return true;
+}
+
+int run_tsgen(int argc, char* argv[]) {
+    synthetic::GeneratorConfig config;
+    std::string output;
+    std::string format_name;
+    size_t threads = 0;
+    std::string trace_file;
+
+    if (!parse_tsgen_args(argc, argv, config, output, format_name, threads, trace_file)) {
+        print_tsgen_usage(argv[0]);
+        return 1;
+    }
+
+    synthetic::OutputFormat format = synthetic::format_for_path(output);
+    if (format_name == "csv") format = synthetic::OutputFormat::CSV;
+    if (format_name == "gz") format = synthetic::OutputFormat::CompressedCSV;
+    if (format_name == "bin") format = synthetic::OutputFormat::Binary;
+
+    if (!trace_file.empty()) {
+        tracing::Tracer::instance().enable();
+    }
+    if (threads != 0) {
+        exec::SchedulerOptions options;
+        options.threads = threads;
+        exec::Scheduler::configure_global(options);
+    }
+
+    try {
+        auto start = std::chrono::steady_clock::now();
+        size_t rows = synthetic::write(config, output, format, threads);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (rows == 0 && config.rows > 0) {
+            return 1;
+        }
+        std::cout << "Generated " << rows << " rows -> " << output << " (" << seconds << "s)"
+                  << std::endl;
+        if (!trace_file.empty() && !tracing::Tracer::instance().write(trace_file)) {
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace tsproc
+
+int main(int argc, char* argv[]) {
+    return tsproc::run_tsgen(argc, argv);
+}
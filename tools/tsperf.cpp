@@ -0,0 +1,585 @@
+#include "csv_reader.hpp"
+#include "downsample.hpp"
+#include "gaps.hpp"
+#include "indicators.hpp"
+#include "io.hpp"
+#include "signals.hpp"
+#include "streaming.hpp"
+#include "synthetic.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifndef TSPERF_BUILD_TYPE
+#define TSPERF_BUILD_TYPE ""
+#endif
+
+namespace tsproc {
+namespace {
+
+constexpr size_t kRows = 200000;          ///< Fixed input size of every workload
+constexpr double kDefaultTolerance = 0.25; ///< Allowed slowdown when a benchmark sets none
+
+// ---------------------------------------------------------------------------
+// Minimal JSON reader for result/baseline files written by this tool
+// ---------------------------------------------------------------------------
+
+struct Json {
+    enum class Type { Null, Bool, Number, String, Array, Object };
+    Type type = Type::Null;
+    double number = 0.0;
+    std::string string;
+    std::vector<Json> items;
+    std::vector<std::pair<std::string, Json>> fields;
+
+    const Json* get(const std::string& key) const {
+        for (const auto& f : fields) {
+            if (f.first == key) return &f.second;
+        }
+        return nullptr;
+    }
+    double number_or(const std::string& key, double fallback) const {
+        const Json* v = get(key);
+        return v && v->type == Type::Number ? v->number : fallback;
+    }
+    std::string string_or(const std::string& key, const std::string& fallback) const {
+        const Json* v = get(key);
+        return v && v->type == Type::String ? v->string : fallback;
+    }
+};
+
+class JsonParser {
+public:
+    explicit JsonParser(const std::string& text) : s_(text) {}
+
+    Json parse() {
+        Json v = value();
+        skip_ws();
+        if (pos_ != s_.size()) fail("trailing characters");
+        return v;
+    }
+
+private:
+    const std::string& s_;
+    size_t pos_ = 0;
+
+    [[noreturn]] void fail(const std::string& what) const {
+        throw std::runtime_error("JSON parse error at offset " + std::to_string(pos_) + ": " + what);
+    }
+    void skip_ws() {
+        while (pos_ < s_.size() && std::isspace(static_cast<unsigned char>(s_[pos_]))) ++pos_;
+    }
+    bool consume(char c) {
+        skip_ws();
+        if (pos_ < s_.size() && s_[pos_] == c) {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+    void expect(char c) {
+        if (!consume(c)) fail(std::string("expected '") + c + "'");
+    }
+    bool literal(const char* word) {
+        size_t n = std::char_traits<char>::length(word);
+        if (s_.compare(pos_, n, word) != 0) return false;
+        pos_ += n;
+        return true;
+    }
+
+    std::string string_value() {
+        expect('"');
+        std::string out;
+        while (pos_ < s_.size() && s_[pos_] != '"') {
+            char c = s_[pos_++];
+            if (c == '\\' && pos_ < s_.size()) {
+                char e = s_[pos_++];
+                switch (e) {
+                    case 'n': out += '\n'; break;
+                    case 't': out += '\t'; break;
+                    case 'r': out += '\r'; break;
+                    case 'u': pos_ += 4; out += '?'; break;  // names are ASCII
+                    default: out += e; break;
+                }
+            } else {
+                out += c;
+            }
+        }
+        if (pos_ >= s_.size()) fail("unterminated string");
+        ++pos_;
+        return out;
+    }
+
+    Json value() {
+        skip_ws();
+        if (pos_ >= s_.size()) fail("unexpected end");
+        Json v;
+        char c = s_[pos_];
+        if (c == '{') {
+            ++pos_;
+            v.type = Json::Type::Object;
+            if (consume('}')) return v;
+            do {
+                skip_ws();
+                std::string key = string_value();
+                expect(':');
+                v.fields.emplace_back(std::move(key), value());
+            } while (consume(','));
+            expect('}');
+        } else if (c == '[') {
+            ++pos_;
+            v.type = Json::Type::Array;
+            if (consume(']')) return v;
+            do {
+                v.items.push_back(value());
+            } while (consume(','));
+            expect(']');
+        } else if (c == '"') {
+            v.type = Json::Type::String;
+            v.string = string_value();
+        } else if (literal("true")) {
+            v.type = Json::Type::Bool;
+            v.number = 1.0;
+        } else if (literal("false")) {
+            v.type = Json::Type::Bool;
+        } else if (literal("null")) {
+            v.type = Json::Type::Null;
+        } else {
+            const char* begin = s_.c_str() + pos_;
+            char* end = nullptr;
+            v.type = Json::Type::Number;
+            v.number = std::strtod(begin, &end);
+            if (end == begin) fail("unexpected character");
+            pos_ += static_cast<size_t>(end - begin);
+        }
+        return v;
+    }
+};
+
+std::string json_escape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+// ---------------------------------------------------------------------------
+// Workload matrix
+// ---------------------------------------------------------------------------
+
+struct Workload {
+    std::string name;
+    /// Runs one repetition; untimed setup happens inside, returns timed seconds
+    std::function<double()> run;
+};
+
+struct Result {
+    std::string name;
+    size_t rows = 0;
+    double best_seconds = 0.0;
+    double median_seconds = 0.0;
+    double rows_per_sec = 0.0;
+    double tolerance = -1.0;  ///< Baseline files only; < 0 = use the default
+};
+
+template <typename F>
+double time_it(F&& body) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/// Fixed minute-bar corpus shared by every workload
+const TimeSeries& input_series() {
+    static const TimeSeries ts = [] {
+        synthetic::GeneratorConfig config;
+        config.rows = kRows;
+        config.start = "2010-01-04";
+        config.frequency_ns = 60LL * 1000000000LL;
+        config.weekdays_only = true;
+        config.session_open_ns = (14LL * 60 + 30) * 60LL * 1000000000LL;
+        config.session_close_ns = 21LL * 3600LL * 1000000000LL;
+        config.volatility = 0.001;
+        config.gap_rate = 0.001;
+        return synthetic::generate_series(config);
+    }();
+    return ts;
+}
+
+std::vector<Workload> workloads(const std::filesystem::path& dir) {
+    const std::string csv_path = (dir / "tsperf_input.csv").string();
+    const std::string bin_path = (dir / "tsperf_input.bin").string();
+    const std::string out_path = (dir / "tsperf_output").string();
+
+    // Files read by the workloads are written once, outside any timing
+    auto ensure_inputs = [csv_path, bin_path] {
+        static bool written = false;
+        if (written) return;
+        CSVWriter(csv_path).write(input_series());
+        BinaryWriter(bin_path).write(input_series());
+        written = true;
+    };
+
+    // Copy the input, then time `kernel` on the copy
+    auto on_copy = [](std::function<void(TimeSeries&)> kernel) {
+        return [kernel] {
+            TimeSeries ts = input_series();
+            return time_it([&] { kernel(ts); });
+        };
+    };
+
+    return {
+        {"csv_read", [=] {
+            ensure_inputs();
+            return time_it([&] { CSVReader(csv_path).read_to_timeseries(); });
+        }},
+        {"csv_write", [=] {
+            const TimeSeries& ts = input_series();
+            double s = time_it([&] { CSVWriter(out_path + ".csv").write(ts); });
+            std::filesystem::remove(out_path + ".csv");
+            return s;
+        }},
+        {"binary_read", [=] {
+            ensure_inputs();
+            return time_it([&] { BinaryReader(bin_path).read(); });
+        }},
+        {"binary_write", [=] {
+            const TimeSeries& ts = input_series();
+            double s = time_it([&] { BinaryWriter(out_path + ".bin").write(ts); });
+            std::filesystem::remove(out_path + ".bin");
+            return s;
+        }},
+        {"sma_20", on_copy([](TimeSeries& ts) { indicators::add_sma(ts, 20); })},
+        {"sma_200", on_copy([](TimeSeries& ts) { indicators::add_sma(ts, 200); })},
+        {"roll_mean_std_20", on_copy([](TimeSeries& ts) { indicators::add_roll_mean_std(ts, 20); })},
+        {"roll_moments_20", on_copy([](TimeSeries& ts) { indicators::add_roll_moments(ts, 20); })},
+        {"zscore_20", on_copy([](TimeSeries& ts) { indicators::add_zscore(ts, 20); })},
+        {"ema_20", on_copy([](TimeSeries& ts) { indicators::add_ema(ts, 20); })},
+        {"volatility_20", on_copy([](TimeSeries& ts) { indicators::add_volatility(ts, 20); })},
+        {"range_volatility_20", on_copy([](TimeSeries& ts) { indicators::add_range_volatility(ts, 20); })},
+        {"sma_crossover_10_50", on_copy([](TimeSeries& ts) {
+            indicators::add_sma(ts, 10);
+            indicators::add_sma(ts, 50);
+            signals::sma_crossover(ts, 10, 50);
+        })},
+        {"zscore_signal_20", on_copy([](TimeSeries& ts) {
+            indicators::add_zscore(ts, 20);
+            signals::zscore_mean_reversion(ts, 20, 2.0, 0.5);
+        })},
+        {"stream_pipeline", on_copy([](TimeSeries& ts) {
+            streaming::StreamConfig config;
+            config.sma_windows = {20};
+            config.zscore_window = 20;
+            config.zscore_signal = true;
+            streaming::StreamPipeline pipeline(config);
+            for (auto& r : ts) r.signal = pipeline.update(r);
+        })},
+        {"lttb_2000", on_copy([](TimeSeries& ts) { downsample::lttb(ts, 2000); })},
+        {"gap_detect_1m", on_copy([](TimeSeries& ts) {
+            gaps::Calendar calendar;
+            calendar.frequency_ns = 60LL * 1000000000LL;
+            calendar.weekdays_only = true;
+            calendar.session_open_ns = (14LL * 60 + 30) * 60LL * 1000000000LL;
+            calendar.session_close_ns = 21LL * 3600LL * 1000000000LL;
+            gaps::detect(ts, calendar);
+        })},
+    };
+}
+
+Result measure(const Workload& w, size_t repeat) {
+    std::vector<double> times;
+    w.run();  // warm-up: page cache, allocator, lazily built inputs
+    for (size_t i = 0; i < repeat; ++i) times.push_back(w.run());
+    std::sort(times.begin(), times.end());
+
+    Result r;
+    r.name = w.name;
+    r.rows = kRows;
+    r.best_seconds = times.front();
+    r.median_seconds = times[times.size() / 2];
+    r.rows_per_sec = r.best_seconds > 0.0 ? static_cast<double>(kRows) / r.best_seconds : 0.0;
+    return r;
+}
+
+// ---------------------------------------------------------------------------
+// Result files
+// ---------------------------------------------------------------------------
+
+struct ResultFile {
+    std::string build_type;
+    double default_tolerance = kDefaultTolerance;
+    std::vector<Result> results;
+};
+
+bool write_results(const std::string& path, const ResultFile& file) {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        std::cerr << "Error: Could not open file for writing: " << path << std::endl;
+        return false;
+    }
+    out << std::setprecision(6);
+    out << "{\n"
+        << "  \"version\": 1,\n"
+        << "  \"build_type\": \"" << json_escape(file.build_type) << "\",\n"
+        << "  \"rows\": " << kRows << ",\n"
+        << "  \"default_tolerance\": " << file.default_tolerance << ",\n"
+        << "  \"results\": [\n";
+    for (size_t i = 0; i < file.results.size(); ++i) {
+        const Result& r = file.results[i];
+        out << "    {\"name\": \"" << json_escape(r.name) << "\", \"rows\": " << r.rows
+            << ", \"best_seconds\": " << r.best_seconds
+            << ", \"median_seconds\": " << r.median_seconds
+            << ", \"rows_per_sec\": " << std::fixed << std::setprecision(0) << r.rows_per_sec
+            << std::defaultfloat << std::setprecision(6);
+        if (r.tolerance >= 0.0) out << ", \"tolerance\": " << r.tolerance;
+        out << "}" << (i + 1 < file.results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+    return out.good();
+}
+
+bool read_results(const std::string& path, ResultFile& file) {
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        std::cerr << "Error: Could not open baseline: " << path << std::endl;
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    try {
+        Json root = JsonParser(buffer.str()).parse();
+        file.build_type = root.string_or("build_type", "");
+        file.default_tolerance = root.number_or("default_tolerance", kDefaultTolerance);
+        const Json* results = root.get("results");
+        if (!results || results->type != Json::Type::Array) {
+            std::cerr << "Error: Baseline has no \"results\" array: " << path << std::endl;
+            return false;
+        }
+        for (const Json& item : results->items) {
+            Result r;
+            r.name = item.string_or("name", "");
+            r.rows = static_cast<size_t>(item.number_or("rows", 0.0));
+            r.best_seconds = item.number_or("best_seconds", 0.0);
+            r.median_seconds = item.number_or("median_seconds", 0.0);
+            r.rows_per_sec = item.number_or("rows_per_sec", 0.0);
+            r.tolerance = item.number_or("tolerance", -1.0);
+            if (!r.name.empty()) file.results.push_back(r);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << path << ": " << e.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+const Result* find(const std::vector<Result>& results, const std::string& name) {
+    for (const auto& r : results) {
+        if (r.name == name) return &r;
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Print the baseline/current table
+ *
+ * @return Number of benchmarks slower than their tolerance allows
+ */
+size_t compare(const ResultFile& baseline, const std::vector<Result>& current,
+               double threshold_override) {
+    size_t regressions = 0;
+    std::printf("%-22s %14s %14s %9s %7s  %s\n", "benchmark", "baseline r/s", "current r/s",
+                "change", "tol", "status");
+    for (const auto& cur : current) {
+        const Result* base = find(baseline.results, cur.name);
+        if (!base || base->rows_per_sec <= 0.0) {
+            std::printf("%-22s %14s %14.0f %9s %7s  %s\n", cur.name.c_str(), "-",
+                        cur.rows_per_sec, "-", "-", "new");
+            continue;
+        }
+        double tolerance = base->tolerance >= 0.0 ? base->tolerance : baseline.default_tolerance;
+        if (threshold_override >= 0.0) tolerance = threshold_override;
+
+        double change = cur.rows_per_sec / base->rows_per_sec - 1.0;
+        const char* status = "ok";
+        if (base->rows != cur.rows) {
+            status = "rows differ";
+        } else if (change < -tolerance) {
+            status = "REGRESSION";
+            ++regressions;
+        } else if (change > tolerance) {
+            status = "faster";
+        }
+        std::printf("%-22s %14.0f %14.0f %+8.1f%% %6.0f%%  %s\n", cur.name.c_str(),
+                    base->rows_per_sec, cur.rows_per_sec, change * 100.0, tolerance * 100.0,
+                    status);
+    }
+    return regressions;
+}
+
+// ---------------------------------------------------------------------------
+// CLI
+// ---------------------------------------------------------------------------
+
+struct Options {
+    std::string baseline;
+    std::string output;
+    std::string filter;
+    size_t repeat = 5;
+    double threshold = -1.0;
+    bool update_baseline = false;
+    bool list = false;
+};
+
+void print_tsperf_usage(const char* program_name) {
+    std::cout << "Usage: " << program_name << " [OPTIONS]\n\n"
+              << "Performance regression harness: runs a fixed workload matrix on\n"
+              << kRows << " generated minute bars and compares rows/s with a baseline\n\n"
+              << "Options:\n"
+              << "  --baseline FILE     Baseline JSON to compare against\n"
+              << "  -o, --output FILE   Write results as JSON\n"
+              << "  --update-baseline   Rewrite --baseline with these results (keeps tolerances)\n"
+              << "  --threshold X       Allowed slowdown for every benchmark, e.g. 0.2 = 20%\n"
+              << "                      (default: per-benchmark tolerance, else "
+              << kDefaultTolerance << ")\n"
+              << "  --repeat N          Timed repetitions per workload; best is kept (default: 5)\n"
+              << "  --filter STR        Only run workloads whose name contains STR\n"
+              << "  --list              List workloads and exit\n"
+              << "  --help              Show this help message\n\n"
+              << "Exit status: 0 = no regression, 1 = regression, 2 = error\n";
+}
+
+bool parse_tsperf_args(int argc, char* argv[], Options& opts) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+
+        if (arg == "--help" || arg == "-h") {
+            return false;
+        }
+        else if (arg == "--baseline" && has_value) {
+            opts.baseline = argv[++i];
+        }
+        else if ((arg == "-o" || arg == "--output") && has_value) {
+            opts.output = argv[++i];
+        }
+        else if (arg == "--filter" && has_value) {
+            opts.filter = argv[++i];
+        }
+        else if (arg == "--repeat" && has_value) {
+            opts.repeat = std::max<size_t>(1, std::stoul(argv[++i]));
+        }
+        else if (arg == "--threshold" && has_value) {
+            opts.threshold = std::stod(argv[++i]);
+        }
+        else if (arg == "--update-baseline") {
+            opts.update_baseline = true;
+        }
+        else if (arg == "--list") {
+            opts.list = true;
+        }
+        else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return false;
+        }
+    }
+
+    if (opts.update_baseline && opts.baseline.empty()) {
+        std::cerr << "Error: --update-baseline requires --baseline\n";
+        return false;
+    }
+    return true;
+}
+
+int run_tsperf(int argc, char* argv[]) {
+    Options opts;
+    if (!parse_tsperf_args(argc, argv, opts)) {
+        print_tsperf_usage(argv[0]);
+        return 2;
+    }
+
+    const std::filesystem::path dir = std::filesystem::temp_directory_path();
+    std::vector<Workload> matrix = workloads(dir);
+    if (opts.list) {
+        for (const auto& w : matrix) std::cout << w.name << "\n";
+        return 0;
+    }
+
+    ResultFile baseline;
+    bool have_baseline = false;
+    if (!opts.baseline.empty() &&
+        (!opts.update_baseline || std::filesystem::exists(opts.baseline))) {
+        if (!read_results(opts.baseline, baseline)) return 2;
+        have_baseline = true;
+    }
+
+    ResultFile current;
+    current.build_type = TSPERF_BUILD_TYPE;
+    current.default_tolerance = baseline.default_tolerance;
+    try {
+        for (const auto& w : matrix) {
+            if (!opts.filter.empty() && w.name.find(opts.filter) == std::string::npos) continue;
+            std::cerr << "running " << w.name << "..." << std::endl;
+            current.results.push_back(measure(w, opts.repeat));
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 2;
+    }
+    std::filesystem::remove(dir / "tsperf_input.csv");
+    std::filesystem::remove(dir / "tsperf_input.bin");
+
+    if (!opts.output.empty() && !write_results(opts.output, current)) return 2;
+
+    if (opts.update_baseline) {
+        // Keep hand-tuned tolerances and entries that were filtered out
+        ResultFile updated = current;
+        for (auto& r : updated.results) {
+            if (const Result* old = find(baseline.results, r.name)) r.tolerance = old->tolerance;
+        }
+        for (const auto& old : baseline.results) {
+            if (!find(updated.results, old.name)) updated.results.push_back(old);
+        }
+        if (!write_results(opts.baseline, updated)) return 2;
+        std::cout << "Baseline written: " << opts.baseline << std::endl;
+        return 0;
+    }
+
+    if (!have_baseline) {
+        compare(baseline, current.results, opts.threshold);
+        return 0;
+    }
+
+    size_t regressions = compare(baseline, current.results, opts.threshold);
+    if (baseline.build_type != current.build_type) {
+        // Timings of differently optimized builds are not comparable
+        std::cout << "\nBaseline was recorded with build type '" << baseline.build_type
+                  << "', this is '" << current.build_type << "': report only." << std::endl;
+        return 0;
+    }
+    if (regressions > 0) {
+        std::cout << "\n" << regressions << " benchmark(s) regressed beyond tolerance" << std::endl;
+        return 1;
+    }
+    std::cout << "\nNo regressions" << std::endl;
+    return 0;
+}
+
+} // namespace
+} // namespace tsproc
+
+int main(int argc, char* argv[]) {
+    return tsproc::run_tsperf(argc, argv);
+}
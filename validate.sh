@@ -68,7 +68,7 @@ echo ""
 # Check data and tools
 echo "Checking data and tools..."
 test -f data/sample.csv; check "sample.csv exists"
-test -f tools/gen_synthetic.py; check "gen_synthetic.py exists"
+test -f tools/tsgen.cpp; check "tsgen.cpp exists"
 test -f examples.sh; check "examples.sh exists"
 echo ""
 